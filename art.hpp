@@ -7,10 +7,12 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <iostream>
 #include <optional>
-#include <stack>
+#include <span>
 #include <type_traits>
+#include <utility>
 
 #include "art_common.hpp"
 #include "art_internal.hpp"
@@ -75,12 +77,16 @@ class inode : public inode_base<Key, Value> {};
 template <typename Key, typename Value>
 class mutex_db;
 
+template <typename Key>
+class multimap_db;
+
 /// A non-thread-safe implementation of the Adaptive Radix Tree (ART).
 ///
 /// \sa olc_art for a highly concurrent thread-safe ART implementation.
 template <typename Key, typename Value>
 class db final {
   friend class mutex_db<Key, Value>;
+  friend class multimap_db<Key>;
 
  public:
   /// The type of the keys in the index.
@@ -117,6 +123,11 @@ class db final {
   /// tree and the associated index entry was removed).
   [[nodiscard]] bool remove_internal(art_key_type remove_key);
 
+  /// Return the tree slot holding the leaf for an encoded key, so that the leaf
+  /// can be replaced in place, or nullptr if the key is not in the tree.
+  [[nodiscard, gnu::pure]] detail::node_ptr* find_leaf_slot(
+      art_key_type search_key) noexcept;
+
  public:
   // Creation and destruction
   db() noexcept = default;
@@ -147,6 +158,11 @@ class db final {
 
   /// Insert a value under a key iff there is no entry for that key.
   ///
+  /// For the fixed-width keys, the tree keeps the path to its rightmost leaf,
+  /// and a key greater than all the keys in the tree is appended starting
+  /// from the deepest slot of that path which is also on the path of the new
+  /// key, skipping the descent from the root.
+  ///
   /// \note Cannot be called during stack unwinding with
   /// `std::uncaught_exceptions() > 0`.
   ///
@@ -166,6 +182,21 @@ class db final {
     return insert_internal(k, v);
   }
 
+  /// Insert the key value pairs of \a batch, skipping the keys already
+  /// present.
+  ///
+  /// The slots on the path of the last insert are kept, and the next insert
+  /// starts from the deepest of them that is still on its own key path instead
+  /// of the root. Batches sorted by key, whose consecutive keys share most of
+  /// their paths, thus skip most of the descents. Unsorted batches are
+  /// inserted correctly too, only without the speedup.
+  ///
+  /// \note Cannot be called during stack unwinding with
+  /// `std::uncaught_exceptions() > 0`.
+  ///
+  /// \return the number of inserted pairs.
+  std::size_t insert_batch(std::span<const std::pair<Key, value_type>> batch);
+
   /// Remove the entry associated with the key.
   ///
   /// \param search_key If Key is a simple primitive type, then it is converted
@@ -183,13 +214,27 @@ class db final {
   // Removes all entries in the index.
   void clear() noexcept;
 
+  /// Set the number of children, ahead of the one being visited, which the
+  /// scans prefetch from each internal node on their path. Larger distances
+  /// hide more memory latency on large trees at the cost of useless loads
+  /// near the scan end. Zero disables prefetching.
+  void set_scan_prefetch_distance(std::uint8_t distance) noexcept {
+    scan_prefetch_distance = distance;
+  }
+
+  /// Return the scan prefetch distance.
+  [[nodiscard]] std::uint8_t get_scan_prefetch_distance() const noexcept {
+    return scan_prefetch_distance;
+  }
+
   ///
   /// iterator (the iterator is an internal API, the public API is scan()).
   ///
   class iterator {
-    // Note: The iterator is backed by a std::stack. This means that
-    // the iterator methods accessing the stack can not be declared as
-    // [[noexcept]].
+    // Note: The iterator is backed by a detail::iterator_stack, which does not
+    // allocate for fixed-width keys. For unodb::key_view keys, deep paths
+    // spill to the heap, so the stack push methods are only noexcept for
+    // fixed-width keys.
     friend class db;
     template <class>
     friend class visitor;
@@ -197,6 +242,9 @@ class db final {
     /// Alias used for the elements of the stack.
     using stack_entry = typename inode_base::iter_result;
 
+    /// True iff pushing onto the stack may allocate.
+    static constexpr bool growable_stack = std::is_same_v<Key, key_view>;
+
    protected:
     /// Construct an empty iterator (one that is logically not
     /// positioned on anything and which will report !valid()).
@@ -271,13 +319,9 @@ class db final {
       os << "keybuf=";
       detail::dump_key(os, keybuf_.get_key_view());
       os << "\n";
-      // Create a new stack and copy everything there.  Using the new
-      // stack, print out the stack in top-bottom order.  This avoids
-      // modifications to the existing stack for the iterator.
-      auto tmp = stack_;
-      auto level = tmp.size() - 1;
-      while (!tmp.empty()) {
-        const auto& e = tmp.top();
+      // Print out the stack in top-bottom order.
+      for (auto level = stack_.size(); level-- > 0;) {
+        const auto& e = stack_[level];
         const auto& np = e.node;
         os << "iter::stack:: level = " << level << ", key_byte=0x" << std::hex
            << std::setfill('0') << std::setw(2)
@@ -289,8 +333,6 @@ class db final {
         os << ", ";
         art_policy::dump_node(os, np, false /*recursive*/);
         if (np.type() != node_type::LEAF) os << '\n';
-        tmp.pop();
-        level--;
       }
     }
     // LCOV_EXCL_STOP
@@ -340,7 +382,8 @@ class db final {
 
     /// Push a non-leaf entry onto the stack.
     void push(detail::node_ptr node, std::byte key_byte,
-              std::uint8_t child_index, detail::key_prefix_snapshot prefix) {
+              std::uint8_t child_index,
+              detail::key_prefix_snapshot prefix) noexcept(!growable_stack) {
       // For variable length keys we need to know the number of bytes
       // associated with the node's key_prefix.  In addition there is
       // one byte for the descent to the child node along the
@@ -354,7 +397,7 @@ class db final {
     }
 
     /// Push a leaf onto the stack.
-    void push_leaf(detail::node_ptr aleaf) {
+    void push_leaf(detail::node_ptr aleaf) noexcept(!growable_stack) {
       // Mock up a stack entry for the leaf.
       stack_.push({
           aleaf,
@@ -396,10 +439,28 @@ class db final {
     }
 
    private:
+    /// Prefetch the children of \a inode following the one at \a child_index
+    /// in the scan direction. Upon descending into \a inode, this prefetches
+    /// the whole window of the scan prefetch distance. Upon advancing within
+    /// it, only the child entering the window is prefetched.
+    template <class INode>
+    void prefetch_ahead(INode* inode, node_type type,
+                        std::uint8_t child_index, bool fwd,
+                        bool descending) const noexcept {
+      const auto distance = db_.scan_prefetch_distance;
+      if (distance == 0) return;
+      if (descending) {
+        inode->prefetch_children(type, child_index, fwd, 0, distance);
+      } else {
+        inode->prefetch_children(type, child_index, fwd,
+                                 static_cast<std::uint8_t>(distance - 1), 1);
+      }
+    }
+
     /// Invalidate the iterator (pops everything off of the stack).
     iterator& invalidate() noexcept {
-      while (!stack_.empty()) stack_.pop();  // clear the stack
-      keybuf_.reset();                       // clear the key buffer
+      stack_.clear();   // clear the stack
+      keybuf_.reset();  // clear the key buffer
       return *this;
     }
 
@@ -442,7 +503,9 @@ class db final {
     /// look at the child_indexes[], find the next mapped key value
     /// greater than the current one, and then look at its entry in
     /// the children[].
-    std::stack<stack_entry> stack_{};
+    detail::iterator_stack<stack_entry, detail::iterator_stack_capacity<Key>,
+                           growable_stack>
+        stack_{};
 
     /// A buffer into which visited encoded (binary comparable) keys
     /// are materialized by during the iterator traversal.  Bytes are
@@ -584,6 +647,53 @@ class db final {
   using visitor_type = visitor<db_type::iterator>;
   using inode_defs_type = detail::inode_defs<Key, Value>;
 
+  /// A tree slot on the path of an insert, with the depth of its node.
+  struct insert_path_entry {
+    detail::node_ptr* node;
+    tree_depth_type depth;
+  };
+
+  /// The slots on the path of the last insert of insert_batch(), root first.
+  using insert_path =
+      detail::iterator_stack<insert_path_entry,
+                             detail::iterator_stack_capacity<Key>,
+                             std::is_same_v<Key, key_view>>;
+
+  /// Insert a value under an encoded key, starting the search at the \a node
+  /// slot at \a depth, which must be on the path of the key, and pushing the
+  /// visited slots onto \a path unless it is nullptr.
+  [[nodiscard]] bool insert_from(detail::node_ptr* node, tree_depth_type depth,
+                                 art_key_type insert_key, value_type v,
+                                 insert_path* path);
+
+  /// Whether the tree maintains rightmost_path. The key_view keys are not
+  /// owned by the tree, so it could not keep its maximum key for them.
+  static constexpr bool caches_rightmost_path =
+      !std::is_same_v<Key, key_view>;
+
+  /// Return true iff \a k is greater than all the keys in the tree, which
+  /// must then be inserted by append().
+  [[nodiscard]] bool is_append(art_key_type k) const noexcept {
+    if constexpr (caches_rightmost_path) {
+      return root == nullptr ||
+             (!rightmost_path.empty() && k.cmp(rightmost_key) > 0);
+    } else {
+      return false;
+    }
+  }
+
+  /// Insert a value under a key greater than all the keys in the tree,
+  /// starting from the deepest rightmost_path slot on its path.
+  void append(art_key_type k, value_type v);
+
+  /// Drop the rightmost_path entries below \a slot, whose node has just been
+  /// replaced or changed.
+  void truncate_rightmost_path(const detail::node_ptr* slot) noexcept;
+
+  /// Refill rightmost_path and rightmost_key by descending to the rightmost
+  /// leaf.
+  void rebuild_rightmost_path() noexcept;
+
   void delete_root_subtree() noexcept;
 
 #ifdef UNODB_DETAIL_WITH_STATS
@@ -632,6 +742,18 @@ class db final {
 
   detail::node_ptr root{nullptr};
 
+  /// A prefix of the path to the rightmost leaf, root first, if
+  /// caches_rightmost_path and the tree is not empty. Appends resume from it
+  /// and extend it to the full path of the new rightmost leaf. The other
+  /// inserts and the removes truncate it below the slot they change.
+  insert_path rightmost_path{};
+
+  /// The key of the rightmost leaf, valid if rightmost_path is not empty.
+  art_key_type rightmost_key{Key{}};
+
+  /// The number of following children the scans prefetch.
+  std::uint8_t scan_prefetch_distance{detail::default_scan_prefetch_distance};
+
 #ifdef UNODB_DETAIL_WITH_STATS
 
   std::size_t current_memory_use{0};
@@ -921,6 +1043,35 @@ typename db<Key, Value>::get_result db<Key, Value>::get_internal(
   }
 }
 
+template <typename Key, typename Value>
+detail::node_ptr* db<Key, Value>::find_leaf_slot(art_key_type k) noexcept {
+  if (UNODB_DETAIL_UNLIKELY(root == nullptr)) return nullptr;
+
+  auto* node = &root;
+  auto remaining_key{k};
+
+  while (true) {
+    const auto node_type = node->type();
+    if (node_type == node_type::LEAF) {
+      const auto* const leaf{node->template ptr<leaf_type*>()};
+      return leaf->matches(k) ? node : nullptr;
+    }
+
+    auto* const inode{node->template ptr<inode_type*>()};
+    const auto& key_prefix{inode->get_key_prefix()};
+    const auto key_prefix_length{key_prefix.length()};
+    if (key_prefix.get_shared_length(remaining_key) < key_prefix_length)
+      return nullptr;
+    remaining_key.shift_right(key_prefix_length);
+    auto* const child{detail::unwrap_fake_critical_section(
+        inode->find_child(node_type, remaining_key[0]).second)};
+    if (child == nullptr) return nullptr;
+
+    node = child;
+    remaining_key.shift_right(1);
+  }
+}
+
 UNODB_DETAIL_DISABLE_MSVC_WARNING(26430)
 // MSVC C26815 false positive: make_db_leaf_ptr/inode::create return smart
 // pointers with LIFETIMEBOUND on db param, but release() transfers ownership
@@ -928,17 +1079,138 @@ UNODB_DETAIL_DISABLE_MSVC_WARNING(26430)
 UNODB_DETAIL_DISABLE_MSVC_WARNING(26815)
 template <typename Key, typename Value>
 bool db<Key, Value>::insert_internal(art_key_type insert_key, value_type v) {
-  if (UNODB_DETAIL_UNLIKELY(root == nullptr)) {
+  if constexpr (caches_rightmost_path) {
+    if (is_append(insert_key)) {
+      append(insert_key, v);
+      return true;
+    }
+    insert_path path;
+    const auto inserted =
+        insert_from(&root, tree_depth_type{}, insert_key, v, &path);
+    if (inserted) truncate_rightmost_path(path.top().node);
+    return inserted;
+  } else {
+    return insert_from(&root, tree_depth_type{}, insert_key, v, nullptr);
+  }
+}
+
+template <typename Key, typename Value>
+void db<Key, Value>::append(art_key_type k, value_type v) {
+  UNODB_DETAIL_ASSERT(is_append(k));
+
+  auto* node = &root;
+  tree_depth_type depth{};
+  if (!rightmost_path.empty()) {
+    // Same as in insert_batch, with the rightmost leaf as the previous key
+    const auto shared_length = k.shared_length(rightmost_key);
+    while (rightmost_path.top().depth > shared_length) rightmost_path.pop();
+    node = rightmost_path.top().node;
+    depth = rightmost_path.top().depth;
+    rightmost_path.pop();
+  }
+  const auto inserted = insert_from(node, depth, k, v, &rightmost_path);
+  UNODB_DETAIL_ASSERT(inserted);
+  (void)inserted;
+  rightmost_key = k;
+}
+
+template <typename Key, typename Value>
+void db<Key, Value>::truncate_rightmost_path(
+    const detail::node_ptr* slot) noexcept {
+  for (std::size_t i = 0; i < rightmost_path.size(); ++i) {
+    if (rightmost_path[i].node == slot) {
+      while (rightmost_path.size() > i + 1) rightmost_path.pop();
+      return;
+    }
+  }
+}
+
+template <typename Key, typename Value>
+void db<Key, Value>::rebuild_rightmost_path() noexcept {
+  rightmost_path.clear();
+  if (root == nullptr) return;
+
+  auto* node = &root;
+  tree_depth_type depth{};
+  while (true) {
+    rightmost_path.push({node, depth});
+    const auto node_type = node->type();
+    if (node_type == node_type::LEAF) {
+      if constexpr (caches_rightmost_path) {
+        const auto leaf_key{node->template ptr<leaf_type*>()->get_key_view()};
+        // The leaf keeps the binary comparable key
+        UNODB_DETAIL_ASSERT(leaf_key.size_bytes() == sizeof(Key));
+        std::memcpy(&rightmost_key.key, leaf_key.data(), sizeof(Key));
+      }
+      return;
+    }
+    auto* const inode{node->template ptr<inode_type*>()};
+    const auto last{inode->last(node_type)};
+    node = detail::unwrap_fake_critical_section(
+        inode->find_child(node_type, last.key_byte).second);
+    depth += inode->get_key_prefix().length();
+    ++depth;
+  }
+}
+
+template <typename Key, typename Value>
+std::size_t db<Key, Value>::insert_batch(
+    std::span<const std::pair<Key, value_type>> batch) {
+  insert_path path;
+  std::size_t inserted{0};
+
+  for (std::size_t i = 0; i < batch.size(); ++i) {
+    const art_key_type k{batch[i].first};
+    if constexpr (caches_rightmost_path) {
+      if (is_append(k)) {
+        // The append may change any slot of the kept path
+        append(k, batch[i].second);
+        path.clear();
+        ++inserted;
+        continue;
+      }
+    }
+    auto* node = &root;
+    tree_depth_type depth{};
+    if (!path.empty()) {
+      // The slots at depths up to the key bytes shared with the previous key
+      // are on the path of this key too, and the previous insert changed at
+      // most the deepest slot, leaving the ones above it in place.
+      const auto shared_length =
+          k.shared_length(art_key_type{batch[i - 1].first});
+      while (path.top().depth > shared_length) path.pop();
+      node = path.top().node;
+      depth = path.top().depth;
+      path.pop();
+    }
+    if (insert_from(node, depth, k, batch[i].second, &path)) {
+      ++inserted;
+      if constexpr (caches_rightmost_path)
+        truncate_rightmost_path(path.top().node);
+    }
+  }
+
+  return inserted;
+}
+
+template <typename Key, typename Value>
+bool db<Key, Value>::insert_from(detail::node_ptr* node, tree_depth_type depth,
+                                 art_key_type insert_key, value_type v,
+                                 insert_path* path) {
+  if (UNODB_DETAIL_UNLIKELY(*node == nullptr)) {
+    UNODB_DETAIL_ASSERT(node == &root);
     auto leaf = art_policy::make_db_leaf_ptr(insert_key, v, *this);
     root = detail::node_ptr{leaf.release(), node_type::LEAF};
+    if (path != nullptr) path->push({node, depth});
     return true;
   }
 
-  auto* node = &root;
-  tree_depth_type depth{};
   auto remaining_key{insert_key};
+  remaining_key.shift_right(depth);
 
   while (true) {
+    if (path != nullptr) path->push({node, depth});
+
     const auto node_type = node->type();
     if (node_type == node_type::LEAF) {
       auto* const leaf{node->template ptr<leaf_type*>()};
@@ -1010,6 +1282,7 @@ bool db<Key, Value>::remove_internal(art_key_type remove_key) {
     if (root_leaf->matches(remove_key)) {
       const auto r{art_policy::reclaim_leaf_on_scope_exit(root_leaf, *this)};
       root = nullptr;
+      rightmost_path.clear();
       return true;
     }
     return false;
@@ -1039,7 +1312,16 @@ bool db<Key, Value>::remove_internal(art_key_type remove_key) {
     if (UNODB_DETAIL_UNLIKELY(!remove_result)) return false;
 
     auto* const child_ptr{*remove_result};
-    if (child_ptr == nullptr) return true;
+    if (child_ptr == nullptr) {
+      if constexpr (caches_rightmost_path) {
+        if (remove_key.cmp(rightmost_key) == 0) {
+          rebuild_rightmost_path();
+        } else {
+          truncate_rightmost_path(node);
+        }
+      }
+      return true;
+    }
 
     node = child_ptr;
     ++depth;
@@ -1100,6 +1382,7 @@ typename db<Key, Value>::iterator& db<Key, Value>::iterator::next() {
     const auto& e2 = nxt.value();
     pop();
     push(e2);
+    prefetch_ahead(inode, node_type, e2.child_index, true, false);
     const auto child = inode->get_child(node_type, e2.child_index);  // descend
     return left_most_traversal(child);
   }
@@ -1130,6 +1413,7 @@ typename db<Key, Value>::iterator& db<Key, Value>::iterator::prior() {
     const auto& e2 = nxt.value();
     pop();
     push(e2);
+    prefetch_ahead(inode, node_type, e2.child_index, false, false);
     auto child = inode->get_child(node_type, e2.child_index);  // descend
     return right_most_traversal(child);
   }
@@ -1154,6 +1438,7 @@ db<Key, Value>::iterator::left_most_traversal(detail::node_ptr node) {
     const auto e =
         inode->begin(node_type);  // first child of current internal node
     push(e);                      // push the entry on the stack.
+    prefetch_ahead(inode, node_type, e.child_index, true, true);
     node = inode->get_child(node_type, e.child_index);  // get the child
   }
   UNODB_DETAIL_CANNOT_HAPPEN();
@@ -1177,6 +1462,7 @@ db<Key, Value>::iterator::right_most_traversal(detail::node_ptr node) {
     const auto e =
         inode->last(node_type);  // first child of current internal node
     push(e);                     // push the entry on the stack.
+    prefetch_ahead(inode, node_type, e.child_index, false, true);
     node = inode->get_child(node_type, e.child_index);  // get the child
   }
   UNODB_DETAIL_CANNOT_HAPPEN();
@@ -1484,6 +1770,7 @@ void db<Key, Value>::clear() noexcept {
   delete_root_subtree();
 
   root = nullptr;
+  rightmost_path.clear();
 #ifdef UNODB_DETAIL_WITH_STATS
   current_memory_use = 0;
   node_counts[as_i<node_type::I4>] = 0;
@@ -34,6 +34,12 @@ class db;
 template <typename Key, typename Value>
 class olc_db;
 
+template <typename Key, typename Value>
+class frozen_db;
+
+template <typename Key, typename Value>
+class rowex_db;
+
 /// Type alias determining the maximum size in bytes of a key that may be stored
 /// in the index.
 using key_size_type = std::uint32_t;
@@ -58,6 +64,8 @@ using value_view = std::span<const std::byte>;
 ///
 /// \sa unodb::db::scan()
 /// \sa unodb::olc_db::scan()
+/// \sa unodb::frozen_db::scan()
+/// \sa unodb::rowex_db::scan()
 template <typename Iterator>
 class visitor {
  protected:
@@ -113,6 +121,8 @@ class visitor {
  private:
   friend class olc_db<key_type, value_type>;
   friend class db<key_type, value_type>;
+  friend class frozen_db<key_type, value_type>;
+  friend class rowex_db<key_type, value_type>;
 };  // class visitor
 
 namespace detail {
@@ -142,6 +142,24 @@ struct [[nodiscard]] basic_art_key final {
     }
   }
 
+  /// Return the number of the leading bytes shared with \a key2.
+  [[nodiscard, gnu::pure]] constexpr std::size_t shared_length(
+      basic_art_key<KeyType> key2) const noexcept {
+    if constexpr (std::is_same_v<KeyType, key_view>) {
+      const auto mismatch = std::ranges::mismatch(key, key2.key).in1;
+      return static_cast<std::size_t>(mismatch - key.begin());
+    } else {
+      // The binary comparable key is stored in the memory order, so on a
+      // little-endian machine its first byte is the least significant one.
+      const auto diff = static_cast<std::make_unsigned_t<KeyType>>(
+          static_cast<std::make_unsigned_t<KeyType>>(key) ^
+          static_cast<std::make_unsigned_t<KeyType>>(key2.key));
+      return diff == 0
+                 ? sizeof(KeyType)
+                 : static_cast<std::size_t>(std::countr_zero(diff)) >> 3U;
+    }
+  }
+
   /// Compare with a \a key2 view.
   ///
   /// \return -1, 0, or 1 if this key is LT, EQ, or GT the other key
@@ -338,6 +356,11 @@ class basic_db_leaf_deleter {
   /// Delete a leaf node \a to_delete through the database.
   void operator()(leaf_type* to_delete) const noexcept;
 
+  /// Allocate the memory of a leaf of \a size bytes for a database.
+  [[nodiscard]] static void* allocate(Db&, std::size_t size) {
+    return allocate_aligned(size, alignment_for_new<leaf_type>());
+  }
+
   /// Get reference to owning database.
   ///
   /// \return Reference to database
@@ -382,6 +405,11 @@ class basic_db_inode_deleter {
   /// Delete an internal node \a inode_ptr through the database.
   void operator()(INode* inode_ptr) noexcept;
 
+  /// Allocate the memory of an internal node for a database.
+  [[nodiscard]] static void* allocate(Db&) {
+    return allocate_aligned(sizeof(INode), alignment_for_new<INode>());
+  }
+
   /// Get reference to owning database.
   ///
   /// \return Reference to database
@@ -630,6 +658,118 @@ class key_buffer {
   size_t off{0};
 };  // class key_buffer
 
+/// Default number of following children which the scans prefetch.
+inline constexpr std::uint8_t default_scan_prefetch_distance = 4;
+
+/// Inline capacity of the iterator stack for unodb::key_view keys, which have
+/// no depth bound. Deeper paths spill to the heap.
+inline constexpr std::size_t key_view_iterator_stack_capacity = 32;
+
+/// Maximum depth of an iterator path for keys of type \a Key, including the
+/// leaf, or the inline capacity if the depth is unbounded. Every inode consumes
+/// at least one key byte, so fixed-width keys bound the depth by their width.
+template <typename Key>
+inline constexpr std::size_t iterator_stack_capacity =
+    std::is_same_v<Key, key_view> ? key_view_iterator_stack_capacity
+                                  : sizeof(Key) + 1;
+
+/// Stack of tree path entries for the iterators.
+///
+/// Entries are kept in an inline array so that the iterators do not allocate.
+/// If \a Growable is false, then the caller guarantees that the stack never
+/// holds more than \a InlineCapacity entries, and push is \c noexcept.
+/// Otherwise, the stack moves to a heap buffer when the inline array is full.
+template <typename T, std::size_t InlineCapacity, bool Growable>
+class iterator_stack final {
+  static_assert(std::is_trivially_copyable_v<T>);
+  static_assert(std::is_trivially_destructible_v<T>);
+
+ public:
+  UNODB_DETAIL_DISABLE_MSVC_WARNING(26495)
+  iterator_stack() noexcept = default;
+  UNODB_DETAIL_RESTORE_MSVC_WARNINGS()
+
+  ~iterator_stack() {
+    if constexpr (Growable) {
+      if (buf != inline_data()) free_aligned(buf);
+    }
+  }
+
+  /// Get the number of entries.
+  [[nodiscard]] std::size_t size() const noexcept { return count; }
+
+  /// Return true iff there are no entries.
+  [[nodiscard]] bool empty() const noexcept { return count == 0; }
+
+  /// Push \a e onto the stack.
+  void push(const T& e) noexcept(!Growable) {
+    if constexpr (Growable) {
+      if (UNODB_DETAIL_UNLIKELY(count == cap)) grow();
+    } else {
+      UNODB_DETAIL_ASSERT(count < InlineCapacity);
+    }
+    std::memcpy(static_cast<void*>(buf + count), &e, sizeof(T));
+    ++count;
+  }
+
+  /// Pop the top entry.
+  void pop() noexcept {
+    UNODB_DETAIL_ASSERT(!empty());
+    --count;
+  }
+
+  /// Pop all the entries, keeping any heap buffer for reuse.
+  void clear() noexcept { count = 0; }
+
+  /// Return the top entry.
+  [[nodiscard]] const T& top() const noexcept {
+    UNODB_DETAIL_ASSERT(!empty());
+    return buf[count - 1];
+  }
+
+  /// Return the entry at \a i, counting from the bottom of the stack.
+  [[nodiscard]] const T& operator[](std::size_t i) const noexcept {
+    UNODB_DETAIL_ASSERT(i < count);
+    return buf[i];
+  }
+
+  /// Non-copyable.
+  iterator_stack(const iterator_stack&) = delete;
+  /// Non-movable.
+  iterator_stack(iterator_stack&&) = delete;
+  /// Non-copy-assignable.
+  iterator_stack& operator=(const iterator_stack&) = delete;
+  /// Non-move-assignable.
+  iterator_stack& operator=(iterator_stack&&) = delete;
+
+ private:
+  [[nodiscard]] T* inline_data() noexcept {
+    return reinterpret_cast<T*>(&storage[0]);
+  }
+
+  /// Double the capacity, moving the entries to a new heap buffer.
+  void grow() {
+    const auto new_cap = cap * 2;
+    auto* const new_buf =
+        static_cast<T*>(allocate_aligned(new_cap * sizeof(T), alignof(T)));
+    std::memcpy(static_cast<void*>(new_buf), buf, count * sizeof(T));
+    if (buf != inline_data()) free_aligned(buf);
+    buf = new_buf;
+    cap = new_cap;
+  }
+
+  /// Inline entry storage avoiding heap allocation.
+  alignas(T) std::byte storage[InlineCapacity * sizeof(T)];
+
+  /// Entry buffer. Initially points to storage, may be reallocated for
+  /// growable stacks.
+  T* buf{inline_data()};
+  /// Current capacity in entries.
+  std::size_t cap{InlineCapacity};
+  /// Number of entries.
+  std::size_t count{0};
+};  // class iterator_stack
+
 }  // namespace unodb::detail
 
 #endif  // UNODB_DETAIL_ART_INTERNAL_HPP
@@ -254,7 +254,7 @@ template <typename Key, typename Value, template <typename, typename> class Db>
       static_cast<typename leaf_type::value_size_type>(v.size_bytes()));
 
   auto* const leaf_mem = static_cast<std::byte*>(
-      allocate_aligned(size, alignment_for_new<leaf_type>()));
+      db_type::art_policy::leaf_reclamator::allocate(db, size));
 
 #ifdef UNODB_DETAIL_WITH_STATS
   db.increment_leaf_count(size);
@@ -338,6 +338,10 @@ struct basic_art_policy final {
 
   using db_type = Db<Key, Value>;
 
+  /// The policy reclaiming the leaves, which also allocates them, so that it
+  /// may reuse the reclaimed memory.
+  using leaf_reclamator = LeafReclamator<db_type>;
+
  private:
   template <class INode>
   using db_inode_deleter = basic_db_inode_deleter<INode, db_type>;
@@ -384,9 +388,9 @@ struct basic_art_policy final {
   [[nodiscard]] static auto make_db_inode_unique_ptr(db_type& db_instance
                                                      UNODB_DETAIL_LIFETIMEBOUND,
                                                      Args&&... args) {
-    // memory allocation
+    // memory allocation, by the reclamation policy, which may reuse memory
     auto* const inode_mem = static_cast<std::byte*>(
-        allocate_aligned(sizeof(INode), alignment_for_new<INode>()));
+        INodeReclamator<Key, Value, INode>::allocate(db_instance));
 
 #ifdef UNODB_DETAIL_WITH_STATS
     db_instance.template increment_inode_count<INode>();
@@ -794,6 +798,10 @@ class fake_inode final {
   fake_inode() = delete;
 };
 
+/// A tag selecting the inode constructors that make an exact copy of another
+/// node of the same type, for the copy-on-write updates of unodb::rowex_db.
+struct node_clone_tag final {};
+
 /// A template class extending the common header and defining some methods
 /// common to all internal node types.  The common header type is specific to
 /// the thread-safety policy.  In particular, for the OLC implementation, the
@@ -1064,6 +1072,62 @@ class basic_inode_impl : public ArtPolicy::header_type {
     // LCOV_EXCL_STOP
   }
 
+  /// Prefetch the children that an iterator will visit after the child at \a
+  /// child_index, so that their cache misses overlap with the visit of the
+  /// preceding children.
+  ///
+  /// \param type The type of this internal node.
+  ///
+  /// \param child_index The current position within that internal node.
+  ///
+  /// \param fwd The iteration direction.
+  ///
+  /// \param skip The number of following positions not to prefetch, because
+  /// earlier calls already have.
+  ///
+  /// \param count The maximum number of positions to prefetch after the
+  /// skipped ones.
+  //
+  // Positions are children[] slots for N4 and N16, and key bytes for N48 and
+  // N256, whose empty slots are skipped without being counted. This keeps the
+  // cost at one load per prefetch, which matters as the iterators call this
+  // for every visited leaf. For OLC this is called without checking the node
+  // version, as it only reads and the prefetched addresses are never
+  // dereferenced.
+  constexpr void prefetch_children(node_type type, std::uint8_t child_index,
+                                   bool fwd, std::uint8_t skip,
+                                   std::uint8_t count) noexcept {
+    UNODB_DETAIL_ASSERT(type != node_type::LEAF);
+    unsigned limit;
+    switch (type) {
+      case node_type::I4:
+        limit = std::min(static_cast<unsigned>(get_children_count()),
+                         static_cast<unsigned>(inode4_type::capacity));
+        break;
+      case node_type::I16:
+        limit = std::min(static_cast<unsigned>(get_children_count()),
+                         static_cast<unsigned>(inode16_type::capacity));
+        break;
+      case node_type::I48:
+      case node_type::I256:
+        limit = 256;
+        break;
+        // LCOV_EXCL_START
+      case node_type::LEAF:
+        UNODB_DETAIL_CANNOT_HAPPEN();
+        // LCOV_EXCL_STOP
+    }
+    const auto first = static_cast<unsigned>(skip) + 1;
+    const auto last = static_cast<unsigned>(skip) + count;
+    for (auto i = first; i <= last; ++i) {
+      if (fwd ? child_index + i >= limit : i > child_index) return;
+      const auto pos =
+          static_cast<std::uint8_t>(fwd ? child_index + i : child_index - i);
+      const auto child = get_child(type, pos);
+      if (child != nullptr) prefetch(child.template ptr<const void*>());
+    }
+  }
+
   /// Return an iter_result for the greatest key byte which orders
   /// lexicographically less than or equal to (LTE) the given \a key_byte.
   //
@@ -1254,6 +1318,9 @@ class [[nodiscard]] basic_inode : public basic_inode_impl<ArtPolicy> {
     // node optimistically in the case of OLC.
     UNODB_DETAIL_ASSERT(is_full_for_add());
   }
+
+  constexpr basic_inode(const Derived& source_node, node_clone_tag) noexcept
+      : parent{source_node.children_count.load(), source_node} {}
 };
 
 template <class ArtPolicy>
@@ -1324,6 +1391,16 @@ class basic_inode_4 : public basic_inode_4_parent<ArtPolicy> {
     init(db_instance, source_node, child_to_delete);
   }
 
+  /// Copy \a source_node, which must not change while being copied.
+  constexpr basic_inode_4(db_type&, const inode4_type& source_node,
+                          node_clone_tag tag) noexcept
+      : parent_class{source_node, tag} {
+    keys.integer = source_node.keys.integer.load();
+    const auto children_count_ = this->children_count.load();
+    for (std::uint8_t i = 0; i < children_count_; ++i)
+      children[i] = source_node.children[i].load();
+  }
+
   constexpr void init(node_ptr source_node, unsigned shared_prefix_len,
                       tree_depth_type depth, db_leaf_unique_ptr&& child1) {
     auto* const source_inode{source_node.template ptr<inode_type*>()};
@@ -1769,6 +1846,17 @@ class basic_inode_16 : public basic_inode_16_parent<ArtPolicy> {
     init(db_instance, source_node, std::move(child), depth);
   }
 
+  /// Copy \a source_node, which must not change while being copied.
+  constexpr basic_inode_16(db_type&, const inode16_type& source_node,
+                           node_clone_tag tag) noexcept
+      : parent_class{source_node, tag} {
+    const auto children_count_ = this->children_count.load();
+    for (std::uint8_t i = 0; i < children_count_; ++i) {
+      keys.byte_array[i] = source_node.keys.byte_array[i].load();
+      children[i] = source_node.children[i].load();
+    }
+  }
+
   constexpr basic_inode_16(db_type& db_instance, inode48_type& source_node,
                            std::uint8_t child_to_delete) noexcept
       : parent_class{source_node} {
@@ -2161,6 +2249,17 @@ class basic_inode_48 : public basic_inode_48_parent<ArtPolicy> {
     init(db_instance, source_node, child_to_delete);
   }
 
+  /// Copy \a source_node, which must not change while being copied.
+  constexpr basic_inode_48(db_type&, const inode48_type& source_node,
+                           node_clone_tag tag) noexcept
+      : parent_class{source_node, tag} {
+    for (unsigned i = 0; i < 256; ++i)
+      child_indexes[i] = source_node.child_indexes[i].load();
+    for (unsigned i = 0; i < basic_inode_48::capacity; ++i) {
+      children.pointer_array[i] = source_node.children.pointer_array[i].load();
+    }
+  }
+
   constexpr void init(db_type& db_instance,
                       inode16_type& __restrict source_node,
                       db_leaf_unique_ptr child,
@@ -2664,6 +2763,7 @@ template <class ArtPolicy>
 class basic_inode_256 : public basic_inode_256_parent<ArtPolicy> {
   using parent_class = basic_inode_256_parent<ArtPolicy>;
 
+  using typename parent_class::inode256_type;
   using typename parent_class::inode48_type;
   using typename parent_class::leaf_type;
   using typename parent_class::node_ptr;
@@ -2687,6 +2787,14 @@ class basic_inode_256 : public basic_inode_256_parent<ArtPolicy> {
     init(db_instance, source_node, std::move(child), depth);
   }
 
+  /// Copy \a source_node, which must not change while being copied.
+  constexpr basic_inode_256(db_type&, const inode256_type& source_node,
+                            node_clone_tag tag) noexcept
+      : parent_class{source_node, tag} {
+    for (unsigned i = 0; i < basic_inode_256::capacity; ++i)
+      children[i] = source_node.children[i].load();
+  }
+
   constexpr void init(db_type& db_instance,
                       inode48_type& __restrict source_node,
                       db_leaf_unique_ptr child,
@@ -7,9 +7,14 @@
 // IWYU pragma: no_include <array>
 // IWYU pragma: no_include <string>
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <numeric>
+#include <span>
 #include <tuple>
+#include <utility>
+#include <vector>
 
 #include <benchmark/benchmark.h>
 
@@ -54,6 +59,30 @@ void dense_insert(benchmark::State& state) {
 #endif  // UNODB_DETAIL_WITH_STATS
 }
 
+// The same keys as dense_insert, inserted by a single insert_batch call
+template <class Db>
+void dense_insert_batch(benchmark::State& state) {
+  const auto key_count = static_cast<std::uint64_t>(state.range(0));
+  std::vector<std::pair<std::uint64_t, unodb::value_view>> batch;
+  batch.reserve(key_count);
+  for (std::uint64_t i = 0; i < key_count; ++i)
+    batch.emplace_back(i, unodb::value_view{unodb::benchmark::value100});
+
+  for (const auto _ : state) {
+    state.PauseTiming();
+    Db test_db;
+    benchmark::ClobberMemory();
+    state.ResumeTiming();
+
+    unodb::benchmark::insert_batch(test_db, batch);
+
+    state.PauseTiming();
+    unodb::benchmark::destroy_tree(test_db, state);
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
 template <class Db>
 void sparse_insert_dups_allowed(benchmark::State& state) {
   unodb::benchmark::batched_prng random_keys;
@@ -160,6 +189,36 @@ void dense_iter_full_fwd_scan(benchmark::State& state) {
 #endif  // UNODB_DETAIL_WITH_STATS
 }
 
+// dense_iter_full_fwd_scan with the scan prefetch distance set to the second
+// argument. The keys are inserted in random order, so that the leaves adjacent
+// in the key order are not adjacent in memory, as in a tree built over time.
+template <class Db>
+void dense_iter_full_fwd_scan_prefetch(benchmark::State& state) {
+  Db test_db;
+  const auto key_limit = static_cast<std::uint64_t>(state.range(0));
+  test_db.set_scan_prefetch_distance(static_cast<std::uint8_t>(state.range(1)));
+
+  std::vector<std::uint64_t> keys(key_limit);
+  std::iota(keys.begin(), keys.end(), 0);
+  std::ranges::shuffle(keys, unodb::benchmark::get_prng());
+  for (const auto k : keys)
+    unodb::benchmark::insert_key(test_db, k,
+                                 unodb::value_view{unodb::benchmark::value100});
+
+  for (const auto _ : state) {
+    std::uint64_t sum = 0;
+    auto fn = [&sum](const unodb::visitor<typename Db::iterator>& v) noexcept {
+      sum += decode(v.get_key());
+      std::ignore = v.get_value();
+      return false;
+    };
+    test_db.scan(fn);
+    ::benchmark::DoNotOptimize(sum);  // ensure that the keys were retrieved.
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
 // inserts keys and a constant value and scans the entries in a
 // key-range in the tree using db::scan(), reading both the keys and
 // the values (this variant has more overhead than a full scan since
@@ -198,6 +257,37 @@ void dense_iter_keyrange_fwd_scan(benchmark::State& state) {
 #endif  // UNODB_DETAIL_WITH_STATS
 }
 
+// dense_iter_keyrange_fwd_scan using olc_db::scan_batched(), which delivers
+// the leaves of each parent in one batch.
+template <class Db>
+void dense_batched_keyrange_fwd_scan(benchmark::State& state) {
+  Db test_db;
+  const auto key_limit = static_cast<std::uint64_t>(state.range(0));
+
+  for (std::uint64_t i = 0; i < key_limit; ++i)
+    unodb::benchmark::insert_key(test_db, i,
+                                 unodb::value_view{unodb::benchmark::value100});
+
+  for (const auto _ : state) {
+    for (auto i = 0; i < full_scan_multiplier; ++i) {
+      std::uint64_t sum = 0;
+      auto fn = [&sum](std::span<const typename Db::scan_batch_entry>
+                           batch) noexcept {
+        for (const auto& e : batch) {
+          sum += decode(e.key);
+          ::benchmark::DoNotOptimize(e.value);
+        }
+        return false;
+      };
+      test_db.scan_batched(0, key_limit, fn);
+      ::benchmark::DoNotOptimize(sum);  // ensure that the keys were retrieved.
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0) *
+                          full_scan_multiplier);
+}
+
 void dense_tree_sparse_deletes_args(benchmark::internal::Benchmark* b) {
   for (auto i = 1000; i <= 5000000; i *= 8) {
     b->Args({i, 800});
@@ -365,6 +455,16 @@ BENCHMARK_TEMPLATE(dense_insert, unodb::benchmark::olc_db)
     ->Range(100, 30000000)
     ->Unit(benchmark::kMicrosecond);
 
+BENCHMARK_TEMPLATE(dense_insert_batch, unodb::benchmark::db)
+    ->Range(100, 30000000)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(dense_insert_batch, unodb::benchmark::mutex_db)
+    ->Range(100, 30000000)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(dense_insert_batch, unodb::benchmark::olc_db)
+    ->Range(100, 30000000)
+    ->Unit(benchmark::kMicrosecond);
+
 BENCHMARK_TEMPLATE(sparse_insert_dups_allowed, unodb::benchmark::db)
     ->Range(100, 10000000)
     ->Unit(benchmark::kMicrosecond);
@@ -395,6 +495,13 @@ BENCHMARK_TEMPLATE(dense_iter_full_fwd_scan, unodb::benchmark::olc_db)
     ->Range(128, 1 << 28)
     ->Unit(benchmark::kMicrosecond);
 
+BENCHMARK_TEMPLATE(dense_iter_full_fwd_scan_prefetch, unodb::benchmark::db)
+    ->ArgsProduct({{1 << 16, 1 << 24}, {0, 4, 16, 64}})
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(dense_iter_full_fwd_scan_prefetch, unodb::benchmark::olc_db)
+    ->ArgsProduct({{1 << 16, 1 << 24}, {0, 4, 16, 64}})
+    ->Unit(benchmark::kMicrosecond);
+
 BENCHMARK_TEMPLATE(dense_iter_keyrange_fwd_scan, unodb::benchmark::db)
     ->Range(128, 1 << 28)
     ->Unit(benchmark::kMicrosecond);
@@ -404,6 +511,9 @@ BENCHMARK_TEMPLATE(dense_iter_keyrange_fwd_scan, unodb::benchmark::mutex_db)
 BENCHMARK_TEMPLATE(dense_iter_keyrange_fwd_scan, unodb::benchmark::olc_db)
     ->Range(128, 1 << 28)
     ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(dense_batched_keyrange_fwd_scan, unodb::benchmark::olc_db)
+    ->Range(128, 1 << 28)
+    ->Unit(benchmark::kMicrosecond);
 
 BENCHMARK_TEMPLATE(dense_tree_sparse_deletes, unodb::benchmark::db)
     ->ArgNames({"", "deletes"})
@@ -33,6 +33,14 @@ constexpr void concurrency_ranges32(::benchmark::internal::Benchmark* b) {
   concurrency_ranges(b, 32);
 }
 
+// The third argument is the percentage of the mixed workload operations that
+// also write
+constexpr void mixed_concurrency_ranges16(::benchmark::internal::Benchmark* b) {
+  for (const auto write_percent : {1, 10, 50})
+    for (auto i = 1; i <= 16; i *= 2)
+      b->Args({i, small_concurrent_tree_size, write_percent});
+}
+
 template <typename T>
 [[nodiscard]] ::benchmark::Counter to_counter(T value) {
   return ::benchmark::Counter{static_cast<double>(value)};
@@ -129,6 +137,41 @@ class [[nodiscard]] concurrent_benchmark {
     test_db.reset(nullptr);
   }
 
+  // Gets the even keys, and for every write_percent out of 100 of them also
+  // inserts and removes the next odd key, so that the writers keep changing the
+  // nodes the readers go through without growing the tree.
+  void parallel_mixed(::benchmark::State& state) {
+    const auto num_of_threads = static_cast<std::size_t>(state.range(0));
+    const auto tree_size = static_cast<std::uint64_t>(state.range(1));
+    const auto write_percent = static_cast<std::uint64_t>(state.range(2));
+
+    test_db = std::make_unique<Db>();
+
+    for (std::uint64_t i = 0; i < tree_size; ++i)
+      insert_key(*test_db, 2 * i, values[i % values.size()]);
+
+    const auto mixed_worker = [write_percent](Db& instance, std::uint64_t start,
+                                              std::uint64_t length) {
+      for (std::uint64_t i = start; i < start + length; ++i) {
+        get_existing_key(instance, 2 * i);
+        if (i % 100 < write_percent) {
+          insert_key(instance, 2 * i + 1, values[i % values.size()]);
+          delete_key(instance, 2 * i + 1);
+        }
+      }
+    };
+
+    for (const auto _ : state) {
+      state.PauseTiming();
+      do_parallel_test(*test_db, num_of_threads, tree_size, mixed_worker,
+                       state);
+      state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(state.range(1));
+    test_db.reset(nullptr);
+  }
+
   concurrent_benchmark(const concurrent_benchmark<Db, Thread>&) = delete;
   concurrent_benchmark(concurrent_benchmark<Db, Thread>&&) = delete;
   concurrent_benchmark<Db, Thread>& operator=(
@@ -0,0 +1,207 @@
+// Copyright 2025 UnoDB contributors
+
+// Should be the first include
+#include "global.hpp"  // IWYU pragma: keep
+
+// IWYU pragma: no_include <string>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "micro_benchmark_concurrency.hpp"
+#include "micro_benchmark_utils.hpp"
+#include "qsbr.hpp"
+#include "redo_log.hpp"
+
+namespace {
+
+// The insert benchmarks compare the in-memory tree against the durable tree
+// with asynchronous and synchronous commits, so that the logging overhead, and
+// how well group commit amortizes the syncs, can be read off directly.
+enum class commit_mode : std::uint8_t { in_memory, async, sync };
+
+constexpr std::array<const char*, 3> commit_mode_names{"in-memory", "async",
+                                                       "sync"};
+
+// Small enough for the synchronous commit runs to finish on a spinning disk
+constexpr auto durable_tree_size = 10000;
+
+[[nodiscard]] std::filesystem::path benchmark_dir() {
+  return std::filesystem::temp_directory_path() /
+         "unodb_micro_benchmark_durable";
+}
+
+template <class Db>
+void durable_insert_worker(unodb::durable_db<Db>& instance,
+                           std::uint64_t start, std::uint64_t length) {
+  for (std::uint64_t i = start; i < start + length; ++i) {
+    const auto value =
+        unodb::benchmark::values[i % unodb::benchmark::values.size()];
+    if constexpr (std::is_same_v<Db, unodb::benchmark::olc_db>) {
+      const unodb::quiescent_state_on_scope_exit qsbr_after_insert{};
+      unodb::benchmark::detail::do_insert_key_ignore_dups(instance, i, value);
+    } else {
+      unodb::benchmark::detail::do_insert_key_ignore_dups(instance, i, value);
+    }
+  }
+}
+
+template <class Db>
+void in_memory_insert_worker(Db& instance, std::uint64_t start,
+                             std::uint64_t length) {
+  for (std::uint64_t i = start; i < start + length; ++i) {
+    unodb::benchmark::insert_key(
+        instance, i,
+        unodb::benchmark::values[i % unodb::benchmark::values.size()]);
+  }
+}
+
+void set_log_counters(benchmark::State& state, std::uint64_t syncs,
+                      std::uint64_t records) {
+  state.counters["syncs"] = benchmark::Counter(
+      static_cast<double>(syncs), benchmark::Counter::kAvgIterations);
+  state.counters["records per sync"] = benchmark::Counter(
+      syncs == 0 ? 0.0
+                 : static_cast<double>(records) / static_cast<double>(syncs));
+}
+
+// Inserts state.range(0) keys from a single thread into an unodb::db, either
+// directly or through an unodb::durable_db in the commit mode state.range(1).
+void insert(benchmark::State& state) {
+  const auto tree_size = static_cast<std::uint64_t>(state.range(0));
+  const auto mode = static_cast<commit_mode>(state.range(1));
+  const auto dir = benchmark_dir();
+  std::uint64_t syncs{0};
+  std::uint64_t records{0};
+
+  for (const auto _ : state) {
+    state.PauseTiming();
+    std::filesystem::remove_all(dir);
+    if (mode == commit_mode::in_memory) {
+      unodb::benchmark::db test_db;
+      state.ResumeTiming();
+
+      in_memory_insert_worker(test_db, 0, tree_size);
+
+      state.PauseTiming();
+    } else {
+      std::optional<unodb::durable_db<unodb::benchmark::db>> test_db;
+      test_db.emplace(dir, mode == commit_mode::sync);
+      state.ResumeTiming();
+
+      durable_insert_worker(*test_db, 0, tree_size);
+      // Include the final write out in the asynchronous mode time
+      test_db->sync();
+
+      state.PauseTiming();
+      syncs += test_db->get_log().get_sync_count();
+      records += test_db->get_log().get_record_count();
+      test_db.reset();
+    }
+    state.ResumeTiming();
+  }
+  std::filesystem::remove_all(dir);
+
+  if (mode != commit_mode::in_memory) set_log_counters(state, syncs, records);
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetLabel(commit_mode_names[static_cast<std::size_t>(mode)]);
+}
+
+// Inserts state.range(1) keys in disjoint ranges from state.range(0) threads
+// into an unodb::olc_db, either directly or through an unodb::durable_db in
+// the commit mode state.range(2). The concurrently committing threads share
+// the syncs in the synchronous mode.
+void parallel_insert(benchmark::State& state) {
+  const auto num_of_threads = static_cast<std::size_t>(state.range(0));
+  const auto tree_size = static_cast<std::uint64_t>(state.range(1));
+  const auto mode = static_cast<commit_mode>(state.range(2));
+  const std::uint64_t length{tree_size / num_of_threads};
+  const auto dir = benchmark_dir();
+  std::uint64_t syncs{0};
+  std::uint64_t records{0};
+
+  const auto run = [num_of_threads, length](auto worker, auto& instance) {
+    std::vector<unodb::qsbr_thread> threads{num_of_threads - 1};
+    for (std::size_t i = 1; i < num_of_threads; ++i) {
+      threads[i - 1] =
+          unodb::qsbr_thread{worker, std::ref(instance), i * length, length};
+    }
+    worker(instance, 0, length);
+    for (auto& thread : threads) thread.join();
+  };
+
+  for (const auto _ : state) {
+    state.PauseTiming();
+    std::filesystem::remove_all(dir);
+    unodb::qsbr::instance().assert_idle();
+    if (mode == commit_mode::in_memory) {
+      auto test_db = std::make_unique<unodb::benchmark::olc_db>();
+      state.ResumeTiming();
+
+      run(in_memory_insert_worker<unodb::benchmark::olc_db>, *test_db);
+      unodb::this_thread().quiescent();
+
+      state.PauseTiming();
+      test_db.reset();
+      unodb::this_thread().quiescent();
+    } else {
+      auto test_db =
+          std::make_unique<unodb::durable_db<unodb::benchmark::olc_db>>(
+              dir, mode == commit_mode::sync);
+      state.ResumeTiming();
+
+      run(durable_insert_worker<unodb::benchmark::olc_db>, *test_db);
+      test_db->sync();
+      unodb::this_thread().quiescent();
+
+      state.PauseTiming();
+      syncs += test_db->get_log().get_sync_count();
+      records += test_db->get_log().get_record_count();
+      test_db.reset();
+      unodb::this_thread().quiescent();
+    }
+    unodb::qsbr::instance().assert_idle();
+    state.ResumeTiming();
+  }
+  std::filesystem::remove_all(dir);
+
+  if (mode != commit_mode::in_memory) set_log_counters(state, syncs, records);
+  state.SetItemsProcessed(state.iterations() * state.range(1));
+  state.SetLabel(commit_mode_names[static_cast<std::size_t>(mode)]);
+}
+
+void insert_ranges(::benchmark::internal::Benchmark* b) {
+  for (const auto mode :
+       {commit_mode::in_memory, commit_mode::async, commit_mode::sync})
+    b->Args({durable_tree_size, static_cast<std::int64_t>(mode)});
+}
+
+void parallel_insert_ranges(::benchmark::internal::Benchmark* b) {
+  for (const auto mode :
+       {commit_mode::in_memory, commit_mode::async, commit_mode::sync}) {
+    for (auto i = 1; i <= 16; i *= 2)
+      b->Args({i, durable_tree_size, static_cast<std::int64_t>(mode)});
+  }
+}
+
+}  // namespace
+
+UNODB_START_BENCHMARKS()
+
+BENCHMARK(insert)->Apply(insert_ranges)->Unit(benchmark::kMillisecond);
+BENCHMARK(parallel_insert)
+    ->Apply(parallel_insert_ranges)
+    ->Unit(benchmark::kMillisecond)
+    ->MeasureProcessCPUTime()
+    ->UseRealTime();
+
+UNODB_BENCHMARK_MAIN();
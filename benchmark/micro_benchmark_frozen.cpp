@@ -0,0 +1,153 @@
+// Copyright 2025 UnoDB contributors
+
+// Should be the first include
+#include "global.hpp"  // IWYU pragma: keep
+
+// IWYU pragma: no_include <__vector/vector.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "art_common.hpp"
+#include "frozen_art.hpp"
+#include "micro_benchmark_node_utils.hpp"
+#include "micro_benchmark_utils.hpp"
+
+namespace {
+
+using frozen_db = unodb::frozen_db<std::uint64_t, unodb::value_view>;
+
+// Run fn on either the source tree itself or on its frozen copy, depending on
+// Db.
+template <class Db, typename FN>
+void with_tree(unodb::benchmark::db& source, FN fn) {
+  if constexpr (std::is_same_v<Db, frozen_db>) {
+    const frozen_db frozen{source};
+    fn(frozen);
+  } else {
+    fn(source);
+  }
+}
+
+template <class Db>
+void set_memory_counters(benchmark::State& state, const Db& test_db,
+                         std::size_t key_count) {
+#ifndef UNODB_DETAIL_WITH_STATS
+  if constexpr (std::is_same_v<Db, frozen_db>)
+#endif  // UNODB_DETAIL_WITH_STATS
+  {
+    const auto tree_size = test_db.get_current_memory_use();
+    unodb::benchmark::set_size_counter(state, "size", tree_size);
+    state.counters["B/key"] =
+        static_cast<double>(tree_size) / static_cast<double>(key_count);
+  }
+}
+
+// Inserts a sequence of keys and then gets them in random order.
+template <class Db>
+void dense_random_get(benchmark::State& state) {
+  const auto key_count = static_cast<std::uint64_t>(state.range(0));
+  unodb::benchmark::db source;
+  for (std::uint64_t i = 0; i < key_count; ++i)
+    unodb::benchmark::insert_key(source, i,
+                                 unodb::value_view{unodb::benchmark::value10});
+
+  with_tree<Db>(source, [&state, key_count](auto& test_db) {
+    unodb::benchmark::batched_prng random_keys{key_count - 1};
+    for (const auto _ : state)
+      for (std::uint64_t i = 0; i < key_count; ++i)
+        unodb::benchmark::get_existing_key(test_db, random_keys.get(state));
+
+    state.SetItemsProcessed(state.iterations() *
+                            static_cast<std::int64_t>(key_count));
+    set_memory_counters(state, test_db, key_count);
+  });
+}
+
+// Inserts random keys and then gets them in random order.
+template <class Db>
+void sparse_random_get(benchmark::State& state) {
+  const auto key_count = static_cast<std::uint64_t>(state.range(0));
+  unodb::benchmark::db source;
+  std::uniform_int_distribution<std::uint64_t> random_keys{
+      0, std::numeric_limits<std::uint64_t>::max()};
+  std::vector<std::uint64_t> keys;
+  keys.reserve(key_count);
+  while (keys.size() < key_count) {
+    const auto k = random_keys(unodb::benchmark::get_prng());
+    if (source.insert(k, unodb::value_view{unodb::benchmark::value10}))
+      keys.push_back(k);
+  }
+
+  with_tree<Db>(source, [&state, &keys](auto& test_db) {
+    unodb::benchmark::batched_prng random_positions{keys.size() - 1};
+    for (const auto _ : state)
+      for (std::size_t i = 0; i < keys.size(); ++i)
+        unodb::benchmark::get_existing_key(
+            test_db, keys[random_positions.get(state)]);
+
+    state.SetItemsProcessed(state.iterations() *
+                            static_cast<std::int64_t>(keys.size()));
+    set_memory_counters(state, test_db, keys.size());
+  });
+}
+
+// Inserts a sequence of keys and then scans all of them.
+template <class Db>
+void dense_full_scan(benchmark::State& state) {
+  const auto key_count = static_cast<std::uint64_t>(state.range(0));
+  unodb::benchmark::db source;
+  for (std::uint64_t i = 0; i < key_count; ++i)
+    unodb::benchmark::insert_key(source, i,
+                                 unodb::value_view{unodb::benchmark::value10});
+
+  with_tree<Db>(source, [&state, key_count](auto& test_db) {
+    using iterator = typename std::remove_cvref_t<decltype(test_db)>::iterator;
+    for (const auto _ : state) {
+      std::size_t sum = 0;
+      test_db.scan(
+          [&sum](const unodb::visitor<iterator>& v) noexcept {
+            sum += v.get_key().size() + v.get_value().size();
+            return false;
+          });
+      ::benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() *
+                            static_cast<std::int64_t>(key_count));
+    set_memory_counters(state, test_db, key_count);
+  });
+}
+
+}  // namespace
+
+UNODB_START_BENCHMARKS()
+
+BENCHMARK_TEMPLATE(dense_random_get, unodb::benchmark::db)
+    ->Range(100, 20000000)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(dense_random_get, frozen_db)
+    ->Range(100, 20000000)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_TEMPLATE(sparse_random_get, unodb::benchmark::db)
+    ->Range(100, 10000000)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(sparse_random_get, frozen_db)
+    ->Range(100, 10000000)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_TEMPLATE(dense_full_scan, unodb::benchmark::db)
+    ->Range(100, 20000000)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(dense_full_scan, frozen_db)
+    ->Range(100, 20000000)
+    ->Unit(benchmark::kMicrosecond);
+
+UNODB_BENCHMARK_MAIN();
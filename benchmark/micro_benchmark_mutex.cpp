@@ -3,7 +3,12 @@
 // Should be the first include
 #include "global.hpp"  // IWYU pragma: keep
 
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <thread>
+#include <vector>
 
 #include <benchmark/benchmark.h>
 
@@ -30,6 +35,77 @@ void parallel_delete_disjoint_ranges(benchmark::State& state) {
   benchmark_fixture.parallel_delete_disjoint_ranges(state);
 }
 
+// The keys of the benchmarks above share their leading bytes, which would put
+// them all into a single unodb::sharded_mutex_db shard. The benchmarks below
+// move the lowest key byte to the front instead, spreading the keys over all
+// the shards, and compare it against unodb::mutex_db on the same keys.
+[[nodiscard]] constexpr std::uint64_t spread_key(std::uint64_t i) noexcept {
+  return std::rotr(i, 8);
+}
+
+template <class Db, typename Worker>
+void run_spread_key_workers(Db& instance, std::size_t num_of_threads,
+                            std::uint64_t tree_size, Worker worker) {
+  std::vector<std::thread> threads;
+  threads.reserve(num_of_threads - 1);
+  const std::uint64_t length{tree_size / num_of_threads};
+  for (std::size_t i = 1; i < num_of_threads; ++i)
+    threads.emplace_back(worker, std::ref(instance), i * length, length);
+  worker(instance, 0, length);
+  for (auto& t : threads) t.join();
+}
+
+template <class Db>
+void spread_key_parallel_get(benchmark::State& state) {
+  const auto num_of_threads = static_cast<std::size_t>(state.range(0));
+  const auto tree_size = static_cast<std::uint64_t>(state.range(1));
+
+  Db instance;
+  for (std::uint64_t i = 0; i < tree_size; ++i) {
+    unodb::benchmark::insert_key(
+        instance, spread_key(i),
+        unodb::benchmark::values[i % unodb::benchmark::values.size()]);
+  }
+
+  for (const auto _ : state) {
+    run_spread_key_workers(
+        instance, num_of_threads, tree_size,
+        [](const Db& db, std::uint64_t start, std::uint64_t length) {
+          for (std::uint64_t i = start; i < start + length; ++i)
+            unodb::benchmark::get_existing_key(db, spread_key(i));
+        });
+  }
+
+  state.SetItemsProcessed(state.range(1));
+}
+
+template <class Db>
+void spread_key_parallel_insert(benchmark::State& state) {
+  const auto num_of_threads = static_cast<std::size_t>(state.range(0));
+  const auto tree_size = static_cast<std::uint64_t>(state.range(1));
+
+  for (const auto _ : state) {
+    state.PauseTiming();
+    Db instance;
+    state.ResumeTiming();
+
+    run_spread_key_workers(
+        instance, num_of_threads, tree_size,
+        [](Db& db, std::uint64_t start, std::uint64_t length) {
+          for (std::uint64_t i = start; i < start + length; ++i) {
+            unodb::benchmark::insert_key(
+                db, spread_key(i),
+                unodb::benchmark::values[i % unodb::benchmark::values.size()]);
+          }
+        });
+
+    state.PauseTiming();
+    unodb::benchmark::destroy_tree(instance, state);
+  }
+
+  state.SetItemsProcessed(state.range(1));
+}
+
 }  // namespace
 
 UNODB_START_BENCHMARKS()
@@ -50,4 +126,26 @@ BENCHMARK(parallel_delete_disjoint_ranges)
     ->MeasureProcessCPUTime()
     ->UseRealTime();
 
+BENCHMARK_TEMPLATE(spread_key_parallel_get, unodb::benchmark::mutex_db)
+    ->Apply(unodb::benchmark::concurrency_ranges16)
+    ->Unit(benchmark::kMillisecond)
+    ->MeasureProcessCPUTime()
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(spread_key_parallel_get, unodb::benchmark::sharded_mutex_db)
+    ->Apply(unodb::benchmark::concurrency_ranges16)
+    ->Unit(benchmark::kMillisecond)
+    ->MeasureProcessCPUTime()
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(spread_key_parallel_insert, unodb::benchmark::mutex_db)
+    ->Apply(unodb::benchmark::concurrency_ranges32)
+    ->Unit(benchmark::kMillisecond)
+    ->MeasureProcessCPUTime()
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(spread_key_parallel_insert,
+                   unodb::benchmark::sharded_mutex_db)
+    ->Apply(unodb::benchmark::concurrency_ranges32)
+    ->Unit(benchmark::kMillisecond)
+    ->MeasureProcessCPUTime()
+    ->UseRealTime();
+
 UNODB_BENCHMARK_MAIN();
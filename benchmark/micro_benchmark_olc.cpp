@@ -5,10 +5,22 @@
 
 // IWYU pragma: no_include <string>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
 #include <benchmark/benchmark.h>
 
+#include "hazard_ptr.hpp"
 #include "micro_benchmark_concurrency.hpp"
 #include "micro_benchmark_utils.hpp"
+#include "optimistic_lock.hpp"
 #include "qsbr.hpp"
 
 namespace {
@@ -85,6 +97,299 @@ void parallel_delete_disjoint_ranges(benchmark::State& state) {
 #endif  // UNODB_DETAIL_WITH_STATS
 }
 
+// Inserts with each spin backoff policy, from one thread up to twice as many
+// as the hardware threads.
+void parallel_insert_spin_backoff(benchmark::State& state) {
+  unodb::set_spin_backoff(static_cast<unodb::spin_backoff>(state.range(2)));
+  benchmark_fixture.parallel_insert_disjoint_ranges(state);
+  unodb::set_spin_backoff(unodb::spin_backoff::none);
+
+  constexpr std::array<const char*, 4> policy_names{
+      "none", "exponential", "exponential_yield", "exponential_park"};
+  state.SetLabel(policy_names[static_cast<std::size_t>(state.range(2))]);
+}
+
+// Deletes disjoint key ranges in parallel as parallel_delete_disjoint_ranges
+// does, timing each delete, with the background QSBR reclaimer off or on. The
+// reported tail delete latencies include the inline frees at the epoch changes
+// in the former case.
+void parallel_delete_latency(benchmark::State& state) {
+  const auto num_of_threads = static_cast<std::size_t>(state.range(0));
+  const auto tree_size = static_cast<std::uint64_t>(state.range(1));
+  const auto background_reclaimer = state.range(2) != 0;
+  const std::uint64_t length{tree_size / num_of_threads};
+
+  if (background_reclaimer)
+    unodb::qsbr::instance().start_background_reclaimer();
+  std::vector<std::chrono::nanoseconds> latencies(length * num_of_threads);
+
+  for (const auto _ : state) {
+    state.PauseTiming();
+    auto test_db = std::make_unique<unodb::benchmark::olc_db>();
+    for (std::uint64_t i = 0; i < tree_size; ++i) {
+      unodb::benchmark::insert_key(
+          *test_db, i,
+          unodb::benchmark::values[i % unodb::benchmark::values.size()]);
+    }
+    const auto worker = [&test_db, &latencies](std::uint64_t start,
+                                               std::uint64_t count) {
+      for (std::uint64_t i = start; i < start + count; ++i) {
+        const auto begin = std::chrono::steady_clock::now();
+        unodb::benchmark::delete_key(*test_db, i);
+        latencies[i] = std::chrono::steady_clock::now() - begin;
+      }
+    };
+    std::vector<unodb::qsbr_thread> threads{num_of_threads - 1};
+    state.ResumeTiming();
+
+    for (std::size_t i = 1; i < num_of_threads; ++i)
+      threads[i - 1] = unodb::qsbr_thread{worker, i * length, length};
+    worker(0, length);
+    for (auto& thread : threads) thread.join();
+    unodb::this_thread().quiescent();
+
+    state.PauseTiming();
+    unodb::benchmark::destroy_tree(*test_db, state);
+  }
+
+  if (background_reclaimer)
+    unodb::qsbr::instance().stop_background_reclaimer();
+  unodb::this_thread().quiescent();
+  unodb::qsbr::instance().assert_idle();
+
+  std::ranges::sort(latencies);
+  const auto percentile = [&latencies](std::size_t per_mille) {
+    return unodb::benchmark::to_counter(
+        latencies[latencies.size() * per_mille / 1000].count());
+  };
+  state.counters["p99 delete ns"] = percentile(990);
+  state.counters["p99.9 delete ns"] = percentile(999);
+  state.counters["max delete ns"] =
+      unodb::benchmark::to_counter(latencies.back().count());
+  state.SetItemsProcessed(state.range(1));
+  state.SetLabel(background_reclaimer ? "background reclaimer" : "inline");
+}
+
+// Inserts and then deletes disjoint key ranges in parallel, either passing
+// through a quiescent state after each operation, or wrapping each operation
+// in an unodb::ebr_guard.
+void parallel_insert_delete_reclamation(benchmark::State& state) {
+  const auto num_of_threads = static_cast<std::size_t>(state.range(0));
+  const auto tree_size = static_cast<std::uint64_t>(state.range(1));
+  const auto guards = state.range(2) != 0;
+  const std::uint64_t length{tree_size / num_of_threads};
+
+  for (const auto _ : state) {
+    state.PauseTiming();
+    auto test_db = std::make_unique<unodb::benchmark::olc_db>();
+    const auto worker = [&test_db, guards](std::uint64_t start,
+                                           std::uint64_t count) {
+      for (std::uint64_t i = start; i < start + count; ++i) {
+        const auto value =
+            unodb::benchmark::values[i % unodb::benchmark::values.size()];
+        if (guards) {
+          const unodb::ebr_guard guard;
+          unodb::benchmark::detail::do_insert_key(*test_db, i, value);
+        } else {
+          unodb::benchmark::insert_key(*test_db, i, value);
+        }
+      }
+      for (std::uint64_t i = start; i < start + count; ++i) {
+        if (guards) {
+          const unodb::ebr_guard guard;
+          unodb::benchmark::detail::do_delete_key(*test_db, i);
+        } else {
+          unodb::benchmark::delete_key(*test_db, i);
+        }
+      }
+    };
+    std::vector<unodb::qsbr_thread> threads{num_of_threads - 1};
+    state.ResumeTiming();
+
+    for (std::size_t i = 1; i < num_of_threads; ++i)
+      threads[i - 1] = unodb::qsbr_thread{worker, i * length, length};
+    worker(0, length);
+    for (auto& thread : threads) thread.join();
+
+    state.PauseTiming();
+    if (guards) {
+      // Leave the guard mode
+      unodb::this_thread().qsbr_pause();
+      unodb::this_thread().qsbr_resume();
+    }
+    unodb::this_thread().quiescent();
+    unodb::this_thread().quiescent();
+    unodb::qsbr::instance().assert_idle();
+    unodb::benchmark::destroy_tree(*test_db, state);
+  }
+
+  state.SetItemsProcessed(state.iterations() * 2 * state.range(1));
+  state.SetLabel(guards ? "EBR guards" : "quiescent states");
+}
+
+// Gets and then deletes disjoint key ranges in parallel, reclaiming the deleted
+// nodes either with QSBR, passing through a quiescent state after each
+// operation, or with hazard pointers.
+void parallel_get_delete_hazard_pointers(benchmark::State& state) {
+  const auto num_of_threads = static_cast<std::size_t>(state.range(0));
+  const auto tree_size = static_cast<std::uint64_t>(state.range(1));
+  const auto hazard_pointers = state.range(2) != 0;
+  const std::uint64_t length{tree_size / num_of_threads};
+
+  for (const auto _ : state) {
+    state.PauseTiming();
+    auto test_db =
+        hazard_pointers ? std::make_unique<unodb::benchmark::olc_db>(
+                              unodb::hazard_pointer_reclamation)
+                        : std::make_unique<unodb::benchmark::olc_db>();
+    for (std::uint64_t i = 0; i < tree_size; ++i) {
+      unodb::benchmark::insert_key(
+          *test_db, i,
+          unodb::benchmark::values[i % unodb::benchmark::values.size()]);
+    }
+    const auto worker = [&test_db, hazard_pointers](std::uint64_t start,
+                                                    std::uint64_t count) {
+      for (std::uint64_t i = start; i < start + count; ++i) {
+        if (hazard_pointers) {
+          unodb::benchmark::detail::do_get_existing_key(*test_db, i);
+        } else {
+          unodb::benchmark::get_existing_key(*test_db, i);
+        }
+      }
+      for (std::uint64_t i = start; i < start + count; ++i) {
+        if (hazard_pointers) {
+          unodb::benchmark::detail::do_delete_key(*test_db, i);
+        } else {
+          unodb::benchmark::delete_key(*test_db, i);
+        }
+      }
+    };
+    std::vector<unodb::qsbr_thread> threads{num_of_threads - 1};
+    state.ResumeTiming();
+
+    for (std::size_t i = 1; i < num_of_threads; ++i)
+      threads[i - 1] = unodb::qsbr_thread{worker, i * length, length};
+    worker(0, length);
+    for (auto& thread : threads) thread.join();
+
+    state.PauseTiming();
+    unodb::this_thread().quiescent();
+    unodb::this_thread().quiescent();
+    unodb::qsbr::instance().assert_idle();
+    unodb::benchmark::destroy_tree(*test_db, state);
+  }
+
+  state.SetItemsProcessed(state.iterations() * 2 * state.range(1));
+  state.SetLabel(hazard_pointers ? "hazard pointers" : "QSBR");
+}
+
+// Runs a task per key, deleting and reinserting it, on a pool of worker threads
+// taking the tasks from a shared queue through unodb::qsbr_worker, with a
+// quiescent state once every state.range(2) tasks. The workers park once the
+// queue is empty. Reports the maximum deallocation requests pending in a worker
+// as the reclamation lag.
+void parallel_pool_tasks(benchmark::State& state) {
+  const auto num_of_threads = static_cast<std::size_t>(state.range(0));
+  const auto tree_size = static_cast<std::uint64_t>(state.range(1));
+  const auto tasks_per_quiescent_state =
+      static_cast<std::uint32_t>(state.range(2));
+  std::size_t max_pending_requests{0};
+
+  for (const auto _ : state) {
+    state.PauseTiming();
+    auto test_db = std::make_unique<unodb::benchmark::olc_db>();
+    for (std::uint64_t i = 0; i < tree_size; ++i) {
+      unodb::benchmark::insert_key(
+          *test_db, i,
+          unodb::benchmark::values[i % unodb::benchmark::values.size()]);
+    }
+    std::atomic<std::uint64_t> next_task{0};
+    std::vector<std::size_t> pending_requests(num_of_threads);
+    const auto worker = [&test_db, &next_task, &pending_requests, tree_size,
+                         tasks_per_quiescent_state](std::size_t worker_i) {
+      unodb::qsbr_worker pool_worker{tasks_per_quiescent_state};
+      const auto& qsbr_thread = unodb::this_thread();
+      // Kept locally, so that the workers do not share a cache line while
+      // timed
+      std::size_t worker_pending_requests{0};
+      while (true) {
+        const auto k = next_task.fetch_add(1, std::memory_order_relaxed);
+        if (k >= tree_size) break;
+        pool_worker.run([&test_db, k] {
+          unodb::benchmark::detail::do_delete_key(*test_db, k);
+          unodb::benchmark::detail::do_insert_key(
+              *test_db, k,
+              unodb::benchmark::values[k % unodb::benchmark::values.size()]);
+        });
+        worker_pending_requests =
+            std::max(worker_pending_requests,
+                     qsbr_thread.get_pending_request_count());
+      }
+      pool_worker.park();
+      pending_requests[worker_i] = worker_pending_requests;
+    };
+    std::vector<unodb::qsbr_thread> threads{num_of_threads - 1};
+    state.ResumeTiming();
+
+    for (std::size_t i = 1; i < num_of_threads; ++i)
+      threads[i - 1] = unodb::qsbr_thread{worker, i};
+    worker(0);
+    for (auto& thread : threads) thread.join();
+
+    state.PauseTiming();
+    unodb::this_thread().qsbr_resume();
+    unodb::this_thread().quiescent();
+    unodb::this_thread().quiescent();
+    unodb::qsbr::instance().assert_idle();
+    max_pending_requests =
+        std::max(max_pending_requests, std::ranges::max(pending_requests));
+    unodb::benchmark::destroy_tree(*test_db, state);
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(1));
+  state.counters["max pending requests"] =
+      unodb::benchmark::to_counter(max_pending_requests);
+}
+
+void pool_task_ranges(::benchmark::internal::Benchmark* b) {
+  for (const auto tasks_per_quiescent_state : {1, 16, 256}) {
+    for (auto i = 1; i <= 8; i *= 2) {
+      b->Args({i, unodb::benchmark::small_concurrent_tree_size,
+               tasks_per_quiescent_state});
+    }
+  }
+}
+
+void reclamation_ranges(::benchmark::internal::Benchmark* b) {
+  for (const auto guards : {0, 1}) {
+    for (auto i = 1; i <= 8; i *= 2)
+      b->Args({i, unodb::benchmark::small_concurrent_tree_size, guards});
+  }
+}
+
+void delete_latency_ranges(::benchmark::internal::Benchmark* b) {
+  for (const auto background_reclaimer : {0, 1}) {
+    for (auto i = 1; i <= 8; i *= 2) {
+      b->Args({i, unodb::benchmark::large_concurrent_tree_size,
+               background_reclaimer});
+    }
+  }
+}
+
+void oversubscribed_backoff_ranges(::benchmark::internal::Benchmark* b) {
+  const auto max_threads =
+      2 * static_cast<int>(std::max(std::thread::hardware_concurrency(), 1U));
+  for (const auto policy :
+       {unodb::spin_backoff::none, unodb::spin_backoff::exponential,
+        unodb::spin_backoff::exponential_yield,
+        unodb::spin_backoff::exponential_park}) {
+    for (auto i = 1; i <= max_threads; i *= 2) {
+      b->Args({i, unodb::benchmark::small_concurrent_tree_size,
+               static_cast<std::int64_t>(policy)});
+    }
+  }
+}
+
 }  // namespace
 
 UNODB_START_BENCHMARKS()
@@ -104,5 +409,30 @@ BENCHMARK(parallel_delete_disjoint_ranges)
     ->Unit(benchmark::kMillisecond)
     ->MeasureProcessCPUTime()
     ->UseRealTime();
+BENCHMARK(parallel_delete_latency)
+    ->Apply(delete_latency_ranges)
+    ->Unit(benchmark::kMillisecond)
+    ->MeasureProcessCPUTime()
+    ->UseRealTime();
+BENCHMARK(parallel_insert_delete_reclamation)
+    ->Apply(reclamation_ranges)
+    ->Unit(benchmark::kMillisecond)
+    ->MeasureProcessCPUTime()
+    ->UseRealTime();
+BENCHMARK(parallel_get_delete_hazard_pointers)
+    ->Apply(reclamation_ranges)
+    ->Unit(benchmark::kMillisecond)
+    ->MeasureProcessCPUTime()
+    ->UseRealTime();
+BENCHMARK(parallel_pool_tasks)
+    ->Apply(pool_task_ranges)
+    ->Unit(benchmark::kMillisecond)
+    ->MeasureProcessCPUTime()
+    ->UseRealTime();
+BENCHMARK(parallel_insert_spin_backoff)
+    ->Apply(oversubscribed_backoff_ranges)
+    ->Unit(benchmark::kMillisecond)
+    ->MeasureProcessCPUTime()
+    ->UseRealTime();
 
 UNODB_BENCHMARK_MAIN();
@@ -0,0 +1,119 @@
+// Copyright 2025 UnoDB contributors
+
+// Should be the first include
+#include "global.hpp"  // IWYU pragma: keep
+
+// IWYU pragma: no_include <string>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "heap.hpp"
+#include "micro_benchmark_utils.hpp"
+#include "qsbr.hpp"
+
+namespace {
+
+// Quiescent states per thread per benchmark iteration
+constexpr std::uint64_t quiescent_states_per_thread = 1000000;
+
+// Every thread defers a deallocation of this size once per this many quiescent
+// states in the deallocation benchmark
+constexpr std::uint64_t quiescent_states_per_deallocation = 8;
+constexpr std::size_t deallocation_size = 64;
+
+void quiescent_worker(bool deallocate) {
+  auto& qsbr_thread = unodb::this_thread();
+  for (std::uint64_t i = 0; i < quiescent_states_per_thread; ++i) {
+    if (deallocate && i % quiescent_states_per_deallocation == 0) {
+      qsbr_thread.on_next_epoch_deallocate(
+          unodb::detail::allocate_aligned(deallocation_size)
+#ifdef UNODB_DETAIL_WITH_STATS
+              ,
+          deallocation_size
+#endif
+#ifndef NDEBUG
+          ,
+          {}
+#endif
+      );
+    }
+    qsbr_thread.quiescent();
+  }
+}
+
+// Run the workers on state.range(0) threads, the calling thread included, all
+// hammering the default QSBR domain state.
+void do_parallel_quiescent(benchmark::State& state, bool deallocate) {
+  const auto num_of_threads = static_cast<std::size_t>(state.range(0));
+#ifdef UNODB_DETAIL_WITH_STATS
+  const auto start_epoch_changes =
+      unodb::qsbr::instance().get_epoch_change_count();
+#endif  // UNODB_DETAIL_WITH_STATS
+
+  for (const auto _ : state) {
+    state.PauseTiming();
+    unodb::qsbr::instance().assert_idle();
+#ifdef UNODB_DETAIL_WITH_STATS
+    unodb::qsbr::instance().reset_stats();
+#endif  // UNODB_DETAIL_WITH_STATS
+    std::vector<unodb::qsbr_thread> threads{num_of_threads - 1};
+    state.ResumeTiming();
+
+    for (auto& t : threads)
+      t = unodb::qsbr_thread{quiescent_worker, deallocate};
+    quiescent_worker(deallocate);
+    for (auto& t : threads) t.join();
+    // Let the requests orphaned by the quit threads expire
+    unodb::this_thread().quiescent();
+    unodb::this_thread().quiescent();
+
+    state.PauseTiming();
+    unodb::qsbr::instance().assert_idle();
+    state.ResumeTiming();
+  }
+
+  const auto quiescent_states_per_iteration =
+      num_of_threads * quiescent_states_per_thread;
+  state.SetItemsProcessed(
+      state.iterations() *
+      static_cast<std::int64_t>(quiescent_states_per_iteration));
+#ifdef UNODB_DETAIL_WITH_STATS
+  state.counters["epoch changes"] = benchmark::Counter{
+      static_cast<double>(unodb::qsbr::instance().get_epoch_change_count() -
+                          start_epoch_changes),
+      benchmark::Counter::kAvgIterations};
+#endif  // UNODB_DETAIL_WITH_STATS
+}
+
+void parallel_quiescent(benchmark::State& state) {
+  do_parallel_quiescent(state, false);
+}
+
+void parallel_quiescent_with_deallocations(benchmark::State& state) {
+  do_parallel_quiescent(state, true);
+}
+
+void thread_ranges(::benchmark::internal::Benchmark* b) {
+  for (auto i = 1; i <= 128; i *= 2) b->Arg(i);
+}
+
+}  // namespace
+
+UNODB_START_BENCHMARKS()
+
+BENCHMARK(parallel_quiescent)
+    ->Apply(thread_ranges)
+    ->Unit(benchmark::kMillisecond)
+    ->MeasureProcessCPUTime()
+    ->UseRealTime();
+BENCHMARK(parallel_quiescent_with_deallocations)
+    ->Apply(thread_ranges)
+    ->Unit(benchmark::kMillisecond)
+    ->MeasureProcessCPUTime()
+    ->UseRealTime();
+
+UNODB_BENCHMARK_MAIN();
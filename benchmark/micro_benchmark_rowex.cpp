@@ -0,0 +1,89 @@
+// Copyright 2025 UnoDB contributors
+
+// Should be the first include
+#include "global.hpp"  // IWYU pragma: keep
+
+// IWYU pragma: no_include <string>
+
+#include <benchmark/benchmark.h>
+
+#include "micro_benchmark_concurrency.hpp"
+#include "micro_benchmark_utils.hpp"
+#include "qsbr.hpp"
+
+// Compares unodb::rowex_db against unodb::olc_db on the read-only and on the
+// mixed read-write workloads.
+
+namespace {
+
+template <class Db>
+class [[nodiscard]] concurrent_benchmark_qsbr final
+    : public unodb::benchmark::concurrent_benchmark<Db, unodb::qsbr_thread> {
+ private:
+  void setup()
+#ifndef UNODB_DETAIL_WITH_STATS
+      noexcept
+#endif
+      override {
+    unodb::qsbr::instance().assert_idle();
+#ifdef UNODB_DETAIL_WITH_STATS
+    unodb::qsbr::instance().reset_stats();
+#endif  // UNODB_DETAIL_WITH_STATS
+  }
+
+  void end_workload_in_main_thread()
+#ifndef UNODB_DETAIL_WITH_STATS
+      noexcept
+#endif
+      override {
+    unodb::this_thread().quiescent();
+  }
+
+  void teardown() noexcept override { unodb::qsbr::instance().assert_idle(); }
+};
+
+concurrent_benchmark_qsbr<unodb::benchmark::olc_db> olc_fixture;
+concurrent_benchmark_qsbr<unodb::benchmark::rowex_db> rowex_fixture;
+
+void olc_parallel_get(benchmark::State& state) {
+  olc_fixture.parallel_get(state);
+}
+
+void rowex_parallel_get(benchmark::State& state) {
+  rowex_fixture.parallel_get(state);
+}
+
+void olc_parallel_mixed(benchmark::State& state) {
+  olc_fixture.parallel_mixed(state);
+}
+
+void rowex_parallel_mixed(benchmark::State& state) {
+  rowex_fixture.parallel_mixed(state);
+}
+
+}  // namespace
+
+UNODB_START_BENCHMARKS()
+
+BENCHMARK(olc_parallel_get)
+    ->Apply(unodb::benchmark::concurrency_ranges16)
+    ->Unit(benchmark::kMillisecond)
+    ->MeasureProcessCPUTime()
+    ->UseRealTime();
+BENCHMARK(rowex_parallel_get)
+    ->Apply(unodb::benchmark::concurrency_ranges16)
+    ->Unit(benchmark::kMillisecond)
+    ->MeasureProcessCPUTime()
+    ->UseRealTime();
+BENCHMARK(olc_parallel_mixed)
+    ->Apply(unodb::benchmark::mixed_concurrency_ranges16)
+    ->Unit(benchmark::kMillisecond)
+    ->MeasureProcessCPUTime()
+    ->UseRealTime();
+BENCHMARK(rowex_parallel_mixed)
+    ->Apply(unodb::benchmark::mixed_concurrency_ranges16)
+    ->Unit(benchmark::kMillisecond)
+    ->MeasureProcessCPUTime()
+    ->UseRealTime();
+
+UNODB_BENCHMARK_MAIN();
@@ -10,6 +10,8 @@
 #include "art.hpp"        // IWYU pragma: keep
 #include "mutex_art.hpp"  // IWYU pragma: keep
 #include "olc_art.hpp"    // IWYU pragma: keep
+#include "rowex_art.hpp"  // IWYU pragma: keep
+#include "sharded_mutex_art.hpp"  // IWYU pragma: keep
 
 namespace unodb::benchmark {
 
@@ -29,5 +31,11 @@ template void destroy_tree<unodb::mutex_db<std::uint64_t, unodb::value_view>>(
     unodb::mutex_db<std::uint64_t, unodb::value_view>&, ::benchmark::State&);
 template void destroy_tree<unodb::olc_db<std::uint64_t, unodb::value_view>>(
     unodb::olc_db<std::uint64_t, unodb::value_view>&, ::benchmark::State&);
+template void destroy_tree<unodb::rowex_db<std::uint64_t, unodb::value_view>>(
+    unodb::rowex_db<std::uint64_t, unodb::value_view>&, ::benchmark::State&);
+template void
+destroy_tree<unodb::sharded_mutex_db<std::uint64_t, unodb::value_view>>(
+    unodb::sharded_mutex_db<std::uint64_t, unodb::value_view>&,
+    ::benchmark::State&);
 
 }  // namespace unodb::benchmark
@@ -15,6 +15,8 @@
 #include <iostream>
 #endif
 #include <random>
+#include <span>
+#include <utility>
 
 #include <benchmark/benchmark.h>
 
@@ -26,6 +28,8 @@
 #include "mutex_art.hpp"
 #include "olc_art.hpp"
 #include "qsbr.hpp"
+#include "rowex_art.hpp"
+#include "sharded_mutex_art.hpp"
 
 // TODO(laurynas): std::uint64_t-specific
 
@@ -45,6 +49,9 @@ namespace unodb::benchmark {
 using db = unodb::db<std::uint64_t, unodb::value_view>;
 using mutex_db = unodb ::mutex_db<std::uint64_t, unodb::value_view>;
 using olc_db = unodb::olc_db<std::uint64_t, unodb::value_view>;
+using rowex_db = unodb::rowex_db<std::uint64_t, unodb::value_view>;
+using sharded_mutex_db =
+    unodb::sharded_mutex_db<std::uint64_t, unodb::value_view>;
 
 // Values
 
@@ -117,6 +124,14 @@ inline void insert_key_ignore_dups(
   detail::do_insert_key_ignore_dups(instance, k, v);
 }
 
+template <>
+inline void insert_key_ignore_dups(
+    unodb::rowex_db<std::uint64_t, unodb::value_view>& instance, std::uint64_t k,
+    unodb::value_view v) {
+  const quiescent_state_on_scope_exit qsbr_after_get{};
+  detail::do_insert_key_ignore_dups(instance, k, v);
+}
+
 template <class Db>
 void insert_key(Db& instance, std::uint64_t k, unodb::value_view v) {
   detail::do_insert_key(instance, k, v);
@@ -130,6 +145,39 @@ inline void insert_key(
   detail::do_insert_key(instance, k, v);
 }
 
+template <>
+inline void insert_key(
+    unodb::rowex_db<std::uint64_t, unodb::value_view>& instance, std::uint64_t k,
+    unodb::value_view v) {
+  const quiescent_state_on_scope_exit qsbr_after_get{};
+  detail::do_insert_key(instance, k, v);
+}
+
+template <class Db>
+void insert_batch(
+    Db& instance,
+    std::span<const std::pair<std::uint64_t, unodb::value_view>> batch) {
+  // Args to ::benchmark::DoNoOptimize cannot be const, thus silence MSVC static
+  // analyzer on that
+  UNODB_DETAIL_DISABLE_MSVC_WARNING(26496)
+  auto result = instance.insert_batch(batch);
+  UNODB_DETAIL_ASSERT(result == batch.size());
+  ::benchmark::DoNotOptimize(result);
+  UNODB_DETAIL_RESTORE_MSVC_WARNINGS()
+}
+
+template <>
+inline void insert_batch(
+    unodb::olc_db<std::uint64_t, unodb::value_view>& instance,
+    std::span<const std::pair<std::uint64_t, unodb::value_view>> batch) {
+  const quiescent_state_on_scope_exit qsbr_after_batch{};
+  UNODB_DETAIL_DISABLE_MSVC_WARNING(26496)
+  auto result = instance.insert_batch(batch);
+  UNODB_DETAIL_ASSERT(result == batch.size());
+  ::benchmark::DoNotOptimize(result);
+  UNODB_DETAIL_RESTORE_MSVC_WARNINGS()
+}
+
 // Deletes
 
 namespace detail {
@@ -178,6 +226,14 @@ inline void delete_key_if_exists(
   detail::do_delete_key_if_exists(instance, k);
 }
 
+template <>
+inline void delete_key_if_exists(
+    unodb::rowex_db<std::uint64_t, unodb::value_view>& instance,
+    std::uint64_t k) {
+  const quiescent_state_on_scope_exit qsbr_after_get{};
+  detail::do_delete_key_if_exists(instance, k);
+}
+
 template <class Db>
 void delete_key(Db& instance, std::uint64_t k) {
   detail::do_delete_key(instance, k);
@@ -191,6 +247,14 @@ inline void delete_key(
   detail::do_delete_key(instance, k);
 }
 
+template <>
+inline void delete_key(
+    unodb::rowex_db<std::uint64_t, unodb::value_view>& instance,
+    std::uint64_t k) {
+  const quiescent_state_on_scope_exit qsbr_after_get{};
+  detail::do_delete_key(instance, k);
+}
+
 // Gets
 
 namespace detail {
@@ -240,6 +304,14 @@ inline void get_key(
   detail::do_get_key(instance, k);
 }
 
+template <>
+inline void get_key(
+    const unodb::rowex_db<std::uint64_t, unodb::value_view>& instance,
+    std::uint64_t k) {
+  const quiescent_state_on_scope_exit qsbr_after_get{};
+  detail::do_get_key(instance, k);
+}
+
 template <class Db>
 void get_existing_key(const Db& instance, std::uint64_t k) {
   detail::do_get_existing_key(instance, k);
@@ -253,6 +325,14 @@ inline void get_existing_key(
   detail::do_get_existing_key(instance, k);
 }
 
+template <>
+inline void get_existing_key(
+    const unodb::rowex_db<std::uint64_t, unodb::value_view>& instance,
+    std::uint64_t k) {
+  const quiescent_state_on_scope_exit qsbr_after_get{};
+  detail::do_get_existing_key(instance, k);
+}
+
 // Teardown
 
 template <class Db>
@@ -266,6 +346,13 @@ destroy_tree<unodb::mutex_db<std::uint64_t, unodb::value_view>>(
 extern template void
 destroy_tree<unodb::olc_db<std::uint64_t, unodb::value_view>>(
     unodb::olc_db<std::uint64_t, unodb::value_view>&, ::benchmark::State&);
+extern template void
+destroy_tree<unodb::rowex_db<std::uint64_t, unodb::value_view>>(
+    unodb::rowex_db<std::uint64_t, unodb::value_view>&, ::benchmark::State&);
+extern template void
+destroy_tree<unodb::sharded_mutex_db<std::uint64_t, unodb::value_view>>(
+    unodb::sharded_mutex_db<std::uint64_t, unodb::value_view>&,
+    ::benchmark::State&);
 
 }  // namespace unodb::benchmark
 
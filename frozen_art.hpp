@@ -0,0 +1,642 @@
+// Copyright 2025 UnoDB contributors
+#ifndef UNODB_DETAIL_FROZEN_ART_HPP
+#define UNODB_DETAIL_FROZEN_ART_HPP
+
+/// \file
+/// Read-only compact Adaptive Radix Tree built from an existing tree.
+
+// Should be the first include
+#include "global.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "art_common.hpp"
+#include "art_internal.hpp"
+#include "assert.hpp"
+
+namespace unodb {
+
+namespace detail {
+
+/// A frozen ART internal node. Internal nodes are created in breadth-first
+/// order, with all the children of a node occupying a contiguous range of the
+/// child reference array, so that a node only needs to store the position of
+/// its first child and the number of children.
+struct [[nodiscard]] frozen_inode final {
+  /// Position of the first child in the child reference array.
+  std::uint32_t first;
+
+  /// Number of children, between 1 and 256. There is a single child only if
+  /// the node is a link in a chain of nodes spelling out a key prefix longer
+  /// than the maximum prefix_length.
+  std::uint16_t children_count;
+
+  /// Number of key bytes skipped by this node. The key prefix bytes themselves
+  /// are not stored: the search is optimistic and verifies the full key at the
+  /// leaf instead.
+  std::uint16_t prefix_length;
+};
+static_assert(sizeof(frozen_inode) == 8);
+
+/// A reference to a frozen ART child: either an internal node index or, if
+/// the top bit is set, a leaf index.
+using frozen_child_ref = std::uint32_t;
+
+inline constexpr frozen_child_ref frozen_leaf_tag = 1U << 31U;
+
+}  // namespace detail
+
+/// A read-only Adaptive Radix Tree built from a snapshot of a unodb::db,
+/// unodb::mutex_db, or unodb::olc_db.
+///
+/// Since the tree never changes after construction, its representation drops
+/// everything that exists only to support updates: there are no Node48
+/// indirection tables, child arrays have the exact size, there are no lock
+/// words, no padding, and no per-node heap allocations. Internal nodes are laid
+/// out in breadth-first order in a single array, the upper tree levels are
+/// therefore packed together at its start. Leaves are not nodes at all, but
+/// 32-bit offsets into a byte arena holding the entries in key order, turning
+/// scans into sequential memory access.
+///
+/// The query API matches the mutable trees: get(), scan(), scan_from(), and
+/// scan_range(). All the queries may run concurrently with each other.
+template <typename Key, typename Value>
+class frozen_db final {
+ public:
+  /// The type of the keys in the index.
+  using key_type = Key;
+  /// The type of the value associated with the key in the index.
+  using value_type = Value;
+  using value_view = unodb::value_view;
+  using get_result = std::optional<value_view>;
+
+  // TODO(laurynas): added temporarily during development
+  static_assert(std::is_same_v<value_type, unodb::value_view>);
+
+ private:
+  using art_key_type = detail::basic_art_key<Key>;
+
+ public:
+  /// Create an empty tree.
+  frozen_db() noexcept = default;
+
+  /// Create a tree with a copy of all the entries in \a source. If \a source
+  /// is a unodb::olc_db, the calling thread must participate in QSBR and \a
+  /// source must not be modified concurrently for the result to be a
+  /// consistent snapshot.
+  ///
+  /// \throws std::length_error if the tree is too large for the compact
+  /// representation, which is limited to 2^31 - 1 entries or internal nodes and
+  /// 4GiB of key and value bytes.
+  template <class Db>
+  explicit frozen_db(Db& source);
+
+  ~frozen_db() noexcept = default;
+
+  frozen_db(frozen_db&&) noexcept = default;
+  frozen_db& operator=(frozen_db&&) noexcept = default;
+
+  /// Query for a value associated with a key.
+  ///
+  /// \param search_key If Key is a simple primitive type, then it is converted
+  /// into a binary comparable key.  If Key is unodb::key_view, then it is
+  /// assumed to already be a binary comparable key, e.g., as produced by
+  /// unodb::key_encoder.
+  [[nodiscard, gnu::pure]] get_result get(Key search_key) const noexcept {
+    const auto k = art_key_type{search_key};
+    return get_internal(k);
+  }
+
+  /// Return true iff the tree is empty.
+  [[nodiscard]] bool empty() const noexcept { return size() == 0; }
+
+  /// Return the number of entries in the tree. A moved-from tree is empty.
+  [[nodiscard]] std::size_t size() const noexcept {
+    // A moved-from tree has lost the leaf_offsets sentinel too
+    return leaf_offsets.empty() ? 0 : leaf_offsets.size() - 1;
+  }
+
+  //
+  // iterator (the iterator is an internal API, the public API is scan()).
+  //
+
+  /// Since the leaves are stored in key order, the iterator is simply a
+  /// position in the leaf array. It does not allocate, and all of its methods
+  /// are `noexcept`.
+  class iterator {
+    friend class frozen_db<Key, Value>;
+    template <class>
+    friend class visitor;
+
+   protected:
+    /// Construct an empty iterator (one that is logically not positioned on
+    /// anything and which will report !valid()).
+    explicit iterator(const frozen_db& tree UNODB_DETAIL_LIFETIMEBOUND) noexcept
+        : db_{tree}, pos{tree.size()} {}
+
+   public:
+    using key_type = Key;
+    using value_type = Value;
+
+    iterator(const iterator&) = delete;
+    iterator(iterator&&) = delete;
+    iterator& operator=(const iterator&) = delete;
+    iterator& operator=(iterator&&) = delete;
+
+    /// Position the iterator on the first entry in the index.
+    iterator& first() noexcept {
+      pos = 0;
+      return *this;
+    }
+
+    /// Advance the iterator to next entry in the index.
+    iterator& next() noexcept {
+      UNODB_DETAIL_ASSERT(valid());
+      ++pos;
+      return *this;
+    }
+
+    /// Position the iterator on the last entry in the index, which can be used
+    /// to initiate a reverse traversal.
+    iterator& last() noexcept {
+      pos = db_.empty() ? 0 : db_.size() - 1;
+      return *this;
+    }
+
+    /// Position the iterator on the previous entry in the index.
+    iterator& prior() noexcept {
+      UNODB_DETAIL_ASSERT(valid());
+      pos = (pos == 0) ? db_.size() : pos - 1;
+      return *this;
+    }
+
+    /// Position the iterator on, before, or after the caller's key, with the
+    /// same semantics as unodb::db::iterator::seek().
+    iterator& seek(art_key_type search_key, bool& match,
+                   bool fwd = true) noexcept;
+
+    /// Return the key_view associated with the current position of the
+    /// iterator.
+    ///
+    /// \pre The iterator MUST be valid().
+    [[nodiscard, gnu::pure]] key_view get_key() const noexcept {
+      UNODB_DETAIL_ASSERT(valid());
+      return db_.leaf_key(pos);
+    }
+
+    /// Return the value_view associated with the current position of the
+    /// iterator.
+    ///
+    /// \pre The iterator MUST be valid().
+    [[nodiscard, gnu::pure]] value_view get_val() const noexcept {
+      UNODB_DETAIL_ASSERT(valid());
+      return db_.leaf_value(pos);
+    }
+
+    /// Return true unless the iterator is past either end of the index.
+    [[nodiscard]] bool valid() const noexcept {
+      return pos < db_.size();
+    }
+
+   protected:
+    /// Compare the given key (e.g., the to_key) to the current key.
+    ///
+    /// \return -1, 0, or 1 if this key is LT, EQ, or GT the other key.
+    [[nodiscard, gnu::pure]] int cmp(const art_key_type& akey) const noexcept {
+      UNODB_DETAIL_ASSERT(valid());
+      return detail::compare(get_key(), akey.get_key_view());
+    }
+
+   private:
+    /// The outer db instance.
+    const frozen_db& db_;
+
+    /// The current leaf index, equal to the tree size if the iterator is not
+    /// valid.
+    std::size_t pos;
+  };  // class iterator
+
+  //
+  // end of the iterator API, which is an internal API.
+  //
+
+  ///
+  /// public scan API
+  ///
+
+  /// Scan the tree, applying the caller's lambda to each visited leaf.
+  ///
+  /// \param fn A function `f(unodb::visitor<unodb::frozen_db::iterator>&)`
+  /// returning `bool`.  The traversal will halt if the function returns \c
+  /// true.
+  ///
+  /// \param fwd When \c true perform a forward scan, otherwise perform a
+  /// reverse scan.
+  template <typename FN>
+  void scan(FN fn, bool fwd = true) const {
+    iterator it(*this);
+    if (fwd)
+      it.first();
+    else
+      it.last();
+    do_scan(it, fn, fwd);
+  }
+
+  /// Scan in the indicated direction, applying the caller's lambda to each
+  /// visited leaf.
+  ///
+  /// \param from_key is an inclusive lower bound for the starting point of the
+  /// scan.
+  ///
+  /// \param fn A function `f(unodb::visitor<unodb::frozen_db::iterator>&)`
+  /// returning `bool`.  The traversal will halt if the function returns \c
+  /// true.
+  ///
+  /// \param fwd When \c true perform a forward scan, otherwise perform a
+  /// reverse scan.
+  template <typename FN>
+  void scan_from(Key from_key, FN fn, bool fwd = true) const {
+    const auto from_key_ = art_key_type{from_key};
+    bool match{};
+    iterator it(*this);
+    it.seek(from_key_, match, fwd);
+    do_scan(it, fn, fwd);
+  }
+
+  /// Scan a half-open key range, applying the caller's lambda to each visited
+  /// leaf, with the same semantics as unodb::db::scan_range().
+  ///
+  /// \param from_key is an inclusive bound for the starting point of the scan.
+  ///
+  /// \param to_key is an exclusive bound for the ending point of the scan.
+  ///
+  /// \param fn A function `f(unodb::visitor<unodb::frozen_db::iterator>&)`
+  /// returning `bool`.  The traversal will halt if the function returns \c
+  /// true.
+  template <typename FN>
+  void scan_range(Key from_key, Key to_key, FN fn) const {
+    const auto from_key_ = art_key_type{from_key};
+    const auto to_key_ = art_key_type{to_key};
+    const auto ret = from_key_.cmp(to_key_);
+    if (ret == 0) return;  // NOP
+    const bool fwd{ret < 0};
+    bool match{};
+    iterator it(*this);
+    it.seek(from_key_, match, fwd);
+    const visitor_type v{it};
+    if (fwd) {
+      while (it.valid() && it.cmp(to_key_) < 0) {
+        if (UNODB_DETAIL_UNLIKELY(fn(v))) break;
+        it.next();
+      }
+    } else {
+      while (it.valid() && it.cmp(to_key_) > 0) {
+        if (UNODB_DETAIL_UNLIKELY(fn(v))) break;
+        it.prior();
+      }
+    }
+  }
+
+  //
+  // TEST ONLY METHODS
+  //
+
+  // Used to write the iterator tests.
+  iterator test_only_iterator() const noexcept { return iterator(*this); }
+
+  /// Return the memory used by the tree in bytes. Unlike the mutable trees,
+  /// this is always available, as it is computed and not counted.
+  [[nodiscard]] std::size_t get_current_memory_use() const noexcept {
+    return inodes.capacity() * sizeof(detail::frozen_inode) +
+           children.capacity() * sizeof(detail::frozen_child_ref) +
+           key_bytes.capacity() +
+           leaf_offsets.capacity() * sizeof(std::uint32_t) + arena.capacity();
+  }
+
+  // Public utils
+  [[nodiscard]] static constexpr bool key_found(
+      const get_result& result) noexcept {
+    return static_cast<bool>(result);
+  }
+
+  // Debugging
+  [[gnu::cold]] UNODB_DETAIL_NOINLINE void dump(std::ostream& os) const;
+  [[gnu::cold]] UNODB_DETAIL_NOINLINE void dump() const;
+
+  frozen_db(const frozen_db&) = delete;
+  frozen_db& operator=(const frozen_db&) = delete;
+
+ private:
+  using visitor_type = visitor<iterator>;
+
+  /// Maximum number of key bytes a single node may skip. Longer shared key
+  /// prefixes are split into a chain of single-child nodes.
+  static constexpr std::size_t max_prefix_length =
+      std::numeric_limits<std::uint16_t>::max();
+
+  /// Whether the key size is fixed and therefore not stored in the arena.
+  static constexpr bool fixed_key_size = !std::is_same_v<Key, unodb::key_view>;
+
+  /// Query for a value associated with an encoded key.
+  [[nodiscard, gnu::pure]] get_result get_internal(
+      art_key_type search_key) const noexcept;
+
+  /// Return the child of \a node for \a key_byte, if any.
+  [[nodiscard, gnu::pure]] std::optional<detail::frozen_child_ref> find_child(
+      const detail::frozen_inode& node, std::byte key_byte) const noexcept;
+
+  /// Append an entry to the arena.
+  void append_leaf(key_view k, value_view v);
+
+  /// Build the internal nodes over the sorted leaves.
+  void build_nodes();
+
+  [[gnu::cold]] void dump_child_ref(std::ostream& os,
+                                    detail::frozen_child_ref ref) const;
+
+  template <typename FN>
+  void do_scan(iterator& it, FN& fn, bool fwd) const {
+    const visitor_type v{it};
+    while (it.valid()) {
+      if (UNODB_DETAIL_UNLIKELY(fn(v))) break;
+      if (fwd)
+        it.next();
+      else
+        it.prior();
+    }
+  }
+
+  [[nodiscard, gnu::pure]] key_view leaf_key(std::size_t i) const noexcept {
+    const auto* const entry = arena.data() + leaf_offsets[i];
+    if constexpr (fixed_key_size) {
+      return key_view{entry, sizeof(Key)};
+    } else {
+      key_size_type key_size;
+      std::memcpy(&key_size, entry, sizeof(key_size));
+      return key_view{entry + sizeof(key_size), key_size};
+    }
+  }
+
+  [[nodiscard, gnu::pure]] value_view leaf_value(std::size_t i) const noexcept {
+    const auto k = leaf_key(i);
+    const auto* const value_start = k.data() + k.size();
+    return value_view{value_start,
+                      static_cast<std::size_t>(arena.data() +
+                                               leaf_offsets[i + 1] -
+                                               value_start)};
+  }
+
+  /// The root node, if the tree has more than one entry.
+  detail::frozen_child_ref root{detail::frozen_leaf_tag};
+
+  /// Internal nodes in breadth-first order.
+  std::vector<detail::frozen_inode> inodes;
+
+  /// Child references of all the internal nodes.
+  std::vector<detail::frozen_child_ref> children;
+
+  /// For each reference in \a children, the key byte under which it is stored
+  /// in its parent. Kept separately from the references so that child searches
+  /// only touch the key bytes.
+  std::vector<std::byte> key_bytes;
+
+  /// Arena offsets of the entries in key order, followed by the arena size.
+  std::vector<std::uint32_t> leaf_offsets{0};
+
+  /// The entries: their key sizes (only for variable-length keys), key bytes,
+  /// and value bytes, the value size being implied by the next offset.
+  std::vector<std::byte> arena;
+};
+
+template <typename Key, typename Value>
+template <class Db>
+frozen_db<Key, Value>::frozen_db(Db& source) {
+  static_assert(std::is_same_v<typename Db::key_type, Key>);
+
+  source.scan([this](const auto& v) {
+    append_leaf(v.get_key(), v.get_value());
+    return false;
+  });
+  leaf_offsets.shrink_to_fit();
+  arena.shrink_to_fit();
+
+  build_nodes();
+}
+
+template <typename Key, typename Value>
+void frozen_db<Key, Value>::append_leaf(key_view k, value_view v) {
+  if (size() >= detail::frozen_leaf_tag - 1)
+    throw std::length_error("unodb::frozen_db: too many keys");
+  if constexpr (fixed_key_size) {
+    UNODB_DETAIL_ASSERT(k.size() == sizeof(Key));
+  } else {
+    const auto key_size = static_cast<key_size_type>(k.size());
+    const auto* const key_size_bytes =
+        reinterpret_cast<const std::byte*>(&key_size);
+    arena.insert(arena.end(), key_size_bytes,
+                 key_size_bytes + sizeof(key_size));
+  }
+  arena.insert(arena.end(), k.begin(), k.end());
+  arena.insert(arena.end(), v.begin(), v.end());
+  if (arena.size() > std::numeric_limits<std::uint32_t>::max())
+    throw std::length_error("unodb::frozen_db: too much key and value data");
+  leaf_offsets.push_back(static_cast<std::uint32_t>(arena.size()));
+}
+
+template <typename Key, typename Value>
+void frozen_db<Key, Value>::build_nodes() {
+  if (empty()) return;
+
+  // A child reference which is not yet set: it covers the leaves [begin, end)
+  // which share the first depth key bytes.
+  struct pending_child {
+    std::size_t ref_i;  // Position in children, or root_ref_i for the root
+    std::size_t begin;
+    std::size_t end;
+    std::size_t depth;
+  };
+  constexpr auto root_ref_i = std::numeric_limits<std::size_t>::max();
+  std::vector<pending_child> queue;
+
+  // A tree with n leaves has at most n - 1 internal nodes and, not counting
+  // single-child nodes for over-long prefixes, at most 2n - 2 child
+  // references.
+  const auto n = size();
+  queue.reserve(n * 2);
+  children.reserve(n * 2);
+  queue.push_back({root_ref_i, 0, n, 0});
+
+  // The queue is consumed in the FIFO order, which creates the children of each
+  // node in a contiguous range, in the breadth-first order overall.
+  for (std::size_t head = 0; head < queue.size(); ++head) {
+    const auto [ref_i, begin, end, depth] = queue[head];
+    auto& ref = (ref_i == root_ref_i) ? root : children[ref_i];
+    if (end - begin == 1) {
+      ref = detail::frozen_leaf_tag | static_cast<std::uint32_t>(begin);
+      continue;
+    }
+
+    // The keys are sorted, thus the longest common prefix of the range is the
+    // longest common prefix of its first and last keys.
+    const auto first_key = leaf_key(begin);
+    const auto last_key = leaf_key(end - 1);
+    const auto max_shared = std::min(first_key.size(), last_key.size());
+    auto split_depth = depth;
+    while (split_depth < max_shared && split_depth - depth < max_prefix_length &&
+           first_key[split_depth] == last_key[split_depth])
+      ++split_depth;
+    // No key may be a prefix of another
+    UNODB_DETAIL_ASSERT(split_depth < max_shared);
+
+    if (inodes.size() >= detail::frozen_leaf_tag ||
+        children.size() >= std::numeric_limits<std::uint32_t>::max() - 256)
+      throw std::length_error("unodb::frozen_db: too many nodes");
+    ref = static_cast<detail::frozen_child_ref>(inodes.size());
+
+    const auto first_child = children.size();
+    auto child_begin = begin;
+    while (child_begin < end) {
+      const auto key_byte = leaf_key(child_begin)[split_depth];
+      auto child_end = child_begin + 1;
+      while (child_end < end && leaf_key(child_end)[split_depth] == key_byte)
+        ++child_end;
+      queue.push_back({children.size(), child_begin, child_end, split_depth + 1});
+      children.push_back({});
+      key_bytes.push_back(key_byte);
+      child_begin = child_end;
+    }
+
+    inodes.push_back({static_cast<std::uint32_t>(first_child),
+                      static_cast<std::uint16_t>(children.size() - first_child),
+                      static_cast<std::uint16_t>(split_depth - depth)});
+  }
+
+  inodes.shrink_to_fit();
+  children.shrink_to_fit();
+  key_bytes.shrink_to_fit();
+}
+
+template <typename Key, typename Value>
+std::optional<detail::frozen_child_ref> frozen_db<Key, Value>::find_child(
+    const detail::frozen_inode& node, std::byte key_byte) const noexcept {
+  // A full node is indexed directly by the key byte
+  if (node.children_count == 256)
+    return children[node.first + static_cast<std::uint8_t>(key_byte)];
+
+  const auto* const first = key_bytes.data() + node.first;
+  const auto* const last = first + node.children_count;
+  const auto* const it = std::lower_bound(first, last, key_byte);
+  if (it == last || *it != key_byte) return {};
+  return children[node.first + static_cast<std::size_t>(it - first)];
+}
+
+template <typename Key, typename Value>
+typename frozen_db<Key, Value>::get_result frozen_db<Key, Value>::get_internal(
+    art_key_type search_key) const noexcept {
+  if (UNODB_DETAIL_UNLIKELY(empty())) return {};
+
+  const auto k = search_key.get_key_view();
+  std::size_t depth = 0;
+  auto ref = root;
+
+  while ((ref & detail::frozen_leaf_tag) == 0) {
+    const auto& node = inodes[ref];
+    depth += node.prefix_length;
+    if (UNODB_DETAIL_UNLIKELY(depth >= k.size())) return {};
+
+    const auto child = find_child(node, k[depth]);
+    if (!child) return {};
+
+    ref = *child;
+    ++depth;
+  }
+
+  // The key prefixes were skipped, check the whole key
+  const auto leaf_i = ref & ~detail::frozen_leaf_tag;
+  if (detail::compare(leaf_key(leaf_i), k) != 0) return {};
+  return leaf_value(leaf_i);
+}
+
+template <typename Key, typename Value>
+typename frozen_db<Key, Value>::iterator&
+frozen_db<Key, Value>::iterator::seek(art_key_type search_key, bool& match,
+                                      bool fwd) noexcept {
+  const auto k = search_key.get_key_view();
+  // Binary search over the sorted leaves for the first one GTE the search key.
+  std::size_t lo = 0;
+  std::size_t hi = db_.size();
+  while (lo < hi) {
+    const auto mid = lo + (hi - lo) / 2;
+    if (detail::compare(db_.leaf_key(mid), k) < 0)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+
+  match = lo < db_.size() && detail::compare(db_.leaf_key(lo), k) == 0;
+  if (fwd || match) {
+    pos = lo;
+  } else {
+    // The last leaf LT the search key, if any
+    pos = (lo == 0) ? db_.size() : lo - 1;
+  }
+  return *this;
+}
+
+template <typename Key, typename Value>
+void frozen_db<Key, Value>::dump(std::ostream& os) const {
+  os << "frozen_db dump, " << size() << " leaves, " << inodes.size()
+     << " internal nodes, current memory use = " << get_current_memory_use()
+     << '\n';
+  if (empty()) return;
+  os << "root ";
+  dump_child_ref(os, root);
+  os << '\n';
+  for (std::size_t i = 0; i < inodes.size(); ++i) {
+    const auto& node = inodes[i];
+    os << "node " << i << ", prefix length " << node.prefix_length << ", "
+       << node.children_count << " children:\n";
+    for (std::size_t j = node.first; j < node.first + node.children_count;
+         ++j) {
+      os << "  key byte ";
+      detail::dump_byte(os, key_bytes[j]);
+      os << ", ";
+      dump_child_ref(os, children[j]);
+      os << '\n';
+    }
+  }
+}
+
+template <typename Key, typename Value>
+void frozen_db<Key, Value>::dump_child_ref(std::ostream& os,
+                                           detail::frozen_child_ref ref) const {
+  if ((ref & detail::frozen_leaf_tag) == 0) {
+    os << "node " << ref;
+    return;
+  }
+  const auto leaf_i = ref & ~detail::frozen_leaf_tag;
+  os << "leaf " << leaf_i << ", ";
+  detail::dump_key(os, leaf_key(leaf_i));
+  os << ", value ";
+  detail::dump_val(os, leaf_value(leaf_i));
+}
+
+// LCOV_EXCL_START
+template <typename Key, typename Value>
+void frozen_db<Key, Value>::dump() const {
+  dump(std::cerr);
+}
+// LCOV_EXCL_STOP
+
+}  // namespace unodb
+
+#endif  // UNODB_DETAIL_FROZEN_ART_HPP
@@ -152,6 +152,10 @@
 /// Defined when UnoDB is compiled with Boost.Stacktrace.
 #define UNODB_DETAIL_BOOST_STACKTRACE
 
+/// Defined when UnoDB is compiled with the support for parking the threads
+/// waiting on the optimistic locks, see unodb::spin_backoff::exponential_park.
+#define UNODB_DETAIL_LOCK_PARKING
+
 /// Defined to the selected value of the optimistic spin lock wait algorithm
 /// implementation for unodb::spin_wait_loop_body(). It is also used by the OLC
 /// ART algorithms restarting close to the start of their execution. The
@@ -0,0 +1,241 @@
+// Copyright 2025 UnoDB contributors
+
+/// \file
+/// Hazard pointer implementation details.
+///
+/// \ingroup hazard-pointers
+///
+/// Implementation of non-inline symbols from hazard_ptr.hpp and of the global
+/// list of the hazard pointer records.
+
+// Should be the first include
+#include "global.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+
+#include "hazard_ptr.hpp"
+
+#include "assert.hpp"
+#include "heap.hpp"
+
+namespace unodb::detail {
+
+/// The global list of the hazard pointer records, freed at the process exit.
+struct hazard_pointer_registry {
+  constexpr hazard_pointer_registry() noexcept = default;
+
+  ~hazard_pointer_registry() {
+    auto* record = head.load(std::memory_order_acquire);
+    while (record != nullptr) {
+      const std::unique_ptr<hazard_pointer_thread> to_free{record};
+      record = record->next_record;
+      to_free->free_all_retired();
+    }
+  }
+
+  /// Give the record of the current thread back on its exit.
+  static void release_current_thread() noexcept {
+    auto* const record = hazard_pointer_thread::current_instance;
+    if (record == nullptr) return;
+    record->release_by_current_thread();
+    hazard_pointer_thread::current_instance = nullptr;
+  }
+
+  /// The most recently created record.
+  std::atomic<hazard_pointer_thread*> head{nullptr};
+
+  hazard_pointer_registry(const hazard_pointer_registry&) = delete;
+  hazard_pointer_registry(hazard_pointer_registry&&) = delete;
+  hazard_pointer_registry& operator=(const hazard_pointer_registry&) = delete;
+  hazard_pointer_registry& operator=(hazard_pointer_registry&&) = delete;
+};
+
+namespace {
+
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+constinit hazard_pointer_registry registry;
+
+/// Gives the record of the current thread back on the thread exit.
+struct release_on_thread_exit {
+  release_on_thread_exit() noexcept = default;
+  ~release_on_thread_exit() noexcept {
+    hazard_pointer_registry::release_current_thread();
+  }
+  release_on_thread_exit(const release_on_thread_exit&) = delete;
+  release_on_thread_exit(release_on_thread_exit&&) = delete;
+  release_on_thread_exit& operator=(const release_on_thread_exit&) = delete;
+  release_on_thread_exit& operator=(release_on_thread_exit&&) = delete;
+};
+
+}  // namespace
+
+}  // namespace unodb::detail
+
+namespace unodb {
+
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+constinit thread_local hazard_pointer_thread*
+    hazard_pointer_thread::current_instance{nullptr};
+
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+constinit std::atomic<std::size_t> hazard_pointer_thread::total_slot_count{0};
+
+hazard_pointer_thread::hazard_pointer_thread() {
+  constexpr auto block_size = detail::hazard_pointer_block::size;
+  free_slots.reserve(block_size);
+  for (auto slot = block_size;
+       slot > rotating_slot_count + fixed_slot_count; --slot)
+    free_slots.push_back(slot - 1);
+  total_slot_count.fetch_add(block_size, std::memory_order_relaxed);
+}
+
+hazard_pointer_thread::~hazard_pointer_thread() {
+  for (auto* const block : more_blocks) delete block;
+}
+
+hazard_pointer_thread& hazard_pointer_thread::take_for_current_thread() {
+  static thread_local const detail::release_on_thread_exit on_exit;
+
+  for (auto* record = detail::registry.head.load(std::memory_order_acquire);
+       record != nullptr; record = record->next_record) {
+    if (record->in_use.load(std::memory_order_relaxed)) continue;
+    bool expected{false};
+    // Acquire the retired nodes and the slot bookkeeping of the last owner
+    if (record->in_use.compare_exchange_strong(expected, true,
+                                               std::memory_order_acquire,
+                                               std::memory_order_relaxed)) {
+      current_instance = record;
+      return *record;
+    }
+  }
+
+  std::unique_ptr<hazard_pointer_thread> new_record{
+      new hazard_pointer_thread{}};
+  auto* old_head = detail::registry.head.load(std::memory_order_relaxed);
+  do {
+    new_record->next_record = old_head;
+  } while (!detail::registry.head.compare_exchange_weak(
+      old_head, new_record.get(), std::memory_order_release,
+      std::memory_order_relaxed));
+  current_instance = new_record.release();
+  return *current_instance;
+}
+
+void hazard_pointer_thread::release_by_current_thread() noexcept {
+  UNODB_DETAIL_ASSERT(free_slots.size() + rotating_slot_count +
+                          fixed_slot_count ==
+                      (more_blocks.size() + 1) *
+                          detail::hazard_pointer_block::size);
+  for (std::size_t slot = 0; slot < rotating_slot_count + fixed_slot_count;
+       ++slot)
+    publish(slot, nullptr);
+  next_rotating_slot = 0;
+
+  if (!retired.empty()) {
+    try {
+      reclaim();
+    }
+    // LCOV_EXCL_START
+    catch (const std::bad_alloc&) {
+      // The next owner of the record will free them
+    }
+    // LCOV_EXCL_STOP
+  }
+
+  in_use.store(false, std::memory_order_release);
+}
+
+std::size_t hazard_pointer_thread::acquire_slot() {
+  if (UNODB_DETAIL_UNLIKELY(free_slots.empty())) {
+    constexpr auto block_size = detail::hazard_pointer_block::size;
+    const auto first_new_slot = (more_blocks.size() + 1) * block_size;
+    // Make room for all the slots, so that release_slot cannot fail
+    free_slots.reserve(first_new_slot + block_size);
+    more_blocks.reserve(more_blocks.size() + 1);
+
+    auto* const last_block =
+        more_blocks.empty() ? &first_block : more_blocks.back();
+    more_blocks.push_back(new detail::hazard_pointer_block{});
+    last_block->next.store(more_blocks.back(), std::memory_order_release);
+
+    for (auto slot = first_new_slot + block_size; slot > first_new_slot;
+         --slot)
+      free_slots.push_back(slot - 1);
+    total_slot_count.fetch_add(block_size, std::memory_order_relaxed);
+  }
+
+  const auto result = free_slots.back();
+  free_slots.pop_back();
+  return result;
+}
+
+void hazard_pointer_thread::retire(void* ptr
+#ifndef NDEBUG
+                                   ,
+                                   debug_callback dealloc_callback
+#endif
+) {
+  retired.push_back({ptr
+#ifndef NDEBUG
+                     ,
+                     dealloc_callback
+#endif
+  });
+
+  // Scanning the slots of all the threads is amortized over a number of
+  // retired nodes proportional to the number of the slots.
+  if (retired.size() >=
+      std::max(min_reclaim_threshold, 2 * get_total_slot_count()))
+    reclaim();
+}
+
+void hazard_pointer_thread::reclaim() {
+  // The retired nodes have been made unreachable before this point. A reader
+  // that published one of them after it, and thus may be missed below, fails
+  // its validation.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+
+  hazards.clear();
+  for (const auto* record =
+           detail::registry.head.load(std::memory_order_acquire);
+       record != nullptr; record = record->next_record) {
+    for (const auto* block = &record->first_block; block != nullptr;
+         block = block->next.load(std::memory_order_acquire)) {
+      for (const auto& slot : block->slots) {
+        const auto* const ptr = slot.load(std::memory_order_acquire);
+        if (ptr != nullptr) hazards.push_back(ptr);
+      }
+    }
+  }
+  std::ranges::sort(hazards);
+
+  std::size_t kept{0};
+  for (const auto& node : retired) {
+    if (std::ranges::binary_search(hazards,
+                                   static_cast<const void*>(node.ptr))) {
+      retired[kept++] = node;
+      continue;
+    }
+#ifndef NDEBUG
+    if (node.dealloc_callback != nullptr) node.dealloc_callback(node.ptr);
+#endif
+    detail::free_aligned(node.ptr);
+  }
+  retired.resize(kept);
+}
+
+void hazard_pointer_thread::free_all_retired() noexcept {
+  for (const auto& node : retired) {
+#ifndef NDEBUG
+    if (node.dealloc_callback != nullptr) node.dealloc_callback(node.ptr);
+#endif
+    detail::free_aligned(node.ptr);
+  }
+  retired.clear();
+}
+
+}  // namespace unodb
@@ -0,0 +1,291 @@
+// Copyright 2025 UnoDB contributors
+#ifndef UNODB_DETAIL_HAZARD_PTR_HPP
+#define UNODB_DETAIL_HAZARD_PTR_HPP
+
+/// \file
+/// Hazard pointer memory reclamation.
+///
+/// \ingroup hazard-pointers
+///
+/// A thread publishes the address of every shared node it is about to follow
+/// in one of its hazard pointer slots, and validates that the node is still
+/// reachable before dereferencing it. A thread removing a node retires it
+/// instead of freeing it, and once it has retired enough nodes, it frees those
+/// not published in any slot of any thread. Unlike with QSBR, a reader stalled
+/// in the middle of a long operation only holds back the nodes it has
+/// published, thus the unreclaimed memory is bounded by the number of the
+/// threads times the number of their slots, and not by the slowest reader.
+///
+/// The slots of a thread live in a record, which is taken from a global list
+/// of the records on the first use by the thread and returned to it on the
+/// thread exit, to be reused by a later thread together with any of the nodes
+/// still retired into it. The records are never freed before the process exit.
+
+// Should be the first include
+#include "global.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+#include "assert.hpp"
+
+namespace unodb {
+
+/// Tag type selecting the hazard pointer reclamation in the constructor of a
+/// tree, see unodb::hazard_pointer_reclamation.
+struct hazard_pointer_reclamation_t {
+  /// Construct the tag.
+  explicit hazard_pointer_reclamation_t() = default;
+};
+
+/// Tag selecting the hazard pointer reclamation in the constructor of a tree.
+inline constexpr hazard_pointer_reclamation_t hazard_pointer_reclamation{};
+
+class hazard_pointer_thread;
+
+namespace detail {
+
+struct hazard_pointer_registry;
+
+/// A block of the hazard pointer slots of a thread.
+struct hazard_pointer_block {
+  /// The number of slots in a block.
+  static constexpr std::size_t size = 16;
+
+  /// The published pointers, `nullptr` for the unused slots.
+  std::array<std::atomic<const void*>, size> slots{};
+
+  /// The next block of the same thread, set once.
+  std::atomic<hazard_pointer_block*> next{nullptr};
+};
+
+}  // namespace detail
+
+/// The hazard pointer record of a thread.
+///
+/// The first rotating_slot_count slots are cycled through by protect_next(),
+/// the following fixed_slot_count ones are reserved for the fixed uses of the
+/// caller, and the rest are handed out by acquire_slot().
+class hazard_pointer_thread final {
+ public:
+#ifndef NDEBUG
+  /// Type of the callbacks called at the actual deallocation time of a
+  /// retired node in debug builds.
+  using debug_callback = void (*)(const void*);
+#endif
+
+  /// The number of slots cycled through by protect_next().
+  static constexpr std::size_t rotating_slot_count = 3;
+
+  /// The number of slots reserved for the fixed uses, numbered from
+  /// rotating_slot_count.
+  static constexpr std::size_t fixed_slot_count = 2;
+
+  /// The minimum number of retired nodes which triggers reclaim().
+  static constexpr std::size_t min_reclaim_threshold = 64;
+
+  /// Return the record of the current thread, taking one on the first call.
+  [[nodiscard]] static hazard_pointer_thread& current() {
+    if (UNODB_DETAIL_UNLIKELY(current_instance == nullptr))
+      return take_for_current_thread();
+    return *current_instance;
+  }
+
+  /// Publish \a ptr in \a slot without ordering it before the following loads.
+  /// Sufficient if the node cannot be retired before a later synchronizing
+  /// operation, i.e. if it is locked by this thread.
+  void publish(std::size_t slot, const void* ptr) noexcept {
+    get_slot(slot).store(ptr, std::memory_order_release);
+  }
+
+  /// Publish \a ptr in \a slot and order it before the following loads, which
+  /// must then validate that the node has not been retired yet.
+  void protect(std::size_t slot, const void* ptr) noexcept {
+    publish(slot, ptr);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+  }
+
+  /// Protect \a ptr, as protect() does, in the least recently used rotating
+  /// slot. The last rotating_slot_count nodes protected so stay protected.
+  void protect_next(const void* ptr) noexcept {
+    protect(next_rotating_slot, ptr);
+    next_rotating_slot = (next_rotating_slot + 1) % rotating_slot_count;
+  }
+
+  /// Take a slot for exclusive use until release_slot().
+  [[nodiscard]] std::size_t acquire_slot();
+
+  /// Clear and give back \a slot taken with acquire_slot().
+  void release_slot(std::size_t slot) noexcept {
+    UNODB_DETAIL_ASSERT(slot >= rotating_slot_count + fixed_slot_count);
+    publish(slot, nullptr);
+    // Cannot fail, the vector has the capacity for all the slots.
+    free_slots.push_back(slot);
+  }
+
+  /// Defer freeing \a ptr, allocated with detail::allocate_aligned() and
+  /// already unreachable for the new readers, until no thread has it
+  /// published. In debug builds, call \a dealloc_callback just before freeing
+  /// it.
+  void retire(void* ptr
+#ifndef NDEBUG
+              ,
+              debug_callback dealloc_callback
+#endif
+  );
+
+  /// Free the retired nodes that are not published by any thread.
+  void reclaim();
+
+  /// Return the number of the nodes retired into this record and not freed
+  /// yet.
+  [[nodiscard]] std::size_t get_retired_count() const noexcept {
+    return retired.size();
+  }
+
+  /// Return the number of the slots of all the records.
+  [[nodiscard]] static std::size_t get_total_slot_count() noexcept {
+    return total_slot_count.load(std::memory_order_relaxed);
+  }
+
+  /// Free the slot blocks other than the first one.
+  ~hazard_pointer_thread();
+
+  hazard_pointer_thread(const hazard_pointer_thread&) = delete;
+  hazard_pointer_thread(hazard_pointer_thread&&) = delete;
+  hazard_pointer_thread& operator=(const hazard_pointer_thread&) = delete;
+  hazard_pointer_thread& operator=(hazard_pointer_thread&&) = delete;
+
+ private:
+  friend struct detail::hazard_pointer_registry;
+
+  /// A retired node.
+  struct retired_node {
+    /// The node memory.
+    void* ptr;
+#ifndef NDEBUG
+    /// The debug callback.
+    debug_callback dealloc_callback;
+#endif
+  };
+
+  hazard_pointer_thread();
+
+  /// Take a free record or create a new one for the current thread.
+  [[nodiscard]] static hazard_pointer_thread& take_for_current_thread();
+
+  /// Clear the slots, free what can be freed, and give the record back.
+  void release_by_current_thread() noexcept;
+
+  /// Free all the retired nodes at the process exit.
+  void free_all_retired() noexcept;
+
+  /// Return the atomic of \a slot.
+  [[nodiscard]] std::atomic<const void*>& get_slot(std::size_t slot) noexcept {
+    if (UNODB_DETAIL_LIKELY(slot < detail::hazard_pointer_block::size))
+      return first_block.slots[slot];
+    UNODB_DETAIL_ASSERT(slot / detail::hazard_pointer_block::size <=
+                        more_blocks.size());
+    return more_blocks[slot / detail::hazard_pointer_block::size - 1]
+        ->slots[slot % detail::hazard_pointer_block::size];
+  }
+
+  /// The record of the current thread.
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+  static constinit thread_local hazard_pointer_thread* current_instance;
+
+  /// The number of the slots of all the records.
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+  static constinit std::atomic<std::size_t> total_slot_count;
+
+  /// The first slot block, which is scanned through its next link.
+  detail::hazard_pointer_block first_block;
+
+  /// The other slot blocks, in their order, owned by this record.
+  std::vector<detail::hazard_pointer_block*> more_blocks;
+
+  /// The slots not taken by acquire_slot().
+  std::vector<std::size_t> free_slots;
+
+  /// The retired nodes.
+  std::vector<retired_node> retired;
+
+  /// The pointers published by all the threads, a reclaim() scratch buffer.
+  std::vector<const void*> hazards;
+
+  /// The rotating slot protect_next() uses next.
+  std::size_t next_rotating_slot{0};
+
+  /// Whether a thread owns the record.
+  std::atomic<bool> in_use{true};
+
+  /// The next record in the global list, set once.
+  hazard_pointer_thread* next_record{nullptr};
+};
+
+/// A set of hazard pointer slots taken from the record of the current thread
+/// on demand and given back on destruction, for the operations which protect a
+/// variable number of nodes. Must be used by a single thread.
+class hazard_pointer_slots final {
+ public:
+  /// Create an empty set.
+  hazard_pointer_slots() noexcept = default;
+
+  /// Give back the slots.
+  ~hazard_pointer_slots() { release(); }
+
+  /// Protect \a ptr, as hazard_pointer_thread::protect() does, in the slot \a
+  /// i of the set, taking the slots up to it if needed.
+  void protect(std::size_t i, const void* ptr) {
+    reserve(i + 1);
+    thread->protect(slots[i], ptr);
+  }
+
+  /// Publish \a ptr, as hazard_pointer_thread::publish() does, in the slot \a
+  /// i of the set, taking the slots up to it if needed.
+  void publish(std::size_t i, const void* ptr) {
+    reserve(i + 1);
+    thread->publish(slots[i], ptr);
+  }
+
+  /// Take slots until there are at least \a count of them.
+  void reserve(std::size_t count) {
+    if (UNODB_DETAIL_LIKELY(count <= slots.size())) return;
+    if (thread == nullptr) thread = &hazard_pointer_thread::current();
+    slots.reserve(count);
+    while (slots.size() < count) slots.push_back(thread->acquire_slot());
+  }
+
+  /// Return the hazard pointer slot number of the slot \a i of the set.
+  [[nodiscard]] std::size_t operator[](std::size_t i) const noexcept {
+    UNODB_DETAIL_ASSERT(i < slots.size());
+    return slots[i];
+  }
+
+  /// Return the number of the slots taken.
+  [[nodiscard]] std::size_t size() const noexcept { return slots.size(); }
+
+  /// Give back all the slots.
+  void release() noexcept {
+    for (const auto slot : slots) thread->release_slot(slot);
+    slots.clear();
+  }
+
+  hazard_pointer_slots(const hazard_pointer_slots&) = delete;
+  hazard_pointer_slots(hazard_pointer_slots&&) = delete;
+  hazard_pointer_slots& operator=(const hazard_pointer_slots&) = delete;
+  hazard_pointer_slots& operator=(hazard_pointer_slots&&) = delete;
+
+ private:
+  /// The record of the thread, once a slot has been taken.
+  hazard_pointer_thread* thread{nullptr};
+
+  /// The slot numbers.
+  std::vector<std::size_t> slots;
+};
+
+}  // namespace unodb
+
+#endif  // UNODB_DETAIL_HAZARD_PTR_HPP
@@ -0,0 +1,430 @@
+// Copyright 2025 UnoDB contributors
+#ifndef UNODB_DETAIL_MULTIMAP_ART_HPP
+#define UNODB_DETAIL_MULTIMAP_ART_HPP
+
+/// \file
+/// Multimap mode for the single-threaded ART.
+///
+/// unodb::multimap_db maps each key to a sorted set of values. All the values
+/// of a key share a single leaf, so a key with many values costs one leaf and
+/// one tree path instead of one of each per (key, value) pair.
+
+// Should be the first include
+#include "global.hpp"
+
+// IWYU pragma: no_include <__ostream/basic_ostream.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "art.hpp"
+#include "art_common.hpp"
+#include "art_internal.hpp"
+#include "assert.hpp"
+#include "node_type.hpp"
+
+namespace unodb {
+
+namespace detail {
+
+/// The value area of a multimap leaf.
+///
+/// The layout is the used size as a std::uint32_t, followed by the entries and
+/// then by unused capacity. Each entry is the value length as a LEB128 varint
+/// followed by the value bytes. The entries are unique and sorted in the
+/// lexicographic order of the value bytes.
+class multimap_value_list final {
+ public:
+  using size_type = std::uint32_t;
+
+  static constexpr std::size_t header_size = sizeof(size_type);
+
+  /// Maximum encoded size of an entry length.
+  static constexpr std::size_t max_length_size = 5;
+
+  explicit multimap_value_list(std::span<std::byte> area_) noexcept
+      : area{area_} {
+    UNODB_DETAIL_ASSERT(area.size() >= header_size);
+  }
+
+  /// Lay out an empty list over the caller's area.
+  static void init(std::span<std::byte> area_) noexcept {
+    UNODB_DETAIL_ASSERT(area_.size() >= header_size);
+    constexpr size_type zero = 0;
+    std::memcpy(area_.data(), &zero, header_size);
+  }
+
+  [[nodiscard]] std::size_t used() const noexcept {
+    size_type result;
+    std::memcpy(&result, area.data(), header_size);
+    return result;
+  }
+
+  [[nodiscard]] std::size_t capacity() const noexcept {
+    return area.size() - header_size;
+  }
+
+  [[nodiscard]] bool empty() const noexcept { return used() == 0; }
+
+  /// Return the encoded size of an entry for a value of size \a value_size.
+  [[nodiscard]] static constexpr std::size_t entry_size(
+      std::size_t value_size) noexcept {
+    std::size_t result = 1;
+    for (auto s = value_size >> 7U; s != 0; s >>= 7U) ++result;
+    return result + value_size;
+  }
+
+  /// Position of an entry in the list: its offset from the first entry and, if
+  /// an entry equal to the searched value exists, whether it was found.
+  struct position {
+    std::size_t offset;
+    bool found;
+  };
+
+  /// Find the entry for \a v, or the position where it would be inserted.
+  [[nodiscard]] position find(value_view v) const noexcept {
+    std::size_t offset = 0;
+    const auto end = used();
+    while (offset < end) {
+      const auto entry = entry_at(offset);
+      const auto value = entry_value(entry);
+      const auto cmp = compare(value, v);
+      if (cmp == 0) return {offset, true};
+      if (cmp > 0) break;
+      offset += entry.size();
+    }
+    return {offset, false};
+  }
+
+  /// Insert an entry for \a v at \a offset, which must come from find().
+  /// There must be enough unused capacity for the entry.
+  void insert(std::size_t offset, value_view v) noexcept {
+    const auto size = entry_size(v.size());
+    const auto old_used = used();
+    UNODB_DETAIL_ASSERT(offset <= old_used);
+    UNODB_DETAIL_ASSERT(old_used + size <= capacity());
+
+    auto* const pos = entries() + offset;
+    std::memmove(pos + size, pos, old_used - offset);
+    write_entry(pos, v);
+    set_used(old_used + size);
+  }
+
+  /// Remove the entry at \a offset.
+  void remove(std::size_t offset) noexcept {
+    const auto old_used = used();
+    UNODB_DETAIL_ASSERT(offset < old_used);
+
+    const auto size = entry_at(offset).size();
+    auto* const pos = entries() + offset;
+    std::memmove(pos, pos + size, old_used - offset - size);
+    set_used(old_used - size);
+  }
+
+  /// Copy the entries to an empty list with enough capacity.
+  void copy_to(multimap_value_list& other) const noexcept {
+    UNODB_DETAIL_ASSERT(other.empty());
+    UNODB_DETAIL_ASSERT(other.capacity() >= used());
+
+    const auto size = used();
+    if (size != 0) std::memcpy(other.entries(), entries(), size);
+    other.set_used(size);
+  }
+
+  /// Call fn(value_view) for each value in order, until it returns true.
+  ///
+  /// \return true iff fn halted the iteration.
+  template <typename FN>
+  bool for_each(FN fn) const {
+    std::size_t offset = 0;
+    const auto end = used();
+    while (offset < end) {
+      const auto entry = entry_at(offset);
+      if (fn(entry_value(entry))) return true;
+      offset += entry.size();
+    }
+    return false;
+  }
+
+  [[nodiscard]] std::size_t count() const noexcept {
+    std::size_t result = 0;
+    for_each([&result](value_view) noexcept {
+      ++result;
+      return false;
+    });
+    return result;
+  }
+
+ private:
+  [[nodiscard]] std::byte* entries() const noexcept {
+    return area.data() + header_size;
+  }
+
+  void set_used(std::size_t new_used) noexcept {
+    UNODB_DETAIL_ASSERT(new_used <= capacity());
+    const auto u = static_cast<size_type>(new_used);
+    std::memcpy(area.data(), &u, header_size);
+  }
+
+  /// Return the encoded entry starting at \a offset.
+  [[nodiscard]] std::span<const std::byte> entry_at(
+      std::size_t offset) const noexcept {
+    const auto* const begin = entries() + offset;
+    const auto* ptr = begin;
+    std::size_t length = 0;
+    unsigned shift = 0;
+    while (true) {
+      const auto b = static_cast<std::uint8_t>(*ptr++);
+      length |= static_cast<std::size_t>(b & 0x7FU) << shift;
+      if ((b & 0x80U) == 0) break;
+      shift += 7;
+    }
+    const auto header = static_cast<std::size_t>(ptr - begin);
+    UNODB_DETAIL_ASSERT(offset + header + length <= used());
+    return {begin, header + length};
+  }
+
+  [[nodiscard]] static value_view entry_value(
+      std::span<const std::byte> entry) noexcept {
+    std::size_t header = 1;
+    while ((static_cast<std::uint8_t>(entry[header - 1]) & 0x80U) != 0)
+      ++header;
+    return entry.subspan(header);
+  }
+
+  static void write_entry(std::byte* dest, value_view v) noexcept {
+    auto length = v.size();
+    while (length >= 0x80U) {
+      *dest++ = static_cast<std::byte>((length & 0x7FU) | 0x80U);
+      length >>= 7U;
+    }
+    *dest++ = static_cast<std::byte>(length);
+    if (!v.empty()) std::memcpy(dest, v.data(), v.size());
+  }
+
+  [[nodiscard]] static int compare(value_view a, value_view b) noexcept {
+    const auto shared = std::min(a.size(), b.size());
+    const auto cmp = shared == 0 ? 0 : std::memcmp(a.data(), b.data(), shared);
+    if (cmp != 0) return cmp;
+    return a.size() < b.size() ? -1 : (a.size() == b.size() ? 0 : 1);
+  }
+
+  std::span<std::byte> area;
+};
+
+}  // namespace detail
+
+/// A single-threaded Adaptive Radix Tree (ART) in multimap mode, where each key
+/// maps to a set of values.
+///
+/// The values of a key are stored in a single leaf as a sorted list with
+/// spare capacity, so adding a value to an existing key usually updates the
+/// leaf in place instead of allocating. Value lookups within a key scan the
+/// list linearly, so this mode is intended for keys with a moderate number of
+/// values, such as a secondary index mapping a column value to row IDs.
+///
+/// \sa unodb::db for the underlying tree.
+template <typename Key>
+class multimap_db final {
+ public:
+  /// The type of the keys in the index.
+  using key_type = Key;
+  using value_view = unodb::value_view;
+
+ private:
+  using db_type = db<Key, value_view>;
+  using art_key_type = detail::basic_art_key<Key>;
+  using art_policy = typename db_type::art_policy;
+  using leaf_type = typename db_type::leaf_type;
+  using value_list = detail::multimap_value_list;
+
+  /// Return the value list of a leaf. Leaf data is not const, only the views
+  /// over it returned by the leaf are.
+  [[nodiscard]] static value_list list_of(const leaf_type& leaf) noexcept {
+    const auto v = leaf.get_value_view();
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+    return value_list{{const_cast<std::byte*>(v.data()), v.size()}};
+  }
+
+  [[nodiscard]] static std::size_t area_size(std::size_t capacity) {
+    if (UNODB_DETAIL_UNLIKELY(
+            capacity > std::numeric_limits<value_list::size_type>::max() -
+                           value_list::header_size)) {
+      throw std::length_error("Value list length must fit in std::uint32_t");
+    }
+    return capacity + value_list::header_size;
+  }
+
+  /// Replace the leaf in \a slot by a new one for \a k with \a capacity bytes
+  /// for the entries, copying the entries over. Return the new value list.
+  value_list relocate(detail::node_ptr& slot, art_key_type k,
+                      std::size_t capacity) {
+    auto* const old_leaf{slot.template ptr<leaf_type*>()};
+    const auto old_list = list_of(*old_leaf);
+
+    scratch.assign(area_size(capacity), std::byte{0});
+    value_list new_list{scratch};
+    value_list::init(scratch);
+    old_list.copy_to(new_list);
+
+    auto new_leaf = art_policy::make_db_leaf_ptr(k, value_view{scratch}, db_);
+    const auto r{art_policy::reclaim_leaf_on_scope_exit(old_leaf, db_)};
+    slot = detail::node_ptr{new_leaf.release(), node_type::LEAF};
+    return list_of(*slot.template ptr<leaf_type*>());
+  }
+
+  [[nodiscard]] bool insert_internal(art_key_type k, value_view v) {
+    const auto entry_size = value_list::entry_size(v.size());
+    auto* const slot = db_.find_leaf_slot(k);
+
+    if (slot == nullptr) {
+      scratch.assign(area_size(entry_size), std::byte{0});
+      value_list::init(scratch);
+      value_list{scratch}.insert(0, v);
+      const auto inserted = db_.insert_internal(k, value_view{scratch});
+      UNODB_DETAIL_ASSERT(inserted);
+      return inserted;
+    }
+
+    auto list = list_of(*slot->template ptr<leaf_type*>());
+    const auto pos = list.find(v);
+    if (pos.found) return false;
+
+    const auto needed = list.used() + entry_size;
+    if (needed > list.capacity()) {
+      // Grow geometrically so that adding values one by one stays amortized
+      // constant in allocations
+      list = relocate(*slot, k, std::max(needed, list.capacity() * 2));
+    }
+    list.insert(pos.offset, v);
+    return true;
+  }
+
+  [[nodiscard]] bool remove_value_internal(art_key_type k, value_view v) {
+    auto* const slot = db_.find_leaf_slot(k);
+    if (slot == nullptr) return false;
+
+    auto list = list_of(*slot->template ptr<leaf_type*>());
+    const auto pos = list.find(v);
+    if (!pos.found) return false;
+
+    list.remove(pos.offset);
+    if (list.empty()) {
+      const auto removed = db_.remove_internal(k);
+      UNODB_DETAIL_ASSERT(removed);
+      return removed;
+    }
+    if (list.used() < list.capacity() / 4) {
+      // Shrink to twice the used size, keeping some room to grow back
+      relocate(*slot, k, list.used() * 2);
+    }
+    return true;
+  }
+
+ public:
+  // Creation and destruction
+  multimap_db() noexcept = default;
+
+  /// Add a value to the set of values of a key, creating the key if needed.
+  ///
+  /// \param insert_key If Key is a simple primitive type, then it is converted
+  /// into a binary comparable key.  If Key is unodb::key_view, then it is
+  /// assumed to already be a binary comparable key, e.g., as produced by
+  /// unodb::key_encoder.
+  ///
+  /// \param v The value to add.
+  ///
+  /// \return true iff the value was added, false if the key already had it.
+  [[nodiscard]] bool insert_dup(Key insert_key, value_view v) {
+    const art_key_type k{insert_key};
+    return insert_internal(k, v);
+  }
+
+  /// Remove a single value of a key, removing the key with its last value.
+  ///
+  /// \return true iff the key had the value.
+  [[nodiscard]] bool remove_value(Key search_key, value_view v) {
+    const art_key_type k{search_key};
+    return remove_value_internal(k, v);
+  }
+
+  /// Remove a key with all its values.
+  ///
+  /// \return true iff the key was found.
+  [[nodiscard]] bool remove(Key search_key) {
+    const art_key_type k{search_key};
+    return db_.remove_internal(k);
+  }
+
+  /// Visit the values of a key in their lexicographic order.
+  ///
+  /// \param fn A function `f(unodb::value_view)` returning `bool`.  The
+  /// traversal will halt if the function returns \c true.  The value views
+  /// are only valid until the next modification of the tree.
+  template <typename FN>
+  void scan_values(Key search_key, FN fn) const {
+    const art_key_type k{search_key};
+    const auto result = db_.get_internal(k);
+    if (!db_type::key_found(result)) return;
+
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+    const value_list list{{const_cast<std::byte*>(result->data()),
+                           result->size()}};
+    list.for_each(fn);
+  }
+
+  /// Return the number of values of a key, 0 if the key is absent.
+  [[nodiscard]] std::size_t value_count(Key search_key) const noexcept {
+    std::size_t result = 0;
+    scan_values(search_key, [&result](value_view) noexcept {
+      ++result;
+      return false;
+    });
+    return result;
+  }
+
+  [[nodiscard]] bool empty() const noexcept { return db_.empty(); }
+
+  /// Removes all entries in the index.
+  void clear() noexcept { db_.clear(); }
+
+  /// Return the underlying tree, whose leaf values are encoded value lists.
+  [[nodiscard]] const db_type& get_db() const noexcept { return db_; }
+
+#ifdef UNODB_DETAIL_WITH_STATS
+
+  [[nodiscard]] auto get_current_memory_use() const noexcept {
+    return db_.get_current_memory_use();
+  }
+
+  template <node_type NodeType>
+  [[nodiscard]] auto get_node_count() const noexcept {
+    return db_.template get_node_count<NodeType>();
+  }
+
+#endif  // UNODB_DETAIL_WITH_STATS
+
+  // Debugging
+  [[gnu::cold]] UNODB_DETAIL_NOINLINE void dump(std::ostream& os) const {
+    db_.dump(os);
+  }
+
+  [[gnu::cold]] UNODB_DETAIL_NOINLINE void dump() const { dump(std::cerr); }
+
+ private:
+  db_type db_;
+
+  /// Reused buffer for building value lists of new leaves.
+  std::vector<std::byte> scratch;
+};
+
+}  // namespace unodb
+
+#endif  // UNODB_DETAIL_MULTIMAP_ART_HPP
@@ -6,7 +6,10 @@
 #include "global.hpp"
 
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
 #include <mutex>
+#include <span>
 #include <type_traits>
 #include <utility>
 
@@ -109,6 +112,17 @@ class mutex_db final {
     return insert_internal(k, v);
   }
 
+  /// Insert the key value pairs of \a batch, skipping the keys already
+  /// present, under a single lock acquisition.
+  ///
+  /// \sa unodb::db::insert_batch
+  ///
+  /// \return the number of inserted pairs.
+  std::size_t insert_batch(std::span<const std::pair<Key, value_type>> batch) {
+    const std::lock_guard guard{mutex};
+    return db_.insert_batch(batch);
+  }
+
   /// Remove the entry associated with the key.
   ///
   /// \param search_key If Key is a simple primitive type, then it is converted
@@ -126,6 +140,21 @@ class mutex_db final {
     db_.clear();
   }
 
+  /// Set the number of children, ahead of the one being visited, which the
+  /// scans prefetch.
+  ///
+  /// \sa unodb::db::set_scan_prefetch_distance
+  void set_scan_prefetch_distance(std::uint8_t distance) {
+    const std::lock_guard guard{mutex};
+    db_.set_scan_prefetch_distance(distance);
+  }
+
+  /// Return the scan prefetch distance.
+  [[nodiscard]] std::uint8_t get_scan_prefetch_distance() const {
+    const std::lock_guard guard{mutex};
+    return db_.get_scan_prefetch_distance();
+  }
+
   //
   // scan API.
   //
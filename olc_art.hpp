@@ -14,14 +14,17 @@
 #include <cstdint>
 #include <iostream>
 #include <optional>
-#include <stack>
+#include <span>
 #include <tuple>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 #include "art_common.hpp"
 #include "art_internal.hpp"
 #include "art_internal_impl.hpp"
 #include "assert.hpp"
+#include "hazard_ptr.hpp"
 #include "node_type.hpp"
 #include "optimistic_lock.hpp"
 #include "portability_arch.hpp"
@@ -60,6 +63,10 @@ struct [[nodiscard]] olc_node_header {
 };
 static_assert(std::is_standard_layout_v<olc_node_header>);
 
+/// Default number of optimistic restarts a unodb::olc_db::get may take before
+/// falling back to write-locking its path.
+inline constexpr std::uint32_t default_read_restart_budget = 64;
+
 template <typename Key, typename Value>
 class olc_inode;
 
@@ -131,6 +138,81 @@ inline non_atomic_array<T> copy_atomic_to_nonatomic(T& atomic_array) noexcept {
   return result;
 }
 
+#ifdef UNODB_DETAIL_WITH_STATS
+
+/// Return the statistics counter stripe index of the current thread. The
+/// threads get consecutive indices in the order of their first calls, so that
+/// a few concurrent threads do not share a stripe.
+[[nodiscard]] inline std::size_t this_thread_stripe() noexcept {
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+  static constinit std::atomic<std::size_t> next_stripe{0};
+  static thread_local const auto stripe =
+      next_stripe.fetch_add(1, std::memory_order_relaxed);
+  return stripe;
+}
+
+/// A set of \a Count statistics counters, striped over cache lines. A thread
+/// always updates the counters in the same stripe, which it rarely shares with
+/// another thread, and the readers sum the stripes up.
+///
+/// A node may be freed by a different thread than the one that allocated it,
+/// thus a single stripe may go below zero, while the sum of all the stripes is
+/// still exact once the updates stop. The stripes are summed without a
+/// consistent snapshot, so a concurrent reader may see a decrement without the
+/// earlier increment it matches, on a stripe it has already summed. Such a
+/// transiently negative sum is returned as zero, so that a reader only ever
+/// sees a slightly stale value.
+template <std::size_t Count>
+class striped_counters final {
+ public:
+  /// The number of the stripes.
+  static constexpr std::size_t stripe_count = 16;
+
+  /// Add \a delta to \a counter.
+  void add(std::size_t counter, std::uint64_t delta) noexcept {
+    get_stripe().counters[counter].fetch_add(static_cast<std::int64_t>(delta),
+                                             std::memory_order_relaxed);
+  }
+
+  /// Subtract \a delta from \a counter.
+  void subtract(std::size_t counter, std::uint64_t delta) noexcept {
+    get_stripe().counters[counter].fetch_sub(static_cast<std::int64_t>(delta),
+                                             std::memory_order_relaxed);
+  }
+
+  /// Return the value of \a counter, or zero if the sum of its stripes is
+  /// transiently negative.
+  [[nodiscard]] std::uint64_t get(std::size_t counter) const noexcept {
+    std::int64_t result{0};
+    for (const auto& s : stripes)
+      result += s.counters[counter].load(std::memory_order_relaxed);
+    return result < 0 ? 0 : static_cast<std::uint64_t>(result);
+  }
+
+  /// Set \a counter to zero. Must not run concurrently with its updates.
+  void reset(std::size_t counter) noexcept {
+    for (auto& s : stripes)
+      s.counters[counter].store(0, std::memory_order_relaxed);
+  }
+
+ private:
+  /// The counters updated by a subset of the threads.
+  struct alignas(hardware_destructive_interference_size) stripe {
+    /// The counter contributions of these threads, possibly negative.
+    std::array<std::atomic<std::int64_t>, Count> counters{};
+  };
+
+  /// Return the stripe of the current thread.
+  [[nodiscard]] stripe& get_stripe() noexcept {
+    return stripes[this_thread_stripe() % stripe_count];
+  }
+
+  /// The stripes.
+  std::array<stripe, stripe_count> stripes{};
+};
+
+#endif  // UNODB_DETAIL_WITH_STATS
+
 template <typename Key, typename Value>
 using olc_leaf_unique_ptr =
     basic_db_leaf_unique_ptr<Key, Value, olc_node_header, olc_db>;
@@ -165,7 +247,7 @@ class olc_db final {
   using art_key_type = detail::basic_art_key<Key>;
 
   /// Query for a value associated with an encoded key.
-  [[nodiscard, gnu::pure]] get_result get_internal(
+  [[nodiscard]] get_result get_internal(
       art_key_type search_key) const noexcept;
 
   /// Insert a value under an encoded key iff there is no entry for
@@ -185,27 +267,137 @@ class olc_db final {
 
  public:
   // Creation and destruction
-  olc_db() noexcept = default;
+
+  /// Create an empty tree, reclaiming its memory in the default QSBR domain.
+  olc_db() noexcept : olc_db{qsbr::instance()} {}
+
+  /// Create an empty tree, reclaiming its memory in the QSBR \a domain, which
+  /// must outlive it. The threads accessing the tree must be registered with
+  /// the domain and pass through its quiescent states.
+  explicit olc_db(qsbr& domain UNODB_DETAIL_LIFETIMEBOUND) noexcept
+      : qsbr_domain{domain} {}
+
+  /// Create an empty tree reclaiming the memory of its removed nodes with
+  /// hazard pointers instead of QSBR, so that a long-running reader only holds
+  /// back the nodes it is on, see hazard_ptr.hpp.
+  ///
+  /// A value returned by get() then stays valid until the next get() of the
+  /// thread on a tree in this mode, a value seen by a scan visitor until the
+  /// scan moves on, and a batch delivered by scan_batched() until the next
+  /// one. The writes do not resume from the paths remembered by the previous
+  /// operations, as the nodes on them may have been freed. The threads must
+  /// still be registered with the default QSBR domain, which checks the value
+  /// views in debug builds, but they need not pass through quiescent states
+  /// for this tree.
+  explicit olc_db(hazard_pointer_reclamation_t) noexcept
+      : qsbr_domain{qsbr::instance()}, hazard_pointer_mode{true} {}
 
   ~olc_db() noexcept;
 
+  /// Get the QSBR domain reclaiming the memory of this tree.
+  [[nodiscard]] qsbr& get_qsbr_domain() const noexcept { return qsbr_domain; }
+
+  /// Return true iff the tree reclaims its memory with hazard pointers.
+  [[nodiscard]] bool uses_hazard_pointers() const noexcept {
+    return hazard_pointer_mode;
+  }
+
   /// Query for a value associated with a key.
   ///
   /// \param search_key If Key is a simple primitive type, then it is converted
   /// into a binary comparable key.  If Key is unodb::key_view, then it is
   /// assumed to already be a binary comparable key, e.g., as produced by
   /// unodb::key_encoder.
-  [[nodiscard, gnu::pure]] get_result get(Key search_key) const noexcept {
+  [[nodiscard]] get_result get(Key search_key) const noexcept {
     const auto k = art_key_type{search_key};
     return get_internal(k);
   }
 
+  /// An optimistic read of several keys giving a consistent view of them, such
+  /// as of a row and its index entries.
+  ///
+  /// Each get() records the version of the node which decided its result: the
+  /// parent of the leaf found or of the mismatching leaf, or the inode where
+  /// the search ended. No locks are held between the calls. try_commit() then
+  /// checks all the recorded versions, and if none has changed, all the
+  /// results held at once, at the time of the first check.
+  ///
+  /// \note The thread must neither pass through a quiescent state nor write to
+  /// the tree between the first get() and try_commit(), as the recorded nodes
+  /// and the returned values are only protected until then, and the writes of
+  /// the only QSBR thread free the nodes at once. In the hazard pointer mode,
+  /// each get() protects its nodes in two hazard pointer slots of its own
+  /// until reset() or the destruction instead.
+  class read_transaction final {
+   public:
+    /// Start an empty transaction on \a db.
+    explicit read_transaction(const olc_db& db) noexcept : db_{db} {}
+
+    /// Query for a value associated with a key, as olc_db::get() does. Unlike
+    /// it, this never falls back to locking the path, as the locks would
+    /// change the versions this depends on.
+    [[nodiscard]] get_result get(Key search_key);
+
+    /// Check that no result returned by get() since the construction or the
+    /// last reset() has been changed by a concurrent write.
+    ///
+    /// \return false if the results must be discarded and read again.
+    [[nodiscard]] bool try_commit() const noexcept;
+
+    /// Forget the results read so far, to start a new attempt.
+    void reset() noexcept {
+      read_set.clear();
+      hazards.release();
+    }
+
+   private:
+    friend class olc_db;
+
+    /// A lock and its version as seen by a get().
+    struct read_set_entry {
+      optimistic_lock* lock;
+      version_tag_type version;
+    };
+
+    const olc_db& db_;
+
+    /// The dependencies of the results read so far.
+    detail::iterator_stack<read_set_entry, 16, true> read_set{};
+
+    /// The hazard pointer slots protecting them and the results, two per
+    /// get().
+    hazard_pointer_slots hazards;
+  };
+
+  /// Call \a fn with a read_transaction until its results are consistent.
+  ///
+  /// \param fn A function `f(read_transaction&)`, which reads the keys with
+  /// read_transaction::get() and keeps the results. It is called again,
+  /// after a backoff, whenever the commit fails, thus it should only keep the
+  /// results of the last call.
+  template <typename FN>
+  void read_consistent(FN fn) const {
+    read_transaction transaction{*this};
+    spin_wait_backoff backoff;
+    while (true) {
+      fn(transaction);
+      if (UNODB_DETAIL_LIKELY(transaction.try_commit())) return;
+      transaction.reset();
+      backoff();
+    }
+  }
+
   /// Return true iff the tree is empty (no root leaf).
   [[nodiscard]] auto empty() const noexcept { return root == nullptr; }
 
   /// Insert a value under a binary comparable key iff there is no entry for
   /// that key.
   ///
+  /// For the fixed-width keys, the tree remembers the write path entry of the
+  /// deepest inode reached by the insert of its greatest key, and an insert of
+  /// a greater key starts from there if the parent version of that inode is
+  /// still current, instead of from the root.
+  ///
   /// \note Cannot be called during stack unwinding with
   /// `std::uncaught_exceptions() > 0`.
   ///
@@ -230,6 +422,22 @@ class olc_db final {
     return insert_internal(k, v);
   }
 
+  /// Insert the key value pairs of \a batch, skipping the keys already
+  /// present.
+  ///
+  /// The path of the last insert is kept, and the next insert resumes from the
+  /// deepest node on it whose parent version is still current and which is
+  /// still on its own key path, instead of taking the read locks from the root
+  /// down again. Batches sorted by key, whose consecutive keys share most of
+  /// their paths, thus skip most of the descents. Unsorted batches are
+  /// inserted correctly too, only without the speedup.
+  ///
+  /// \note The calling thread does not pass through a quiescent state during
+  /// the batch, thus long batches delay the memory reclamation.
+  ///
+  /// \return the number of inserted pairs.
+  std::size_t insert_batch(std::span<const std::pair<Key, value_type>> batch);
+
   /// Remove the entry associated with the key.
   ///
   /// \param search_key If Key is a simple primitive type, then it is converted
@@ -249,6 +457,42 @@ class olc_db final {
   /// \note Only legal in single-threaded context, as destructor
   void clear() noexcept;
 
+  /// Set the number of children, ahead of the one being visited, which the
+  /// scans prefetch from each internal node on their path. Larger distances
+  /// hide more memory latency on large trees at the cost of useless loads
+  /// near the scan end. Zero disables prefetching.
+  void set_scan_prefetch_distance(std::uint8_t distance) noexcept {
+    scan_prefetch_distance.store(distance, std::memory_order_relaxed);
+  }
+
+  /// Return the scan prefetch distance.
+  [[nodiscard]] std::uint8_t get_scan_prefetch_distance() const noexcept {
+    return scan_prefetch_distance.load(std::memory_order_relaxed);
+  }
+
+  /// Set the number of optimistic restarts a get() may take before it
+  /// write-locks the node whose read failed instead of restarting from the
+  /// root, bounding its latency under write contention. Zero makes every get()
+  /// take that path, which locks no node without contention.
+  void set_read_restart_budget(std::uint32_t budget) noexcept {
+    read_restart_budget.store(budget, std::memory_order_relaxed);
+  }
+
+  /// Return the read restart budget.
+  [[nodiscard]] std::uint32_t get_read_restart_budget() const noexcept {
+    return read_restart_budget.load(std::memory_order_relaxed);
+  }
+
+  /// A key and value pair delivered by scan_batched(). Like the visitor of the
+  /// other scans, it refers to the leaf data, which stays valid until the next
+  /// quiescent state even if the leaf is removed concurrently.
+  struct scan_batch_entry {
+    /// The binary comparable key.
+    key_view key;
+    /// The value.
+    qsbr_value_view value;
+  };
+
   //
   // iterator (the iterator is an internal API, the public API is scan()).
   //
@@ -287,8 +531,10 @@ class olc_db final {
   /// had read until it verifies that the version tag remained unchanged across
   /// the read operation.
   ///
-  /// \note The iterator is backed by a std::stack. This means that the iterator
-  /// methods accessing the stack can not be declared as \c noexcept.
+  /// \note The iterator is backed by a detail::iterator_stack, which does not
+  /// allocate for fixed-width keys. For unodb::key_view keys, deep paths spill
+  /// to the heap, so the stack push methods are only \c noexcept for
+  /// fixed-width keys.
   class iterator {
     friend class olc_db<Key, Value>;
     template <class>
@@ -309,6 +555,9 @@ class olc_db final {
       version_tag_type version;
     };
 
+    /// True iff pushing onto the stack may allocate.
+    static constexpr bool growable_stack = std::is_same_v<Key, key_view>;
+
    protected:
     /// Construct an empty iterator (one that is logically not
     /// positioned on anything and which will report !valid()).
@@ -383,13 +632,9 @@ class olc_db final {
       os << "keybuf=";
       detail::dump_key(os, keybuf_.get_key_view());
       os << "\n";
-      // Create a new stack and copy everything there.  Using the new
-      // stack, print out the stack in top-bottom order.  This avoids
-      // modifications to the existing stack for the iterator.
-      auto tmp = stack_;
-      auto level = tmp.size() - 1;
-      while (!tmp.empty()) {
-        const auto& e = tmp.top();
+      // Print out the stack in top-bottom order.
+      for (auto level = stack_.size(); level-- > 0;) {
+        const auto& e = stack_[level];
         const auto& np = e.node;
         os << "iter::stack:: level = " << level << ", key_byte=0x" << std::hex
            << std::setfill('0') << std::setw(2)
@@ -403,8 +648,6 @@ class olc_db final {
         os << ", ";
         art_policy::dump_node(os, np, false /*recursive*/);  // node or leaf.
         if (np.type() != node_type::LEAF) os << '\n';
-        tmp.pop();
-        level--;
       }
     }
     // LCOV_EXCL_STOP
@@ -434,7 +677,8 @@ class olc_db final {
     /// Push an entry onto the stack.
     bool try_push(detail::olc_node_ptr node, std::byte key_byte,
                   std::uint8_t child_index, detail::key_prefix_snapshot prefix,
-                  const optimistic_lock::read_critical_section& rcs) {
+                  const optimistic_lock::read_critical_section& rcs) noexcept(
+        !growable_stack) {
       // For variable length keys we need to know the number of bytes
       // associated with the node's key_prefix.  In addition there is
       // one byte for the descent to the child node along the
@@ -450,7 +694,8 @@ class olc_db final {
 
     /// Push a leaf onto the stack.
     bool try_push_leaf(detail::olc_node_ptr aleaf,
-                       const optimistic_lock::read_critical_section& rcs) {
+                       const optimistic_lock::read_critical_section& rcs) noexcept(
+        !growable_stack) {
       // The [key], [child_index] and [prefix] are ignored for a leaf.
       stack_.push({{aleaf,
                     static_cast<std::byte>(0xFFU),     // key_byte
@@ -498,11 +743,53 @@ class olc_db final {
     }
 
    private:
+    /// In the hazard pointer mode, protect \a node, just loaded and to be
+    /// validated by a version check of its parent, in the slot of the stack
+    /// \a depth it is or is about to be pushed at. Each node on the stack stays
+    /// protected by its slot until popped, as the slot is only reused for the
+    /// nodes pushed after that.
+    void protect(std::size_t depth, detail::olc_node_ptr node) {
+      if (db_.hazard_pointer_mode)
+        hazards_.protect(depth, node.ptr<const void*>());
+    }
+
+    /// Return \a key of the current leaf, copied into the iterator if it
+    /// refers to the leaf memory, which may be freed once the iterator moves
+    /// off the leaf in the hazard pointer mode.
+    [[nodiscard]] art_key_type stable_key(art_key_type key) {
+      if constexpr (std::is_same_v<Key, key_view>) {
+        if (db_.hazard_pointer_mode) {
+          const auto view = key.get_key_view();
+          saved_key_.assign(view.begin(), view.end());
+          return art_key_type{key_view{saved_key_.data(), saved_key_.size()}};
+        }
+      }
+      return key;
+    }
+
+    /// Prefetch the children of \a inode following the one at \a child_index
+    /// in the scan direction. Upon descending into \a inode, this prefetches
+    /// the whole window of the scan prefetch distance. Upon advancing within
+    /// it, only the child entering the window is prefetched.
+    template <class INode>
+    void prefetch_ahead(INode* inode, node_type type,
+                        std::uint8_t child_index, bool fwd,
+                        bool descending) const noexcept {
+      const auto distance = db_.get_scan_prefetch_distance();
+      if (distance == 0) return;
+      if (descending) {
+        inode->prefetch_children(type, child_index, fwd, 0, distance);
+      } else {
+        inode->prefetch_children(type, child_index, fwd,
+                                 static_cast<std::uint8_t>(distance - 1), 1);
+      }
+    }
+
     /// Invalidate the iterator (pops everything off of the stack).
     ///
     /// post-condition: The iterator is !valid().
     iterator& invalidate() noexcept {
-      while (!stack_.empty()) stack_.pop();  // clear the stack
+      stack_.clear();  // clear the stack
       return *this;
     }
 
@@ -532,6 +819,33 @@ class olc_db final {
     /// Core logic invoked from retry loop.
     [[nodiscard]] bool try_seek(art_key_type search_key, bool& match, bool fwd);
 
+    /// Copy the current leaf and the leaves which follow it as the next
+    /// children of the same parent into \a run, stopping at the first inode
+    /// child, at the first key not less than \a to_key, or when \a run is
+    /// full. The children are read under a single read critical section on the
+    /// parent, which is checked once for all of them. If the check fails, only
+    /// the current leaf is copied. The iterator is then moved past the copied
+    /// leaves, as next() would from the last one, unless the run ended at
+    /// \a to_key, in which case it is invalidated. In the hazard pointer mode,
+    /// the copied leaves stay protected until the next call.
+    ///
+    /// \pre The iterator is valid() and positioned before \a to_key.
+    ///
+    /// \return the number of copied entries, at least one.
+    [[nodiscard]] std::size_t collect_leaf_run(
+        art_key_type to_key, std::span<scan_batch_entry> run);
+
+    /// Replace the current leaf and its parent entry on the stack with the
+    /// parent entry \a parent_entry for another child \a leaf of the same
+    /// parent, read under \a parent_critical_section, and that leaf.
+    ///
+    /// \return false if the stack could not be updated, leaving it partially
+    /// updated.
+    [[nodiscard]] bool try_move_to_leaf(
+        const typename inode_base::iter_result& parent_entry,
+        detail::olc_node_ptr leaf,
+        const optimistic_lock::read_critical_section& parent_critical_section);
+
     /// The outer db instance.
     olc_db& db_;
 
@@ -539,7 +853,9 @@ class olc_db final {
     /// to the current leaf.  An empty stack corresponds to a
     /// logically empty iterator and can be detected using !valid().
     /// The iterator for an empty tree is an empty stack.
-    std::stack<stack_entry> stack_{};
+    detail::iterator_stack<stack_entry, detail::iterator_stack_capacity<Key>,
+                           growable_stack>
+        stack_{};
 
     /// A buffer into which visited encoded (binary comparable) keys
     /// are materialized by during the iterator traversal.  Bytes are
@@ -547,12 +863,27 @@ class olc_db final {
     /// iterator stack and popped off of this buffer when we pop
     /// something off of the iterator stack.
     detail::key_buffer keybuf_{};
+
+    /// In the hazard pointer mode, the slots protecting the nodes on the
+    /// stack, indexed by their depth.
+    hazard_pointer_slots hazards_;
+
+    /// In the hazard pointer mode, the slots protecting the leaves of the last
+    /// collect_leaf_run() batch, its first leaf first.
+    hazard_pointer_slots batch_hazards_;
+
+    /// The copy of the key of the leaf being moved off, see stable_key().
+    std::vector<std::byte> saved_key_;
   };  // class iterator
 
   //
   // end of the iterator API, which is an internal API.
   //
 
+  /// The maximum number of entries scan_batched() delivers at once, which is
+  /// the maximum fanout of an inode.
+  static constexpr std::size_t scan_batch_capacity = 256;
+
  public:
   ///
   /// public scan API
@@ -695,6 +1026,42 @@ class olc_db final {
     }
   }
 
+  /// Scan the half-open key range `[from_key,to_key)` in forward order,
+  /// delivering the entries to the caller's lambda in batches.
+  ///
+  /// A batch is a run of consecutive leaves under the same parent inode, read
+  /// under a single read critical section on that parent and validated once,
+  /// instead of validating the path on every step as the other scans do.
+  /// Under concurrent writes, the batches have the same per-entry semantics as
+  /// scan_range() does.
+  ///
+  /// \param from_key is an inclusive bound for the starting point of the scan.
+  ///
+  /// \param to_key is an exclusive bound for the ending point of the scan. The
+  /// scan visits nothing unless \a from_key is less than \a to_key.
+  ///
+  /// \param fn A function `f(std::span<const scan_batch_entry>)` returning
+  /// `bool`.  The batches are never empty and hold at most
+  /// scan_batch_capacity entries.  The traversal will halt if the function
+  /// returns \c true.
+  template <typename FN>
+  void scan_batched(Key from_key, Key to_key, FN fn) {
+    const auto from_key_ = art_key_type{from_key};  // convert to internal key
+    const auto to_key_ = art_key_type{to_key};      // convert to internal key
+    if (from_key_.cmp(to_key_) >= 0) return;
+    std::array<scan_batch_entry, scan_batch_capacity> batch;
+    bool match{};
+    iterator it(*this);
+    it.seek(from_key_, match, true /*fwd*/);
+    // collect_leaf_run() moves the iterator past the batch, or invalidates it
+    while (it.valid() && it.cmp(to_key_) < 0) {
+      const auto batch_size = it.collect_leaf_run(to_key_, batch);
+      if (UNODB_DETAIL_UNLIKELY(
+              fn(std::span<const scan_batch_entry>{batch.data(), batch_size})))
+        break;
+    }
+  }
+
   //
   // TEST ONLY METHODS
   //
@@ -708,42 +1075,51 @@ class olc_db final {
 
   // Return current memory use by tree nodes in bytes
   [[nodiscard]] std::size_t get_current_memory_use() const noexcept {
-    return current_memory_use.load(std::memory_order_relaxed);
+    return stats.get(memory_use_stat);
   }
 
   template <node_type NodeType>
   [[nodiscard]] std::uint64_t get_node_count() const noexcept {
-    return node_counts[as_i<NodeType>].load(std::memory_order_relaxed);
+    return stats.get(node_count_stats + as_i<NodeType>);
   }
 
   [[nodiscard]] node_type_counter_array get_node_counts() const noexcept {
-    return detail::copy_atomic_to_nonatomic(node_counts);
+    return get_stat_array<node_type_counter_array>(node_count_stats);
   }
 
   template <node_type NodeType>
   [[nodiscard]] std::uint64_t get_growing_inode_count() const noexcept {
-    return growing_inode_counts[internal_as_i<NodeType>].load(
-        std::memory_order_relaxed);
+    return stats.get(growing_inode_stats + internal_as_i<NodeType>);
   }
 
   [[nodiscard]] inode_type_counter_array get_growing_inode_counts()
       const noexcept {
-    return detail::copy_atomic_to_nonatomic(growing_inode_counts);
+    return get_stat_array<inode_type_counter_array>(growing_inode_stats);
   }
 
   template <node_type NodeType>
   [[nodiscard]] std::uint64_t get_shrinking_inode_count() const noexcept {
-    return shrinking_inode_counts[internal_as_i<NodeType>].load(
-        std::memory_order_relaxed);
+    return stats.get(shrinking_inode_stats + internal_as_i<NodeType>);
   }
 
   [[nodiscard]] inode_type_counter_array get_shrinking_inode_counts()
       const noexcept {
-    return detail::copy_atomic_to_nonatomic(shrinking_inode_counts);
+    return get_stat_array<inode_type_counter_array>(shrinking_inode_stats);
   }
 
   [[nodiscard]] std::uint64_t get_key_prefix_splits() const noexcept {
-    return key_prefix_splits.load(std::memory_order_relaxed);
+    return stats.get(key_prefix_split_stat);
+  }
+
+  /// Return the number of optimistic get() attempts that had to restart.
+  [[nodiscard]] std::uint64_t get_read_restarts() const noexcept {
+    return stats.get(read_restart_stat);
+  }
+
+  /// Return the number of get() calls that exhausted the restart budget and
+  /// write-locked their path.
+  [[nodiscard]] std::uint64_t get_pessimistic_reads() const noexcept {
+    return stats.get(pessimistic_read_stat);
   }
 
 #endif  // UNODB_DETAIL_WITH_STATS
@@ -779,31 +1155,149 @@ class olc_db final {
 
   using try_update_result_type = std::optional<bool>;
 
-  [[nodiscard]] try_get_result_type try_get(art_key_type k) const noexcept;
+  /// A node visited by a write operation, recorded so that a failed attempt
+  /// may resume from the deepest ancestor whose version is still current
+  /// instead of from the root.  The entry holds the version of the parent at
+  /// the time the node was read from its slot in the parent, and the depth of
+  /// the node, which is all that is needed to resume the search of any key
+  /// sharing that many leading bytes with the recorded one.
+  struct write_path_entry {
+    /// The lock of the parent, or the root pointer lock.
+    optimistic_lock* parent_lock;
+    /// The parent version under which the node was read.
+    version_tag_type parent_version;
+    /// The slot of the node in the parent.
+    in_critical_section<detail::olc_node_ptr>* node_in_parent;
+    /// The depth of the node.
+    tree_depth_type depth;
+  };
+
+  /// The path of a write operation, root first.
+  using write_path =
+      detail::iterator_stack<write_path_entry,
+                             detail::iterator_stack_capacity<Key>,
+                             std::is_same_v<Key, key_view>>;
+
+  /// Pop the \a path entries whose parents have changed since they were
+  /// pushed and read-lock the parent of the deepest remaining one into \a
+  /// parent_critical_section.
+  ///
+  /// \return false if no entry is valid and the operation must start from the
+  /// root.
+  [[nodiscard]] static bool resume_write_path(
+      write_path& path,
+      optimistic_lock::read_critical_section& parent_critical_section) noexcept;
+
+  using read_set_entry = typename read_transaction::read_set_entry;
+
+  /// The hazard pointer slots of get().
+  static constexpr std::array<std::size_t, 2> get_hazard_slots{
+      hazard_pointer_thread::rotating_slot_count,
+      hazard_pointer_thread::rotating_slot_count + 1};
+
+  /// Search for \a k once. If \a dependency is not \c nullptr and the search
+  /// did not restart, store into it the lock and the version deciding the
+  /// result. In the hazard pointer mode, protect the visited nodes alternately
+  /// in the two \a hazard_slots, which leaves the result leaf and its parent
+  /// protected.
+  [[nodiscard]] try_get_result_type try_get(
+      art_key_type k, read_set_entry* dependency = nullptr,
+      const std::array<std::size_t, 2>& hazard_slots = get_hazard_slots)
+      const noexcept;
+
+  /// Search for \a k, write-locking for a single step only the node whose
+  /// optimistic read failed, instead of restarting from the root. Used once
+  /// try_get() has exhausted the restart budget.
+  [[nodiscard]] get_result get_pessimistic(art_key_type k) const noexcept;
 
   [[nodiscard]] try_update_result_type try_insert(
-      art_key_type k, value_type v, olc_db_leaf_unique_ptr_type& cached_leaf);
+      art_key_type k, value_type v, olc_db_leaf_unique_ptr_type& cached_leaf,
+      write_path& path);
+
+  [[nodiscard]] try_update_result_type try_remove(art_key_type k,
+                                                  write_path& path);
+
+  /// Whether the tree maintains rightmost_hint, which keeps the binary
+  /// comparable hinted key as a std::uint64_t, thus only for such keys.
+  static constexpr bool caches_rightmost_path =
+      std::is_same_v<Key, std::uint64_t>;
+
+  /// Return the art key for the binary comparable \a key of rightmost_hint.
+  [[nodiscard]] static art_key_type make_hinted_key(
+      std::uint64_t key) noexcept {
+    if constexpr (caches_rightmost_path) {
+      art_key_type result{Key{}};
+      result.key = key;
+      return result;
+    } else {
+      UNODB_DETAIL_CANNOT_HAPPEN();
+    }
+  }
+
+  /// Push the rightmost_hint entry onto the empty \a path if \a k is greater
+  /// than the hinted key and shares with it the bytes leading to the entry.
+  void seed_from_rightmost_hint(art_key_type k, write_path& path) noexcept;
 
-  [[nodiscard]] try_update_result_type try_remove(art_key_type k);
+  /// Point rightmost_hint at the deepest still valid entry of the \a path of
+  /// a successful insert of \a k, unless it holds a greater key already.
+  void update_rightmost_hint(art_key_type k, write_path& path) noexcept;
+
+  /// Clear rightmost_hint if its parent lock is \a node_lock of an inode that
+  /// has been obsoleted and is about to be retired. Only writes the hint if it
+  /// does point to the inode.
+  void forget_rightmost_hint(const optimistic_lock& node_lock) noexcept;
+
+  /// In the hazard pointer mode, protect \a node, just loaded by a write and
+  /// to be validated by a version check of its parent, in the next rotating
+  /// slot of the thread. The parent and the grandparent stay protected.
+  void protect_for_write(detail::olc_node_ptr node) const noexcept {
+    if (hazard_pointer_mode) {
+      hazard_pointer_thread::current().protect_next(
+          node.ptr<const void*>());
+    }
+  }
 
   void delete_root_subtree() noexcept;
 
 #ifdef UNODB_DETAIL_WITH_STATS
+  // The indices of the statistics counters in [stats]
+  static constexpr std::size_t memory_use_stat = 0;
+  static constexpr std::size_t key_prefix_split_stat = 1;
+  static constexpr std::size_t read_restart_stat = 2;
+  static constexpr std::size_t pessimistic_read_stat = 3;
+  // The first of the node_type_count node counters
+  static constexpr std::size_t node_count_stats = 4;
+  // The first of the inode_type_count growing inode counters
+  static constexpr std::size_t growing_inode_stats =
+      node_count_stats + detail::node_type_count;
+  // The first of the inode_type_count shrinking inode counters
+  static constexpr std::size_t shrinking_inode_stats =
+      growing_inode_stats + detail::inode_type_count;
+  static constexpr std::size_t stat_count =
+      shrinking_inode_stats + detail::inode_type_count;
+
+  template <class Array>
+  [[nodiscard]] Array get_stat_array(std::size_t first) const noexcept {
+    UNODB_DETAIL_DISABLE_MSVC_WARNING(26494)
+    Array result;
+    UNODB_DETAIL_RESTORE_MSVC_WARNINGS()
+
+    for (typename Array::size_type i = 0; i < result.size(); ++i)
+      result[i] = stats.get(first + i);
+    return result;
+  }
+
   void increase_memory_use(std::size_t delta) noexcept;
   void decrease_memory_use(std::size_t delta) noexcept;
 
   void increment_leaf_count(std::size_t leaf_size) noexcept {
     increase_memory_use(leaf_size);
-    node_counts[as_i<node_type::LEAF>].fetch_add(1, std::memory_order_relaxed);
+    stats.add(node_count_stats + as_i<node_type::LEAF>, 1);
   }
 
   void decrement_leaf_count(std::size_t leaf_size) noexcept {
     decrease_memory_use(leaf_size);
-
-    const auto old_leaf_count UNODB_DETAIL_USED_IN_DEBUG =
-        node_counts[as_i<node_type::LEAF>].fetch_sub(1,
-                                                     std::memory_order_relaxed);
-    UNODB_DETAIL_ASSERT(old_leaf_count > 0);
+    stats.subtract(node_count_stats + as_i<node_type::LEAF>, 1);
   }
 
   template <class INode>
@@ -831,28 +1325,54 @@ class olc_db final {
   static_assert(sizeof(root_pointer_lock) + sizeof(root) <=
                 detail::hardware_constructive_interference_size);
 
-#ifdef UNODB_DETAIL_WITH_STATS
-
-  // Current logically allocated memory that is not scheduled to be reclaimed.
-  // The total memory currently allocated is this plus the QSBR deallocation
-  // backlog (qsbr::previous_interval_total_dealloc_size +
-  // qsbr::current_interval_total_dealloc_size).
-  alignas(detail::hardware_destructive_interference_size)
-      std::atomic<std::size_t> current_memory_use{0};
+  /// The QSBR domain reclaiming the memory of this tree.
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-const-or-ref-data-members)
+  qsbr& qsbr_domain;
 
-  alignas(detail::hardware_destructive_interference_size)
-      std::atomic<std::uint64_t> key_prefix_splits{0};
+  /// Whether the removed nodes are reclaimed with hazard pointers.
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-const-or-ref-data-members)
+  const bool hazard_pointer_mode{false};
+
+  /// The number of following children the scans prefetch.
+  std::atomic<std::uint8_t> scan_prefetch_distance{
+      detail::default_scan_prefetch_distance};
+
+  /// The number of restarts after which get() write-locks its path.
+  std::atomic<std::uint32_t> read_restart_budget{
+      detail::default_read_restart_budget};
+
+  /// The write path entry of an inode on the path of the greatest key
+  /// inserted so far, and that key.  The fields are read and written under
+  /// the own lock of the hint.  The parent lock of the entry lives in a node
+  /// that is not retired before the hint stops pointing to it, because the
+  /// inode deleter clears the hint if it points to the node, see
+  /// forget_rightmost_hint().  Thus an entry read under a valid hint version
+  /// is safe to check until the next quiescent state.
+  struct alignas(detail::hardware_destructive_interference_size)
+      rightmost_hint_type {
+    optimistic_lock lock;
+    /// nullptr if there is no hint.
+    in_critical_section<optimistic_lock*> parent_lock{nullptr};
+    in_critical_section<version_tag_type> parent_version;
+    in_critical_section<in_critical_section<detail::olc_node_ptr>*>
+        node_in_parent;
+    in_critical_section<typename tree_depth_type::value_type> depth;
+    /// The binary comparable hinted key.
+    in_critical_section<std::uint64_t> key;
+  };
+
+  rightmost_hint_type rightmost_hint{};
 
-  template <class T>
-  using atomic_array = std::array<std::atomic<typename T::value_type>,
-                                  std::tuple_size<T>::value>;
+#ifdef UNODB_DETAIL_WITH_STATS
 
-  alignas(detail::hardware_destructive_interference_size)
-      atomic_array<node_type_counter_array> node_counts{};
-  alignas(detail::hardware_destructive_interference_size)
-      atomic_array<inode_type_counter_array> growing_inode_counts{};
-  alignas(detail::hardware_destructive_interference_size)
-      atomic_array<inode_type_counter_array> shrinking_inode_counts{};
+  // All the statistics counters, striped so that the concurrent writers do
+  // not bounce their cache lines. The memory use counter is the current
+  // logically allocated memory that is not scheduled to be reclaimed. The total
+  // memory currently allocated is this plus the QSBR deallocation backlog
+  // (qsbr::previous_interval_total_dealloc_size +
+  // qsbr::current_interval_total_dealloc_size). Mutable because the read
+  // restart counters are updated by the const get().
+  mutable detail::striped_counters<stat_count> stats;
 
 #endif  // UNODB_DETAIL_WITH_STATS
 
@@ -893,6 +1413,10 @@ template <typename Key, typename Value, class INode>
 using db_inode_qsbr_deleter_parent =
     unodb::detail::basic_db_inode_deleter<INode, unodb::olc_db<Key, Value>>;
 
+// The OLC nodes reclaimed by QSBR are kept on the per-thread free lists of
+// their node type, from which the next nodes of that type are allocated.
+static_assert(node_type_count <= qsbr_free_lists::list_count);
+
 template <typename Key, typename Value, class INode>
 class db_inode_qsbr_deleter
     : public db_inode_qsbr_deleter_parent<Key, Value, INode> {
@@ -903,21 +1427,39 @@ class db_inode_qsbr_deleter
   void operator()(INode* inode_ptr) {
     static_assert(std::is_trivially_destructible_v<INode>);
 
-    this_thread().on_next_epoch_deallocate(inode_ptr
-#ifdef UNODB_DETAIL_WITH_STATS
-                                           ,
-                                           sizeof(INode)
+    auto& tree = this->get_db();
+    if (tree.hazard_pointer_mode) {
+      hazard_pointer_thread::current().retire(inode_ptr
+#ifndef NDEBUG
+                                              ,
+                                              olc_node_header::check_on_dealloc
 #endif
+      );
+    } else {
+      tree.forget_rightmost_hint(inode_ptr->lock());
+      tree.get_qsbr_domain().current_thread().on_next_epoch_recycle(
+          inode_ptr, as_i<INode::type>, sizeof(INode)
 #ifndef NDEBUG
-                                               ,
-                                           olc_node_header::check_on_dealloc
+                                            ,
+          olc_node_header::check_on_dealloc
 #endif
-    );
+      );
+    }
 
 #ifdef UNODB_DETAIL_WITH_STATS
     this->get_db().template decrement_inode_count<INode>();
 #endif  // UNODB_DETAIL_WITH_STATS
   }
+
+  /// Allocate the memory of an internal node for \a db, reusing one
+  /// reclaimed by this thread in its QSBR domain if there is any.
+  [[nodiscard]] static void* allocate(olc_db<Key, Value>& db) {
+    auto* const recycled =
+        db.get_qsbr_domain().current_thread().take_free_block(
+            as_i<INode::type>, sizeof(INode));
+    if (UNODB_DETAIL_LIKELY(recycled != nullptr)) return recycled;
+    return db_inode_qsbr_deleter_parent<Key, Value, INode>::allocate(db);
+  }
 };
 
 template <class Db>
@@ -933,26 +1475,45 @@ class db_leaf_qsbr_deleter {
       : db_instance{db_} {}
 
   void operator()(leaf_type* to_delete) const {
-#ifdef UNODB_DETAIL_WITH_STATS
     const auto leaf_size = to_delete->get_size();
-#endif  // UNODB_DETAIL_WITH_STATS
 
-    this_thread().on_next_epoch_deallocate(to_delete
-#ifdef UNODB_DETAIL_WITH_STATS
-                                           ,
-                                           leaf_size
-#endif  // UNODB_DETAIL_WITH_STATS
+    // Shared with unodb::rowex_db, which has no hazard pointer mode
+    bool hazard_pointers{false};
+    if constexpr (requires { db_instance.uses_hazard_pointers(); })
+      hazard_pointers = db_instance.uses_hazard_pointers();
+
+    if (hazard_pointers) {
+      hazard_pointer_thread::current().retire(to_delete
 #ifndef NDEBUG
-                                           ,
-                                           olc_node_header::check_on_dealloc
+                                              ,
+                                              olc_node_header::check_on_dealloc
 #endif
-    );
+      );
+    } else {
+      db_instance.get_qsbr_domain().current_thread().on_next_epoch_recycle(
+          to_delete, as_i<node_type::LEAF>, leaf_size
+#ifndef NDEBUG
+          ,
+          olc_node_header::check_on_dealloc
+#endif
+      );
+    }
 
 #ifdef UNODB_DETAIL_WITH_STATS
     db_instance.decrement_leaf_count(leaf_size);
 #endif  // UNODB_DETAIL_WITH_STATS
   }
 
+  /// Allocate the memory of a leaf of \a size bytes for \a db, reusing one
+  /// reclaimed by this thread in its QSBR domain if there is any.
+  [[nodiscard]] static void* allocate(Db& db, std::size_t size) {
+    auto* const recycled =
+        db.get_qsbr_domain().current_thread().take_free_block(
+            as_i<node_type::LEAF>, size);
+    if (UNODB_DETAIL_LIKELY(recycled != nullptr)) return recycled;
+    return allocate_aligned(size, alignment_for_new<leaf_type>());
+  }
+
   ~db_leaf_qsbr_deleter() = default;
   db_leaf_qsbr_deleter(const db_leaf_qsbr_deleter&) = default;
   db_leaf_qsbr_deleter& operator=(const db_leaf_qsbr_deleter&) = delete;
@@ -1503,6 +2064,7 @@ template <typename Key, typename Value, class INode>
   }
 
   *child = found_child->load();
+  db_instance.protect_for_write(*child);
 
   if (UNODB_DETAIL_UNLIKELY(!node_critical_section.check())) return {};
 
@@ -1617,7 +2179,8 @@ template <typename Key, typename Value, class INode>
 template <typename Key, typename Value>
 olc_db<Key, Value>::~olc_db() noexcept {
   UNODB_DETAIL_ASSERT(
-      qsbr_state::single_thread_mode(qsbr::instance().get_state()));
+      hazard_pointer_mode ||
+      qsbr_state::single_thread_mode(qsbr_domain.get_state()));
 
   delete_root_subtree();
 }  // namespace >::~
@@ -1625,55 +2188,269 @@ olc_db<Key, Value>::~olc_db() noexcept {
 template <typename Key, typename Value>
 void olc_db<Key, Value>::delete_root_subtree() noexcept {
   UNODB_DETAIL_ASSERT(
-      qsbr_state::single_thread_mode(qsbr::instance().get_state()));
+      hazard_pointer_mode ||
+      qsbr_state::single_thread_mode(qsbr_domain.get_state()));
 
   if (root != nullptr) art_policy::delete_subtree(root, *this);
 
 #ifdef UNODB_DETAIL_WITH_STATS
   // It is possible to reset the counter to zero instead of decrementing it for
   // each leaf, but not sure the savings will be significant.
-  UNODB_DETAIL_ASSERT(
-      node_counts[as_i<node_type::LEAF>].load(std::memory_order_relaxed) == 0);
+  UNODB_DETAIL_ASSERT(get_node_count<node_type::LEAF>() == 0);
 #endif  // UNODB_DETAIL_WITH_STATS
 }
 
 template <typename Key, typename Value>
 void olc_db<Key, Value>::clear() noexcept {
   UNODB_DETAIL_ASSERT(
-      qsbr_state::single_thread_mode(qsbr::instance().get_state()));
+      hazard_pointer_mode ||
+      qsbr_state::single_thread_mode(qsbr_domain.get_state()));
 
   delete_root_subtree();
 
   root = detail::olc_node_ptr{nullptr};
+  rightmost_hint.parent_lock = nullptr;
 
 #ifdef UNODB_DETAIL_WITH_STATS
-  current_memory_use.store(0, std::memory_order_relaxed);
+  stats.reset(memory_use_stat);
 
-  node_counts[as_i<node_type::I4>].store(0, std::memory_order_relaxed);
-  node_counts[as_i<node_type::I16>].store(0, std::memory_order_relaxed);
-  node_counts[as_i<node_type::I48>].store(0, std::memory_order_relaxed);
-  node_counts[as_i<node_type::I256>].store(0, std::memory_order_relaxed);
+  stats.reset(node_count_stats + as_i<node_type::I4>);
+  stats.reset(node_count_stats + as_i<node_type::I16>);
+  stats.reset(node_count_stats + as_i<node_type::I48>);
+  stats.reset(node_count_stats + as_i<node_type::I256>);
 #endif  // UNODB_DETAIL_WITH_STATS
 }
 
 template <typename Key, typename Value>
 typename olc_db<Key, Value>::get_result olc_db<Key, Value>::get_internal(
     art_key_type k) const noexcept {
-  try_get_result_type result;
+  const auto budget = read_restart_budget.load(std::memory_order_relaxed);
+  std::uint32_t restarts = 0;
+  spin_wait_backoff backoff;
+
+  while (restarts < budget) {
+    const auto result = try_get(k);
+    if (UNODB_DETAIL_LIKELY(result.has_value())) {
+#ifdef UNODB_DETAIL_WITH_STATS
+      if (UNODB_DETAIL_UNLIKELY(restarts > 0))
+        stats.add(read_restart_stat, restarts);
+#endif  // UNODB_DETAIL_WITH_STATS
+      return *result;
+    }
+    ++restarts;
+    backoff();
+  }
+
+  // The optimistic attempts keep getting invalidated by the writers. Lock the
+  // contended node instead of restarting from the root, so that a reader on a
+  // hot path does not starve.
+#ifdef UNODB_DETAIL_WITH_STATS
+  if (restarts > 0) stats.add(read_restart_stat, restarts);
+  stats.add(pessimistic_read_stat, 1);
+#endif  // UNODB_DETAIL_WITH_STATS
+  return get_pessimistic(k);
+}
+
+template <typename Key, typename Value>
+typename olc_db<Key, Value>::get_result
+olc_db<Key, Value>::read_transaction::get(Key search_key) {
+  const auto k = art_key_type{search_key};
+  read_set_entry dependency;
+  auto hazard_slots = get_hazard_slots;
+  if (db_.hazard_pointer_mode) {
+    const auto first_slot = hazards.size();
+    hazards.reserve(first_slot + 2);
+    hazard_slots = {hazards[first_slot], hazards[first_slot + 1]};
+  }
+  spin_wait_backoff backoff;
 
   while (true) {
-    result = try_get(k);
-    if (result) break;
-    // TODO(laurynas): upgrade to write locks to prevent starving after a
-    // certain number of failures?
+    const auto result = db_.try_get(k, &dependency, hazard_slots);
+    if (UNODB_DETAIL_LIKELY(result.has_value())) {
+      // Consecutive keys under the same parent share their dependency
+      if (read_set.empty() || read_set.top().lock != dependency.lock ||
+          read_set.top().version != dependency.version)
+        read_set.push(dependency);
+      return *result;
+    }
+    backoff();
   }
+}
 
-  return *result;
+template <typename Key, typename Value>
+bool olc_db<Key, Value>::read_transaction::try_commit() const noexcept {
+  for (std::size_t i = 0; i < read_set.size(); ++i) {
+    const auto& e = read_set[i];
+    if (UNODB_DETAIL_UNLIKELY(
+            !e.lock->rehydrate_read_lock(e.version).try_read_unlock()))
+      return false;
+  }
+  return true;
+}
+
+namespace detail {
+
+/// Write-lock \a lock into \a guard, waiting for any concurrent writer to
+/// finish.
+///
+/// \return false if \a lock is obsolete.
+[[nodiscard]] inline bool olc_write_lock_wait(
+    optimistic_lock& lock,
+    std::optional<optimistic_lock::write_guard>& guard) noexcept {
+  spin_wait_backoff backoff;
+  while (true) {
+    auto critical_section = lock.try_read_lock();
+    if (UNODB_DETAIL_UNLIKELY(critical_section.must_restart()))
+      return false;  // LCOV_EXCL_LINE
+    guard.emplace(std::move(critical_section));
+    if (UNODB_DETAIL_LIKELY(!guard->must_restart())) return true;
+    // LCOV_EXCL_START
+    guard.reset();
+    backoff.wait_for_lock();
+    // LCOV_EXCL_STOP
+  }
 }
 
+}  // namespace detail
+
 template <typename Key, typename Value>
-typename olc_db<Key, Value>::try_get_result_type olc_db<Key, Value>::try_get(
+typename olc_db<Key, Value>::get_result olc_db<Key, Value>::get_pessimistic(
     art_key_type k) const noexcept {
+  // As try_get(), except that a node whose read is invalidated is write-locked
+  // and read again instead of restarting from the root. A write-locked node
+  // keeps its children from being replaced or obsoleted, thus the lock is held
+  // only until its child is read-locked. An obsolete node has been replaced
+  // under its parent, which is locked and read again in turn, and the search
+  // restarts from the root only if the parent is obsolete too. At most one
+  // node is locked at a time, and writers do not wait on locks while holding
+  // others, thus this cannot deadlock with them.
+  struct path_node {
+    detail::olc_node_ptr node;  ///< nullptr for the root pointer
+    optimistic_lock* lock;      ///< nullptr for an unknown node
+    art_key_type key;           ///< The remaining key at the node
+  };
+  const path_node root_pointer{detail::olc_node_ptr{nullptr},
+                               &root_pointer_lock, k};
+
+  // The last three nodes stay protected: the current one, its parent, and the
+  // child being validated.
+  auto* const hazards =
+      hazard_pointer_mode ? &hazard_pointer_thread::current() : nullptr;
+  const auto protect = [hazards](detail::olc_node_ptr n) noexcept {
+    if (hazards != nullptr) hazards->protect_next(n.ptr<const void*>());
+  };
+
+  path_node parent{root_pointer.node, nullptr, k};
+  path_node current{root_pointer};
+  auto critical_section = root_pointer_lock.try_read_lock();
+  UNODB_DETAIL_ASSERT(!critical_section.must_restart());
+  std::optional<optimistic_lock::write_guard> guard;
+
+  while (true) {
+    get_result result{};
+    detail::olc_node_ptr child{nullptr};
+    auto child_key{current.key};
+
+    if (current.lock == &root_pointer_lock) {
+      child = root.load();
+    } else if (current.node.type() == node_type::LEAF) {
+      const auto* const leaf{current.node.template ptr<leaf_type*>()};
+      if (leaf->matches(k))
+        result = qsbr_ptr_span<const std::byte>{leaf->get_value_view()};
+    } else {
+      const auto node_type = current.node.type();
+      auto* const inode{current.node.template ptr<inode_type*>()};
+      const auto& key_prefix{inode->get_key_prefix()};
+      const auto key_prefix_length{key_prefix.length()};
+      if (key_prefix.get_shared_length(child_key) >= key_prefix_length) {
+        child_key.shift_right(key_prefix_length);
+        const auto* const child_in_parent{
+            inode->find_child(node_type, child_key[0]).second};
+        if (child_in_parent != nullptr) {
+          child = child_in_parent->load();
+          child_key.shift_right(1);
+        }
+      }
+    }
+
+    // Validate the reads of the current node, read-locking the child first
+    optimistic_lock::read_critical_section child_critical_section;
+    bool child_locked = false;
+    bool valid = true;
+    if (child != nullptr) {
+      protect(child);
+      // A check() is required before acting on the child by taking its lock
+      valid = guard.has_value() || critical_section.check();
+      if (UNODB_DETAIL_LIKELY(valid)) {
+        child_critical_section = node_ptr_lock(child).try_read_lock();
+        child_locked = !child_critical_section.must_restart();
+        valid = child_locked;
+        UNODB_DETAIL_ASSERT(valid || !guard.has_value());
+      }
+    }
+    if (guard.has_value()) {
+      guard.reset();
+    } else if (valid) {
+      valid = critical_section.try_read_unlock();
+    }
+
+    if (UNODB_DETAIL_LIKELY(valid)) {
+      if (child == nullptr) {
+        if (hazards != nullptr && result.has_value())
+          hazards->protect(get_hazard_slots[0],
+                           current.node.template ptr<const void*>());
+        return result;
+      }
+      parent = current;
+      current = {child, &node_ptr_lock(child), child_key};
+      critical_section = std::move(child_critical_section);
+      continue;
+    }
+
+    if (child_locked) std::ignore = child_critical_section.try_read_unlock();
+    // Read the current node again under its lock
+    if (UNODB_DETAIL_LIKELY(detail::olc_write_lock_wait(*current.lock, guard)))
+      continue;
+    // LCOV_EXCL_START
+    // It has been replaced, read its parent again under its lock, or the root
+    // pointer if the parent is unknown or obsolete too
+    if (parent.lock != nullptr &&
+        detail::olc_write_lock_wait(*parent.lock, guard)) {
+      current = parent;
+      protect(current.node);
+    } else {
+      current = root_pointer;
+      const auto root_locked UNODB_DETAIL_USED_IN_DEBUG =
+          detail::olc_write_lock_wait(root_pointer_lock, guard);
+      UNODB_DETAIL_ASSERT(root_locked);
+    }
+    parent.lock = nullptr;
+    // LCOV_EXCL_STOP
+  }
+}
+
+template <typename Key, typename Value>
+typename olc_db<Key, Value>::try_get_result_type olc_db<Key, Value>::try_get(
+    art_key_type k, read_set_entry* dependency,
+    const std::array<std::size_t, 2>& hazard_slots) const noexcept {
+  const auto record_dependency =
+      [dependency](optimistic_lock& lock,
+                   const optimistic_lock::read_critical_section&
+                       critical_section) noexcept {
+        if (dependency != nullptr)
+          *dependency = {&lock, critical_section.get()};
+      };
+  // Each node is protected before the check of its parent validates it
+  auto* const hazards =
+      hazard_pointer_mode ? &hazard_pointer_thread::current() : nullptr;
+  std::size_t hazard_slot_i{0};
+  const auto protect = [hazards, &hazard_slots,
+                        &hazard_slot_i](detail::olc_node_ptr n) noexcept {
+    if (hazards == nullptr) return;
+    hazards->protect(hazard_slots[hazard_slot_i], n.ptr<const void*>());
+    hazard_slot_i ^= 1U;
+  };
+
   auto parent_critical_section = root_pointer_lock.try_read_lock();
   if (UNODB_DETAIL_UNLIKELY(parent_critical_section.must_restart())) {
     // LCOV_EXCL_START
@@ -1683,6 +2460,7 @@ typename olc_db<Key, Value>::try_get_result_type olc_db<Key, Value>::try_get(
   }
 
   detail::olc_node_ptr node{root.load()};  // load root into [node].
+  protect(node);
 
   if (UNODB_DETAIL_UNLIKELY(node == nullptr)) {  // special path if empty tree.
     if (UNODB_DETAIL_UNLIKELY(!parent_critical_section.try_read_unlock())) {
@@ -1691,6 +2469,7 @@ typename olc_db<Key, Value>::try_get_result_type olc_db<Key, Value>::try_get(
       return {};
       // LCOV_EXCL_STOP
     }
+    record_dependency(root_pointer_lock, parent_critical_section);
     // return an empty result (breaks out of caller's while(true) loop)
     return std::make_optional<get_result>(std::nullopt);
   }
@@ -1704,6 +2483,7 @@ typename olc_db<Key, Value>::try_get_result_type olc_db<Key, Value>::try_get(
   }
 
   auto remaining_key{k};
+  optimistic_lock* parent_lock{&root_pointer_lock};
 
   while (true) {
     // Lock version chaining (node and parent)
@@ -1720,10 +2500,14 @@ typename olc_db<Key, Value>::try_get_result_type olc_db<Key, Value>::try_get(
         const auto val_view{leaf->get_value_view()};
         if (UNODB_DETAIL_UNLIKELY(!node_critical_section.try_read_unlock()))
           return {};  // LCOV_EXCL_LINE
+        // The leaf cannot be removed without write-locking its parent
+        record_dependency(*parent_lock, parent_critical_section);
         return qsbr_ptr_span<const std::byte>{val_view};
       }
       if (UNODB_DETAIL_UNLIKELY(!node_critical_section.try_read_unlock()))
         return {};  // LCOV_EXCL_LINE
+      // Nor can it be replaced by an inode holding the key
+      record_dependency(*parent_lock, parent_critical_section);
       return std::make_optional<get_result>(std::nullopt);
     }
 
@@ -1736,6 +2520,8 @@ typename olc_db<Key, Value>::try_get_result_type olc_db<Key, Value>::try_get(
     if (shared_key_prefix_length < key_prefix_length) {
       if (UNODB_DETAIL_UNLIKELY(!node_critical_section.try_read_unlock()))
         return {};  // LCOV_EXCL_LINE
+      // Splitting the key prefix write-locks this node
+      record_dependency(node_ptr_lock(node), node_critical_section);
       return std::make_optional<get_result>(std::nullopt);
     }
 
@@ -1749,12 +2535,16 @@ typename olc_db<Key, Value>::try_get_result_type olc_db<Key, Value>::try_get(
     if (child_in_parent == nullptr) {
       if (UNODB_DETAIL_UNLIKELY(!node_critical_section.try_read_unlock()))
         return {};  // LCOV_EXCL_LINE
+      // Adding the child write-locks this node or obsoletes it
+      record_dependency(node_ptr_lock(node), node_critical_section);
       return std::make_optional<get_result>(std::nullopt);
     }
 
     const auto child = child_in_parent->load();
+    protect(child);
 
     parent_critical_section = std::move(node_critical_section);
+    parent_lock = &node_ptr_lock(node);
     node = child;
     remaining_key.shift_right(1);
 
@@ -1768,55 +2558,238 @@ bool olc_db<Key, Value>::insert_internal(art_key_type insert_key,
   try_update_result_type result;
   olc_db_leaf_unique_ptr_type cached_leaf{
       nullptr, detail::basic_db_leaf_deleter<olc_db<Key, Value>>{*this}};
+  write_path path;
+  spin_wait_backoff backoff;
+
+  if constexpr (caches_rightmost_path) {
+    if (!hazard_pointer_mode) seed_from_rightmost_hint(insert_key, path);
+  }
 
   while (true) {
-    result = try_insert(insert_key, v, cached_leaf);
+    result = try_insert(insert_key, v, cached_leaf, path);
     if (result) break;
+    backoff();
+  }
+
+  if constexpr (caches_rightmost_path) {
+    if (*result && !hazard_pointer_mode)
+      update_rightmost_hint(insert_key, path);
   }
 
   return *result;
 }
 
 template <typename Key, typename Value>
-typename olc_db<Key, Value>::try_update_result_type
-olc_db<Key, Value>::try_insert(art_key_type k, value_type v,
-                               olc_db_leaf_unique_ptr_type& cached_leaf) {
-  auto parent_critical_section = root_pointer_lock.try_read_lock();
-  if (UNODB_DETAIL_UNLIKELY(parent_critical_section.must_restart())) {
-    // LCOV_EXCL_START
-    spin_wait_loop_body();
-    return {};
-    // LCOV_EXCL_STOP
-  }
+void olc_db<Key, Value>::seed_from_rightmost_hint(art_key_type k,
+                                                  write_path& path) noexcept {
+  UNODB_DETAIL_ASSERT(path.empty());
+
+  auto hint_critical_section = rightmost_hint.lock.try_read_lock();
+  if (UNODB_DETAIL_UNLIKELY(hint_critical_section.must_restart()))
+    return;  // LCOV_EXCL_LINE
+  const write_path_entry e{
+      rightmost_hint.parent_lock.load(), rightmost_hint.parent_version.load(),
+      rightmost_hint.node_in_parent.load(),
+      tree_depth_type{rightmost_hint.depth.load()}};
+  const auto hint_key = make_hinted_key(rightmost_hint.key.load());
+  if (UNODB_DETAIL_UNLIKELY(!hint_critical_section.try_read_unlock()))
+    return;  // LCOV_EXCL_LINE
+
+  if (e.parent_lock == nullptr || k.cmp(hint_key) <= 0 ||
+      k.shared_length(hint_key) < e.depth)
+    return;
+  // try_insert checks the parent version before using the entry
+  path.push(e);
+}
 
-  auto node{root.load()};
+template <typename Key, typename Value>
+void olc_db<Key, Value>::update_rightmost_hint(art_key_type k,
+                                               write_path& path) noexcept {
+  // The insert may have changed the parents of the deepest entries
+  optimistic_lock::read_critical_section entry_critical_section;
+  if (!resume_write_path(path, entry_critical_section)) return;
+  std::ignore = entry_critical_section.try_read_unlock();
+  const auto e = path.top();
+
+  auto hint_critical_section = rightmost_hint.lock.try_read_lock();
+  if (UNODB_DETAIL_UNLIKELY(hint_critical_section.must_restart()))
+    return;  // LCOV_EXCL_LINE
+  const auto* const hint_parent_lock = rightmost_hint.parent_lock.load();
+  // An unchanged entry stays usable for the keys greater than the hinted one,
+  // and not writing it keeps the appends of the same inode read-only here.
+  if (hint_parent_lock != nullptr &&
+      ((hint_parent_lock == e.parent_lock &&
+        rightmost_hint.parent_version.load() == e.parent_version &&
+        rightmost_hint.node_in_parent.load() == e.node_in_parent) ||
+       k.cmp(make_hinted_key(rightmost_hint.key.load())) <= 0)) {
+    std::ignore = hint_critical_section.try_read_unlock();
+    return;
+  }
+
+  // Another thread updating the hint at the same time will do
+  const optimistic_lock::write_guard hint_guard{
+      std::move(hint_critical_section)};
+  if (UNODB_DETAIL_UNLIKELY(hint_guard.must_restart())) return;
+
+  rightmost_hint.parent_lock = e.parent_lock;
+  rightmost_hint.parent_version = e.parent_version;
+  rightmost_hint.node_in_parent = e.node_in_parent;
+  rightmost_hint.depth = e.depth;
+  rightmost_hint.key = k.get_u64();
+
+  // The parent must be checked after publishing the hint. Paired with the
+  // fence in forget_rightmost_hint(): either this finds the parent locked or
+  // obsolete, or its deleter finds the new hint and clears it.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  const auto parent_critical_section =
+      e.parent_lock->rehydrate_read_lock(e.parent_version);
+  if (UNODB_DETAIL_UNLIKELY(!parent_critical_section.try_read_unlock()))
+    rightmost_hint.parent_lock = nullptr;
+}
 
-  if (UNODB_DETAIL_UNLIKELY(node == nullptr)) {
-    create_leaf_if_needed(cached_leaf, k, v, *this);
+template <typename Key, typename Value>
+void olc_db<Key, Value>::forget_rightmost_hint(
+    const optimistic_lock& node_lock) noexcept {
+  if constexpr (caches_rightmost_path) {
+    // The hint rarely points to a retired inode, so only check it without
+    // writing. Paired with the fence in update_rightmost_hint(), which checks
+    // the node lock after publishing the hint: either that finds it obsolete
+    // and clears the hint, or this finds the node in the hint.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (UNODB_DETAIL_LIKELY(rightmost_hint.parent_lock.load() != &node_lock))
+      return;
+
+    // Write-lock to clear it, waiting for a concurrent
+    // update_rightmost_hint() to finish.
+    spin_wait_backoff backoff;
+    while (true) {
+      auto hint_critical_section = rightmost_hint.lock.try_read_lock();
+      if (UNODB_DETAIL_LIKELY(!hint_critical_section.must_restart())) {
+        const optimistic_lock::write_guard hint_guard{
+            std::move(hint_critical_section)};
+        if (UNODB_DETAIL_LIKELY(!hint_guard.must_restart())) {
+          if (rightmost_hint.parent_lock.load() == &node_lock)
+            rightmost_hint.parent_lock = nullptr;
+          return;
+        }
+      }
+      backoff.wait_for_lock();  // LCOV_EXCL_LINE
+    }
+  }
+}
 
-    const optimistic_lock::write_guard write_unlock_on_exit{
-        std::move(parent_critical_section)};
-    if (UNODB_DETAIL_UNLIKELY(write_unlock_on_exit.must_restart())) {
-      // Do not call spin_wait_loop_body here - creating the leaf took some time
-      return {};  // LCOV_EXCL_LINE
+template <typename Key, typename Value>
+std::size_t olc_db<Key, Value>::insert_batch(
+    std::span<const std::pair<Key, value_type>> batch) {
+  olc_db_leaf_unique_ptr_type cached_leaf{
+      nullptr, detail::basic_db_leaf_deleter<olc_db<Key, Value>>{*this}};
+  write_path path;
+  std::size_t inserted{0};
+
+  for (std::size_t i = 0; i < batch.size(); ++i) {
+    const art_key_type k{batch[i].first};
+    if (i > 0) {
+      // Only the nodes at the depths up to the key bytes shared with the
+      // previous key are on the path of this key too. Their parent versions
+      // are checked on resume.
+      const auto shared_length =
+          k.shared_length(art_key_type{batch[i - 1].first});
+      while (!path.empty() && path.top().depth > shared_length) path.pop();
     }
 
-    root = detail::olc_node_ptr{cached_leaf.release(), node_type::LEAF};
-    return true;
+    try_update_result_type result;
+    spin_wait_backoff backoff;
+    while (true) {
+      result = try_insert(k, batch[i].second, cached_leaf, path);
+      if (result) break;
+      backoff();
+    }
+    if (*result) ++inserted;
   }
 
+  return inserted;
+}
+
+template <typename Key, typename Value>
+bool olc_db<Key, Value>::resume_write_path(
+    write_path& path,
+    optimistic_lock::read_critical_section& parent_critical_section) noexcept {
+  while (!path.empty()) {
+    const auto& e = path.top();
+    parent_critical_section =
+        e.parent_lock->rehydrate_read_lock(e.parent_version);
+    if (parent_critical_section.check()) return true;
+    path.pop();
+  }
+  return false;
+}
+
+template <typename Key, typename Value>
+typename olc_db<Key, Value>::try_update_result_type
+olc_db<Key, Value>::try_insert(art_key_type k, value_type v,
+                               olc_db_leaf_unique_ptr_type& cached_leaf,
+                               write_path& path) {
+  optimistic_lock::read_critical_section parent_critical_section;
+  auto* parent_lock{&root_pointer_lock};
+  detail::olc_node_ptr node{nullptr};
   auto* node_in_parent{&root};
   tree_depth_type depth{};
   auto remaining_key{k};
 
-  if (UNODB_DETAIL_UNLIKELY(!parent_critical_section.check())) {
-    // LCOV_EXCL_START
-    spin_wait_loop_body();
-    return {};
-    // LCOV_EXCL_STOP
+  // The nodes on the path of a previous attempt may have been freed since
+  if (hazard_pointer_mode) path.clear();
+
+  if (resume_write_path(path, parent_critical_section)) {
+    // A previous attempt failed below a node that has not changed since, pick
+    // up from there.
+    const auto& e = path.top();
+    parent_lock = e.parent_lock;
+    node_in_parent = e.node_in_parent;
+    depth = e.depth;
+    remaining_key.shift_right(depth);
+    path.pop();
+
+    node = node_in_parent->load();
+    if (UNODB_DETAIL_UNLIKELY(!parent_critical_section.check())) return {};
+  } else {
+    parent_critical_section = root_pointer_lock.try_read_lock();
+    if (UNODB_DETAIL_UNLIKELY(parent_critical_section.must_restart())) {
+      // LCOV_EXCL_START
+      spin_wait_loop_body();
+      return {};
+      // LCOV_EXCL_STOP
+    }
+
+    node = root.load();
+    protect_for_write(node);
+
+    if (UNODB_DETAIL_UNLIKELY(node == nullptr)) {
+      create_leaf_if_needed(cached_leaf, k, v, *this);
+
+      const optimistic_lock::write_guard write_unlock_on_exit{
+          std::move(parent_critical_section)};
+      if (UNODB_DETAIL_UNLIKELY(write_unlock_on_exit.must_restart())) {
+        // Do not call spin_wait_loop_body here - creating the leaf took some
+        // time
+        return {};  // LCOV_EXCL_LINE
+      }
+
+      root = detail::olc_node_ptr{cached_leaf.release(), node_type::LEAF};
+      return true;
+    }
+
+    if (UNODB_DETAIL_UNLIKELY(!parent_critical_section.check())) {
+      // LCOV_EXCL_START
+      spin_wait_loop_body();
+      return {};
+      // LCOV_EXCL_STOP
+    }
   }
 
   while (true) {
+    path.push(
+        {parent_lock, parent_critical_section.get(), node_in_parent, depth});
+
     auto node_critical_section = node_ptr_lock(node).try_read_lock();
     if (UNODB_DETAIL_UNLIKELY(node_critical_section.must_restart())) return {};
 
@@ -1889,7 +2862,7 @@ olc_db<Key, Value>::try_insert(art_key_type k, value_type v,
 
 #ifdef UNODB_DETAIL_WITH_STATS
       account_growing_inode<node_type::I4>();
-      key_prefix_splits.fetch_add(1, std::memory_order_relaxed);
+      stats.add(key_prefix_split_stat, 1);
 #endif  // UNODB_DETAIL_WITH_STATS
 
       return true;
@@ -1914,8 +2887,10 @@ olc_db<Key, Value>::try_insert(art_key_type k, value_type v,
       return {};  // LCOV_EXCL_LINE
 
     const auto child = child_in_parent->load();
+    protect_for_write(child);
 
     parent_critical_section = std::move(node_critical_section);
+    parent_lock = &node_ptr_lock(node);
     node = child;
     node_in_parent = child_in_parent;
     ++depth;
@@ -1928,9 +2903,13 @@ olc_db<Key, Value>::try_insert(art_key_type k, value_type v,
 template <typename Key, typename Value>
 bool olc_db<Key, Value>::remove_internal(art_key_type remove_key) {
   try_update_result_type result;
+  write_path path;
+  spin_wait_backoff backoff;
+
   while (true) {
-    result = try_remove(remove_key);
+    result = try_remove(remove_key, path);
     if (result) break;
+    backoff();
   }
 
   return *result;
@@ -1938,68 +2917,97 @@ bool olc_db<Key, Value>::remove_internal(art_key_type remove_key) {
 
 template <typename Key, typename Value>
 typename olc_db<Key, Value>::try_update_result_type
-olc_db<Key, Value>::try_remove(art_key_type k) {
-  auto parent_critical_section = root_pointer_lock.try_read_lock();
-  if (UNODB_DETAIL_UNLIKELY(parent_critical_section.must_restart())) {
-    // LCOV_EXCL_START
-    spin_wait_loop_body();
-    return {};
-    // LCOV_EXCL_STOP
-  }
+olc_db<Key, Value>::try_remove(art_key_type k, write_path& path) {
+  optimistic_lock::read_critical_section parent_critical_section;
+  optimistic_lock::read_critical_section node_critical_section;
+  auto* parent_lock{&root_pointer_lock};
+  detail::olc_node_ptr node{nullptr};
+  auto* node_in_parent{&root};
+  tree_depth_type depth{};
+  auto remaining_key{k};
 
-  auto node{root.load()};
+  // The nodes on the path of a previous attempt may have been freed since
+  if (hazard_pointer_mode) path.clear();
 
-  if (UNODB_DETAIL_UNLIKELY(!parent_critical_section.check())) {
-    // LCOV_EXCL_START
-    spin_wait_loop_body();
-    return {};
-    // LCOV_EXCL_STOP
-  }
-
-  if (UNODB_DETAIL_UNLIKELY(node == nullptr)) return false;
+  if (resume_write_path(path, parent_critical_section)) {
+    // A previous attempt failed below a node that has not changed since, pick
+    // up from there. Only the internal nodes are recorded.
+    const auto& e = path.top();
+    parent_lock = e.parent_lock;
+    node_in_parent = e.node_in_parent;
+    depth = e.depth;
+    remaining_key.shift_right(depth);
+    path.pop();
 
-  auto node_critical_section = node_ptr_lock(node).try_read_lock();
-  if (UNODB_DETAIL_UNLIKELY(node_critical_section.must_restart())) {
-    // LCOV_EXCL_START
-    spin_wait_loop_body();
-    return {};
-    // LCOV_EXCL_STOP
-  }
+    node = node_in_parent->load();
+    if (UNODB_DETAIL_UNLIKELY(!parent_critical_section.check())) return {};
 
-  auto node_type = node.type();
+    node_critical_section = node_ptr_lock(node).try_read_lock();
+    if (UNODB_DETAIL_UNLIKELY(node_critical_section.must_restart())) return {};
+  } else {
+    parent_critical_section = root_pointer_lock.try_read_lock();
+    if (UNODB_DETAIL_UNLIKELY(parent_critical_section.must_restart())) {
+      // LCOV_EXCL_START
+      spin_wait_loop_body();
+      return {};
+      // LCOV_EXCL_STOP
+    }
 
-  if (node_type == node_type::LEAF) {
-    auto* const leaf{node.template ptr<leaf_type*>()};
-    if (leaf->matches(k)) {
-      const optimistic_lock::write_guard parent_guard{
-          std::move(parent_critical_section)};
-      // Do not call spin_wait_loop_body from this point on - assume
-      // the above took enough time
-      if (UNODB_DETAIL_UNLIKELY(parent_guard.must_restart())) return {};
+    node = root.load();
+    protect_for_write(node);
 
-      optimistic_lock::write_guard node_guard{std::move(node_critical_section)};
-      if (UNODB_DETAIL_UNLIKELY(node_guard.must_restart())) return {};
+    if (UNODB_DETAIL_UNLIKELY(!parent_critical_section.check())) {
+      // LCOV_EXCL_START
+      spin_wait_loop_body();
+      return {};
+      // LCOV_EXCL_STOP
+    }
 
-      node_guard.unlock_and_obsolete();
+    if (UNODB_DETAIL_UNLIKELY(node == nullptr)) return false;
 
-      const auto r{art_policy::reclaim_leaf_on_scope_exit(leaf, *this)};
-      root = detail::olc_node_ptr{nullptr};
-      return true;
+    node_critical_section = node_ptr_lock(node).try_read_lock();
+    if (UNODB_DETAIL_UNLIKELY(node_critical_section.must_restart())) {
+      // LCOV_EXCL_START
+      spin_wait_loop_body();
+      return {};
+      // LCOV_EXCL_STOP
     }
 
-    if (UNODB_DETAIL_UNLIKELY(!node_critical_section.try_read_unlock()))
-      return {};  // LCOV_EXCL_LINE
+    if (node.type() == node_type::LEAF) {
+      auto* const leaf{node.template ptr<leaf_type*>()};
+      if (leaf->matches(k)) {
+        const optimistic_lock::write_guard parent_guard{
+            std::move(parent_critical_section)};
+        // Do not call spin_wait_loop_body from this point on - assume
+        // the above took enough time
+        if (UNODB_DETAIL_UNLIKELY(parent_guard.must_restart())) return {};
 
-    return false;
+        optimistic_lock::write_guard node_guard{
+            std::move(node_critical_section)};
+        if (UNODB_DETAIL_UNLIKELY(node_guard.must_restart())) return {};
+
+        node_guard.unlock_and_obsolete();
+
+        const auto r{art_policy::reclaim_leaf_on_scope_exit(leaf, *this)};
+        root = detail::olc_node_ptr{nullptr};
+        return true;
+      }
+
+      if (UNODB_DETAIL_UNLIKELY(!node_critical_section.try_read_unlock()))
+        return {};  // LCOV_EXCL_LINE
+
+      return false;
+    }
   }
 
-  auto* node_in_parent{&root};
-  tree_depth_type depth{};
-  auto remaining_key{k};
+  auto node_type = node.type();
 
   while (true) {
     UNODB_DETAIL_ASSERT(node_type != node_type::LEAF);
 
+    path.push(
+        {parent_lock, parent_critical_section.get(), node_in_parent, depth});
+
     auto* const inode{node.template ptr<inode_type*>()};
     const auto& key_prefix{inode->get_key_prefix()};
     const auto key_prefix_length{key_prefix.length()};
@@ -2041,6 +3049,7 @@ olc_db<Key, Value>::try_remove(art_key_type k) {
     if (child_in_parent == nullptr) return true;
 
     parent_critical_section = std::move(node_critical_section);
+    parent_lock = &node_ptr_lock(node);
     node = child;
     node_in_parent = child_in_parent;
     node_critical_section = std::move(child_critical_section);
@@ -2057,8 +3066,9 @@ olc_db<Key, Value>::try_remove(art_key_type k) {
 
 template <typename Key, typename Value>
 typename olc_db<Key, Value>::iterator& olc_db<Key, Value>::iterator::first() {
+  spin_wait_backoff backoff;
   while (!try_first()) {
-    unodb::spin_wait_loop_body();  // LCOV_EXCL_LINE
+    backoff.wait_for_lock();  // LCOV_EXCL_LINE
   }
   return *this;
 }
@@ -2076,13 +3086,15 @@ bool olc_db<Key, Value>::iterator::try_first() {
   if (UNODB_DETAIL_UNLIKELY(node == nullptr)) {
     return UNODB_DETAIL_LIKELY(parent_critical_section.try_read_unlock());
   }
+  protect(0, node);
   return try_left_most_traversal(node, parent_critical_section);
 }
 
 template <typename Key, typename Value>
 typename olc_db<Key, Value>::iterator& olc_db<Key, Value>::iterator::last() {
+  spin_wait_backoff backoff;
   while (!try_last()) {
-    unodb::spin_wait_loop_body();  // LCOV_EXCL_LINE
+    backoff.wait_for_lock();  // LCOV_EXCL_LINE
   }
   return *this;
 }
@@ -2100,6 +3112,7 @@ bool olc_db<Key, Value>::iterator::try_last() {
   if (UNODB_DETAIL_UNLIKELY(node == nullptr)) {
     return UNODB_DETAIL_LIKELY(parent_critical_section.try_read_unlock());
   }
+  protect(0, node);
   return try_right_most_traversal(node, parent_critical_section);
 }
 
@@ -2113,7 +3126,8 @@ typename olc_db<Key, Value>::iterator& olc_db<Key, Value>::iterator::next() {
     // copy of the key since actions on the stack will make it
     // impossible to reconstruct the key.  So maybe we have two
     // internal buffers on the iterator to support this?
-    const auto& akey = leaf->get_key();  // access the key on the leaf.
+    // access the key on the leaf.
+    const auto akey = stable_key(leaf->get_key());
     if (UNODB_DETAIL_LIKELY(try_next())) return *this;
     while (true) {
       bool match{};
@@ -2167,8 +3181,10 @@ bool olc_db<Key, Value>::iterator::try_next() {
     const auto& e2 = nxt.value();
     pop();
     if (UNODB_DETAIL_UNLIKELY(!try_push(e2, node_critical_section)))
-      return false;                                            // LCOV_EXCL_LINE
+      return false;  // LCOV_EXCL_LINE
+    prefetch_ahead(inode, node_type, e2.child_index, true, false);
     auto child = inode->get_child(node_type, e2.child_index);  // descend
+    protect(stack_.size(), child);
     if (UNODB_DETAIL_UNLIKELY(!node_critical_section.check()))  // before using
       return false;  // LCOV_EXCL_LINE
     return try_left_most_traversal(child, node_critical_section);
@@ -2186,7 +3202,8 @@ typename olc_db<Key, Value>::iterator& olc_db<Key, Value>::iterator::prior() {
     // copy of the key since actions on the stack will make it
     // impossible to reconstruct the key.  So maybe we have two
     // internal buffers on the iterator to support this?
-    const auto& akey = leaf->get_key();  // access the key on the leaf.
+    // access the key on the leaf.
+    const auto akey = stable_key(leaf->get_key());
     if (UNODB_DETAIL_LIKELY(try_prior())) return *this;
     while (true) {
       bool match{};
@@ -2237,8 +3254,10 @@ bool olc_db<Key, Value>::iterator::try_prior() {
     const auto& e2 = nxt.value();
     pop();
     if (UNODB_DETAIL_UNLIKELY(!try_push(e2, node_critical_section)))
-      return false;                                            // LCOV_EXCL_LINE
+      return false;  // LCOV_EXCL_LINE
+    prefetch_ahead(inode, node_type, e2.child_index, false, false);
     auto child = inode->get_child(node_type, e2.child_index);  // get child
+    protect(stack_.size(), child);
     if (UNODB_DETAIL_UNLIKELY(!node_critical_section.check()))  // before using
       return false;  // LCOV_EXCL_LINE
     return try_right_most_traversal(child, node_critical_section);
@@ -2249,8 +3268,9 @@ bool olc_db<Key, Value>::iterator::try_prior() {
 template <typename Key, typename Value>
 typename olc_db<Key, Value>::iterator& olc_db<Key, Value>::iterator::seek(
     art_key_type search_key, bool& match, bool fwd) {
+  spin_wait_backoff backoff;
   while (!try_seek(search_key, match, fwd)) {
-    unodb::spin_wait_loop_body();  // LCOV_EXCL_LINE
+    backoff.wait_for_lock();  // LCOV_EXCL_LINE
   }
   return *this;
 }
@@ -2296,6 +3316,7 @@ bool olc_db<Key, Value>::iterator::try_seek(art_key_type search_key,
   if (UNODB_DETAIL_UNLIKELY(node == nullptr)) {
     return UNODB_DETAIL_LIKELY(parent_critical_section.try_read_unlock());
   }
+  protect(0, node);
   // A check() is required before acting on [node] by taking the lock.
   if (UNODB_DETAIL_UNLIKELY(!parent_critical_section.check())) {
     // LCOV_EXCL_START
@@ -2432,6 +3453,7 @@ bool olc_db<Key, Value>::iterator::try_seek(art_key_type search_key,
             if (cnxt) {
               auto nchild = icnode->get_child(
                   cnode.type(), centry.child_index);  // get the child
+              protect(stack_.size(), nchild);
               if (UNODB_DETAIL_UNLIKELY(
                       !c_critical_section.check()))  // before using [nchild]
                 return false;                        // LCOV_EXCL_LINE
@@ -2447,6 +3469,8 @@ bool olc_db<Key, Value>::iterator::try_seek(art_key_type search_key,
         const auto child_index = tmp.child_index;
         const auto child =
             inode->get_child(node_type, child_index);  // get child
+        // [node] is not on the stack yet
+        protect(stack_.size() + 1, child);
         if (UNODB_DETAIL_UNLIKELY(
                 !node_critical_section.check()))  // before using [child]
           return false;                           // LCOV_EXCL_LINE
@@ -2488,6 +3512,7 @@ bool olc_db<Key, Value>::iterator::try_seek(art_key_type search_key,
           if (cnxt) {
             auto nchild = icnode->get_child(
                 cnode.type(), centry.child_index);  // get the child
+            protect(stack_.size(), nchild);
             if (UNODB_DETAIL_UNLIKELY(
                     !c_critical_section.check()))  // before using [nchild]
               return false;                        // LCOV_EXCL_LINE
@@ -2503,6 +3528,8 @@ bool olc_db<Key, Value>::iterator::try_seek(art_key_type search_key,
       const auto child_index = tmp.child_index;
       const auto child =
           inode->get_child(node_type, child_index);  // get the child
+      // [node] is not on the stack yet
+      protect(stack_.size() + 1, child);
       if (UNODB_DETAIL_UNLIKELY(
               !node_critical_section.check()))  // before using [child]
         return false;                           // LCOV_EXCL_LINE
@@ -2522,6 +3549,7 @@ bool olc_db<Key, Value>::iterator::try_seek(art_key_type search_key,
                                         key_prefix, node_critical_section)))
       return false;  // LCOV_EXCL_LINE
     node = *child;
+    protect(stack_.size(), node);
     remaining_key.shift_right(1);
     // check node before using [child] and before we std::move() the RCS.
     if (UNODB_DETAIL_UNLIKELY(!node_critical_section.check()))
@@ -2569,8 +3597,10 @@ bool olc_db<Key, Value>::iterator::try_left_most_traversal(
     if (UNODB_DETAIL_UNLIKELY(!node_critical_section.check()))
       return false;  // LCOV_EXCL_LINE
     if (UNODB_DETAIL_UNLIKELY(!try_push(t, node_critical_section)))
-      return false;                                     // LCOV_EXCL_LINE
+      return false;  // LCOV_EXCL_LINE
+    prefetch_ahead(inode, node_type, t.child_index, true, true);
     node = inode->get_child(node_type, t.child_index);  // get child
+    protect(stack_.size(), node);
     if (UNODB_DETAIL_UNLIKELY(!node_critical_section.check()))  // before using
       return false;  // LCOV_EXCL_LINE
     // Move RCS (will check invariant at top of loop)
@@ -2616,8 +3646,10 @@ bool olc_db<Key, Value>::iterator::try_right_most_traversal(
     if (UNODB_DETAIL_UNLIKELY(!node_critical_section.check()))
       return false;  // LCOV_EXCL_LINE
     if (UNODB_DETAIL_UNLIKELY(!try_push(t, node_critical_section)))
-      return false;                                     // LCOV_EXCL_LINE
+      return false;  // LCOV_EXCL_LINE
+    prefetch_ahead(inode, node_type, t.child_index, false, true);
     node = inode->get_child(node_type, t.child_index);  // get child
+    protect(stack_.size(), node);
     if (UNODB_DETAIL_UNLIKELY(!node_critical_section.check()))  // before using
       return false;  // LCOV_EXCL_LINE
     // Move RCS (will check invariant at top of loop)
@@ -2661,6 +3693,113 @@ qsbr_value_view olc_db<Key, Value>::iterator::get_val() const noexcept {
   return qsbr_ptr_span{leaf->get_value_view()};
 }
 
+template <typename Key, typename Value>
+std::size_t olc_db<Key, Value>::iterator::collect_leaf_run(
+    art_key_type to_key, std::span<scan_batch_entry> run) {
+  UNODB_DETAIL_ASSERT(valid());
+  UNODB_DETAIL_ASSERT(!run.empty());
+
+  if (db_.hazard_pointer_mode) {
+    // The batch stays protected until the next one, while the iterator moves
+    // off its leaves
+    batch_hazards_.protect(0, top().node.template ptr<const void*>());
+  }
+  run[0] = {get_key(), get_val()};
+  if (stack_.size() < 2) {  // A root leaf
+    next();
+    return 1;
+  }
+
+  const auto parent = stack_[stack_.size() - 2];
+  auto parent_critical_section =
+      node_ptr_lock(parent.node).rehydrate_read_lock(parent.version);
+  if (UNODB_DETAIL_UNLIKELY(!parent_critical_section.check())) {
+    next();
+    return 1;
+  }
+
+  // Only read the child pointers here, and follow them once the parent has
+  // been checked for all of them.
+  auto* const inode{parent.node.template ptr<inode_type*>()};
+  const auto node_type = parent.node.type();
+  std::array<detail::olc_node_ptr, scan_batch_capacity> leaves;
+  std::size_t leaf_count{0};
+  std::optional<typename inode_base::iter_result> last_leaf_entry;
+  auto child_index = parent.child_index;
+  while (leaf_count + 1 < run.size()) {
+    const auto nxt = inode->next(node_type, child_index);
+    if (!nxt.has_value()) break;
+    const auto child = inode->get_child(node_type, nxt->child_index);
+    if (child.type() != node_type::LEAF) break;
+    leaves[leaf_count++] = child;
+    last_leaf_entry = nxt;
+    child_index = nxt->child_index;
+  }
+  if (leaf_count == 0) {
+    std::ignore = parent_critical_section.try_read_unlock();
+    next();
+    return 1;
+  }
+  if (db_.hazard_pointer_mode) {
+    // The parent check below validates all of them
+    batch_hazards_.reserve(leaf_count + 1);
+    for (std::size_t i = 0; i < leaf_count; ++i)
+      batch_hazards_.publish(i + 1, leaves[i].template ptr<const void*>());
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+  }
+  if (UNODB_DETAIL_UNLIKELY(!parent_critical_section.try_read_unlock())) {
+    next();
+    return 1;
+  }
+
+  std::size_t run_size{1};
+  for (std::size_t i = 0; i < leaf_count; ++i) {
+    const auto* const leaf{leaves[i].template ptr<leaf_type*>()};
+    if (to_key.cmp(leaf->get_key_view()) <= 0) {
+      // The following leaves are out of the range too, the scan is over
+      invalidate();
+      return run_size;
+    }
+    run[run_size++] = {leaf->get_key_view(),
+                       qsbr_ptr_span{leaf->get_value_view()}};
+  }
+
+  // Move onto the last copied leaf, as the next() calls would have, and then
+  // past it. If the leaf has been removed since, next() seeks past it.
+  const auto last_leaf = leaves[leaf_count - 1];
+  if (UNODB_DETAIL_UNLIKELY(!try_move_to_leaf(*last_leaf_entry, last_leaf,
+                                              parent_critical_section))) {
+    // LCOV_EXCL_START
+    const auto* const leaf{last_leaf.template ptr<leaf_type*>()};
+    const auto akey = stable_key(leaf->get_key());
+    bool match{};
+    seek(akey, match, true /*fwd*/);
+    if (match) next();
+    return run_size;
+    // LCOV_EXCL_STOP
+  }
+  next();
+  return run_size;
+}
+
+template <typename Key, typename Value>
+bool olc_db<Key, Value>::iterator::try_move_to_leaf(
+    const typename inode_base::iter_result& parent_entry,
+    detail::olc_node_ptr leaf,
+    const optimistic_lock::read_critical_section& parent_critical_section) {
+  pop();  // the current leaf
+  pop();  // its parent
+  if (UNODB_DETAIL_UNLIKELY(!try_push(parent_entry, parent_critical_section)))
+    return false;  // LCOV_EXCL_LINE
+  protect(stack_.size(), leaf);
+  const auto leaf_critical_section = node_ptr_lock(leaf).try_read_lock();
+  if (UNODB_DETAIL_UNLIKELY(!try_push_leaf(leaf, leaf_critical_section)))
+    return false;  // LCOV_EXCL_LINE
+  if (UNODB_DETAIL_LIKELY(!leaf_critical_section.must_restart()))
+    std::ignore = leaf_critical_section.try_read_unlock();
+  return true;
+}
+
 template <typename Key, typename Value>
 int olc_db<Key, Value>::iterator::cmp(const art_key_type& akey) const noexcept {
   // TODO(thompsonbry) : variable length keys. Explore a cheaper way
@@ -2685,7 +3824,7 @@ template <typename Key, typename Value>
 void olc_db<Key, Value>::increase_memory_use(std::size_t delta) noexcept {
   UNODB_DETAIL_ASSERT(delta > 0);
 
-  current_memory_use.fetch_add(delta, std::memory_order_relaxed);
+  stats.add(memory_use_stat, delta);
 }
 
 UNODB_DETAIL_RESTORE_GCC_WARNINGS()
@@ -2693,10 +3832,8 @@ UNODB_DETAIL_RESTORE_GCC_WARNINGS()
 template <typename Key, typename Value>
 void olc_db<Key, Value>::decrease_memory_use(std::size_t delta) noexcept {
   UNODB_DETAIL_ASSERT(delta > 0);
-  UNODB_DETAIL_ASSERT(delta <=
-                      current_memory_use.load(std::memory_order_relaxed));
 
-  current_memory_use.fetch_sub(delta, std::memory_order_relaxed);
+  stats.subtract(memory_use_stat, delta);
 }
 
 template <typename Key, typename Value>
@@ -2704,7 +3841,7 @@ template <class INode>
 constexpr void olc_db<Key, Value>::increment_inode_count() noexcept {
   static_assert(detail::olc_inode_defs<Key, Value>::template is_inode<INode>());
 
-  node_counts[as_i<INode::type>].fetch_add(1, std::memory_order_relaxed);
+  stats.add(node_count_stats + as_i<INode::type>, 1);
   increase_memory_use(sizeof(INode));
 }
 
@@ -2713,10 +3850,7 @@ template <class INode>
 constexpr void olc_db<Key, Value>::decrement_inode_count() noexcept {
   static_assert(detail::olc_inode_defs<Key, Value>::template is_inode<INode>());
 
-  const auto old_inode_count UNODB_DETAIL_USED_IN_DEBUG =
-      node_counts[as_i<INode::type>].fetch_sub(1, std::memory_order_relaxed);
-  UNODB_DETAIL_ASSERT(old_inode_count > 0);
-
+  stats.subtract(node_count_stats + as_i<INode::type>, 1);
   decrease_memory_use(sizeof(INode));
 }
 
@@ -2725,9 +3859,7 @@ template <node_type NodeType>
 constexpr void olc_db<Key, Value>::account_growing_inode() noexcept {
   static_assert(NodeType != node_type::LEAF);
 
-  // NOLINTNEXTLINE(google-readability-casting)
-  growing_inode_counts[internal_as_i<NodeType>].fetch_add(
-      1, std::memory_order_relaxed);
+  stats.add(growing_inode_stats + internal_as_i<NodeType>, 1);
 }
 
 template <typename Key, typename Value>
@@ -2735,8 +3867,7 @@ template <node_type NodeType>
 constexpr void olc_db<Key, Value>::account_shrinking_inode() noexcept {
   static_assert(NodeType != node_type::LEAF);
 
-  shrinking_inode_counts[internal_as_i<NodeType>].fetch_add(
-      1, std::memory_order_relaxed);
+  stats.add(shrinking_inode_stats + internal_as_i<NodeType>, 1);
 }
 
 #endif  // UNODB_DETAIL_WITH_STATS
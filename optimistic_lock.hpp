@@ -213,6 +213,7 @@
 // Should be the first include
 #include "global.hpp"
 
+#include <algorithm>
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
@@ -227,6 +228,7 @@
 #endif
 
 #include "assert.hpp"
+#include "portability_arch.hpp"
 
 namespace unodb {
 
@@ -259,6 +261,127 @@ inline void spin_wait_loop_body() noexcept {
 }
 // LCOV_EXCL_STOP
 
+/// Backoff policies for the optimistic lock wait and retry loops, selectable
+/// at runtime with unodb::set_spin_backoff().
+enum class spin_backoff : std::uint8_t {
+  /// No backoff, the default. The retry loops retry immediately, and the waits
+  /// for a write-locked lock call unodb::spin_wait_loop_body() once.
+  none,
+  /// Exponentially growing runs of unodb::spin_wait_loop_body() calls, up to a
+  /// cap.
+  exponential,
+  /// As unodb::spin_backoff::exponential, but yield the CPU once the cap has
+  /// been reached a number of times in a row. Helps the lock holder make
+  /// progress when there are more threads than cores.
+  exponential_yield,
+  /// As unodb::spin_backoff::exponential_yield, but a thread waiting for a
+  /// write-locked unodb::optimistic_lock parks on it instead of yielding, and
+  /// the unlocking writer wakes it up. The loops that do not wait on a
+  /// specific lock still yield.
+  ///
+  /// \note Parking makes every write unlock an atomic read-modify-write, thus
+  /// it is compiled in only with #UNODB_DETAIL_LOCK_PARKING. Without it, this
+  /// policy is the same as unodb::spin_backoff::exponential_yield.
+  exponential_park,
+};
+
+namespace detail {
+
+inline std::atomic<spin_backoff> spin_backoff_policy{spin_backoff::none};
+inline std::atomic<std::uint32_t> spin_backoff_max_spins{1024};
+inline std::atomic<std::uint32_t> spin_backoff_yield_after{16};
+
+/// Whether the unodb::spin_backoff::exponential_park policy is active.
+[[nodiscard]] inline bool lock_parking_enabled() noexcept {
+#ifdef UNODB_DETAIL_LOCK_PARKING
+  return UNODB_DETAIL_UNLIKELY(
+      spin_backoff_policy.load(std::memory_order_relaxed) ==
+      spin_backoff::exponential_park);
+#else
+  return false;
+#endif
+}
+
+}  // namespace detail
+
+/// Select the backoff \a policy for all the optimistic lock waits, with runs
+/// of at most \a max_spins unodb::spin_wait_loop_body() calls, and, for
+/// unodb::spin_backoff::exponential_yield, yielding after \a yield_after
+/// capped runs. Affects the waits that start after the call.
+inline void set_spin_backoff(spin_backoff policy,
+                             std::uint32_t max_spins = 1024,
+                             std::uint32_t yield_after = 16) noexcept {
+  UNODB_DETAIL_ASSERT(max_spins > 0);
+  detail::spin_backoff_max_spins.store(max_spins, std::memory_order_relaxed);
+  detail::spin_backoff_yield_after.store(yield_after,
+                                         std::memory_order_relaxed);
+  detail::spin_backoff_policy.store(policy, std::memory_order_relaxed);
+}
+
+/// Return the current backoff policy.
+[[nodiscard]] inline spin_backoff get_spin_backoff() noexcept {
+  return detail::spin_backoff_policy.load(std::memory_order_relaxed);
+}
+
+/// The state of one wait or retry loop under the current unodb::spin_backoff
+/// policy. Create one before the loop and call it each time the loop has to
+/// wait.
+class [[nodiscard]] spin_wait_backoff final {
+ public:
+  /// Back off before the next attempt of a retry loop. A no-op under
+  /// unodb::spin_backoff::none.
+  void operator()() noexcept {
+    const auto policy =
+        detail::spin_backoff_policy.load(std::memory_order_relaxed);
+    if (policy == spin_backoff::none) return;
+    back_off(policy);
+  }
+
+  /// Wait for a write-locked lock to be released before looking at it again.
+  /// As operator(), but calls unodb::spin_wait_loop_body() once under
+  /// unodb::spin_backoff::none.
+  void wait_for_lock() noexcept {
+    const auto policy =
+        detail::spin_backoff_policy.load(std::memory_order_relaxed);
+    if (policy == spin_backoff::none) {
+      spin_wait_loop_body();
+      return;
+    }
+    back_off(policy);
+  }
+
+  /// Check whether a wait on a specific lock should park on it instead of
+  /// calling this object again.
+  [[nodiscard]] bool should_park() const noexcept {
+    return capped_waits >=
+               detail::spin_backoff_yield_after.load(
+                   std::memory_order_relaxed) &&
+           detail::lock_parking_enabled();
+  }
+
+ private:
+  /// Spin or yield under one of the backoff \a policy values other than
+  /// unodb::spin_backoff::none.
+  void back_off(spin_backoff policy) noexcept {
+    const auto max_spins =
+        detail::spin_backoff_max_spins.load(std::memory_order_relaxed);
+    if (spins >= max_spins && policy != spin_backoff::exponential &&
+        ++capped_waits > detail::spin_backoff_yield_after.load(
+                             std::memory_order_relaxed)) {
+      std::this_thread::yield();
+      return;
+    }
+
+    for (std::uint32_t i = 0; i < spins; ++i) spin_wait_loop_body();
+    spins = std::min(spins * 2, max_spins);
+  }
+
+  /// The length of the next run of unodb::spin_wait_loop_body() calls.
+  std::uint32_t spins{1};
+  /// The number of waits since the run length has reached the cap.
+  std::uint32_t capped_waits{0};
+};
+
 /// Underlying integer type used to store optimistic lock word, including its
 /// version and lock state information.
 //
@@ -284,7 +407,10 @@ class [[nodiscard]] optimistic_lock final {
   /// The lock word consists of:
   /// - Bit 0: obsolete state. If set, all other bits are zero.
   /// - Bit 1: write lock
-  /// - Bits 2-63: version counter
+  /// - Bits 2-62: version counter
+  /// - Bit 63: parked waiters. Set by the threads parking on the write-locked
+  ///   lock, and cleared by the next write lock after the unlock that wakes
+  ///   them up.
   // TODO(laurynas): rename to lock_word
   class [[nodiscard]] version_type final {
    public:
@@ -319,12 +445,27 @@ class [[nodiscard]] optimistic_lock final {
       return version == obsolete_lock_word;
     }
 
-    /// Return a lock word with the current version and lock bit set.
+    /// Return whether the lock word has the parked waiters bit set.
+    [[nodiscard, gnu::const]] constexpr bool has_parked_waiters()
+        const noexcept {
+      return (version & parked_waiters_bit) != 0U;
+    }
+
+    /// Return a lock word with the current version and lock bit set, and the
+    /// parked waiters bit clear.
     /// \pre the lock word must be free.
     [[nodiscard, gnu::const]] constexpr version_type set_locked_bit()
         const noexcept {
       UNODB_DETAIL_ASSERT(is_free());
-      return version_type{version + 2};
+      return version_type{(version & ~parked_waiters_bit) + 2};
+    }
+
+    /// Return this lock word with the parked waiters bit set.
+    /// \pre the lock word must be write-locked.
+    [[nodiscard, gnu::const]] constexpr version_type set_parked_waiters_bit()
+        const noexcept {
+      UNODB_DETAIL_ASSERT(is_write_locked());
+      return version_type{version | parked_waiters_bit};
     }
 
     /// Return the version_tag_type (just the data, including both the version
@@ -348,9 +489,13 @@ class [[nodiscard]] optimistic_lock final {
          << version << std::dec;
       if (is_write_locked()) os << " (write locked)";
       if (is_obsolete()) os << " (obsoleted)";
+      if (has_parked_waiters()) os << " (parked waiters)";
     }
 
    private:
+    /// The parked waiters bit.
+    static constexpr version_tag_type parked_waiters_bit = 1ULL << 63U;
+
     /// Raw lock word value.
     version_tag_type version{0};
   };  // class version_type
@@ -385,32 +530,64 @@ class [[nodiscard]] optimistic_lock final {
     /// Atomically clear the write lock bit with release memory ordering.
     /// The version number is preserved.
     /// \pre The write lock bit must be set.
-    void write_unlock() noexcept {
+    /// \return whether any threads parked on the lock, which must be woken up
+    [[nodiscard]] bool write_unlock() noexcept {
+#ifdef UNODB_DETAIL_LOCK_PARKING
+      // The parking threads may set the parked waiters bit concurrently, thus
+      // this must be a read-modify-write, whichever the backoff policy.
+      const auto old_lock_word =
+          version_type{version.fetch_add(2, std::memory_order_release)};
+      UNODB_DETAIL_ASSERT(old_lock_word.is_write_locked());
+      return UNODB_DETAIL_UNLIKELY(old_lock_word.has_parked_waiters());
+#else
       // This thread has written the previous lock word value, and no other
       // thread may write it before the unlock, thus we can read it without
       // ordering.
       const auto old_lock_word = load_relaxed();
       UNODB_DETAIL_ASSERT(old_lock_word.is_write_locked());
+      UNODB_DETAIL_ASSERT(!old_lock_word.has_parked_waiters());
+
+      version.store(old_lock_word.get() + 2, std::memory_order_release);
+      return false;
+#endif
+    }
 
-      const auto new_lock_word = old_lock_word.get() + 2;
-      version.store(new_lock_word, std::memory_order_release);
+    /// Block while the lock word equals \a old_val, or until woken up.
+    void wait(version_type old_val) const noexcept {
+      version.wait(old_val.get(), std::memory_order_seq_cst);
     }
 
+    /// Wake up all the threads blocked in wait().
+    void notify_all() noexcept { version.notify_all(); }
+
     /// Atomically clear the set write lock bit and set the obsolete bit with
     /// release memory ordering.
     /// \pre The obsolete bit must be clear
     /// \pre The write lock bit must be set
-    void write_unlock_and_obsolete() noexcept {
+    /// \return whether any threads parked on the lock, which must be woken up
+    [[nodiscard]] bool write_unlock_and_obsolete() noexcept {
+#ifdef UNODB_DETAIL_LOCK_PARKING
+      const auto old_lock_word = version_type{version.exchange(
+          version_type::obsolete_lock_word, std::memory_order_release)};
+      UNODB_DETAIL_ASSERT(!old_lock_word.is_obsolete());
+      UNODB_DETAIL_ASSERT(old_lock_word.is_write_locked());
+
+      UNODB_DETAIL_ASSERT(load_relaxed().is_obsolete());
+      return UNODB_DETAIL_UNLIKELY(old_lock_word.has_parked_waiters());
+#else
 #ifndef NDEBUG
       const auto old_lock_word{load_relaxed()};
       UNODB_DETAIL_ASSERT(!old_lock_word.is_obsolete());
       UNODB_DETAIL_ASSERT(old_lock_word.is_write_locked());
+      UNODB_DETAIL_ASSERT(!old_lock_word.has_parked_waiters());
 #endif
 
       version.store(version_type::obsolete_lock_word,
                     std::memory_order_release);
 
       UNODB_DETAIL_ASSERT(load_relaxed().is_obsolete());
+      return false;
+#endif
     }
 
    private:
@@ -681,6 +858,7 @@ class [[nodiscard]] optimistic_lock final {
   /// \note read_critical_section::must_restart must be called before the first
   /// protected data access to check for obsolete state.
   [[nodiscard]] read_critical_section try_read_lock() noexcept {
+    spin_wait_backoff backoff;
     while (true) {
       const auto current_version = version.load_acquire();
       if (UNODB_DETAIL_LIKELY(current_version.is_free())) {
@@ -691,7 +869,10 @@ class [[nodiscard]] optimistic_lock final {
       if (UNODB_DETAIL_UNLIKELY(current_version.is_obsolete()))
         return read_critical_section{};
       UNODB_DETAIL_ASSERT(current_version.is_write_locked());
-      spin_wait_loop_body();
+      if (backoff.should_park())
+        park(current_version);
+      else
+        backoff.wait_for_lock();
       // LCOV_EXCL_STOP
     }
   }
@@ -796,17 +977,38 @@ class [[nodiscard]] optimistic_lock final {
 
   /// Write unlock this lock.
   /// \pre The lock must be write-locked.
-  void write_unlock() noexcept { version.write_unlock(); }
+  void write_unlock() noexcept {
+    if (version.write_unlock()) wake_parked();
+  }
 
   /// Atomically write unlock and obsolete this lock.
   /// \pre The lock must be write-locked.
   void write_unlock_and_obsolete() noexcept {
-    version.write_unlock_and_obsolete();
+    const auto parked_waiters = version.write_unlock_and_obsolete();
 #ifndef NDEBUG
     obsoleter_thread = std::this_thread::get_id();
 #endif
+    if (parked_waiters) wake_parked();
   }
 
+  /// Block until write-locked \a locked_version is unlocked.
+  // LCOV_EXCL_START
+  void park(version_type locked_version) noexcept {
+    // The unlock read-modify-write is ordered with the CAS setting the parked
+    // waiters bit: either it sees the bit and wakes this thread up, or the CAS
+    // fails, and the caller looks at the lock again. Thus the wake-up does not
+    // depend on the backoff policy of the writer.
+    const auto parked_version = locked_version.set_parked_waiters_bit();
+    if (!locked_version.has_parked_waiters() &&
+        !version.cas_acquire(locked_version, parked_version))
+      return;
+    version.wait(parked_version);
+  }
+
+  /// Wake up the threads parked on this lock after unlocking it.
+  void wake_parked() noexcept { version.notify_all(); }
+  // LCOV_EXCL_STOP
+
   /// Atomic lock word.
   atomic_version_type version{};
 
@@ -76,6 +76,22 @@ template <typename To, typename From>
   return reinterpret_cast<const To&>(tmp);
 }
 
+/// Hint the processor to start loading the cache line at \a p for reading.
+///
+/// This is only a hint: it never faults, even for invalid addresses, so it can
+/// be issued for pointers read optimistically.
+inline void prefetch(const void* p) noexcept {
+#ifdef UNODB_DETAIL_MSVC
+#ifdef UNODB_DETAIL_X86_64
+  _mm_prefetch(static_cast<const char*>(p), _MM_HINT_T0);
+#else
+  __prefetch(p);
+#endif
+#else   // UNODB_DETAIL_MSVC
+  __builtin_prefetch(p);
+#endif  // UNODB_DETAIL_MSVC
+}
+
 }  // namespace unodb::detail
 
 #endif
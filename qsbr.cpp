@@ -14,20 +14,23 @@
 // IWYU pragma: no_include <__new/exceptions.h>
 // IWYU pragma: no_include <__hash_table>
 
+#include <array>
 #include <atomic>
+#include <bit>
+#include <cstddef>
 #include <cstdint>
 #include <exception>
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <new>  // IWYU pragma: keep
+#include <thread>
+#include <tuple>
 #include <utility>
+#include <vector>
 
 #include "qsbr.hpp"
 
-#ifdef UNODB_DETAIL_WITH_STATS
-#include <mutex>
-#endif  // UNODB_DETAIL_WITH_STATS
-
 #ifdef UNODB_DETAIL_THREAD_SANITIZER
 #include <sanitizer/tsan_interface.h>
 #endif
@@ -68,10 +71,48 @@ struct set_qsbr_per_thread_in_main_thread {
   UNODB_DETAIL_RESTORE_MSVC_WARNINGS()
 };
 
+/// Node in the linked list of the non-default QSBR domains a thread has
+/// joined, with its state in that domain.
+struct domain_thread_node {
+  /// The domain.
+  unodb::qsbr* domain;
+  /// The thread state in the domain.
+  std::unique_ptr<unodb::qsbr_per_thread> thread;
+  /// Next linked list node.
+  domain_thread_node* next;
+};
+
 }  // namespace unodb::detail
 
 namespace {
 
+/// The non-default QSBR domains the thread has joined. A trivially
+/// destructible head, so that the domains destroyed at the process exit may
+/// look at it after the thread-local destructors of the main thread.
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+constinit thread_local unodb::detail::domain_thread_node* domain_threads{
+    nullptr};
+
+/// The taken unodb::qsbr::domain_thread_cache slots, one bit each.
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+constinit std::atomic<std::uint64_t> used_thread_cache_slots{0};
+
+/// Leave all the non-default QSBR domains the thread has joined.
+void leave_all_domains() noexcept {
+  while (domain_threads != nullptr)
+    domain_threads->domain->leave_current_thread();
+}
+
+/// Leaves the joined domains on the thread exit.
+struct domain_threads_on_exit final {
+  domain_threads_on_exit() noexcept = default;
+  ~domain_threads_on_exit() noexcept { leave_all_domains(); }
+  domain_threads_on_exit(const domain_threads_on_exit&) = delete;
+  domain_threads_on_exit(domain_threads_on_exit&&) = delete;
+  domain_threads_on_exit& operator=(const domain_threads_on_exit&) = delete;
+  domain_threads_on_exit& operator=(domain_threads_on_exit&&) = delete;
+};
+
 /// Global instance to register the thread with QSBR during program startup.
 // NOLINTNEXTLINE(fuchsia-statically-constructed-objects)
 const unodb::detail::set_qsbr_per_thread_in_main_thread do_it;
@@ -85,6 +126,10 @@ thread_local std::unique_ptr<qsbr_per_thread>
     // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
     qsbr_per_thread::current_thread_instance;
 
+constinit thread_local std::array<qsbr_per_thread*, qsbr::cached_domain_count>
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+    qsbr::domain_thread_cache{};
+
 // LCOV_EXCL_START
 [[gnu::cold]] UNODB_DETAIL_NOINLINE void qsbr_epoch::dump(
     std::ostream& os) const {
@@ -96,11 +141,13 @@ thread_local std::unique_ptr<qsbr_per_thread>
 // LCOV_EXCL_STOP
 
 [[nodiscard]] qsbr_state::type
-qsbr_state::atomic_fetch_dec_threads_in_previous_epoch(
-    std::atomic<qsbr_state::type>& word) noexcept {
-  const auto old_word = word.fetch_sub(1, std::memory_order_acq_rel);
+qsbr_state::atomic_fetch_sub_threads_in_previous_epoch(
+    std::atomic<qsbr_state::type>& word,
+    qsbr_thread_count_type threads) noexcept {
+  UNODB_DETAIL_ASSERT(threads > 0);
+  const auto old_word = word.fetch_sub(threads, std::memory_order_acq_rel);
 
-  UNODB_DETAIL_ASSERT(get_threads_in_previous_epoch(old_word) > 0);
+  UNODB_DETAIL_ASSERT(get_threads_in_previous_epoch(old_word) >= threads);
   assert_invariants(old_word);
 
   return old_word;
@@ -198,7 +245,7 @@ void free_orphan_list(detail::dealloc_vector_list_node* list) noexcept {
   while (list != nullptr) {
     const std::unique_ptr<detail::dealloc_vector_list_node> list_ptr{list};
     const detail::deferred_requests requests_to_deallocate{
-        std::move(list_ptr->requests)
+        std::move(list_ptr->requests), nullptr
 #ifndef NDEBUG
             ,
         true,
@@ -210,15 +257,31 @@ void free_orphan_list(detail::dealloc_vector_list_node* list) noexcept {
   }
 }
 
+/// Execute the requests handed off to the background reclaimer and free
+/// \a list itself.
+void free_reclaimer_list(detail::reclaimer_list_node* list) noexcept {
+  while (list != nullptr) {
+    const std::unique_ptr<detail::reclaimer_list_node> list_ptr{list};
+    const detail::deferred_requests requests_to_deallocate{
+        std::move(list_ptr->requests), nullptr
+#ifndef NDEBUG
+        ,
+        false, list_ptr->dealloc_epoch, list_ptr->single_thread_mode
+#endif
+    };
+    list = list_ptr->next;
+  }
+}
+
 }  // namespace
 
 void qsbr_per_thread::orphan_pending_requests() noexcept {
   add_to_orphan_list(
-      qsbr::instance().orphaned_previous_interval_dealloc_requests,
+      domain.orphaned_previous_interval_dealloc_requests,
       std::move(previous_interval_dealloc_requests),
       std::move(previous_interval_orphan_list_node));
   add_to_orphan_list(
-      qsbr::instance().orphaned_current_interval_dealloc_requests,
+      domain.orphaned_current_interval_dealloc_requests,
       std::move(current_interval_dealloc_requests),
       std::move(current_interval_orphan_list_node));
 
@@ -231,8 +294,77 @@ void qsbr_per_thread::orphan_pending_requests() noexcept {
   UNODB_DETAIL_ASSERT(current_interval_orphan_list_node == nullptr);
 }
 
+void qsbr_per_thread::handle_backlog_over_limit() noexcept {
+  while (true) {
+    const auto limit = domain.get_backlog_limit();
+    if (limit == 0 || get_pending_request_count() <= limit) {
+      over_backlog_limit = false;
+      backlog_limit_reported = false;
+      return;
+    }
+
+    if (!backlog_limit_reported) {
+      backlog_limit_reported = true;
+      domain.report_lagging_threads();
+    }
+    if (domain.get_backlog_policy() != qsbr_backlog_policy::throttle) return;
+
+    // This thread is in a quiescent state, and may keep passing through them
+    // until the epoch changes execute enough of its requests.
+    std::this_thread::yield();
+    do_quiescent();
+  }
+}
+
+void qsbr_per_thread::catch_up_after_offline(
+    detail::offline_word::type word) noexcept {
+  const auto helps = detail::offline_word::get_helps(word);
+  UNODB_DETAIL_ASSERT(helps > 0);
+  UNODB_DETAIL_ASSERT(detail::offline_word::passed_quiescent_state(word));
+
+  // The other threads have passed through a quiescent state on behalf of this
+  // one in the word epoch.
+  const auto helped_epoch = detail::offline_word::get_epoch(word);
+#ifdef UNODB_DETAIL_WITH_STATS
+  if (helped_epoch != last_seen_quiescent_state_epoch)
+    register_quiescent_states_between_epoch_changes(
+        quiescent_states_since_epoch_change);
+#endif  // UNODB_DETAIL_WITH_STATS
+  last_seen_quiescent_state_epoch = helped_epoch;
+  quiescent_states_since_epoch_change = 1;
+
+  // This thread went offline in its last seen epoch, and every help after the
+  // first one was in a new epoch. As the epoch cannot advance past the helped
+  // one twice without this thread, the epoch changes since going offline are
+  // one of helps - 1, helps, and helps + 1, which the modulo-4 epoch tells
+  // apart.
+  const auto state = domain.get_state();
+  const auto current_global_epoch = qsbr_state::get_epoch(state);
+  UNODB_DETAIL_ASSERT(current_global_epoch == helped_epoch ||
+                      current_global_epoch == helped_epoch.advance());
+  std::uint32_t epoch_changes = helps - 1;
+  if (helps < 3) {
+    while (last_seen_epoch.advance(epoch_changes % (qsbr_epoch::max + 1U)) !=
+           current_global_epoch) {
+      ++epoch_changes;
+      UNODB_DETAIL_ASSERT(epoch_changes <= helps + 1);
+    }
+  }
+
+  if (epoch_changes == 0) return;
+  if (epoch_changes == 1) {
+    advance_last_seen_epoch(qsbr_state::single_thread_mode(state),
+                            current_global_epoch);
+    return;
+  }
+  // Both the previous and the current interval requests have expired
+  execute_previous_requests(false, last_seen_epoch.advance());
+  execute_previous_requests(false, last_seen_epoch.advance());
+  last_seen_epoch = current_global_epoch;
+}
+
 UNODB_DETAIL_DISABLE_CLANG_21_WARNING("-Wnrvo")
-qsbr_epoch qsbr::register_thread() noexcept {
+qsbr_epoch qsbr::register_thread(std::size_t shard) noexcept {
   auto old_state = get_state();
 
   while (true) {
@@ -248,8 +380,12 @@ qsbr_epoch qsbr::register_thread() noexcept {
 
       if (UNODB_DETAIL_LIKELY(state.compare_exchange_weak(
               old_state, new_state, std::memory_order_acq_rel,
-              std::memory_order_acquire)))
+              std::memory_order_acquire))) {
+        // The epoch cannot change before this thread joins its shard, as it
+        // is in the previous epoch thread count of the state word
+        join_quiescence_shard(shard, old_epoch);
         return old_epoch;
+      }
 
       // LCOV_EXCL_START
       continue;
@@ -270,11 +406,15 @@ qsbr_epoch qsbr::register_thread() noexcept {
       // Spin until the epoch change completes. An alternative would be to
       // return the new epoch early, and then handle seeing it in quiescent
       // state as a no-op, but that trades spinning here for more work in a
-      // hotter path.
+      // hotter path. The shard is joined only in the new epoch, whose
+      // previous epoch thread count already includes this thread.
       while (true) {
         old_state = get_state();
         const auto new_epoch = qsbr_state::get_epoch(old_state);
-        if (new_epoch != old_epoch) return new_epoch;
+        if (new_epoch != old_epoch) {
+          join_quiescence_shard(shard, new_epoch);
+          return new_epoch;
+        }
       }
     }
   }
@@ -284,11 +424,14 @@ UNODB_DETAIL_RESTORE_CLANG_21_WARNINGS()
 
 void qsbr::unregister_thread(std::uint64_t quiescent_states_since_epoch_change,
                              qsbr_epoch thread_epoch,
-                             qsbr_per_thread& qsbr_thread)
-#ifndef UNODB_DETAIL_WITH_STATS
-    noexcept
-#endif
-{
+                             qsbr_per_thread& qsbr_thread) noexcept {
+  // Leave the shard first, so that its next epoch does not wait for this
+  // thread if the epoch changes before the state word update below, whose
+  // new previous epoch thread count still includes this thread then.
+  const auto shard_threads = leave_quiescence_shard(
+      qsbr_thread.quiescence_shard, thread_epoch,
+      quiescent_states_since_epoch_change != 0);
+  const auto passed_threads = shard_threads == 0 ? 0 : shard_threads - 1;
   bool epoch_change_prepared = false;
   auto old_state = state.load(std::memory_order_acquire);
 
@@ -299,6 +442,7 @@ void qsbr::unregister_thread(std::uint64_t quiescent_states_since_epoch_change,
     if (UNODB_DETAIL_UNLIKELY(old_threads_in_previous_epoch == 0)) {
       // LCOV_EXCL_START
       UNODB_DETAIL_ASSERT(thread_epoch == qsbr_state::get_epoch(old_state));
+      UNODB_DETAIL_ASSERT(shard_threads == 0);
 
       // Epoch change in progress - try to decrement the thread count only
       const auto new_state = qsbr_state::dec_thread_count(old_state);
@@ -317,17 +461,19 @@ void qsbr::unregister_thread(std::uint64_t quiescent_states_since_epoch_change,
     const auto old_single_thread_mode =
         qsbr_state::single_thread_mode(old_state);
 
+    // A thread whose quiescent state has been subtracted already is still
+    // counted in the previous epoch if the epoch has changed since
     const auto remove_thread_from_old_epoch =
-        (thread_epoch != old_epoch) ||
-        (quiescent_states_since_epoch_change == 0);
+        (shard_threads != 0) || (thread_epoch != old_epoch);
     const auto advance_epoch =
-        remove_thread_from_old_epoch && (old_threads_in_previous_epoch == 1);
+        remove_thread_from_old_epoch &&
+        (old_threads_in_previous_epoch == passed_threads + 1);
 
     const auto new_state =
         UNODB_DETAIL_UNLIKELY(remove_thread_from_old_epoch)
             ? qsbr_state::
                   dec_thread_count_threads_in_previous_epoch_maybe_advance(
-                      old_state, advance_epoch)
+                      old_state, advance_epoch, passed_threads)
             : qsbr_state::dec_thread_count(old_state);
 
     if (UNODB_DETAIL_UNLIKELY(remove_thread_from_old_epoch)) {
@@ -350,6 +496,7 @@ void qsbr::unregister_thread(std::uint64_t quiescent_states_since_epoch_change,
       // second-to-last thread quit before, advancing the epoch.
       qsbr_thread.advance_last_seen_epoch(old_single_thread_mode, old_epoch);
       if (UNODB_DETAIL_UNLIKELY(advance_epoch)) {
+        bump_epoch_change_sequence(old_single_thread_mode);
 #ifdef UNODB_DETAIL_WITH_STATS
         bump_epoch_change_count();
 #endif  // UNODB_DETAIL_WITH_STATS
@@ -360,7 +507,7 @@ void qsbr::unregister_thread(std::uint64_t quiescent_states_since_epoch_change,
 
 #ifdef UNODB_DETAIL_WITH_STATS
       if (UNODB_DETAIL_UNLIKELY(thread_epoch != old_epoch)) {
-        register_quiescent_states_per_thread_between_epoch_changes(
+        qsbr_thread.register_quiescent_states_between_epoch_changes(
             quiescent_states_since_epoch_change);
       }
 #endif  // UNODB_DETAIL_WITH_STATS
@@ -377,22 +524,31 @@ void qsbr::reset_stats() {
   // prevents to leaving idle state at any time
   assert_idle();
 
-  {
-    const std::lock_guard guard{dealloc_stats_lock};
-
-    epoch_dealloc_per_thread_count_stats = {};
-    publish_epoch_callback_stats();
+  const std::lock_guard guard{thread_registry_lock};
+  stats_generation.store(stats_generation.load(std::memory_order_relaxed) + 1,
+                         std::memory_order_relaxed);
+  unregistered_thread_stats = {};
+}
 
-    deallocation_size_per_thread_stats = {};
-    publish_deallocation_size_stats();
+detail::qsbr_stats_summary qsbr::summarize_stats() const noexcept {
+  const std::lock_guard guard{thread_registry_lock};
+  auto result = unregistered_thread_stats;
+  const auto generation = get_stats_generation();
+  for (const auto* thread = registered_threads; thread != nullptr;
+       thread = thread->next_registered_thread) {
+    // Acquire the reset of the statistics started over for this generation
+    if (thread->stats.generation.load(std::memory_order_acquire) == generation)
+      thread->stats.add_to(result);
   }
+  return result;
+}
 
-  {
-    const std::lock_guard guard{quiescent_state_stats_lock};
-
-    quiescent_states_per_thread_between_epoch_change_stats = {};
-    publish_quiescent_states_per_thread_between_epoch_change_stats();
-  }
+void qsbr::retire_thread_stats(qsbr_per_thread& thread) noexcept {
+  const std::lock_guard guard{thread_registry_lock};
+  if (thread.stats.generation.load(std::memory_order_relaxed) ==
+      get_stats_generation())
+    thread.stats.add_to(unregistered_thread_stats);
+  thread.stats.reset();
 }
 
 #endif  // UNODB_DETAIL_WITH_STATS
@@ -418,7 +574,7 @@ void qsbr::thread_epoch_change_barrier() noexcept {
 }
 
 qsbr_epoch qsbr::remove_thread_from_previous_epoch(
-    qsbr_epoch current_global_epoch
+    qsbr_epoch current_global_epoch, std::size_t shard
 #ifndef NDEBUG
     ,
     qsbr_epoch thread_epoch
@@ -426,8 +582,37 @@ qsbr_epoch qsbr::remove_thread_from_previous_epoch(
     ) noexcept {
   thread_epoch_change_barrier();
 
-  const auto old_state =
-      qsbr_state::atomic_fetch_dec_threads_in_previous_epoch(state);
+  // Pass through the quiescent state in the shard. The state word is updated
+  // only by the last thread of the shard to pass, for all of them.
+  auto& shard_word = quiescence_shards[shard].word;
+  auto old_shard_word = shard_word.load(std::memory_order_acquire);
+  qsbr_thread_count_type passed_threads;
+  while (true) {
+    const auto current_shard_word =
+        detail::quiescence_shard_word::start_epoch(old_shard_word,
+                                                   current_global_epoch);
+    if (UNODB_DETAIL_UNLIKELY(
+            detail::quiescence_shard_word::is_flushed(current_shard_word))) {
+      // This thread joined the shard after its flush in this epoch, thus is
+      // not counted there
+      passed_threads = 1;
+      break;
+    }
+    const auto new_shard_word =
+        detail::quiescence_shard_word::pass(current_shard_word);
+    if (UNODB_DETAIL_LIKELY(shard_word.compare_exchange_weak(
+            old_shard_word, new_shard_word, std::memory_order_acq_rel,
+            std::memory_order_acquire))) {
+      if (!detail::quiescence_shard_word::is_flushed(new_shard_word))
+        return current_global_epoch;
+      passed_threads =
+          detail::quiescence_shard_word::get_passed(current_shard_word) + 1;
+      break;
+    }
+  }
+
+  const auto old_state = qsbr_state::atomic_fetch_sub_threads_in_previous_epoch(
+      state, passed_threads);
 
   const auto old_threads_in_previous_epoch =
       qsbr_state::get_threads_in_previous_epoch(old_state);
@@ -440,7 +625,8 @@ qsbr_epoch qsbr::remove_thread_from_previous_epoch(
   UNODB_DETAIL_ASSERT(thread_epoch == current_global_epoch ||
                       thread_epoch.advance() == current_global_epoch);
 
-  if (old_threads_in_previous_epoch > 1) return current_global_epoch;
+  if (old_threads_in_previous_epoch > passed_threads)
+    return current_global_epoch;
 
   const auto new_epoch =
       change_epoch(current_global_epoch, old_single_thread_mode);
@@ -498,6 +684,316 @@ void qsbr::epoch_change_barrier_and_handle_orphans(
   }
 }
 
+void qsbr::start_background_reclaimer() {
+  const std::lock_guard control_guard{reclaimer_control_lock};
+  const std::lock_guard guard{reclaimer_lock};
+  if (reclaimer_enabled.load(std::memory_order_relaxed)) return;
+
+  UNODB_DETAIL_ASSERT(!reclaimer_thread.joinable());
+  UNODB_DETAIL_ASSERT(reclaimer_requests == nullptr);
+  reclaimer_thread = std::thread{[this] { run_background_reclaimer(); }};
+  reclaimer_enabled.store(true, std::memory_order_release);
+}
+
+void qsbr::stop_background_reclaimer() noexcept {
+  // Held until the join, so that a concurrent start does not replace a
+  // joinable thread
+  const std::lock_guard control_guard{reclaimer_control_lock};
+  {
+    const std::lock_guard guard{reclaimer_lock};
+    if (!reclaimer_enabled.load(std::memory_order_relaxed)) return;
+    reclaimer_enabled.store(false, std::memory_order_release);
+  }
+  reclaimer_wakeup.notify_one();
+  reclaimer_thread.join();
+  UNODB_DETAIL_ASSERT(reclaimer_requests == nullptr);
+}
+
+bool qsbr::hand_off_to_reclaimer(detail::dealloc_request_vector& requests
+#ifndef NDEBUG
+                                 ,
+                                 qsbr_epoch dealloc_epoch,
+                                 bool single_thread_mode
+#endif
+                                 ) noexcept {
+  UNODB_DETAIL_ASSERT(!requests.empty());
+
+  // If the list node cannot be allocated, the caller executes the requests
+  std::unique_ptr<detail::reclaimer_list_node> list_node{
+      new (std::nothrow) detail::reclaimer_list_node{std::move(requests),
+                                                     nullptr
+#ifndef NDEBUG
+                                                     ,
+                                                     dealloc_epoch,
+                                                     single_thread_mode
+#endif
+      }};
+  if (UNODB_DETAIL_UNLIKELY(list_node == nullptr)) return false;
+
+  {
+    const std::lock_guard guard{reclaimer_lock};
+    // Stopped since the caller checked
+    if (UNODB_DETAIL_UNLIKELY(
+            !reclaimer_enabled.load(std::memory_order_relaxed))) {
+      requests = std::move(list_node->requests);
+      return false;
+    }
+
+    list_node->next = reclaimer_requests;
+    reclaimer_requests = list_node.release();
+  }
+  reclaimer_wakeup.notify_one();
+  return true;
+}
+
+void qsbr::run_background_reclaimer() noexcept {
+  std::unique_lock guard{reclaimer_lock};
+  while (true) {
+    reclaimer_wakeup.wait(guard, [this]() noexcept {
+      return reclaimer_requests != nullptr ||
+             !reclaimer_enabled.load(std::memory_order_relaxed);
+    });
+    // The requests handed off before the stop are executed before exiting
+    auto* const requests = std::exchange(reclaimer_requests, nullptr);
+    if (requests == nullptr) return;
+
+    guard.unlock();
+    free_reclaimer_list(requests);
+    guard.lock();
+  }
+}
+
+qsbr::qsbr() noexcept : thread_cache_slot{acquire_thread_cache_slot()} {}
+
+std::size_t qsbr::acquire_thread_cache_slot() noexcept {
+  static_assert(cached_domain_count == 64);
+  auto used = used_thread_cache_slots.load(std::memory_order_relaxed);
+  while (true) {
+    if (UNODB_DETAIL_UNLIKELY(~used == 0)) return no_thread_cache_slot;
+    const auto slot = static_cast<std::size_t>(std::countr_one(used));
+    if (UNODB_DETAIL_LIKELY(used_thread_cache_slots.compare_exchange_weak(
+            used, used | (std::uint64_t{1} << slot), std::memory_order_acquire,
+            std::memory_order_relaxed)))
+      return slot;
+  }
+}
+
+qsbr::~qsbr() noexcept {
+  stop_background_reclaimer();
+  if (!default_domain) {
+    leave_current_thread();
+    // Release pairs with the acquire of the next domain taking the slot,
+    // ordering the cache entries of the threads that left this one before it
+    if (thread_cache_slot != no_thread_cache_slot)
+      used_thread_cache_slots.fetch_and(
+          ~(std::uint64_t{1} << thread_cache_slot), std::memory_order_release);
+    // No threads are left to hold pointers to the orphaned requests
+    UNODB_DETAIL_ASSERT(qsbr_state::get_thread_count(get_state()) == 0);
+    UNODB_DETAIL_ASSERT(registered_threads == nullptr);
+    free_orphan_list(
+        take_orphan_list(orphaned_previous_interval_dealloc_requests));
+    free_orphan_list(
+        take_orphan_list(orphaned_current_interval_dealloc_requests));
+  }
+  assert_idle();
+}
+
+qsbr_per_thread& qsbr::join_current_thread() {
+  UNODB_DETAIL_ASSERT(!default_domain);
+
+  for (auto* node = domain_threads; node != nullptr; node = node->next)
+    if (node->domain == this) return *node->thread;
+
+  // The per-thread state registers with the domain on construction
+  auto new_node = std::make_unique<detail::domain_thread_node>(
+      this, std::make_unique<qsbr_per_thread>(*this), domain_threads);
+  // Make sure the joined domains are left on the thread exit
+  static thread_local const domain_threads_on_exit on_exit;
+  domain_threads = new_node.release();
+  if (thread_cache_slot != no_thread_cache_slot)
+    domain_thread_cache[thread_cache_slot] = domain_threads->thread.get();
+  return *domain_threads->thread;
+}
+
+void qsbr::leave_current_thread() noexcept {
+  UNODB_DETAIL_ASSERT(!default_domain);
+
+  for (auto** link = &domain_threads; *link != nullptr;
+       link = &(*link)->next) {
+    if ((*link)->domain != this) continue;
+    const std::unique_ptr<detail::domain_thread_node> node{*link};
+    *link = node->next;
+    if (thread_cache_slot != no_thread_cache_slot)
+      domain_thread_cache[thread_cache_slot] = nullptr;
+    return;
+  }
+}
+
+
+void qsbr::set_backlog_limit(std::size_t max_requests,
+                             qsbr_backlog_policy policy,
+                             qsbr_backlog_callback callback) {
+  const std::lock_guard guard{thread_registry_lock};
+  backlog_callback = std::move(callback);
+  backlog_policy.store(policy, std::memory_order_relaxed);
+  backlog_limit.store(max_requests, std::memory_order_relaxed);
+}
+
+void qsbr::for_each_lagging_thread(const qsbr_backlog_callback& fn) {
+  std::vector<std::thread::id> lagging_threads;
+  {
+    const std::lock_guard guard{thread_registry_lock};
+    lagging_threads = get_lagging_threads_locked();
+  }
+  for (const auto thread_id : lagging_threads) fn(thread_id);
+}
+
+std::vector<std::thread::id> qsbr::get_lagging_threads_locked() const {
+  std::vector<std::thread::id> result;
+  const auto current_epoch = qsbr_state::get_epoch(get_state());
+  for (const auto* thread = registered_threads; thread != nullptr;
+       thread = thread->next_registered_thread) {
+    if (thread->published_quiescent_state_epoch.load(
+            std::memory_order_relaxed) != current_epoch)
+      result.push_back(thread->thread_id);
+  }
+  return result;
+}
+
+void qsbr::report_lagging_threads() noexcept {
+  qsbr_backlog_callback callback;
+  std::vector<std::thread::id> lagging_threads;
+  {
+    const std::lock_guard guard{thread_registry_lock};
+    if (backlog_callback == nullptr) return;
+    callback = backlog_callback;
+    lagging_threads = get_lagging_threads_locked();
+  }
+  // Unlocked, so that the callback may call the rest of the domain API
+  for (const auto thread_id : lagging_threads) callback(thread_id);
+}
+
+void qsbr::help_offline_threads() noexcept {
+  const std::unique_lock guard{thread_registry_lock, std::try_to_lock};
+  if (!guard.owns_lock()) return;  // LCOV_EXCL_LINE
+  for (auto* thread = registered_threads; thread != nullptr;
+       thread = thread->next_registered_thread) {
+    auto word = thread->offline_word.load(std::memory_order_acquire);
+    if (!detail::offline_word::is_offline(word)) continue;
+
+    // An offline thread which has not passed through a quiescent state in the
+    // current epoch holds it back, thus the epoch cannot change until the CAS
+    // below, unless the thread goes online, failing the CAS.
+    const auto current_global_epoch = qsbr_state::get_epoch(get_state());
+    const auto thread_epoch = detail::offline_word::get_epoch(word);
+    const auto passed_quiescent_state =
+        detail::offline_word::passed_quiescent_state(word);
+    if (passed_quiescent_state
+            ? thread_epoch.advance() != current_global_epoch
+            : thread_epoch != current_global_epoch)
+      continue;
+
+    if (!thread->offline_word.compare_exchange_strong(
+            word,
+            detail::offline_word::make(current_global_epoch, true,
+                                       detail::offline_word::get_helps(word) +
+                                           1,
+                                       word),
+            std::memory_order_acq_rel, std::memory_order_relaxed))
+      continue;
+
+    thread->published_quiescent_state_epoch.store(current_global_epoch,
+                                                  std::memory_order_relaxed);
+    std::ignore = remove_thread_from_previous_epoch(current_global_epoch,
+                                                    thread->quiescence_shard
+#ifndef NDEBUG
+                                                    ,
+                                                    thread_epoch
+#endif
+    );
+  }
+}
+
+void qsbr::link_thread(qsbr_per_thread& thread) noexcept {
+  const std::lock_guard guard{thread_registry_lock};
+  UNODB_DETAIL_ASSERT(thread.next_registered_thread == nullptr);
+  thread.next_registered_thread = registered_threads;
+  registered_threads = &thread;
+}
+
+void qsbr::unlink_thread(qsbr_per_thread& thread) noexcept {
+  const std::lock_guard guard{thread_registry_lock};
+  for (auto** link = &registered_threads; *link != nullptr;
+       link = &(*link)->next_registered_thread) {
+    if (*link != &thread) continue;
+    *link = thread.next_registered_thread;
+    thread.next_registered_thread = nullptr;
+    return;
+  }
+  UNODB_DETAIL_CANNOT_HAPPEN();
+}
+
+void qsbr::set_thread_owner(qsbr_per_thread& thread) noexcept {
+  const std::lock_guard guard{thread_registry_lock};
+  thread.thread_id = std::this_thread::get_id();
+}
+
+std::size_t qsbr::choose_quiescence_shard() const noexcept {
+  std::size_t result = 0;
+  auto result_threads = detail::quiescence_shard_word::get_threads(
+      quiescence_shards[0].word.load(std::memory_order_relaxed));
+  for (std::size_t i = 1; i < quiescence_shard_count; ++i) {
+    const auto threads = detail::quiescence_shard_word::get_threads(
+        quiescence_shards[i].word.load(std::memory_order_relaxed));
+    if (threads < result_threads) {
+      result = i;
+      result_threads = threads;
+    }
+  }
+  return result;
+}
+
+void qsbr::join_quiescence_shard(std::size_t shard,
+                                 qsbr_epoch current_global_epoch) noexcept {
+  auto& shard_word = quiescence_shards[shard].word;
+  auto old_shard_word = shard_word.load(std::memory_order_relaxed);
+  while (!shard_word.compare_exchange_weak(
+      old_shard_word,
+      detail::quiescence_shard_word::add_thread(old_shard_word,
+                                                current_global_epoch),
+      std::memory_order_acq_rel, std::memory_order_relaxed)) {
+  }
+}
+
+qsbr_thread_count_type qsbr::leave_quiescence_shard(
+    std::size_t shard, qsbr_epoch thread_epoch,
+    bool passed_quiescent_state) noexcept {
+  auto& shard_word = quiescence_shards[shard].word;
+  auto old_shard_word = shard_word.load(std::memory_order_acquire);
+  while (true) {
+    // The shard counts the thread among the ones to pass if it counts the
+    // quiescent states in the epoch the thread has not passed through one in
+    // yet, and among the passed ones if it still counts them in the epoch the
+    // thread has. Otherwise, the thread is counted in the state word only, if
+    // at all.
+    const auto waiting = detail::quiescence_shard_word::is_counting(
+        old_shard_word,
+        passed_quiescent_state ? thread_epoch.advance() : thread_epoch);
+    const auto passed =
+        passed_quiescent_state && detail::quiescence_shard_word::is_counting(
+                                      old_shard_word, thread_epoch);
+    const auto new_shard_word = detail::quiescence_shard_word::remove_thread(
+        old_shard_word, waiting, passed);
+    if (UNODB_DETAIL_LIKELY(shard_word.compare_exchange_weak(
+            old_shard_word, new_shard_word, std::memory_order_acq_rel,
+            std::memory_order_acquire))) {
+      if (waiting && detail::quiescence_shard_word::is_flushed(new_shard_word))
+        return detail::quiescence_shard_word::get_passed(old_shard_word) + 1;
+      return (waiting || passed || !passed_quiescent_state) ? 1 : 0;
+    }
+  }
+}
+
 qsbr_epoch qsbr::change_epoch(qsbr_epoch current_global_epoch,
                               bool single_thread_mode) noexcept {
   epoch_change_barrier_and_handle_orphans(single_thread_mode);
@@ -514,6 +1010,7 @@ qsbr_epoch qsbr::change_epoch(qsbr_epoch current_global_epoch,
       UNODB_DETAIL_ASSERT(current_global_epoch.advance() ==
                           qsbr_state::get_epoch(new_state));
 
+      bump_epoch_change_sequence(qsbr_state::single_thread_mode(old_state));
 #ifdef UNODB_DETAIL_WITH_STATS
       bump_epoch_change_count();
 #endif  // UNODB_DETAIL_WITH_STATS
@@ -33,12 +33,19 @@
 // IWYU pragma: no_include <boost/fusion/sequence/intrinsic/end.hpp>
 // IWYU pragma: no_include <boost/fusion/iterator/deref.hpp>
 
+#include <algorithm>
+#include <array>
 #include <atomic>
+#include <condition_variable>
 #include <cstddef>
 #include <cstdint>
 #include <exception>
+#include <functional>
 #include <iostream>
+#include <limits>
 #include <memory>
+#include <mutex>
+#include <new>
 #include <system_error>
 #include <thread>
 #include <type_traits>
@@ -51,20 +58,6 @@
 #include <unordered_set>
 #endif
 
-#ifdef UNODB_DETAIL_WITH_STATS
-
-#include <mutex>
-
-#include <boost/accumulators/accumulators_fwd.hpp>  // IWYU pragma: keep
-#include <boost/accumulators/framework/accumulator_set.hpp>
-#include <boost/accumulators/framework/extractor.hpp>
-#include <boost/accumulators/statistics/max.hpp>
-#include <boost/accumulators/statistics/mean.hpp>
-#include <boost/accumulators/statistics/stats.hpp>
-#include <boost/accumulators/statistics/variance.hpp>
-
-#endif  // UNODB_DETAIL_WITH_STATS
-
 #include "assert.hpp"
 #include "heap.hpp"
 #include "portability_arch.hpp"
@@ -194,6 +187,11 @@ inline constexpr qsbr_thread_count_type max_qsbr_threads = (2UL << 29U) - 1U;
 /// this thread is responsible for the epoch change. The decrement of the last
 /// thread in the previous epoch and the epoch bump may happen in a single step,
 /// in which case nobody will observe zero threads in the previous epoch.
+///
+/// The threads are subtracted from the previous epoch count by their quiescence
+/// shards, see detail::quiescence_shard_word, thus a thread that has passed
+/// through a quiescent state stays counted there until the rest of its shard
+/// does too.
 // TODO(laurynas): move to detail namespace
 struct qsbr_state {
   /// Underlying type for the state word.
@@ -318,18 +316,23 @@ struct qsbr_state {
     return result;
   }
 
-  /// Decrement both the thread count and threads in previous epoch in \a word.
+  /// Decrement the thread count in \a word, and the threads in previous epoch
+  /// by one and \a passed_threads more, the count of the other threads whose
+  /// quiescent states the quiescence shard of the thread reports with it.
   [[nodiscard, gnu::const]] static constexpr type
-  dec_thread_count_and_threads_in_previous_epoch(type word) noexcept {
+  dec_thread_count_and_threads_in_previous_epoch(
+      type word, qsbr_thread_count_type passed_threads) noexcept {
     assert_invariants(word);
     UNODB_DETAIL_ASSERT(get_thread_count(word) > 0);
-    UNODB_DETAIL_ASSERT(get_threads_in_previous_epoch(word) > 0);
+    UNODB_DETAIL_ASSERT(get_threads_in_previous_epoch(word) >
+                        passed_threads);
 
-    const auto result = word - one_thread_and_one_in_previous;
+    const auto result = word - one_thread_and_one_in_previous - passed_threads;
 
     assert_invariants(result);
     UNODB_DETAIL_ASSERT(get_epoch(word) == get_epoch(result));
-    UNODB_DETAIL_ASSERT(get_threads_in_previous_epoch(word) - 1 ==
+    UNODB_DETAIL_ASSERT(get_threads_in_previous_epoch(word) - 1 -
+                            passed_threads ==
                         get_threads_in_previous_epoch(result));
     UNODB_DETAIL_ASSERT(get_thread_count(word) - 1 == get_thread_count(result));
 
@@ -361,13 +364,18 @@ struct qsbr_state {
   }
 
   /// Increment the epoch, decrement the thread count, and reset the threads in
-  /// previous epoch to the new thread count.
+  /// previous epoch, which must be one plus \a passed_threads, to the new
+  /// thread count.
   [[nodiscard, gnu::const]] static constexpr type
-  inc_epoch_dec_thread_count_reset_previous(type word) noexcept {
+  inc_epoch_dec_thread_count_reset_previous(
+      type word,
+      qsbr_thread_count_type passed_threads
+          UNODB_DETAIL_USED_IN_DEBUG) noexcept {
     assert_invariants(word);
     const auto old_thread_count = get_thread_count(word);
     UNODB_DETAIL_ASSERT(old_thread_count > 0);
-    UNODB_DETAIL_ASSERT(get_threads_in_previous_epoch(word) == 1);
+    UNODB_DETAIL_ASSERT(get_threads_in_previous_epoch(word) ==
+                        passed_threads + 1);
 
     const auto new_word_with_epoch = make_from_epoch(get_epoch(word).advance());
     const auto new_thread_count = old_thread_count - 1;
@@ -386,21 +394,27 @@ struct qsbr_state {
     return result;
   }
 
-  /// Decrement thread counts in \a word while optionally advancing the epoch if
+  /// Decrement thread counts in \a word, the threads in previous epoch by one
+  /// plus \a passed_threads, while optionally advancing the epoch if
   /// \a advance_epoch is set.
   [[nodiscard, gnu::const]] static constexpr type
   dec_thread_count_threads_in_previous_epoch_maybe_advance(
-      type word, bool advance_epoch) noexcept {
+      type word, bool advance_epoch,
+      qsbr_thread_count_type passed_threads) noexcept {
     return UNODB_DETAIL_UNLIKELY(advance_epoch)
-               ? inc_epoch_dec_thread_count_reset_previous(word)
-               : dec_thread_count_and_threads_in_previous_epoch(word);
+               ? inc_epoch_dec_thread_count_reset_previous(word, passed_threads)
+               : dec_thread_count_and_threads_in_previous_epoch(word,
+                                                                passed_threads);
   }
 
-  /// Atomically decrement the number of threads in the previous epoch.
+  /// Atomically subtract \a threads from the number of threads in the
+  /// previous epoch.
   /// \param word atomic QSBR state word
+  /// \param threads count of threads to subtract
   /// \return old word value
   [[nodiscard]] static qsbr_state::type
-  atomic_fetch_dec_threads_in_previous_epoch(std::atomic<type>& word) noexcept;
+  atomic_fetch_sub_threads_in_previous_epoch(
+      std::atomic<type>& word, qsbr_thread_count_type threads) noexcept;
 
   /// Assert that all invariants hold for \a word.
   static constexpr void assert_invariants(type word
@@ -408,8 +422,11 @@ struct qsbr_state {
 #ifndef NDEBUG
     const auto thread_count = do_get_thread_count(word);
     UNODB_DETAIL_ASSERT(thread_count <= max_qsbr_threads);
-    const auto threads_in_previous = do_get_threads_in_previous_epoch(word);
-    UNODB_DETAIL_ASSERT(threads_in_previous <= thread_count);
+    // The threads in the previous epoch may exceed the thread count for a
+    // moment, while a quiescence shard subtracts its passed threads, some of
+    // which may have quit since. Thus only check the field range.
+    UNODB_DETAIL_ASSERT(do_get_threads_in_previous_epoch(word) <=
+                        max_qsbr_threads);
 #endif
   }
 
@@ -450,6 +467,297 @@ struct qsbr_state {
 
 namespace detail {
 
+/// Encoding of the word of a QSBR domain quiescence shard, which counts the
+/// quiescent states of a subset of the domain threads, so that the threads of
+/// different shards do not write the same cache line, and the state word is
+/// written once per shard and epoch instead of once per thread and epoch.
+///
+/// The word holds the epoch the shard counts the quiescent states in, the
+/// count of its threads, the count of those yet to pass through a quiescent
+/// state in that epoch, and the count of those that have, but have not been
+/// subtracted from the threads in the previous epoch of the state word yet.
+/// Once no threads are left to pass, the last one subtracts the passed ones
+/// together with itself, and marks the shard as flushed. The threads joining a
+/// flushed shard, or one of an older epoch, are not counted in its epoch, and
+/// subtract themselves from the state word directly. A word of an older epoch
+/// is started over with all its threads to pass by the first quiescent state
+/// in the current one. As all the threads of a shard pass through a quiescent
+/// state before the epoch changes, that word is always of the previous epoch,
+/// with nothing left to subtract, unless the shard has no threads.
+struct quiescence_shard_word {
+  /// Underlying type for the word.
+  using type = std::uint64_t;
+
+  /// Maximum number of threads in a single shard. As the new threads join the
+  /// shard with the fewest threads, the domain holds a multiple of it. Its
+  /// overflow is not checked in Release builds, as with max_qsbr_threads.
+  static constexpr qsbr_thread_count_type max_threads = (1U << 20U) - 1U;
+
+  /// Get the epoch from \a word.
+  [[nodiscard, gnu::const]] static constexpr qsbr_epoch get_epoch(
+      type word) noexcept {
+    return qsbr_epoch{
+        static_cast<qsbr_epoch::epoch_type>(word >> epoch_offset)};
+  }
+
+  /// Get the count of the shard threads from \a word.
+  [[nodiscard, gnu::const]] static constexpr qsbr_thread_count_type
+  get_threads(type word) noexcept {
+    return get_field(word, threads_offset);
+  }
+
+  /// Get the count of the threads yet to pass through a quiescent state from
+  /// \a word.
+  [[nodiscard, gnu::const]] static constexpr qsbr_thread_count_type
+  get_waiting(type word) noexcept {
+    return get_field(word, waiting_offset);
+  }
+
+  /// Get the count of the threads that passed through a quiescent state but
+  /// have not been subtracted from the state word from \a word.
+  [[nodiscard, gnu::const]] static constexpr qsbr_thread_count_type
+  get_passed(type word) noexcept {
+    return get_field(word, 0);
+  }
+
+  /// Check whether all the threads counted in the epoch of \a word have been
+  /// subtracted from the state word.
+  [[nodiscard, gnu::const]] static constexpr bool is_flushed(
+      type word) noexcept {
+    return (word & flushed_bit) != 0;
+  }
+
+  /// Check whether \a word counts the quiescent states of its threads in
+  /// \a epoch, and has not been flushed yet.
+  [[nodiscard, gnu::const]] static constexpr bool is_counting(
+      type word, qsbr_epoch epoch) noexcept {
+    return get_epoch(word) == epoch && !is_flushed(word);
+  }
+
+  /// Start counting the quiescent states in \a epoch over in \a word, unless
+  /// it already counts them.
+  [[nodiscard, gnu::const]] static constexpr type start_epoch(
+      type word, qsbr_epoch epoch) noexcept {
+    if (get_epoch(word) == epoch) return word;
+    UNODB_DETAIL_ASSERT(get_waiting(word) == 0);
+    UNODB_DETAIL_ASSERT(get_passed(word) == 0);
+    const auto threads = get_threads(word);
+    return make(epoch, false, threads, threads, 0);
+  }
+
+  /// Add a thread which has not passed through a quiescent state in the
+  /// current \a epoch to \a word.
+  [[nodiscard, gnu::const]] static constexpr type add_thread(
+      type word, qsbr_epoch epoch) noexcept {
+    UNODB_DETAIL_ASSERT(get_threads(word) < max_threads);
+    if (!is_counting(word, epoch)) {
+      UNODB_DETAIL_ASSERT(get_waiting(word) == 0);
+      UNODB_DETAIL_ASSERT(get_passed(word) == 0);
+      return word + one_thread;
+    }
+    return word + one_thread + one_waiting;
+  }
+
+  /// Pass a thread through a quiescent state in \a word, which must be
+  /// counting them in the current epoch. Flushes the shard if it is the last
+  /// one to pass.
+  [[nodiscard, gnu::const]] static constexpr type pass(type word) noexcept {
+    UNODB_DETAIL_ASSERT(!is_flushed(word));
+    UNODB_DETAIL_ASSERT(get_waiting(word) > 0);
+    if (get_waiting(word) == 1)
+      return make(get_epoch(word), true, get_threads(word), 0, 0);
+    return word - one_waiting + 1;
+  }
+
+  /// Remove a thread from \a word. If \a waiting is set, the thread is one
+  /// of the ones yet to pass, and it flushes the shard if it is the last one.
+  /// If \a passed is set, it is one of the passed ones instead.
+  [[nodiscard, gnu::const]] static constexpr type remove_thread(
+      type word, bool waiting, bool passed) noexcept {
+    UNODB_DETAIL_ASSERT(get_threads(word) > 0);
+    UNODB_DETAIL_ASSERT(!waiting || !passed);
+    if (passed) {
+      UNODB_DETAIL_ASSERT(get_passed(word) > 0);
+      return word - one_thread - 1;
+    }
+    if (!waiting) return word - one_thread;
+    UNODB_DETAIL_ASSERT(get_waiting(word) > 0);
+    if (get_waiting(word) == 1)
+      return make(get_epoch(word), true, get_threads(word) - 1, 0, 0);
+    return word - one_thread - one_waiting;
+  }
+
+ private:
+  /// Make a word from its fields.
+  [[nodiscard, gnu::const]] static constexpr type make(
+      qsbr_epoch epoch, bool flushed, qsbr_thread_count_type threads,
+      qsbr_thread_count_type waiting, qsbr_thread_count_type passed) noexcept {
+    UNODB_DETAIL_ASSERT(waiting + passed <= threads);
+    UNODB_DETAIL_ASSERT(threads <= max_threads);
+    return (static_cast<type>(epoch.get_val()) << epoch_offset) |
+           (flushed ? flushed_bit : 0U) |
+           (static_cast<type>(threads) << threads_offset) |
+           (static_cast<type>(waiting) << waiting_offset) | passed;
+  }
+
+  /// Extract the count field at \a offset from \a word.
+  [[nodiscard, gnu::const]] static constexpr qsbr_thread_count_type get_field(
+      type word, unsigned offset) noexcept {
+    return static_cast<qsbr_thread_count_type>((word >> offset) & max_threads);
+  }
+
+  /// Bit offset for the waiting thread count field.
+  static constexpr auto waiting_offset = 20U;
+
+  /// Bit offset for the thread count field.
+  static constexpr auto threads_offset = 40U;
+
+  /// Bit offset for the epoch field.
+  static constexpr auto epoch_offset = 62U;
+
+  /// Flag for the shard having been flushed in its epoch.
+  static constexpr type flushed_bit = 1ULL << 60U;
+
+  /// Value to use for incrementing or decrementing the waiting thread count.
+  static constexpr auto one_waiting = 1ULL << waiting_offset;
+
+  /// Value to use for incrementing or decrementing the thread count.
+  static constexpr auto one_thread = 1ULL << threads_offset;
+
+  static_assert(((max_threads + 1ULL) << threads_offset) <= flushed_bit);
+};
+
+/// Per-thread lists of memory blocks reclaimed by QSBR, from which the next
+/// allocations of the same kind take their memory instead of the heap.
+///
+/// Each list holds blocks of a single size, which its first block sets, and at
+/// most get_capacity() of them. A block over the capacity, or of a size other
+/// than that of the blocks already on the list, is freed instead.
+class qsbr_free_lists final {
+ public:
+  /// Number of the lists.
+  static constexpr std::size_t list_count = 8;
+
+  /// Default maximum number of blocks on each list.
+  static constexpr std::size_t default_capacity = 1024;
+
+  /// Create empty lists.
+  qsbr_free_lists() noexcept = default;
+
+  /// Free all the blocks on the lists.
+  ~qsbr_free_lists() noexcept { trim(0); }
+
+  /// Check whether put() would keep a block of \a size bytes on the list
+  /// \a list instead of freeing it.
+  [[nodiscard]] bool accepts(std::size_t list,
+                             std::size_t size) const noexcept {
+    UNODB_DETAIL_ASSERT(list < list_count);
+    const auto& free_list = lists[list];
+    return free_list.count < capacity &&
+           (free_list.count == 0 || free_list.block_size == size);
+  }
+
+  /// Put \a block of \a size bytes, allocated with allocate_aligned(), onto
+  /// the list \a list, or free it.
+  void put(std::size_t list, void* block, std::size_t size) noexcept {
+    if (UNODB_DETAIL_UNLIKELY(!accepts(list, size))) {
+      free_aligned(block);
+      return;
+    }
+    auto& free_list = lists[list];
+    if (free_list.count == 0) free_list.block_size = size;
+    free_list.head = new (block) free_block{free_list.head};
+    ++free_list.count;
+  }
+
+  /// Take a block of \a size bytes from the list \a list.
+  ///
+  /// In debug builds, the allocation failure injector is hooked as for a heap
+  /// allocation.
+  ///
+  /// \return the block, or \c nullptr if the list has none of that size.
+  /// \throws `std::bad_alloc` if the failure injector says so
+  [[nodiscard]] void* take(std::size_t list, std::size_t size) {
+    UNODB_DETAIL_ASSERT(list < list_count);
+    auto& free_list = lists[list];
+    if (free_list.head == nullptr || free_list.block_size != size)
+      return nullptr;
+#ifndef NDEBUG
+    unodb::test::allocation_failure_injector::maybe_fail();
+#endif
+    auto* const result = free_list.head;
+    free_list.head = result->next;
+    --free_list.count;
+    return result;
+  }
+
+  /// Set the maximum number of blocks on each list to \a new_capacity,
+  /// freeing the blocks over it. Zero disables the lists.
+  void set_capacity(std::size_t new_capacity) noexcept {
+    capacity = new_capacity;
+    trim(new_capacity);
+  }
+
+  /// Get the maximum number of blocks on each list.
+  [[nodiscard]] std::size_t get_capacity() const noexcept { return capacity; }
+
+  /// Get the number of blocks on the list \a list.
+  [[nodiscard]] std::size_t size(std::size_t list) const noexcept {
+    UNODB_DETAIL_ASSERT(list < list_count);
+    return lists[list].count;
+  }
+
+  /// Copy construction is disabled.
+  qsbr_free_lists(const qsbr_free_lists&) = delete;
+
+  /// Move construction is disabled.
+  qsbr_free_lists(qsbr_free_lists&&) = delete;
+
+  /// Copy assignment is disabled.
+  qsbr_free_lists& operator=(const qsbr_free_lists&) = delete;
+
+  /// Move assignment is disabled.
+  qsbr_free_lists& operator=(qsbr_free_lists&&) = delete;
+
+ private:
+  /// A free block, linking to the next one on its list.
+  struct free_block {
+    /// The next block on the list.
+    free_block* next;
+  };
+
+  /// A list of free blocks of the same size.
+  struct free_list_type {
+    /// The first block.
+    free_block* head{nullptr};
+    /// The size of the blocks.
+    std::size_t block_size{0};
+    /// The number of the blocks.
+    std::size_t count{0};
+  };
+
+  /// Free the blocks over \a max_count on each list.
+  void trim(std::size_t max_count) noexcept {
+    for (auto& free_list : lists) {
+      while (free_list.count > max_count) {
+        auto* const block = free_list.head;
+        free_list.head = block->next;
+        --free_list.count;
+        free_aligned(block);
+      }
+    }
+  }
+
+  /// The lists.
+  std::array<free_list_type, list_count> lists{};
+
+  /// The maximum number of blocks on each list.
+  std::size_t capacity{default_capacity};
+};
+
+/// The free list index of QSBR-managed memory which is never recycled.
+inline constexpr std::size_t no_free_list = qsbr_free_lists::list_count;
+
 /// Pending deallocation request for QSBR-managed memory.
 class [[nodiscard]] deallocation_request final {
  public:
@@ -459,17 +767,21 @@ class [[nodiscard]] deallocation_request final {
   using debug_callback = std::function<void(const void*)>;
 #endif
 
-  /// Create a new deallocation request for \a pointer_. In debug builds also
-  /// pass \a request_epoch_ and \a dealloc_callback_ to be executed during
-  /// deallocation.
-  explicit deallocation_request(void* pointer_ UNODB_DETAIL_LIFETIMEBOUND
+  /// Create a new deallocation request for \a pointer_ to a block of \a
+  /// block_size_ bytes, to be put on the free list \a free_list_ unless it is
+  /// no_free_list. In debug builds also pass \a request_epoch_ and \a
+  /// dealloc_callback_ to be executed during deallocation.
+  explicit deallocation_request(void* pointer_ UNODB_DETAIL_LIFETIMEBOUND,
+                                std::size_t free_list_, std::size_t block_size_
 #ifndef NDEBUG
                                 ,
                                 qsbr_epoch request_epoch_,
                                 debug_callback dealloc_callback_
 #endif
                                 ) noexcept
-      : pointer{pointer_}
+      : pointer{pointer_},
+        block_size{block_size_},
+        free_list{free_list_}
 #ifndef NDEBUG
         ,
         dealloc_callback{std::move(dealloc_callback_)},
@@ -487,21 +799,31 @@ class [[nodiscard]] deallocation_request final {
   /// Destructor.
   ~deallocation_request() = default;
 
-  /// Do the deallocation. All parameters are debug build-only.
+  /// Do the deallocation.
   ///
+  /// \param free_lists The free lists to put the block on, or \c nullptr to
+  /// free it
 #ifndef NDEBUG
   /// \param orphan Whether this request belongs to a terminated thread
   /// \param dealloc_epoch Optional epoch when deallocation happens
   /// \param dealloc_epoch_single_thread_mode Optional flag whether the
   /// deallocation epoch has total zero or one thread only
 #endif
-  void deallocate(
+  void deallocate(qsbr_free_lists* free_lists
 #ifndef NDEBUG
-      bool orphan, std::optional<qsbr_epoch> dealloc_epoch,
-      std::optional<bool> dealloc_epoch_single_thread_mode
+                  ,
+                  bool orphan, std::optional<qsbr_epoch> dealloc_epoch,
+                  std::optional<bool> dealloc_epoch_single_thread_mode
 #endif
   ) const noexcept;
 
+  /// Check whether deallocate() would keep the memory on \a free_lists.
+  [[nodiscard]] bool is_recyclable_into(
+      const qsbr_free_lists& free_lists) const noexcept {
+    return free_list != no_free_list &&
+           free_lists.accepts(free_list, block_size);
+  }
+
   /// Copy construction is disabled to prevent redundant instances.
   deallocation_request(const deallocation_request&) = delete;
 
@@ -524,6 +846,14 @@ class [[nodiscard]] deallocation_request final {
   // NOLINTNEXTLINE(cppcoreguidelines-avoid-const-or-ref-data-members)
   void* const pointer;
 
+  /// Size of the memory block, if it is to be recycled.
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-const-or-ref-data-members)
+  const std::size_t block_size;
+
+  /// Free list for the memory block, or no_free_list.
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-const-or-ref-data-members)
+  const std::size_t free_list;
+
 #ifndef NDEBUG
   /// Debug build only: callback to execute during deallocation.
   // Non-const to support move
@@ -545,8 +875,9 @@ using dealloc_request_vector = std::vector<deallocation_request>;
 /// A scope guard that executes deallocation requests upon destruction.
 class [[nodiscard]] deferred_requests final {
  public:
-  /// Create a deferred requests object that takes ownership of \a requests_.
-  /// In debug builds, also stores metadata about the requests.
+  /// Create a deferred requests object that takes ownership of \a requests_,
+  /// recycling their memory into \a free_lists_ unless it is \c nullptr. In
+  /// debug builds, also stores metadata about the requests.
   ///
 #ifndef NDEBUG
   /// \param orphaned_requests_ Whether these requests belongs to a terminated
@@ -556,15 +887,16 @@ class [[nodiscard]] deferred_requests final {
   ///                                          deallocation epoch has total zero
   ///                                          or one thread only
 #endif
-  UNODB_DETAIL_RELEASE_EXPLICIT deferred_requests(
-      dealloc_request_vector&& requests_
+  deferred_requests(
+      dealloc_request_vector&& requests_, qsbr_free_lists* free_lists_
 #ifndef NDEBUG
       ,
       bool orphaned_requests_, std::optional<qsbr_epoch> request_epoch_,
       std::optional<bool> dealloc_epoch_single_thread_mode_
 #endif
       ) noexcept
-      : requests{std::move(requests_)}
+      : requests{std::move(requests_)},
+        free_lists{free_lists_}
 #ifndef NDEBUG
         ,
         orphaned_requests{orphaned_requests_},
@@ -589,9 +921,11 @@ class [[nodiscard]] deferred_requests final {
   /// Destruct this object and execute all deallocation requests.
   ~deferred_requests() noexcept {
     for (const auto& dealloc_request : requests) {
-      dealloc_request.deallocate(
+      dealloc_request.deallocate(free_lists
 #ifndef NDEBUG
-          orphaned_requests, dealloc_epoch, dealloc_epoch_single_thread_mode
+                                 ,
+                                 orphaned_requests, dealloc_epoch,
+                                 dealloc_epoch_single_thread_mode
 #endif
       );
     }
@@ -604,6 +938,9 @@ class [[nodiscard]] deferred_requests final {
   /// The vector of deallocation requests to be executed.
   const dealloc_request_vector requests;
 
+  /// The free lists to recycle the memory into, if any.
+  qsbr_free_lists* const free_lists;
+
 #ifndef NDEBUG
   /// Whether these requests belong to a terminated thread.
   const bool orphaned_requests;
@@ -628,8 +965,25 @@ struct dealloc_vector_list_node {
 };
 UNODB_DETAIL_RESTORE_MSVC_WARNINGS()
 
+/// Node in a linked list of expired deallocation requests handed off to the
+/// background reclaimer.
+struct reclaimer_list_node {
+  /// Deallocation requests to execute.
+  detail::dealloc_request_vector requests;
+  /// Next linked list node.
+  reclaimer_list_node* next;
+#ifndef NDEBUG
+  /// Debug build only: the epoch in which the requests expired.
+  qsbr_epoch dealloc_epoch;
+  /// Debug build only: whether that epoch was in single-thread mode.
+  bool single_thread_mode;
+#endif
+};
+
 struct set_qsbr_per_thread_in_main_thread;
 
+struct domain_thread_node;
+
 #ifndef UNODB_DETAIL_MSVC_CLANG
 
 /// Register a function \a fn of type \a Func to be called on thread exit.
@@ -667,13 +1021,231 @@ void on_thread_exit(Func fn) noexcept {
 
 #endif  // #ifndef UNODB_DETAIL_MSVC_CLANG
 
+/// Encoding of the word through which the other threads of a domain pass
+/// through quiescent states on behalf of an offline thread, see
+/// unodb::ebr_guard.
+///
+/// The word holds the offline flag, the last epoch the thread passed through a
+/// quiescent state in or has seen, whether it did pass through one in that
+/// epoch, the saturating count of the quiescent states passed through on its
+/// behalf since it went offline, and the count of times it went offline,
+/// which keeps the helping threads from mistaking a new offline period for
+/// the one they have read.
+struct offline_word {
+  /// Underlying type for the word.
+  using type = std::uint32_t;
+
+  /// Maximum count of quiescent states passed through on behalf of the thread.
+  static constexpr std::uint32_t max_helps = 255;
+
+  /// Mask for the generation field. Clearing the rest of an offline thread word
+  /// yields the online thread word.
+  static constexpr type generation_mask = 0xFFFF'0000U;
+
+  /// Make an offline thread word for the offline period of \a generation_word.
+  [[nodiscard, gnu::const]] static constexpr type make(
+      qsbr_epoch epoch, bool passed_quiescent_state, std::uint32_t helps,
+      type generation_word) noexcept {
+    return offline_bit | (passed_quiescent_state ? quiescent_state_bit : 0U) |
+           epoch.get_val() | (std::min(helps, max_helps) << helps_offset) |
+           (generation_word & generation_mask);
+  }
+
+  /// Make an offline thread word for the offline period following the one of
+  /// \a word.
+  [[nodiscard, gnu::const]] static constexpr type make_next(
+      qsbr_epoch epoch, bool passed_quiescent_state, type word) noexcept {
+    return make(epoch, passed_quiescent_state, 0, word + generation_one);
+  }
+
+  /// Check whether \a word belongs to an offline thread.
+  [[nodiscard, gnu::const]] static constexpr bool is_offline(
+      type word) noexcept {
+    return (word & offline_bit) != 0;
+  }
+
+  /// Check whether the thread of \a word passed through a quiescent state in
+  /// its epoch.
+  [[nodiscard, gnu::const]] static constexpr bool passed_quiescent_state(
+      type word) noexcept {
+    return (word & quiescent_state_bit) != 0;
+  }
+
+  /// Get the epoch from \a word.
+  [[nodiscard, gnu::const]] static constexpr qsbr_epoch get_epoch(
+      type word) noexcept {
+    return qsbr_epoch{static_cast<qsbr_epoch::epoch_type>(word & epoch_mask)};
+  }
+
+  /// Get the count of quiescent states passed through on behalf of the thread
+  /// from \a word.
+  [[nodiscard, gnu::const]] static constexpr std::uint32_t get_helps(
+      type word) noexcept {
+    return (word >> helps_offset) & max_helps;
+  }
+
+ private:
+  /// Mask for the epoch field.
+  static constexpr type epoch_mask = qsbr_epoch::max;
+
+  /// Flag for the thread having passed through a quiescent state.
+  static constexpr type quiescent_state_bit = 4U;
+
+  /// Flag for the thread being offline.
+  static constexpr type offline_bit = 8U;
+
+  /// Bit offset for the help count field.
+  static constexpr auto helps_offset = 8U;
+
+  /// Value of one in the generation field.
+  static constexpr type generation_one = 1U << 16U;
+
+  static_assert((epoch_mask & quiescent_state_bit) == 0);
+  static_assert(((max_helps << helps_offset) & generation_mask) == 0);
+  static_assert((generation_one & generation_mask) == generation_one);
+};
+
+#ifdef UNODB_DETAIL_WITH_STATS
+
+/// Summary of the samples of a QSBR statistic.
+struct qsbr_stat_summary {
+  /// Count of the samples.
+  std::uint64_t count{0};
+
+  /// Sum of the samples.
+  std::uint64_t sum{0};
+
+  /// Sum of the squares of the samples.
+  double sum_of_squares{0};
+
+  /// Maximum sample, zero if there are none.
+  std::uint64_t max{0};
+
+  /// Get the mean of the samples, NaN if there are none.
+  [[nodiscard]] double mean() const noexcept {
+    if (count == 0) return std::numeric_limits<double>::quiet_NaN();
+    return static_cast<double>(sum) / static_cast<double>(count);
+  }
+
+  /// Get the population variance of the samples, zero if there are none.
+  [[nodiscard]] double variance() const noexcept {
+    if (count == 0) return 0;
+    const auto sample_mean = mean();
+    // Clamp the rounding errors
+    return std::max(
+        sum_of_squares / static_cast<double>(count) - sample_mean * sample_mean,
+        0.0);
+  }
+};
+
+/// Summary of the QSBR statistics of a set of threads.
+struct qsbr_stats_summary {
+  /// Counts of deallocation requests per thread between epoch changes.
+  qsbr_stat_summary dealloc_counts;
+
+  /// Total sizes of deallocation requests per thread between epoch changes.
+  qsbr_stat_summary dealloc_sizes;
+
+  /// Counts of quiescent states per thread between epoch changes.
+  qsbr_stat_summary quiescent_states;
+};
+
+/// A QSBR statistic of a single thread.
+///
+/// Only the owning thread adds samples, thus it does so without
+/// read-modify-write operations, and without any locking. The other threads
+/// read the statistic when summarizing the statistics of the domain, and may
+/// then miss the fields of a concurrently added sample.
+class qsbr_thread_stat final {
+ public:
+  /// Add \a sample. Must be called by the owning thread only.
+  void add(std::uint64_t sample) noexcept {
+    count.store(count.load(std::memory_order_relaxed) + 1,
+                std::memory_order_relaxed);
+    sum.store(sum.load(std::memory_order_relaxed) + sample,
+              std::memory_order_relaxed);
+    const auto sample_as_double = static_cast<double>(sample);
+    sum_of_squares.store(sum_of_squares.load(std::memory_order_relaxed) +
+                             sample_as_double * sample_as_double,
+                         std::memory_order_relaxed);
+    if (sample > max.load(std::memory_order_relaxed))
+      max.store(sample, std::memory_order_relaxed);
+  }
+
+  /// Add the samples to \a summary.
+  void add_to(qsbr_stat_summary& summary) const noexcept {
+    summary.count += count.load(std::memory_order_relaxed);
+    summary.sum += sum.load(std::memory_order_relaxed);
+    summary.sum_of_squares += sum_of_squares.load(std::memory_order_relaxed);
+    summary.max = std::max(summary.max, max.load(std::memory_order_relaxed));
+  }
+
+  /// Drop all the samples. Must be called by the owning thread only.
+  void reset() noexcept {
+    count.store(0, std::memory_order_relaxed);
+    sum.store(0, std::memory_order_relaxed);
+    sum_of_squares.store(0, std::memory_order_relaxed);
+    max.store(0, std::memory_order_relaxed);
+  }
+
+ private:
+  /// Count of the samples.
+  std::atomic<std::uint64_t> count{0};
+
+  /// Sum of the samples.
+  std::atomic<std::uint64_t> sum{0};
+
+  /// Sum of the squares of the samples.
+  std::atomic<double> sum_of_squares{0};
+
+  /// Maximum sample.
+  std::atomic<std::uint64_t> max{0};
+};
+
+/// The QSBR statistics of a single thread, see qsbr_thread_stat.
+struct qsbr_thread_stats {
+  /// Counts of deallocation requests between epoch changes.
+  qsbr_thread_stat dealloc_counts;
+
+  /// Total sizes of deallocation requests between epoch changes.
+  qsbr_thread_stat dealloc_sizes;
+
+  /// Counts of quiescent states between epoch changes.
+  qsbr_thread_stat quiescent_states;
+
+  /// The domain statistics generation of the samples, see
+  /// qsbr::reset_stats(). Released after starting the statistics over for a
+  /// new generation.
+  std::atomic<std::uint64_t> generation{0};
+
+  /// Add the samples to \a summary.
+  void add_to(qsbr_stats_summary& summary) const noexcept {
+    dealloc_counts.add_to(summary.dealloc_counts);
+    dealloc_sizes.add_to(summary.dealloc_sizes);
+    quiescent_states.add_to(summary.quiescent_states);
+  }
+
+  /// Drop all the samples. Must be called by the owning thread only.
+  void reset() noexcept {
+    dealloc_counts.reset();
+    dealloc_sizes.reset();
+    quiescent_states.reset();
+  }
+};
+
+#endif  // UNODB_DETAIL_WITH_STATS
+
 }  // namespace detail
 
+class qsbr;
+class ebr_guard;
+
 /// Thread-local QSBR data structure.
 ///
 /// Maintains pending deallocation requests for the previous and current epoch,
 /// tracks the last seen global epoch by any operation, and the last seen global
-/// epoch by a quiescent state for this thread.
+/// epoch by a quiescent state for this thread. Each instance belongs to one
+/// QSBR domain, see unodb::qsbr.
 ///
 /// Also owns the preallocated list nodes for orphaning pending previous and
 /// current interval deallocation requests on thread exit. Having them
@@ -681,41 +1253,18 @@ void on_thread_exit(Func fn) noexcept {
 /// handling any allocation failures is hard.
 class [[nodiscard]] qsbr_per_thread final {
  public:
-  /// Construct a new thread-local QSBR structure and register with global QSBR.
+  /// Construct a new thread-local QSBR structure and register with the
+  /// default QSBR domain.
   qsbr_per_thread();
 
+  /// Construct a new thread-local QSBR structure and register with \a
+  /// domain_.
+  explicit qsbr_per_thread(qsbr& domain_ UNODB_DETAIL_LIFETIMEBOUND);
+
   /// Unregister the current thread from global QSBR on thread exist.
   UNODB_DETAIL_DISABLE_MSVC_WARNING(26447)
   ~qsbr_per_thread() noexcept {
-    if (!is_qsbr_paused()) {
-#ifdef UNODB_DETAIL_WITH_STATS
-      // TODO(laurynas): to avoid try/catch below:
-      // - replace std::mutex with noexcept synchronization, realistically only
-      // spinlock fits, which might not be good enough;
-      // - replace Boost.Accumulator with own noexcept stats.
-      try {
-        qsbr_pause();
-      }
-      // The QSBR destructor can only throw std::system_error from the stats
-      // mutex lock. Eat this exception, and eat any other unexpected exceptions
-      // too, except for the debug build.
-      // LCOV_EXCL_START
-      catch (const std::system_error& e) {
-        std::cerr << "Failed to register QSBR stats for the quitting thread: "
-                  << e.what() << '\n';
-      } catch (const std::exception& e) {
-        std::cerr << "Unknown exception in the QSBR thread destructor: "
-                  << e.what() << '\n';
-        UNODB_DETAIL_DEBUG_CRASH();
-      } catch (...) {
-        std::cerr << "Unknown exception in the QSBR thread destructor";
-        UNODB_DETAIL_DEBUG_CRASH();
-      }
-#else
-      qsbr_pause();
-#endif
-      // LCOV_EXCL_STOP
-    }
+    if (!is_qsbr_paused()) qsbr_pause();
   }
   UNODB_DETAIL_RESTORE_MSVC_WARNINGS()
 
@@ -740,22 +1289,68 @@ class [[nodiscard]] qsbr_per_thread final {
 #endif
   );
 
+  /// Request the block at \a pointer of \a size bytes, allocated with
+  /// detail::allocate_aligned(), to be put on the free list \a free_list of
+  /// the thread which reclaims it when it is safe to do so, instead of being
+  /// freed.
+  ///
+#ifndef NDEBUG
+  /// \param dealloc_callback Debug callback to execute during deallocation
+#endif
+  void on_next_epoch_recycle(
+      void* pointer, std::size_t free_list, std::size_t size
+#ifndef NDEBUG
+      ,
+      detail::deallocation_request::debug_callback dealloc_callback
+#endif
+  );
+
+  /// Take a block of \a size bytes from the free list \a free_list of this
+  /// thread, filled by on_next_epoch_recycle().
+  ///
+  /// \return the block, or \c nullptr if there is none and the caller should
+  /// allocate it.
+  [[nodiscard]] void* take_free_block(std::size_t free_list,
+                                      std::size_t size) {
+    return free_lists.take(free_list, size);
+  }
+
+  /// Set the maximum number of blocks on each free list of this thread to \a
+  /// capacity, freeing the blocks over it. Zero disables the recycling.
+  void set_free_list_capacity(std::size_t capacity) noexcept {
+    free_lists.set_capacity(capacity);
+  }
+
+  /// Get the maximum number of blocks on each free list of this thread.
+  [[nodiscard]] std::size_t get_free_list_capacity() const noexcept {
+    return free_lists.get_capacity();
+  }
+
+  /// Get the number of blocks on the free list \a free_list of this thread.
+  [[nodiscard]] std::size_t get_free_list_size(
+      std::size_t free_list) const noexcept {
+    return free_lists.size(free_list);
+  }
+
   /// Signal that this thread is quiescent.
+  ///
+  /// If this thread has more pending deallocation requests than the domain
+  /// backlog limit, applies the domain backlog policy, see
+  /// qsbr::set_backlog_limit.
   /// \pre No active pointers to QSBR-managed data must be held.
-  void quiescent()
-#ifndef UNODB_DETAIL_WITH_STATS
-      noexcept
-#endif
-      ;
+  void quiescent() noexcept;
+
+  /// Get the number of deallocation requests of this thread waiting for an
+  /// epoch change.
+  [[nodiscard]] std::size_t get_pending_request_count() const noexcept {
+    return previous_interval_dealloc_requests.size() +
+           current_interval_dealloc_requests.size();
+  }
 
   /// Pause QSBR for this thread, unregistering from global QSBR.
   /// \pre No active pointers to QSBR-managed data must be held.
   /// \pre QSBR must not be paused for this thread.
-  void qsbr_pause()
-#ifndef UNODB_DETAIL_WITH_STATS
-      noexcept
-#endif
-      ;
+  void qsbr_pause() noexcept;
 
   /// Resume QSBR for this thread, registering with global QSBR.
   /// \pre QSBR must be paused for this thread.
@@ -766,6 +1361,9 @@ class [[nodiscard]] qsbr_per_thread final {
     return paused;
   }
 
+  /// Get the QSBR domain of this thread-local structure.
+  [[nodiscard, gnu::pure]] qsbr& get_domain() const noexcept { return domain; }
+
   /// Check if there are no deallocation requests for the previous epoch.
   [[nodiscard]] bool previous_interval_requests_empty() const noexcept {
     return previous_interval_dealloc_requests.empty();
@@ -803,6 +1401,7 @@ class [[nodiscard]] qsbr_per_thread final {
   friend class detail::qsbr_ptr_base;
   friend class qsbr;
   friend class qsbr_thread;
+  friend class ebr_guard;
   friend qsbr_per_thread& this_thread() noexcept;
   friend struct detail::set_qsbr_per_thread_in_main_thread;
 
@@ -827,6 +1426,7 @@ class [[nodiscard]] qsbr_per_thread final {
   static void set_instance(
       std::unique_ptr<qsbr_per_thread> new_instance) noexcept {
     current_thread_instance = std::move(new_instance);
+    current_thread_instance->set_owner_to_current_thread();
 #ifndef UNODB_DETAIL_MSVC_CLANG
     // Force qsbr_per_thread destructor to run on thread exit. It already runs
     // without this kludge on most configurations, except with gcc --coverage on
@@ -840,6 +1440,9 @@ class [[nodiscard]] qsbr_per_thread final {
   // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
   thread_local static std::unique_ptr<qsbr_per_thread> current_thread_instance;
 
+  /// The QSBR domain this thread is registered with.
+  qsbr& domain;
+
   /// Preallocated list node for orphaning pending previous epoch requests on
   /// thread exit.
   /// \hideinitializer
@@ -857,12 +1460,34 @@ class [[nodiscard]] qsbr_per_thread final {
   /// Number of quiescent states since the last epoch change.
   std::uint64_t quiescent_states_since_epoch_change{0};
 
+  /// The quiescence shard of this thread in its domain.
+  std::size_t quiescence_shard;
+
   /// Last seen global epoch by quiescent state for this thread.
   qsbr_epoch last_seen_quiescent_state_epoch;
 
   /// Last seen global epoch by any operation for this thread.
   qsbr_epoch last_seen_epoch;
 
+  /// The last epoch in which this thread passed through a quiescent state, or
+  /// the one after the registration epoch if it has not done so yet. Read by
+  /// other threads looking for the ones holding back an epoch change.
+  std::atomic<qsbr_epoch> published_quiescent_state_epoch{
+      last_seen_quiescent_state_epoch.advance()};
+
+  /// The ID of the thread owning this structure, protected by
+  /// qsbr::thread_registry_lock. A structure may be created by another thread
+  /// than the one it is installed for, which then updates it.
+  std::thread::id thread_id{std::this_thread::get_id()};
+
+  /// The next thread registered with the same domain, protected by
+  /// qsbr::thread_registry_lock.
+  qsbr_per_thread* next_registered_thread{nullptr};
+
+  /// The domain epoch change sequence number as of the last quiescent state
+  /// of this thread that read the global state.
+  std::uint64_t last_seen_epoch_change_sequence{0};
+
   /// Pending deallocation requests for the previous epoch.
   detail::dealloc_request_vector previous_interval_dealloc_requests;
 
@@ -872,10 +1497,54 @@ class [[nodiscard]] qsbr_per_thread final {
   /// Whether QSBR participation is currently paused for this thread.
   bool paused{false};
 
+  /// Whether a deallocation request took this thread over the domain backlog
+  /// limit since its last quiescent state.
+  bool over_backlog_limit{false};
+
+  /// Whether this thread has entered a unodb::ebr_guard since it registered
+  /// with the domain, and thus goes offline outside of them.
+  bool guard_mode{false};
+
+  /// Whether this thread is offline, that is, in guard mode and outside of
+  /// any guard.
+  bool offline{false};
+
+  /// Nesting depth of the unodb::ebr_guard scopes of this thread.
+  std::uint32_t guard_depth{0};
+
+  /// The detail::offline_word of this thread. Written by this thread when
+  /// going offline and online, and by the other threads of the domain passing
+  /// through quiescent states on its behalf while it is offline.
+  std::atomic<detail::offline_word::type> offline_word{0};
+
+  /// Whether the lagging threads have been reported for the current time this
+  /// thread is over the domain backlog limit.
+  bool backlog_limit_reported{false};
+
+  /// The blocks recycled by this thread for reuse.
+  detail::qsbr_free_lists free_lists;
+
 #ifdef UNODB_DETAIL_WITH_STATS
   /// Total size of memory that was submitted for deallocation in the current
   /// epoch.
   std::size_t current_interval_total_dealloc_size{0};
+
+  /// The statistics of this thread, summarized by the domain on read.
+  detail::qsbr_thread_stats stats;
+
+  /// Register the count of quiescent \a states of this thread between its
+  /// epoch changes.
+  void register_quiescent_states_between_epoch_changes(
+      std::uint64_t states) noexcept;
+
+  /// Register the deallocation requests of this thread between its epoch
+  /// changes, \a count of them with \a total_size in bytes.
+  void register_dealloc_stats_between_epoch_changes(std::size_t total_size,
+                                                    std::size_t count) noexcept;
+
+  /// Start the statistics of this thread over if the domain ones have been
+  /// reset since the last sample.
+  void refresh_stats_generation() noexcept;
 #endif  // UNODB_DETAIL_WITH_STATS
 
   /// Update this thread's view of the current epoch and execute the previous
@@ -886,11 +1555,7 @@ class [[nodiscard]] qsbr_per_thread final {
   /// \param new_current_requests Deallocation requests for the current epoch
   void advance_last_seen_epoch(
       bool single_thread_mode, qsbr_epoch new_seen_epoch,
-      detail::dealloc_request_vector new_current_requests = {})
-#ifndef UNODB_DETAIL_WITH_STATS
-      noexcept
-#endif
-      ;
+      detail::dealloc_request_vector new_current_requests = {}) noexcept;
 
   /// Execute the previous interval deallocation requests and move the
   /// current interval ones to the previous interval.
@@ -901,16 +1566,74 @@ class [[nodiscard]] qsbr_per_thread final {
   ///                             epoch
   void execute_previous_requests(
       bool single_thread_mode, qsbr_epoch dealloc_epoch,
-      detail::dealloc_request_vector new_current_requests = {})
-#ifndef UNODB_DETAIL_WITH_STATS
-      noexcept
+      detail::dealloc_request_vector new_current_requests = {}) noexcept;
+
+  /// Recycle the expired previous interval deallocation requests that fit
+  /// into the free lists of this thread, which no other thread may access,
+  /// and hand off the rest to the background reclaimer of the domain.
+  ///
+#ifndef NDEBUG
+  /// \param dealloc_epoch Deallocation epoch
+  /// \param single_thread_mode Whether QSBR is in single-thread mode
 #endif
-      ;
+  /// \return Whether no requests are left. If not, the remaining ones must be
+  /// executed by the caller.
+  [[nodiscard]] bool recycle_or_hand_off_previous_requests(
+#ifndef NDEBUG
+      qsbr_epoch dealloc_epoch, bool single_thread_mode
+#endif
+      ) noexcept;
 
   /// Move any pending deallocation requests to the global QSBR structure when
   /// the thread exits.
   void orphan_pending_requests() noexcept;
 
+  /// Make the calling thread the owner of this structure.
+  void set_owner_to_current_thread() noexcept;
+
+  /// Quiescent states passed through by this thread in a single epoch after
+  /// which it passes through them on behalf of the offline threads too.
+  static constexpr std::uint64_t offline_help_interval = 64;
+
+  static_assert((offline_help_interval & (offline_help_interval - 1)) == 0);
+
+  /// Enter a unodb::ebr_guard scope.
+  void enter_guard();
+
+  /// Leave a unodb::ebr_guard scope.
+  void leave_guard() noexcept;
+
+  /// Go offline, allowing the other threads to pass through quiescent states
+  /// on behalf of this one.
+  void go_offline() noexcept;
+
+  /// Go online, catching up with the epoch changes made while offline.
+  void go_online() noexcept;
+
+  /// Catch up with the epoch changes made after other threads passed through
+  /// quiescent states on behalf of this one, as recorded in \a word.
+  void catch_up_after_offline(detail::offline_word::type word) noexcept;
+
+  /// Pass through a quiescent state, without checking the backlog limit.
+  void do_quiescent() noexcept;
+
+  /// Flag this thread for the backlog policy if its pending deallocation
+  /// requests are over the domain limit.
+  void check_backlog_limit() noexcept;
+
+  /// Apply the domain backlog policy to this thread, over the backlog limit.
+  void handle_backlog_over_limit() noexcept;
+
+  /// Request deallocation of \a pointer when it is safe to do so, and
+  /// recycling it if \a free_list is not detail::no_free_list.
+  void defer_deallocation(
+      void* pointer, std::size_t free_list, std::size_t size
+#ifndef NDEBUG
+      ,
+      detail::deallocation_request::debug_callback dealloc_callback
+#endif
+  );
+
 #ifndef NDEBUG
   /// Set of active pointers to QSBR-managed data held by this thread.
   std::unordered_multiset<const void*> active_ptrs;
@@ -922,46 +1645,134 @@ class [[nodiscard]] qsbr_per_thread final {
   return qsbr_per_thread::get_instance();
 }
 
-#ifdef UNODB_DETAIL_WITH_STATS
-
-namespace boost_acc = boost::accumulators;
-
-#endif  // UNODB_DETAIL_WITH_STATS
-
 // If C++ standartisation proposal by A. D. Robison "Policy-based design for
 // safe destruction in concurrent containers" ever gets anywhere, consider
 // changing to its interface, like Stamp-it paper does.
 
-/// Global QSBR state manager for memory reclamation.
+/// What to do with a thread having more pending deallocation requests than
+/// the backlog limit of its domain, see qsbr::set_backlog_limit.
+enum class qsbr_backlog_policy : std::uint8_t {
+  /// Report the threads holding back the epoch change to the backlog callback
+  /// only.
+  notify,
+  /// Report them, then keep the thread over the limit passing through
+  /// quiescent states until enough epoch changes bring it under the limit.
+  throttle,
+};
+
+/// Backlog callback, called with the ID of a thread that has not passed
+/// through a quiescent state in the current epoch.
+using qsbr_backlog_callback = std::function<void(std::thread::id)>;
+
+/// QSBR domain: the state manager for memory reclamation.
 ///
 /// Tracks threads participating in QSBR, manages epoch transitions, and handles
 /// orphaned deallocation requests from terminated threads.
+///
+/// The process-wide default domain, returned by instance(), is the one all the
+/// threads are registered with by default, and whose per-thread state is
+/// this_thread(). Further domains may be created to isolate the reclamation of
+/// unrelated data structures, so that a thread slow to pass through a
+/// quiescent state in one domain does not delay the epoch changes in another.
+/// A thread joins such a domain on its first current_thread() call, which must
+/// precede its first access to the data protected by the domain, and leaves it
+/// on exit or on leave_current_thread(). All the threads but the destroying
+/// one must have left a domain before its destruction.
 class qsbr final {
  public:
-  /// Get the global QSBR singleton instance.
+  /// Get the default QSBR domain.
   [[nodiscard]] static qsbr& instance() noexcept {
-    static qsbr instance;
+    static qsbr instance{default_domain_tag{}};
     return instance;
   }
 
+  /// Create a new QSBR domain with no threads.
+  qsbr() noexcept;
+
+  /// Destroy the domain. Stops the background reclaimer, if any, and, for a
+  /// non-default domain, removes the calling thread from it and executes the
+  /// requests orphaned by the threads that left it. In debug builds asserts
+  /// that the domain is idle.
+  ~qsbr() noexcept;
+
+  /// Get the QSBR state of the calling thread in this domain, registering the
+  /// thread with the domain if this is its first call.
+  ///
+  /// \throws std::bad_alloc if the state of a newly registered thread cannot
+  /// be allocated
+  [[nodiscard]] qsbr_per_thread& current_thread() {
+    if (UNODB_DETAIL_LIKELY(default_domain)) return this_thread();
+    if (UNODB_DETAIL_LIKELY(thread_cache_slot != no_thread_cache_slot)) {
+      auto* const thread = domain_thread_cache[thread_cache_slot];
+      if (UNODB_DETAIL_LIKELY(thread != nullptr)) return *thread;
+    }
+    return join_current_thread();
+  }
+
+  /// Remove the calling thread from this non-default domain, as if it exited.
+  /// Does nothing if it is not registered with the domain.
+  /// \pre No active pointers to the data protected by the domain must be held.
+  void leave_current_thread() noexcept;
+
+  /// Limit the deferred deallocation requests pending in each thread of this
+  /// domain to \a max_requests, zero disabling the limit.
+  ///
+  /// A single thread not passing through quiescent states blocks all the
+  /// epoch changes, making the pending requests of every other thread grow
+  /// without bound. A thread whose requests go over the limit handles it in
+  /// its next quiescent state: it calls \a callback, if set, once for each
+  /// thread holding back the current epoch, and then, with
+  /// qsbr_backlog_policy::throttle, waits there for the epoch changes that
+  /// bring it under the limit. The callback is called once per going over the
+  /// limit, without any locks of this domain held, and must not throw. It runs
+  /// in a quiescent state of the calling thread, thus must not unregister,
+  /// pause, or resume that thread. A throttled thread waits for as long as the
+  /// lagging threads do not pass through quiescent states, so these must not
+  /// wait for it.
+  void set_backlog_limit(std::size_t max_requests, qsbr_backlog_policy policy,
+                         qsbr_backlog_callback callback = {});
+
+  /// Get the limit of deferred deallocation requests pending in each thread,
+  /// zero if there is none.
+  [[nodiscard]] std::size_t get_backlog_limit() const noexcept {
+    return backlog_limit.load(std::memory_order_relaxed);
+  }
+
+  /// Get what a thread over the backlog limit does.
+  [[nodiscard]] qsbr_backlog_policy get_backlog_policy() const noexcept {
+    return backlog_policy.load(std::memory_order_relaxed);
+  }
+
+  /// Call \a fn with the ID of each thread registered with this domain that
+  /// has not passed through a quiescent state in the current epoch. \a fn is
+  /// called without any locks of this domain held, thus the threads may have
+  /// passed through quiescent states or quit by then.
+  void for_each_lagging_thread(const qsbr_backlog_callback& fn);
+
   /// Process quiescent state for a thread, potentially triggering an epoch
   /// change.
   /// \param current_global_epoch Current global epoch
+  /// \param shard The quiescence shard of the thread
 #ifndef NDEBUG
   /// \param thread_epoch Current thread epoch (debug builds only)
 #endif
   /// \return Potentially updated global epoch
   [[nodiscard]] qsbr_epoch remove_thread_from_previous_epoch(
-      qsbr_epoch current_global_epoch
+      qsbr_epoch current_global_epoch, std::size_t shard
 #ifndef NDEBUG
       ,
       qsbr_epoch thread_epoch
 #endif
       ) noexcept;
 
+  /// Pick the quiescence shard for a new thread, the one with the fewest
+  /// threads.
+  [[nodiscard]] std::size_t choose_quiescence_shard() const noexcept;
+
   /// Register a new thread with QSBR.
+  /// \param shard The quiescence shard of the thread
   /// \return The current global epoch
-  [[nodiscard]] qsbr_epoch register_thread() noexcept;
+  [[nodiscard]] qsbr_epoch register_thread(std::size_t shard) noexcept;
 
   /// Unregister a thread from QSBR.
   /// \param quiescent_states_since_epoch_change Count of quiescent states by
@@ -970,57 +1781,39 @@ class qsbr final {
   /// \param thread_epoch Last seen epoch by this thread
   /// \param qsbr_thread The thread's QSBR instance to unregister
   void unregister_thread(std::uint64_t quiescent_states_since_epoch_change,
-                         qsbr_epoch thread_epoch, qsbr_per_thread& qsbr_thread)
-#ifndef UNODB_DETAIL_WITH_STATS
-      noexcept
-#endif
-      ;
+                         qsbr_epoch thread_epoch,
+                         qsbr_per_thread& qsbr_thread) noexcept;
 
 #ifdef UNODB_DETAIL_WITH_STATS
   /// Reset all statistics counters to zero.
+  ///
+  /// The threads start their own statistics over lazily, on their next
+  /// sample.
   void reset_stats();
 
-  /// Register thread's count of quiescent \a states between thread epoch
-  /// changes.
-  void register_quiescent_states_per_thread_between_epoch_changes(
-      std::uint64_t states) {
-    const std::lock_guard guard{quiescent_state_stats_lock};
-    quiescent_states_per_thread_between_epoch_change_stats(states);
-    publish_quiescent_states_per_thread_between_epoch_change_stats();
-  }
-
-  /// Register thread's deallocation request stats between thread epoch changes.
-  ///
-  /// \param total_size Total size in bytes of deallocation requests
-  /// \param count Count of deallocation requests
-  void register_dealloc_stats_per_thread_between_epoch_changes(
-      std::size_t total_size, std::size_t count) {
-    const std::lock_guard guard{dealloc_stats_lock};
-    deallocation_size_per_thread_stats(total_size);
-    publish_deallocation_size_stats();
-    epoch_dealloc_per_thread_count_stats(count);
-    publish_epoch_callback_stats();
-  }
+  // The statistics are accumulated by each thread separately, and summarized
+  // over the registered threads and the ones that have quit on every call of
+  // the getters below, which thus take the thread registry lock. The getters
+  // are noexcept, thus a std::system_error from locking that std::mutex ends
+  // in std::terminate.
 
   /// Get maximum number of threads' deallocation request counts between epoch
   /// changes.
   [[nodiscard]] std::size_t get_epoch_callback_count_max() const noexcept {
-    return epoch_dealloc_per_thread_count_max.load(std::memory_order_acquire);
+    return summarize_stats().dealloc_counts.max;
   }
 
   /// Get variance of threads' deallocation request counts between epoch
   /// changes.
   [[nodiscard]] double get_epoch_callback_count_variance() const noexcept {
-    return epoch_dealloc_per_thread_count_variance.load(
-        std::memory_order_acquire);
+    return summarize_stats().dealloc_counts.variance();
   }
 
-  /// Get mean of threads' deallocation request counts between epoch
-  /// changes.
+  /// Get mean of threads' quiescent state counts between epoch changes, NaN
+  /// if there were no epoch changes.
   [[nodiscard]] double
   get_mean_quiescent_states_per_thread_between_epoch_changes() const noexcept {
-    return quiescent_states_per_thread_between_epoch_change_mean.load(
-        std::memory_order_acquire);
+    return summarize_stats().quiescent_states.mean();
   }
 
   /// Get total number of epoch changes.
@@ -1030,16 +1823,37 @@ class qsbr final {
 
   /// Get maximum size of memory waiting for deallocation in bytes.
   [[nodiscard]] std::uint64_t get_max_backlog_bytes() const noexcept {
-    return deallocation_size_per_thread_max.load(std::memory_order_acquire);
+    return summarize_stats().dealloc_sizes.max;
   }
 
-  /// Get mean backlog of memory waiting for deallocation in bytes.
+  /// Get mean backlog of memory waiting for deallocation in bytes, zero if
+  /// there were no epoch changes.
   [[nodiscard]] double get_mean_backlog_bytes() const noexcept {
-    return deallocation_size_per_thread_mean.load(std::memory_order_acquire);
+    const auto dealloc_sizes = summarize_stats().dealloc_sizes;
+    return dealloc_sizes.count == 0 ? 0 : dealloc_sizes.mean();
   }
 
 #endif  // UNODB_DETAIL_WITH_STATS
 
+  /// Start a background thread that executes the expired deallocation
+  /// requests of the QSBR threads, so that they no longer free memory inline
+  /// at their epoch changes. The threads still recycle the memory that fits
+  /// into their own free lists themselves, as that is cheaper than the
+  /// hand-off, and only the rest is freed by the reclaimer. Does nothing if
+  /// the reclaimer is already running.
+  ///
+  /// \throws std::system_error if the thread cannot be started
+  void start_background_reclaimer();
+
+  /// Stop the background reclaimer after it has executed all the requests
+  /// handed to it. Does nothing if the reclaimer is not running.
+  void stop_background_reclaimer() noexcept;
+
+  /// Check whether the background reclaimer is running.
+  [[nodiscard]] bool has_background_reclaimer() const noexcept {
+    return reclaimer_enabled.load(std::memory_order_acquire);
+  }
+
   /// Get the current QSBR state word.
   /// \note Made public for tests and asserts, do not call from the user code.
   [[nodiscard]] qsbr_state::type get_state() const noexcept {
@@ -1083,27 +1897,117 @@ class qsbr final {
   /// Output QSBR state to \a out for debugging.
   [[gnu::cold]] UNODB_DETAIL_NOINLINE void dump(std::ostream& out) const;
 
-  /// Copy construction is disabled for a singleton.
+  /// Copy construction is disabled, threads refer to their domain.
   qsbr(const qsbr&) = delete;
 
-  /// Move construction is disabled for a singleton.
+  /// Move construction is disabled, threads refer to their domain.
   qsbr(qsbr&&) = delete;
 
-  /// Copy assignment is disabled for a singleton.
+  /// Copy assignment is disabled.
   qsbr& operator=(const qsbr&) = delete;
 
-  /// Move assignment is disabled for a singleton.
+  /// Move assignment is disabled.
   qsbr& operator=(qsbr&&) = delete;
 
  private:
   friend class detail::deallocation_request;
   friend class qsbr_per_thread;
 
-  /// Default constructor for singleton.
-  qsbr() noexcept = default;
+  /// Tag to construct the default domain.
+  struct default_domain_tag {};
+
+  /// Construct the default domain.
+  explicit qsbr(default_domain_tag) noexcept : default_domain{true} {}
+
+  /// Register the calling thread with this non-default domain, unless it
+  /// already is, and return its state.
+  [[nodiscard]] qsbr_per_thread& join_current_thread();
+
+  /// Number of the non-default domains whose per-thread states are cached by
+  /// each thread, see domain_thread_cache.
+  static constexpr std::size_t cached_domain_count = 64;
+
+  /// Slot of a domain whose per-thread states are not cached, which
+  /// current_thread() looks up in the list of the joined domains instead.
+  static constexpr std::size_t no_thread_cache_slot = cached_domain_count;
+
+  /// Take a free domain_thread_cache slot, or return no_thread_cache_slot if
+  /// there are none.
+  [[nodiscard]] static std::size_t acquire_thread_cache_slot() noexcept;
+
+  /// The states of the calling thread in the non-default domains it has
+  /// joined, indexed by their thread_cache_slot, or nullptr. A slot is given
+  /// back on the domain destruction, by which time all the threads have left
+  /// it and cleared their entries, thus a reused slot starts empty everywhere.
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+  static constinit thread_local std::array<qsbr_per_thread*,
+                                           cached_domain_count>
+      domain_thread_cache;
+
+  /// Hand off the expired deallocation \a requests to the background
+  /// reclaimer, if it is running.
+  ///
+#ifndef NDEBUG
+  /// \param dealloc_epoch The epoch in which the requests expired
+  /// \param single_thread_mode Whether that epoch is in single-thread mode
+#endif
+  /// \return Whether the requests were taken. If not, \a requests are intact
+  /// and must be executed by the caller.
+  [[nodiscard]] bool hand_off_to_reclaimer(
+      detail::dealloc_request_vector& requests
+#ifndef NDEBUG
+      ,
+      qsbr_epoch dealloc_epoch, bool single_thread_mode
+#endif
+      ) noexcept;
+
+  /// The background reclaimer thread body.
+  void run_background_reclaimer() noexcept;
+
+  /// Pass through quiescent states on behalf of the offline threads of this
+  /// domain, if there are any.
+  void maybe_help_offline_threads() noexcept {
+    if (UNODB_DETAIL_UNLIKELY(
+            offline_threads.load(std::memory_order_relaxed) != 0))
+      help_offline_threads();
+  }
+
+  /// Pass through quiescent states on behalf of the offline threads of this
+  /// domain that have not done so in the current epoch. Does nothing if
+  /// thread_registry_lock is taken, as its holder only delays the help until
+  /// the next attempt.
+  void help_offline_threads() noexcept;
 
-  /// Destructor. In debug builds asserts that QSBR is idle.
-  ~qsbr() noexcept { assert_idle(); }
+  /// Add \a thread to the threads registered with this domain.
+  void link_thread(qsbr_per_thread& thread) noexcept;
+
+  /// Remove \a thread from the threads registered with this domain.
+  void unlink_thread(qsbr_per_thread& thread) noexcept;
+
+  /// Make the calling thread the owner of \a thread.
+  void set_thread_owner(qsbr_per_thread& thread) noexcept;
+
+  /// Report the threads holding back the current epoch to the backlog
+  /// callback, if any.
+  void report_lagging_threads() noexcept;
+
+  /// Get the IDs of the lagging threads.
+  /// \pre thread_registry_lock must be held
+  [[nodiscard]] std::vector<std::thread::id> get_lagging_threads_locked()
+      const;
+
+  /// Get the epoch change sequence number.
+  [[nodiscard]] std::uint64_t get_epoch_change_sequence() const noexcept {
+    return epoch_change_sequence.load(std::memory_order_acquire);
+  }
+
+  /// Bump the epoch change sequence number after publishing an epoch change
+  /// from a state word where \a single_thread_mode was as given. Does nothing
+  /// in single-thread mode, as there is no other thread to notify then.
+  void bump_epoch_change_sequence(bool single_thread_mode) noexcept {
+    if (UNODB_DETAIL_LIKELY(!single_thread_mode))
+      epoch_change_sequence.fetch_add(1, std::memory_order_release);
+  }
 
   /// Free memory at \a pointer using detail::free_aligned.
   ///
@@ -1136,6 +2040,22 @@ class qsbr final {
   void epoch_change_barrier_and_handle_orphans(
       bool single_thread_mode) noexcept;
 
+  /// Add a thread which has not passed through a quiescent state in
+  /// \a current_global_epoch to quiescence shard \a shard.
+  void join_quiescence_shard(std::size_t shard,
+                             qsbr_epoch current_global_epoch) noexcept;
+
+  /// Remove a thread that last passed through a quiescent state in, or
+  /// registered in, \a thread_epoch from quiescence shard \a shard.
+  /// \param passed_quiescent_state Whether the thread passed through a
+  ///                               quiescent state in \a thread_epoch
+  /// \return The count of the threads to subtract from the previous epoch
+  ///         thread count of the state word, this one included, or zero if
+  ///         its quiescent state has been subtracted already
+  [[nodiscard]] qsbr_thread_count_type leave_quiescence_shard(
+      std::size_t shard, qsbr_epoch thread_epoch,
+      bool passed_quiescent_state) noexcept;
+
   /// Advance to the next epoch by synchronizing threads, handling orphaned
   /// requests, and publishing the new global QSBR state.
   ///
@@ -1149,37 +2069,28 @@ class qsbr final {
   /// Increment the epoch change counter.
   void bump_epoch_change_count() noexcept;
 
-  /// Make updated deallocation size statistics visible for readers.
-  void publish_deallocation_size_stats() {
-    deallocation_size_per_thread_max.store(
-        boost_acc::max(deallocation_size_per_thread_stats),
-        std::memory_order_relaxed);
-    deallocation_size_per_thread_mean.store(
-        boost_acc::mean(deallocation_size_per_thread_stats),
-        std::memory_order_relaxed);
-    deallocation_size_per_thread_variance.store(
-        boost_acc::variance(deallocation_size_per_thread_stats),
-        std::memory_order_relaxed);
-  }
-
-  /// Make updated deallocation count statistics visible for readers.
-  void publish_epoch_callback_stats() {
-    epoch_dealloc_per_thread_count_max.store(
-        boost_acc::max(epoch_dealloc_per_thread_count_stats),
-        std::memory_order_relaxed);
-    epoch_dealloc_per_thread_count_variance.store(
-        boost_acc::variance(epoch_dealloc_per_thread_count_stats),
-        std::memory_order_relaxed);
-  }
-
-  /// Make updated Q state between thread epoch change statistics visible for
-  /// readers.
-  void publish_quiescent_states_per_thread_between_epoch_change_stats() {
-    quiescent_states_per_thread_between_epoch_change_mean.store(
-        boost_acc::mean(quiescent_states_per_thread_between_epoch_change_stats),
-        std::memory_order_relaxed);
+  /// Get the current domain statistics generation, see
+  /// detail::qsbr_thread_stats::generation.
+  [[nodiscard]] std::uint64_t get_stats_generation() const noexcept {
+    return stats_generation.load(std::memory_order_relaxed);
   }
 
+  /// Summarize the statistics of the registered threads and of the ones that
+  /// have unregistered since the last reset.
+  ///
+  /// \note Takes the thread registry lock. Should its std::mutex throw
+  /// std::system_error, std::terminate is called.
+  [[nodiscard]] detail::qsbr_stats_summary summarize_stats() const noexcept;
+
+  /// Move the statistics of \a thread, which must be the current one and
+  /// unregistered, to the ones of the unregistered threads.
+  ///
+  /// \note Takes the thread registry lock. Should its std::mutex throw
+  /// std::system_error, std::terminate is called. It is called from
+  /// qsbr_per_thread::qsbr_pause(), including the one in the thread exit,
+  /// which thus cannot report this failure as an exception either.
+  void retire_thread_stats(qsbr_per_thread& thread) noexcept;
+
 #endif  // UNODB_DETAIL_WITH_STATS
 
   /// The global QSBR state.
@@ -1196,61 +2107,105 @@ class qsbr final {
   std::atomic<detail::dealloc_vector_list_node*>
       orphaned_current_interval_dealloc_requests;
 
+  /// Whether this is the default domain.
+  const bool default_domain{false};
+
+  /// The domain_thread_cache slot of this non-default domain.
+  const std::size_t thread_cache_slot{no_thread_cache_slot};
+
   static_assert(sizeof(state) +
                         sizeof(orphaned_previous_interval_dealloc_requests) +
-                        sizeof(orphaned_current_interval_dealloc_requests) <=
+                        sizeof(orphaned_current_interval_dealloc_requests) +
+                        sizeof(default_domain) + sizeof(thread_cache_slot) <=
                     detail::hardware_constructive_interference_size,
                 "Global QSBR fields must fit into a single cache line");
 
-#ifdef UNODB_DETAIL_WITH_STATS
+  /// Incremented after every epoch change with more than one registered
+  /// thread. Every thread passing through a quiescent state for the first time
+  /// in an epoch writes its quiescence shard word, and the last one of each
+  /// shard writes the state word, but this one is written once per epoch. Thus
+  /// the threads that have already passed through one in the current epoch
+  /// poll it instead of the state word in quiescent() and stay off the
+  /// contended cache lines until the next epoch change.
+  alignas(detail::hardware_destructive_interference_size)
+      std::atomic<std::uint64_t> epoch_change_sequence;
 
-  /// Epoch change counter.
+  /// Number of the quiescence shards.
+  static constexpr std::size_t quiescence_shard_count = 8;
+
+  /// A quiescence shard, in a cache line of its own, see
+  /// detail::quiescence_shard_word.
+  struct alignas(detail::hardware_destructive_interference_size)
+      quiescence_shard {
+    /// The shard word.
+    std::atomic<detail::quiescence_shard_word::type> word;
+  };
+
+  /// The quiescence shards. The threads pass through the quiescent states in
+  /// their shards, and only the last one to pass in each shard and epoch
+  /// writes the state word.
+  std::array<quiescence_shard, quiescence_shard_count> quiescence_shards{};
+
+  /// Whether the background reclaimer is running. Read without
+  /// reclaimer_lock to skip the hand-off when it is not.
   alignas(detail::hardware_destructive_interference_size)
-      std::atomic<std::uint64_t> epoch_change_count;
+      std::atomic<bool> reclaimer_enabled;
+
+  /// Mutex serializing the background reclaimer starts and stops, including
+  /// the joins of the stopped reclaimers. Taken before reclaimer_lock.
+  std::mutex reclaimer_control_lock;
 
-  /// Mutex protecting deallocation statistics.
-  alignas(detail::hardware_destructive_interference_size) std::mutex
-      dealloc_stats_lock;
+  /// Mutex protecting the background reclaimer request list and its enabled
+  /// flag updates.
+  std::mutex reclaimer_lock;
 
-  // TODO(laurynas): more interesting callback stats?
+  /// Condition variable the background reclaimer waits on for requests.
+  std::condition_variable reclaimer_wakeup;
 
-  /// Statistics for deallocation counts per thread between epoch changes.
-  boost_acc::accumulator_set<
-      std::size_t,
-      boost_acc::stats<boost_acc::tag::max, boost_acc::tag::variance>>
-      epoch_dealloc_per_thread_count_stats;
+  /// Deallocation requests handed off to the background reclaimer, protected
+  /// by reclaimer_lock.
+  detail::reclaimer_list_node* reclaimer_requests{nullptr};
 
-  /// Maximum deallocation count per thread between epoch changes.
-  std::atomic<std::size_t> epoch_dealloc_per_thread_count_max;
+  /// The background reclaimer thread, if started.
+  std::thread reclaimer_thread;
 
-  /// Variance of deallocation count per thread between epoch changes..
-  std::atomic<double> epoch_dealloc_per_thread_count_variance;
+  /// Limit of deferred deallocation requests pending in each thread, zero if
+  /// there is none.
+  alignas(detail::hardware_destructive_interference_size)
+      std::atomic<std::size_t> backlog_limit;
+
+  /// What a thread over the backlog limit does.
+  std::atomic<qsbr_backlog_policy> backlog_policy{qsbr_backlog_policy::notify};
+
+  /// Mutex protecting the registered thread list, the backlog callback, and the
+  /// statistics of the unregistered threads.
+  mutable std::mutex thread_registry_lock;
+
+  /// The threads registered with this domain, linked through
+  /// qsbr_per_thread::next_registered_thread.
+  qsbr_per_thread* registered_threads{nullptr};
 
-  /// Statistics for deallocation sizes per thread between epoch changes.
-  boost_acc::accumulator_set<
-      std::uint64_t,
-      boost_acc::stats<boost_acc::tag::max, boost_acc::tag::variance>>
-      deallocation_size_per_thread_stats;
+  /// The backlog callback, protected by thread_registry_lock.
+  qsbr_backlog_callback backlog_callback;
 
-  /// Maximum total deallocation size per thread between epoch changes.
-  std::atomic<std::uint64_t> deallocation_size_per_thread_max;
+  /// Number of registered threads which are offline, outside of any
+  /// unodb::ebr_guard in the guard mode. Only a hint for when to help them,
+  /// thus relaxed.
+  std::atomic<qsbr_thread_count_type> offline_threads;
 
-  /// Mean total deallocation size per thread between epoch changes.
-  std::atomic<double> deallocation_size_per_thread_mean;
+#ifdef UNODB_DETAIL_WITH_STATS
 
-  /// Variance of total deallocation size per thread between epoch changes.
-  std::atomic<double> deallocation_size_per_thread_variance;
+  /// Epoch change counter.
+  alignas(detail::hardware_destructive_interference_size)
+      std::atomic<std::uint64_t> epoch_change_count;
 
-  /// Mutex protecting quiescent state statistics.
-  alignas(detail::hardware_destructive_interference_size) std::mutex
-      quiescent_state_stats_lock;
+  /// Statistics generation, incremented by reset_stats() with
+  /// thread_registry_lock held.
+  std::atomic<std::uint64_t> stats_generation;
 
-  /// Statistics for quiescent states per thread between epoch changes.
-  boost_acc::accumulator_set<std::uint64_t,
-                             boost_acc::stats<boost_acc::tag::mean>>
-      quiescent_states_per_thread_between_epoch_change_stats;
-  /// Mean number of quiescent states between epoch changes per thread.
-  std::atomic<double> quiescent_states_per_thread_between_epoch_change_mean;
+  /// Statistics of the threads that have unregistered in the current
+  /// statistics generation, protected by thread_registry_lock.
+  detail::qsbr_stats_summary unregistered_thread_stats;
 
 #endif  // UNODB_DETAIL_WITH_STATS
 };
@@ -1260,8 +2215,16 @@ static_assert(std::atomic<double>::is_always_lock_free);
 
 UNODB_DETAIL_DISABLE_MSVC_WARNING(26455)
 inline qsbr_per_thread::qsbr_per_thread()
-    : last_seen_quiescent_state_epoch{qsbr::instance().register_thread()},
-      last_seen_epoch{last_seen_quiescent_state_epoch} {}
+    : qsbr_per_thread{qsbr::instance()} {}
+
+inline qsbr_per_thread::qsbr_per_thread(qsbr& domain_)
+    : domain{domain_},
+      quiescence_shard{domain_.choose_quiescence_shard()},
+      last_seen_quiescent_state_epoch{
+          domain_.register_thread(quiescence_shard)},
+      last_seen_epoch{last_seen_quiescent_state_epoch} {
+  domain.link_thread(*this);
+}
 UNODB_DETAIL_RESTORE_MSVC_WARNINGS()
 
 inline void qsbr_per_thread::on_next_epoch_deallocate(
@@ -1274,16 +2237,60 @@ inline void qsbr_per_thread::on_next_epoch_deallocate(
     ,
     detail::deallocation_request::debug_callback dealloc_callback
 #endif
+) {
+  defer_deallocation(pointer, detail::no_free_list,
+#ifdef UNODB_DETAIL_WITH_STATS
+                     size
+#else
+                     0
+#endif
+#ifndef NDEBUG
+                     ,
+                     std::move(dealloc_callback)
+#endif
+  );
+}
+
+inline void qsbr_per_thread::on_next_epoch_recycle(
+    void* pointer, std::size_t free_list, std::size_t size
+#ifndef NDEBUG
+    ,
+    detail::deallocation_request::debug_callback dealloc_callback
+#endif
+) {
+  UNODB_DETAIL_ASSERT(free_list < detail::no_free_list);
+  defer_deallocation(pointer, free_list, size
+#ifndef NDEBUG
+                     ,
+                     std::move(dealloc_callback)
+#endif
+  );
+}
+
+inline void qsbr_per_thread::defer_deallocation(
+    void* pointer, std::size_t free_list, std::size_t size
+#ifndef NDEBUG
+    ,
+    detail::deallocation_request::debug_callback dealloc_callback
+#endif
 ) {
   UNODB_DETAIL_ASSERT(!is_qsbr_paused());
+  UNODB_DETAIL_ASSERT(!offline);
 
-  const auto current_qsbr_state = qsbr::instance().get_state();
+  const auto current_qsbr_state = domain.get_state();
   const auto current_global_epoch = qsbr_state::get_epoch(current_qsbr_state);
   const auto single_thread_mode =
       qsbr_state::single_thread_mode(current_qsbr_state);
 
   if (UNODB_DETAIL_UNLIKELY(single_thread_mode)) {
     advance_last_seen_epoch(single_thread_mode, current_global_epoch);
+    if (free_list != detail::no_free_list) {
+#ifndef NDEBUG
+      if (dealloc_callback != nullptr) dealloc_callback(pointer);
+#endif
+      free_lists.put(free_list, pointer, size);
+      return;
+    }
     qsbr::deallocate(pointer
 #ifndef NDEBUG
                      ,
@@ -1295,7 +2302,7 @@ inline void qsbr_per_thread::on_next_epoch_deallocate(
 
   if (last_seen_epoch != current_global_epoch) {
     detail::dealloc_request_vector new_current_requests;
-    new_current_requests.emplace_back(pointer
+    new_current_requests.emplace_back(pointer, free_list, size
 #ifndef NDEBUG
                                       ,
                                       current_global_epoch,
@@ -1309,10 +2316,11 @@ inline void qsbr_per_thread::on_next_epoch_deallocate(
     UNODB_DETAIL_ASSERT(current_interval_total_dealloc_size == 0);
     current_interval_total_dealloc_size = size;
 #endif  // UNODB_DETAIL_WITH_STATS
+    check_backlog_limit();
     return;
   }
 
-  current_interval_dealloc_requests.emplace_back(pointer
+  current_interval_dealloc_requests.emplace_back(pointer, free_list, size
 #ifndef NDEBUG
                                                  ,
                                                  last_seen_epoch,
@@ -1322,15 +2330,73 @@ inline void qsbr_per_thread::on_next_epoch_deallocate(
 #ifdef UNODB_DETAIL_WITH_STATS
   current_interval_total_dealloc_size += size;
 #endif  // UNODB_DETAIL_WITH_STATS
+  check_backlog_limit();
+}
+
+inline void qsbr_per_thread::set_owner_to_current_thread() noexcept {
+  domain.set_thread_owner(*this);
+}
+
+inline void qsbr_per_thread::enter_guard() {
+  UNODB_DETAIL_ASSERT(!paused);
+
+  if (guard_depth++ != 0) return;
+  if (UNODB_DETAIL_LIKELY(offline)) {
+    go_online();
+    return;
+  }
+  guard_mode = true;
+}
+
+inline void qsbr_per_thread::leave_guard() noexcept {
+  UNODB_DETAIL_ASSERT(guard_depth > 0);
+
+  if (--guard_depth != 0) return;
+  quiescent();
+  go_offline();
+}
+
+inline void qsbr_per_thread::go_offline() noexcept {
+  UNODB_DETAIL_ASSERT(guard_mode);
+  UNODB_DETAIL_ASSERT(!offline);
+  UNODB_DETAIL_ASSERT(last_seen_epoch == last_seen_quiescent_state_epoch);
+
+  // Release pairs with the acquire of the threads passing through quiescent
+  // states on behalf of this one, ordering its critical section before them.
+  // Only this thread writes the word while it is online.
+  const auto online_word = offline_word.load(std::memory_order_relaxed);
+  offline_word.store(detail::offline_word::make_next(
+                         last_seen_quiescent_state_epoch,
+                         quiescent_states_since_epoch_change != 0, online_word),
+                     std::memory_order_release);
+  offline = true;
+  domain.offline_threads.fetch_add(1, std::memory_order_relaxed);
+}
+
+inline void qsbr_per_thread::go_online() noexcept {
+  UNODB_DETAIL_ASSERT(offline);
+
+  // An RMW, so that any other thread either passes through a quiescent state
+  // on behalf of this one before, or sees it online.
+  const auto word = offline_word.fetch_and(
+      detail::offline_word::generation_mask, std::memory_order_acq_rel);
+  UNODB_DETAIL_ASSERT(detail::offline_word::is_offline(word));
+  offline = false;
+  domain.offline_threads.fetch_sub(1, std::memory_order_relaxed);
+  if (UNODB_DETAIL_UNLIKELY(detail::offline_word::get_helps(word) != 0))
+    catch_up_after_offline(word);
+}
+
+inline void qsbr_per_thread::check_backlog_limit() noexcept {
+  const auto limit = domain.get_backlog_limit();
+  if (UNODB_DETAIL_UNLIKELY(limit != 0) &&
+      UNODB_DETAIL_UNLIKELY(get_pending_request_count() > limit))
+    over_backlog_limit = true;
 }
 
 inline void qsbr_per_thread::advance_last_seen_epoch(
     bool single_thread_mode, qsbr_epoch new_seen_epoch,
-    detail::dealloc_request_vector new_current_requests)
-#ifndef UNODB_DETAIL_WITH_STATS
-    noexcept
-#endif
-{
+    detail::dealloc_request_vector new_current_requests) noexcept {
   if (new_seen_epoch == last_seen_epoch) return;
 
   // NOLINTNEXTLINE(readability-simplify-boolean-expr)
@@ -1346,23 +2412,27 @@ inline void qsbr_per_thread::advance_last_seen_epoch(
 
 inline void qsbr_per_thread::execute_previous_requests(
     bool single_thread_mode, qsbr_epoch dealloc_epoch,
-    detail::dealloc_request_vector new_current_requests)
-#ifndef UNODB_DETAIL_WITH_STATS
-    noexcept
-#endif
-{
+    detail::dealloc_request_vector new_current_requests) noexcept {
   last_seen_epoch = dealloc_epoch;
 
-  const detail::deferred_requests requests_to_deallocate{
-      std::move(previous_interval_dealloc_requests)
+  if (UNODB_DETAIL_LIKELY(!domain.has_background_reclaimer()) ||
+      previous_interval_dealloc_requests.empty() ||
+      !recycle_or_hand_off_previous_requests(
 #ifndef NDEBUG
-          ,
-      false, dealloc_epoch, single_thread_mode
+          dealloc_epoch, single_thread_mode
 #endif
-  };
+          )) {
+    const detail::deferred_requests requests_to_deallocate{
+        std::move(previous_interval_dealloc_requests), &free_lists
+#ifndef NDEBUG
+            ,
+        false, dealloc_epoch, single_thread_mode
+#endif
+    };
+  }
 
 #ifdef UNODB_DETAIL_WITH_STATS
-  qsbr::instance().register_dealloc_stats_per_thread_between_epoch_changes(
+  register_dealloc_stats_between_epoch_changes(
       current_interval_total_dealloc_size,
       current_interval_dealloc_requests.size());
   current_interval_total_dealloc_size = 0;
@@ -1374,7 +2444,7 @@ inline void qsbr_per_thread::execute_previous_requests(
   } else {
     previous_interval_dealloc_requests.clear();
     const detail::deferred_requests additional_requests_to_deallocate{
-        std::move(current_interval_dealloc_requests)
+        std::move(current_interval_dealloc_requests), &free_lists
 #ifndef NDEBUG
             ,
         false, dealloc_epoch, single_thread_mode
@@ -1384,15 +2454,102 @@ inline void qsbr_per_thread::execute_previous_requests(
   current_interval_dealloc_requests = std::move(new_current_requests);
 }
 
-inline void qsbr_per_thread::quiescent()
-#ifndef UNODB_DETAIL_WITH_STATS
-    noexcept
+inline bool qsbr_per_thread::recycle_or_hand_off_previous_requests(
+#ifndef NDEBUG
+    qsbr_epoch dealloc_epoch, bool single_thread_mode
+#endif
+    ) noexcept {
+  UNODB_DETAIL_ASSERT(!previous_interval_dealloc_requests.empty());
+
+  if (free_lists.get_capacity() != 0) {
+    detail::dealloc_request_vector requests_to_free;
+    for (auto& dealloc_request : previous_interval_dealloc_requests) {
+      if (dealloc_request.is_recyclable_into(free_lists)) {
+        dealloc_request.deallocate(&free_lists
+#ifndef NDEBUG
+                                   ,
+                                   false, dealloc_epoch, single_thread_mode
 #endif
-{
+        );
+      } else {
+        requests_to_free.push_back(std::move(dealloc_request));
+      }
+    }
+    previous_interval_dealloc_requests = std::move(requests_to_free);
+    if (previous_interval_dealloc_requests.empty()) return true;
+  }
+
+  return domain.hand_off_to_reclaimer(previous_interval_dealloc_requests
+#ifndef NDEBUG
+                                      ,
+                                      dealloc_epoch, single_thread_mode
+#endif
+  );
+}
+
+#ifdef UNODB_DETAIL_WITH_STATS
+
+inline void qsbr_per_thread::refresh_stats_generation() noexcept {
+  const auto generation = domain.get_stats_generation();
+  if (UNODB_DETAIL_LIKELY(stats.generation.load(std::memory_order_relaxed) ==
+                          generation))
+    return;
+  stats.reset();
+  stats.generation.store(generation, std::memory_order_release);
+}
+
+inline void qsbr_per_thread::register_quiescent_states_between_epoch_changes(
+    std::uint64_t states) noexcept {
+  refresh_stats_generation();
+  stats.quiescent_states.add(states);
+}
+
+inline void qsbr_per_thread::register_dealloc_stats_between_epoch_changes(
+    std::size_t total_size, std::size_t count) noexcept {
+  refresh_stats_generation();
+  stats.dealloc_sizes.add(total_size);
+  stats.dealloc_counts.add(count);
+}
+
+#endif  // UNODB_DETAIL_WITH_STATS
+
+inline void qsbr_per_thread::quiescent() noexcept {
+  const auto was_offline = offline;
+  if (UNODB_DETAIL_UNLIKELY(was_offline)) go_online();
+  do_quiescent();
+  if (UNODB_DETAIL_UNLIKELY(over_backlog_limit)) handle_backlog_over_limit();
+  if (UNODB_DETAIL_UNLIKELY(was_offline)) go_offline();
+}
+
+inline void qsbr_per_thread::do_quiescent() noexcept {
   UNODB_DETAIL_ASSERT(!paused);
+  UNODB_DETAIL_ASSERT(!offline);
+  UNODB_DETAIL_ASSERT(guard_depth == 0);
   UNODB_DETAIL_ASSERT(active_ptrs.empty());
 
-  const auto state = qsbr::instance().get_state();
+  // If this thread has already passed through a quiescent state in its last
+  // seen epoch, and no epoch change happened since, there is nothing to do. Not
+  // noticing an epoch change yet is safe, as it only postpones this thread
+  // leaving the previous epoch. The sequence number must be read before the
+  // state so that it cannot miss the change to the epoch read below. A
+  // deallocation request may have seen an epoch change whose sequence number
+  // bump is still pending, in which case the slow path catches up with it, so
+  // that the quiescent state epoch is never behind the last seen one.
+  const auto epoch_change_sequence = domain.get_epoch_change_sequence();
+  if (UNODB_DETAIL_LIKELY(epoch_change_sequence ==
+                          last_seen_epoch_change_sequence) &&
+      UNODB_DETAIL_LIKELY(quiescent_states_since_epoch_change != 0) &&
+      UNODB_DETAIL_LIKELY(last_seen_epoch == last_seen_quiescent_state_epoch)) {
+    ++quiescent_states_since_epoch_change;
+    // The epoch might be held back by the offline threads
+    if (UNODB_DETAIL_UNLIKELY((quiescent_states_since_epoch_change &
+                               (offline_help_interval - 1)) == 0))
+      domain.maybe_help_offline_threads();
+    return;
+  }
+  last_seen_epoch_change_sequence = epoch_change_sequence;
+
+  const auto state = domain.get_state();
   const auto current_global_epoch = qsbr_state::get_epoch(state);
   const auto single_thread_mode = qsbr_state::single_thread_mode(state);
 
@@ -1404,7 +2561,7 @@ inline void qsbr_per_thread::quiescent()
 
     last_seen_quiescent_state_epoch = current_global_epoch;
 #ifdef UNODB_DETAIL_WITH_STATS
-    qsbr::instance().register_quiescent_states_per_thread_between_epoch_changes(
+    register_quiescent_states_between_epoch_changes(
         quiescent_states_since_epoch_change);
 #endif  // UNODB_DETAIL_WITH_STATS
     quiescent_states_since_epoch_change = 0;
@@ -1413,8 +2570,8 @@ inline void qsbr_per_thread::quiescent()
   UNODB_DETAIL_ASSERT(current_global_epoch == last_seen_quiescent_state_epoch);
   if (quiescent_states_since_epoch_change == 0) {
     const auto new_global_epoch =
-        qsbr::instance().remove_thread_from_previous_epoch(
-            current_global_epoch
+        domain.remove_thread_from_previous_epoch(
+            current_global_epoch, quiescence_shard
 #ifndef NDEBUG
             ,
             last_seen_quiescent_state_epoch
@@ -1423,6 +2580,8 @@ inline void qsbr_per_thread::quiescent()
     UNODB_DETAIL_ASSERT(new_global_epoch == last_seen_quiescent_state_epoch ||
                         new_global_epoch ==
                             last_seen_quiescent_state_epoch.advance());
+    published_quiescent_state_epoch.store(current_global_epoch,
+                                          std::memory_order_relaxed);
 
     if (new_global_epoch != last_seen_quiescent_state_epoch) {
       last_seen_quiescent_state_epoch = new_global_epoch;
@@ -1431,8 +2590,7 @@ inline void qsbr_per_thread::quiescent()
       execute_previous_requests(single_thread_mode, new_global_epoch);
 
 #ifdef UNODB_DETAIL_WITH_STATS
-      qsbr::instance()
-          .register_quiescent_states_per_thread_between_epoch_changes(1);
+      register_quiescent_states_between_epoch_changes(1);
 #endif  // UNODB_DETAIL_WITH_STATS
       return;
     }
@@ -1443,7 +2601,9 @@ inline void qsbr_per_thread::quiescent()
 namespace detail {
 
 inline void deallocation_request::deallocate(
+    qsbr_free_lists* free_lists
 #ifndef NDEBUG
+    ,
     bool orphan, std::optional<qsbr_epoch> dealloc_epoch,
     std::optional<bool> dealloc_epoch_single_thread_mode
 #endif
@@ -1457,12 +2617,19 @@ inline void deallocation_request::deallocate(
                          *dealloc_epoch == request_epoch.advance()) ||
                         *dealloc_epoch == request_epoch.advance(2))));
 
-  qsbr::deallocate(pointer
+  if (free_lists != nullptr && free_list != no_free_list) {
 #ifndef NDEBUG
-                   ,
-                   dealloc_callback
+    if (dealloc_callback != nullptr) dealloc_callback(pointer);
 #endif
-  );
+    free_lists->put(free_list, pointer, block_size);
+  } else {
+    qsbr::deallocate(pointer
+#ifndef NDEBUG
+                     ,
+                     dealloc_callback
+#endif
+    );
+  }
 
 #ifndef NDEBUG
   instance_count.fetch_sub(1, std::memory_order_relaxed);
@@ -1471,16 +2638,19 @@ inline void deallocation_request::deallocate(
 
 }  // namespace detail
 
-inline void qsbr_per_thread::qsbr_pause()
-#ifndef UNODB_DETAIL_WITH_STATS
-    noexcept
-#endif
-{
+inline void qsbr_per_thread::qsbr_pause() noexcept {
   UNODB_DETAIL_ASSERT(!paused);
   UNODB_DETAIL_ASSERT(active_ptrs.empty());
+  UNODB_DETAIL_ASSERT(guard_depth == 0);
 
-  qsbr::instance().unregister_thread(quiescent_states_since_epoch_change,
-                                     last_seen_quiescent_state_epoch, *this);
+  if (offline) go_online();
+  guard_mode = false;
+  domain.unlink_thread(*this);
+  domain.unregister_thread(quiescent_states_since_epoch_change,
+                           last_seen_quiescent_state_epoch, *this);
+#ifdef UNODB_DETAIL_WITH_STATS
+  domain.retire_thread_stats(*this);
+#endif
   paused = true;
 
   UNODB_DETAIL_ASSERT(previous_interval_requests_empty());
@@ -1500,10 +2670,16 @@ inline void qsbr_per_thread::qsbr_resume() {
   current_interval_orphan_list_node =
       std::make_unique<detail::dealloc_vector_list_node>();
 
-  last_seen_quiescent_state_epoch = qsbr::instance().register_thread();
+  quiescence_shard = domain.choose_quiescence_shard();
+  last_seen_quiescent_state_epoch = domain.register_thread(quiescence_shard);
   last_seen_epoch = last_seen_quiescent_state_epoch;
+  published_quiescent_state_epoch.store(
+      last_seen_quiescent_state_epoch.advance(), std::memory_order_relaxed);
   quiescent_states_since_epoch_change = 0;
+  over_backlog_limit = false;
+  backlog_limit_reported = false;
   paused = false;
+  domain.link_thread(*this);
 }
 
 /// RAII guard that signals quiescent state for this thread on destruction.
@@ -1512,38 +2688,7 @@ struct quiescent_state_on_scope_exit final {
   quiescent_state_on_scope_exit() = default;
 
   /// Destructor, that signals quiescent state for this thread.
-  ~quiescent_state_on_scope_exit()
-#ifdef UNODB_DETAIL_WITH_STATS
-      noexcept(false)
-#else
-      noexcept
-#endif
-  {
-#ifdef UNODB_DETAIL_WITH_STATS
-    // TODO(laurynas): to avoid try/catch, see the TODO at the previous
-    // try/catch.
-    try {
-      this_thread().quiescent();
-    }
-    // LCOV_EXCL_START
-    catch (const std::system_error& e) {
-      if (exceptions_at_ctor == std::uncaught_exceptions()) throw;
-      std::cerr << "QSBR quiescent state failed to register QSBR stats: "
-                << e.what() << '\n';
-    } catch (const std::exception& e) {
-      if (exceptions_at_ctor == std::uncaught_exceptions()) throw;
-      std::cerr << "QSBR quiescent state exception: " << e.what() << '\n';
-      UNODB_DETAIL_DEBUG_CRASH();
-    } catch (...) {
-      if (exceptions_at_ctor == std::uncaught_exceptions()) throw;
-      std::cerr << "QSBR quiescent state unknown exception\n";
-      UNODB_DETAIL_DEBUG_CRASH();
-    }
-    // LCOV_EXCL_STOP
-#else
-    this_thread().quiescent();
-#endif
-  }
+  ~quiescent_state_on_scope_exit() noexcept { this_thread().quiescent(); }
 
   /// Copy construction is disabled.
   quiescent_state_on_scope_exit(const quiescent_state_on_scope_exit&) = delete;
@@ -1558,13 +2703,158 @@ struct quiescent_state_on_scope_exit final {
   /// Move assignment is disabled.
   quiescent_state_on_scope_exit& operator=(quiescent_state_on_scope_exit&&) =
       delete;
+};
 
-#ifdef UNODB_DETAIL_WITH_STATS
+/// RAII guard for using QSBR in the epoch-based reclamation style.
+///
+/// Instead of passing through quiescent states regularly, a thread may access
+/// the QSBR-protected data only inside guard scopes, which may nest. Once it
+/// has entered a guard, the thread is in guard mode until it pauses or exits:
+/// on leaving the outermost guard scope it passes through a quiescent state
+/// and goes offline, and then the other threads pass through quiescent states
+/// on its behalf, so that an idle thread does not hold back the epoch changes.
+/// The epochs advance lazily: an active thread does this for the offline ones
+/// after detail::qsbr_per_thread::offline_help_interval of its quiescent
+/// states in the same epoch. The thread going online catches up with the
+/// epoch changes made meanwhile, executing its deallocation requests that
+/// expired.
+///
+/// Entering and leaving the outermost guard costs an atomic store and an
+/// atomic exchange of a thread-local word in addition to the quiescent state.
+class [[nodiscard]] ebr_guard final {
+ public:
+  /// Enter a guard scope for the default QSBR domain.
+  ebr_guard() : ebr_guard{this_thread()} {}
+
+  /// Enter a guard scope for \a domain.
+  explicit ebr_guard(qsbr& domain UNODB_DETAIL_LIFETIMEBOUND)
+      : ebr_guard{domain.current_thread()} {}
+
+  /// Leave the guard scope, going offline if it is the outermost one.
+  ~ebr_guard() noexcept { thread.leave_guard(); }
+
+  /// Copy construction is disabled.
+  ebr_guard(const ebr_guard&) = delete;
+
+  /// Move construction is disabled.
+  ebr_guard(ebr_guard&&) = delete;
+
+  /// Copy assignment is disabled.
+  ebr_guard& operator=(const ebr_guard&) = delete;
+
+  /// Move assignment is disabled.
+  ebr_guard& operator=(ebr_guard&&) = delete;
 
  private:
-  /// Count of exceptions at constructor time for proper rethrow handling.
-  const int exceptions_at_ctor{std::uncaught_exceptions()};
-#endif
+  /// Enter a guard scope for the thread with the state \a thread_.
+  explicit ebr_guard(qsbr_per_thread& thread_) : thread{thread_} {
+    thread.enter_guard();
+  }
+
+  /// The QSBR state of the guarded thread.
+  qsbr_per_thread& thread;
+};
+
+/// Task-boundary hooks for a worker thread of a thread pool whose tasks access
+/// the QSBR-protected data.
+///
+/// Tasks run through run() pass through a quiescent state once every
+/// tasks_per_quiescent_state of them, amortizing its cost over the tasks at the
+/// price of a reclamation lag of that many tasks. A worker about to block
+/// waiting for new tasks calls park(), which pauses QSBR for the thread so that
+/// it does not hold back the epoch changes while idle, and the next run()
+/// resumes it.
+///
+/// Must be created, used, and destroyed by the worker thread. The tasks must
+/// not hold active pointers to the QSBR-protected data after they end.
+class [[nodiscard]] qsbr_worker final {
+ public:
+  /// Default count of tasks between quiescent states.
+  static constexpr std::uint32_t default_tasks_per_quiescent_state = 16;
+
+  /// Create the hooks for the current thread in the default QSBR domain,
+  /// passing through a quiescent state once every \a tasks_per_quiescent_state_
+  /// tasks.
+  explicit qsbr_worker(std::uint32_t tasks_per_quiescent_state_ =
+                           default_tasks_per_quiescent_state)
+      : qsbr_worker{qsbr::instance(), tasks_per_quiescent_state_} {}
+
+  /// Create the hooks for the current thread in \a domain, passing through a
+  /// quiescent state once every \a tasks_per_quiescent_state_ tasks.
+  explicit qsbr_worker(qsbr& domain UNODB_DETAIL_LIFETIMEBOUND,
+                       std::uint32_t tasks_per_quiescent_state_ =
+                           default_tasks_per_quiescent_state)
+      : thread{domain.current_thread()},
+        tasks_per_quiescent_state{tasks_per_quiescent_state_} {
+    UNODB_DETAIL_ASSERT(tasks_per_quiescent_state > 0);
+  }
+
+  /// Pass through a quiescent state if any tasks have run since the last one.
+  /// A parked thread stays paused.
+  ~qsbr_worker() noexcept {
+    if (!parked && tasks_since_quiescent_state > 0) thread.quiescent();
+  }
+
+  /// Run \a task, resuming QSBR for the thread first if it is parked, and then
+  /// pass through a quiescent state if enough tasks have run since the last
+  /// one.
+  ///
+  /// \throws std::bad_alloc if the thread is parked and cannot be resumed,
+  /// and any exception thrown by \a task, after which the task is not counted
+  template <typename Task>
+  void run(Task&& task) {
+    if (UNODB_DETAIL_UNLIKELY(parked)) unpark();
+    std::invoke(std::forward<Task>(task));
+    if (++tasks_since_quiescent_state < tasks_per_quiescent_state) return;
+    tasks_since_quiescent_state = 0;
+    thread.quiescent();
+  }
+
+  /// Pause QSBR for the thread before it blocks waiting for new tasks. Does
+  /// nothing if it is parked already.
+  void park() noexcept {
+    if (parked) return;
+    thread.qsbr_pause();
+    tasks_since_quiescent_state = 0;
+    parked = true;
+  }
+
+  /// Resume QSBR for the parked thread without running a task.
+  ///
+  /// \throws std::bad_alloc if the thread cannot be resumed
+  void unpark() {
+    UNODB_DETAIL_ASSERT(parked);
+    thread.qsbr_resume();
+    parked = false;
+  }
+
+  /// Check whether the thread is parked.
+  [[nodiscard]] bool is_parked() const noexcept { return parked; }
+
+  /// Copy construction is disabled.
+  qsbr_worker(const qsbr_worker&) = delete;
+
+  /// Move construction is disabled.
+  qsbr_worker(qsbr_worker&&) = delete;
+
+  /// Copy assignment is disabled.
+  qsbr_worker& operator=(const qsbr_worker&) = delete;
+
+  /// Move assignment is disabled.
+  qsbr_worker& operator=(qsbr_worker&&) = delete;
+
+ private:
+  /// The QSBR state of the worker thread.
+  qsbr_per_thread& thread;
+
+  /// Count of tasks between quiescent states.
+  const std::uint32_t tasks_per_quiescent_state;
+
+  /// Count of tasks run since the last quiescent state.
+  std::uint32_t tasks_since_quiescent_state{0};
+
+  /// Whether QSBR is paused for the thread by park().
+  bool parked{false};
 };
 
 /// An `std::thread`-like thread that participates in QSBR.
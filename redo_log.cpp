@@ -0,0 +1,270 @@
+// Copyright 2025 UnoDB contributors
+
+/// \file
+/// Redo log implementation details.
+///
+/// Implementation of non-inline symbols from redo_log.hpp: the log record
+/// format, the file I/O, and the group commit.
+
+// Should be the first include
+#include "global.hpp"
+
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "art_common.hpp"
+#include "assert.hpp"
+#include "redo_log.hpp"
+
+namespace {
+
+// Record layout: type (1 byte), key size (4 bytes), value size (4 bytes), key
+// bytes, value bytes, and a checksum (4 bytes) of everything before it. The
+// integers are in the native byte order.
+constexpr std::size_t header_size = 1 + 2 * sizeof(std::uint32_t);
+constexpr std::size_t checksum_size = sizeof(std::uint32_t);
+
+// FNV-1a, sufficient to detect torn writes
+[[nodiscard]] std::uint32_t checksum(std::span<const std::byte> data,
+                                     std::uint32_t hash = 2166136261U) noexcept {
+  for (const auto b : data) {
+    hash ^= static_cast<std::uint8_t>(b);
+    hash *= 16777619U;
+  }
+  return hash;
+}
+
+[[nodiscard]] std::error_code last_error() noexcept {
+  // Not every stdio failure sets errno
+  return {errno != 0 ? errno : EIO, std::generic_category()};
+}
+
+[[nodiscard]] std::FILE* open_file(const std::filesystem::path& path,
+                                   const char* mode) {
+  errno = 0;
+  auto* const result = std::fopen(path.string().c_str(), mode);
+  if (result == nullptr)
+    throw std::system_error{last_error(),
+                            "unodb::redo_log: cannot open " + path.string()};
+  // The log does its own buffering
+  std::setvbuf(result, nullptr, _IONBF, 0);
+  return result;
+}
+
+[[nodiscard]] bool sync_file(std::FILE* file) noexcept {
+#ifdef _WIN32
+  return _commit(_fileno(file)) == 0;
+#else
+  return fsync(fileno(file)) == 0;
+#endif
+}
+
+}  // namespace
+
+namespace unodb::detail {
+
+redo_log_reader::redo_log_reader(const std::filesystem::path& path) {
+  if (!std::filesystem::exists(path)) return;
+  file = open_file(path, "rb");
+  file_size = std::filesystem::file_size(path);
+}
+
+redo_log_reader::~redo_log_reader() noexcept {
+  if (file != nullptr) std::fclose(file);
+}
+
+bool redo_log_reader::next(redo_record& record) {
+  if (file == nullptr) return false;
+
+  std::array<std::byte, header_size> header;
+  if (std::fread(header.data(), 1, header_size, file) != header_size)
+    return false;
+
+  const auto type = static_cast<redo_record_type>(header[0]);
+  if (type != redo_record_type::INSERT && type != redo_record_type::REMOVE)
+    return false;
+  std::uint32_t key_size;
+  std::uint32_t value_size;
+  std::memcpy(&key_size, header.data() + 1, sizeof(key_size));
+  std::memcpy(&value_size, header.data() + 1 + sizeof(key_size),
+              sizeof(value_size));
+
+  // Do not trust the sizes of a possibly torn record before allocating for it
+  const auto payload_size =
+      std::size_t{key_size} + std::size_t{value_size} + checksum_size;
+  if (file_size - valid_size - header_size < payload_size) return false;
+
+  buffer.resize(payload_size);
+  if (std::fread(buffer.data(), 1, payload_size, file) != payload_size)
+    return false;  // LCOV_EXCL_LINE
+
+  std::uint32_t stored_checksum;
+  std::memcpy(&stored_checksum, buffer.data() + key_size + value_size,
+              sizeof(stored_checksum));
+  const auto computed_checksum =
+      checksum(std::span{buffer.data(), std::size_t{key_size} + value_size},
+               checksum(header));
+  if (stored_checksum != computed_checksum) return false;
+
+  record.type = type;
+  record.key = std::span{buffer.data(), key_size};
+  record.value = value_view{buffer.data() + key_size, value_size};
+  valid_size += header_size + payload_size;
+  return true;
+}
+
+redo_log::redo_log(std::filesystem::path path_, bool sync_commits_)
+    : path{std::move(path_)},
+      sync_commits{sync_commits_},
+      file{open_file(path, "ab")} {}
+
+redo_log::~redo_log() noexcept {
+  try {
+    if (!error) sync();
+    // LCOV_EXCL_START
+  } catch (...) {
+  }
+  // LCOV_EXCL_STOP
+  std::fclose(file);
+}
+
+redo_log::lsn_type redo_log::append(redo_record_type type,
+                                    std::span<const std::byte> key,
+                                    value_view value) {
+  if (UNODB_DETAIL_UNLIKELY(key.size() >
+                            std::numeric_limits<std::uint32_t>::max())) {
+    throw std::length_error("Key length must fit in std::uint32_t");
+  }
+  if (UNODB_DETAIL_UNLIKELY(value.size() >
+                            std::numeric_limits<std::uint32_t>::max())) {
+    throw std::length_error("Value length must fit in std::uint32_t");
+  }
+  const auto key_size = static_cast<std::uint32_t>(key.size());
+  const auto value_size = static_cast<std::uint32_t>(value.size());
+
+  std::array<std::byte, header_size> header;
+  header[0] = static_cast<std::byte>(type);
+  std::memcpy(header.data() + 1, &key_size, sizeof(key_size));
+  std::memcpy(header.data() + 1 + sizeof(key_size), &value_size,
+              sizeof(value_size));
+  const auto record_checksum = checksum(value, checksum(key, checksum(header)));
+
+  const std::lock_guard guard{mutex};
+  check_error();
+  buffer.insert(buffer.end(), header.begin(), header.end());
+  buffer.insert(buffer.end(), key.begin(), key.end());
+  buffer.insert(buffer.end(), value.begin(), value.end());
+  const auto* const checksum_bytes =
+      reinterpret_cast<const std::byte*>(&record_checksum);
+  buffer.insert(buffer.end(), checksum_bytes, checksum_bytes + checksum_size);
+
+  appended_lsn += header_size + key_size + value_size + checksum_size;
+  ++record_count;
+  return appended_lsn;
+}
+
+void redo_log::commit(lsn_type lsn) {
+  std::unique_lock lock{mutex};
+  if (sync_commits) {
+    write_out(lock, lsn, true);
+  } else if (buffer.size() >= write_threshold) {
+    write_out(lock, appended_lsn, false);
+  }
+}
+
+void redo_log::write_out(std::unique_lock<std::mutex>& lock, lsn_type lsn,
+                         bool do_sync) {
+  UNODB_DETAIL_ASSERT(lock.owns_lock());
+  UNODB_DETAIL_ASSERT(lsn <= appended_lsn);
+
+  while (true) {
+    check_error();
+    if (written_lsn >= lsn && (!do_sync || durable_lsn >= lsn)) return;
+    if (io_in_progress) {
+      io_done.wait(lock);
+      continue;
+    }
+
+    // Become the I/O thread for everything appended so far
+    io_in_progress = true;
+    io_buffer.swap(buffer);
+    const auto batch_lsn = appended_lsn;
+    lock.unlock();
+
+    errno = 0;
+    std::error_code io_error;
+    if (!io_buffer.empty() &&
+        (std::fwrite(io_buffer.data(), 1, io_buffer.size(), file) !=
+             io_buffer.size() ||
+         std::fflush(file) != 0)) {
+      io_error = last_error();  // LCOV_EXCL_LINE
+    } else if (do_sync && !sync_file(file)) {
+      io_error = last_error();  // LCOV_EXCL_LINE
+    }
+    io_buffer.clear();
+
+    lock.lock();
+    io_in_progress = false;
+    io_done.notify_all();
+    if (UNODB_DETAIL_UNLIKELY(static_cast<bool>(io_error))) {
+      error = io_error;  // LCOV_EXCL_LINE
+      continue;          // LCOV_EXCL_LINE
+    }
+    written_lsn = batch_lsn;
+    if (do_sync) {
+      durable_lsn = batch_lsn;
+      ++sync_count;
+    }
+  }
+}
+
+void redo_log::reset() {
+  UNODB_DETAIL_ASSERT(!io_in_progress);
+
+  std::fclose(file);
+  file = open_file(path, "wb");
+  buffer.clear();
+  error.clear();
+  appended_lsn = 0;
+  written_lsn = 0;
+  durable_lsn = 0;
+}
+
+void sync_directory(const std::filesystem::path& dir) {
+#ifndef _WIN32
+  const auto fd = open(dir.c_str(), O_RDONLY);
+  if (fd == -1) {
+    throw std::system_error{last_error(),  // LCOV_EXCL_LINE
+                            "unodb::redo_log: cannot open " + dir.string()};
+  }
+  const auto sync_result = fsync(fd);
+  const auto sync_error = last_error();
+  close(fd);
+  if (sync_result != 0) {
+    throw std::system_error{sync_error,  // LCOV_EXCL_LINE
+                            "unodb::redo_log: cannot sync " + dir.string()};
+  }
+#else
+  static_cast<void>(dir);
+#endif
+}
+
+}  // namespace unodb::detail
@@ -0,0 +1,503 @@
+// Copyright 2025 UnoDB contributors
+#ifndef UNODB_DETAIL_REDO_LOG_HPP
+#define UNODB_DETAIL_REDO_LOG_HPP
+
+/// \file
+/// Optional redo logging and crash recovery for the ART trees.
+
+// Should be the first include
+#include "global.hpp"
+
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <mutex>
+#include <span>
+#include <system_error>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "art_common.hpp"
+#include "assert.hpp"
+#include "portability_arch.hpp"
+
+namespace unodb {
+
+namespace detail {
+
+/// Redo log record types.
+enum class redo_record_type : std::uint8_t { INSERT = 1, REMOVE = 2 };
+
+/// A redo log record, referring to the key and value bytes in the buffer of
+/// the unodb::detail::redo_log_reader which has produced it.
+struct [[nodiscard]] redo_record final {
+  redo_record_type type;
+  std::span<const std::byte> key;
+  value_view value;
+};
+
+/// A sequential reader of a redo log file. It stops at the end of the file or
+/// at the first torn or corrupted record, whichever comes first, the latter
+/// being the expected state of the log tail after a crash.
+class [[nodiscard]] redo_log_reader final {
+ public:
+  /// Open \a path for reading. A missing file is read as an empty one.
+  ///
+  /// \throws std::system_error if the file exists but cannot be opened.
+  explicit redo_log_reader(const std::filesystem::path& path);
+
+  ~redo_log_reader() noexcept;
+
+  /// Read the next record into \a record. The record is valid until the next
+  /// call.
+  ///
+  /// \return false if there are no more valid records.
+  [[nodiscard]] bool next(redo_record& record);
+
+  /// Return the file offset after the last valid record read.
+  [[nodiscard]] std::uint64_t get_valid_size() const noexcept {
+    return valid_size;
+  }
+
+  redo_log_reader(const redo_log_reader&) = delete;
+  redo_log_reader(redo_log_reader&&) = delete;
+  redo_log_reader& operator=(const redo_log_reader&) = delete;
+  redo_log_reader& operator=(redo_log_reader&&) = delete;
+
+ private:
+  std::FILE* file{nullptr};
+  std::uint64_t file_size{0};
+  std::vector<std::byte> buffer;
+  std::uint64_t valid_size{0};
+};
+
+/// An append-only redo log file with group commit.
+///
+/// Appending a record only copies it to an in-memory buffer under a mutex.
+/// Committing makes the log durable up to a given record: the first committing
+/// thread writes out and syncs the whole buffer, including the records of any
+/// other threads, while the concurrently committing threads wait for it and
+/// then find their records already durable, or, if they were appended during
+/// the sync, form the next batch. Thus the number of syncs is bounded by the
+/// number of committing threads, not by the number of records.
+class [[nodiscard]] redo_log final {
+ public:
+  /// Log sequence number: the log size in bytes after a given record.
+  using lsn_type = std::uint64_t;
+
+  /// Open or create the log at \a path for appending. If \a sync_commits is
+  /// false, then commit() does not wait for anything, and the records are
+  /// written out when the buffer fills up, on sync(), and on destruction,
+  /// trading durability of the latest records for throughput.
+  ///
+  /// \throws std::system_error if the file cannot be opened.
+  redo_log(std::filesystem::path path, bool sync_commits);
+
+  /// Write out and sync the buffered records. Any errors are ignored, call
+  /// sync() first to handle them.
+  ~redo_log() noexcept;
+
+  /// Append a record to the log buffer.
+  ///
+  /// \return The LSN of the record, to be passed to commit().
+  ///
+  /// \throws std::system_error if an earlier write to the log has failed.
+  [[nodiscard]] lsn_type append(redo_record_type type,
+                                std::span<const std::byte> key,
+                                value_view value);
+
+  /// Make the log durable up to \a lsn, if sync_commits was requested.
+  /// Otherwise, write out the buffer if it has grown large enough.
+  ///
+  /// \throws std::system_error on write or sync failure.
+  void commit(lsn_type lsn);
+
+  /// Write out and sync all the appended records.
+  ///
+  /// \throws std::system_error on write or sync failure.
+  void sync() {
+    std::unique_lock lock{mutex};
+    write_out(lock, appended_lsn, true);
+  }
+
+  /// Discard the log contents, including any buffered records. Must not be
+  /// called concurrently with any other methods.
+  ///
+  /// \throws std::system_error if the file cannot be truncated.
+  void reset();
+
+  /// Return the number of syncs so far.
+  [[nodiscard]] std::uint64_t get_sync_count() const noexcept {
+    const std::lock_guard guard{mutex};
+    return sync_count;
+  }
+
+  /// Return the number of records appended so far.
+  [[nodiscard]] std::uint64_t get_record_count() const noexcept {
+    const std::lock_guard guard{mutex};
+    return record_count;
+  }
+
+  redo_log(const redo_log&) = delete;
+  redo_log(redo_log&&) = delete;
+  redo_log& operator=(const redo_log&) = delete;
+  redo_log& operator=(redo_log&&) = delete;
+
+ private:
+  /// Buffer size at which commit() writes out the records, if sync_commits is
+  /// false.
+  static constexpr std::size_t write_threshold = 1024 * 1024;
+
+  /// Write out, and optionally sync, the log up to at least \a lsn, either by
+  /// doing the I/O on this thread, or by waiting for the thread that is already
+  /// doing it. The \a lock is released for the duration of I/O.
+  void write_out(std::unique_lock<std::mutex>& lock, lsn_type lsn,
+                 bool do_sync);
+
+  /// Throw if an earlier write has failed.
+  void check_error() const {
+    if (UNODB_DETAIL_UNLIKELY(static_cast<bool>(error)))
+      throw std::system_error{error, "unodb::redo_log: earlier write failed"};
+  }
+
+  const std::filesystem::path path;
+  const bool sync_commits;
+
+  std::FILE* file{nullptr};
+
+  mutable std::mutex mutex;
+
+  /// Signalled when the thread doing I/O completes it.
+  std::condition_variable io_done;
+
+  /// Records appended but not yet handed over to I/O.
+  std::vector<std::byte> buffer;
+
+  /// Records being written out by the thread doing I/O, swapped with \a buffer.
+  std::vector<std::byte> io_buffer;
+
+  /// Whether some thread is doing I/O without holding the mutex.
+  bool io_in_progress{false};
+
+  /// The error of the first failed write or sync, if any. All the subsequent
+  /// operations fail, as the log file tail is in an unknown state.
+  std::error_code error;
+
+  lsn_type appended_lsn{0};
+  lsn_type written_lsn{0};
+  lsn_type durable_lsn{0};
+
+  std::uint64_t sync_count{0};
+  std::uint64_t record_count{0};
+};
+
+/// Sync the directory entries of \a dir, making a preceding rename durable.
+/// Does nothing on the platforms where this is not supported.
+void sync_directory(const std::filesystem::path& dir);
+
+}  // namespace detail
+
+/// An ART tree with redo logging for crash recovery, wrapping a unodb::db,
+/// unodb::mutex_db, or unodb::olc_db instance.
+///
+/// The state consists of two files in a directory: a base image, created by
+/// checkpoint(), and a redo log of all the successful insert() and remove()
+/// operations since. The constructor recovers the tree by loading the base
+/// image, which is stored in key order, and then replaying the log over it. A
+/// torn record at the log tail, left by a crash during a write, is discarded.
+///
+/// The writers apply the operation to the tree, append it to the in-memory log
+/// buffer, and, if synchronous commits are requested, wait for the log to
+/// become durable. Concurrent waiting writers are group-committed, sharing a
+/// single log write and sync. The writers to the same key are serialized over
+/// the apply and append steps by one of the lock stripes, so that the log
+/// order matches the tree order for any key. Operations become visible to the
+/// readers before they become durable.
+///
+/// If Db is unodb::olc_db, all the calling threads, including the one
+/// constructing the instance, must participate in QSBR.
+template <class Db>
+class durable_db final {
+ public:
+  /// The type of the keys in the index.
+  using key_type = typename Db::key_type;
+  /// The type of the value associated with the keys in the index.
+  using value_type = typename Db::value_type;
+  using get_result = typename Db::get_result;
+  using iterator = typename Db::iterator;
+
+  static_assert(std::is_same_v<key_type, key_view> ||
+                std::is_integral_v<key_type>);
+
+  /// Open the durable tree in the directory \a dir, creating it if needed, and
+  /// recover its contents.
+  ///
+  /// \param sync_commits Whether insert() and remove() return only after their
+  /// log records are durable. If false, the most recent operations may be lost
+  /// in a crash, but the recovered state is still consistent.
+  ///
+  /// \throws std::system_error or std::filesystem::filesystem_error on I/O
+  /// errors.
+  explicit durable_db(const std::filesystem::path& dir,
+                      bool sync_commits = true)
+      : dir_{create_directory(dir)}, log{recover(), sync_commits} {}
+
+  ~durable_db() noexcept = default;
+
+  /// Query for a value associated with a key.
+  [[nodiscard]] get_result get(key_type search_key) const noexcept {
+    return db_.get(search_key);
+  }
+
+  /// Return true iff the tree is empty.
+  [[nodiscard]] auto empty() const { return db_.empty(); }
+
+  /// Insert a value under a key iff there is no entry for that key, and log
+  /// the insert if it succeeds.
+  ///
+  /// \return true iff the key value pair was inserted.
+  ///
+  /// \throws std::system_error on log I/O errors, in which case the insert is
+  /// durable if and only if a later recovery finds it in the log.
+  [[nodiscard]] bool insert(key_type insert_key, value_type v) {
+    const auto key_bytes = as_bytes(insert_key);
+    detail::redo_log::lsn_type lsn;
+    {
+      const std::lock_guard guard{stripe_for(key_bytes)};
+      if (!db_.insert(insert_key, v)) return false;
+      try {
+        lsn = log.append(detail::redo_record_type::INSERT, key_bytes, v);
+      } catch (...) {
+        std::ignore = db_.remove(insert_key);
+        throw;
+      }
+    }
+    log.commit(lsn);
+    return true;
+  }
+
+  /// Remove the entry associated with the key, and log the removal if it
+  /// succeeds.
+  ///
+  /// \return true iff the key was found and removed.
+  ///
+  /// \throws std::system_error on log I/O errors. If the removal could not be
+  /// appended to the log, the tree is left unchanged, otherwise the removal is
+  /// durable if and only if a later recovery finds it in the log.
+  ///
+  /// \throws std::bad_alloc if the tree fails to shrink a node, after the
+  /// removal has been logged. The key then stays in the tree until the next
+  /// recovery.
+  [[nodiscard]] bool remove(key_type search_key) {
+    const auto key_bytes = as_bytes(search_key);
+    detail::redo_log::lsn_type lsn;
+    {
+      const std::lock_guard guard{stripe_for(key_bytes)};
+      // Log before removing, so that a failed append leaves the tree intact.
+      // The stripe lock keeps the key from going away in between.
+      if (!Db::key_found(db_.get(search_key))) return false;
+      lsn = log.append(detail::redo_record_type::REMOVE, key_bytes, {});
+      const auto removed UNODB_DETAIL_USED_IN_DEBUG = db_.remove(search_key);
+      UNODB_DETAIL_ASSERT(removed);
+    }
+    log.commit(lsn);
+    return true;
+  }
+
+  /// Write out and sync the log. Only needed if synchronous commits are
+  /// disabled.
+  void sync() { log.sync(); }
+
+  /// Write the current tree contents as a new base image and empty the log,
+  /// bounding the recovery time. Must not be called concurrently with
+  /// insert() and remove().
+  void checkpoint();
+
+  /// Scan the tree, see unodb::db::scan().
+  template <typename FN>
+  void scan(FN fn, bool fwd = true) {
+    db_.scan(fn, fwd);
+  }
+
+  /// Scan the tree from a key, see unodb::db::scan_from().
+  template <typename FN>
+  void scan_from(key_type from_key, FN fn, bool fwd = true) {
+    db_.scan_from(from_key, fn, fwd);
+  }
+
+  /// Scan a key range, see unodb::db::scan_range().
+  template <typename FN>
+  void scan_range(key_type from_key, key_type to_key, FN fn) {
+    db_.scan_range(from_key, to_key, fn);
+  }
+
+  /// Return the wrapped tree, e.g. for its stats. It must not be modified
+  /// directly.
+  [[nodiscard]] const Db& get_db() const noexcept { return db_; }
+
+  /// Return the redo log, e.g. for its stats.
+  [[nodiscard]] const detail::redo_log& get_log() const noexcept {
+    return log;
+  }
+
+  /// Return the base image file name in the tree directory.
+  [[nodiscard]] static constexpr const char* base_image_name() noexcept {
+    return "base.img";
+  }
+
+  /// Return the redo log file name in the tree directory.
+  [[nodiscard]] static constexpr const char* log_name() noexcept {
+    return "redo.log";
+  }
+
+  durable_db(const durable_db&) = delete;
+  durable_db(durable_db&&) = delete;
+  durable_db& operator=(const durable_db&) = delete;
+  durable_db& operator=(durable_db&&) = delete;
+
+ private:
+  /// Number of lock stripes for the writers. A power of two.
+  static constexpr std::size_t stripe_count = 64;
+
+  struct alignas(detail::hardware_destructive_interference_size) padded_mutex {
+    std::mutex mutex;
+  };
+
+  [[nodiscard]] static std::span<const std::byte> as_bytes(
+      const key_type& k) noexcept {
+    if constexpr (std::is_same_v<key_type, key_view>) {
+      return k;
+    } else {
+      return std::as_bytes(std::span{&k, 1});
+    }
+  }
+
+  template <typename V>
+  [[nodiscard]] static value_view as_value_view(const V& v) noexcept {
+    if constexpr (std::is_same_v<V, value_view>) {
+      return v;
+    } else {
+      return value_view{v.begin().get(), v.size()};
+    }
+  }
+
+  [[nodiscard]] std::mutex& stripe_for(
+      std::span<const std::byte> key_bytes) noexcept {
+    // FNV-1a
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (const auto b : key_bytes) {
+      hash ^= static_cast<std::uint8_t>(b);
+      hash *= 1099511628211ULL;
+    }
+    return stripes[hash & (stripe_count - 1)].mutex;
+  }
+
+  [[nodiscard]] static const std::filesystem::path& create_directory(
+      const std::filesystem::path& dir) {
+    std::filesystem::create_directories(dir);
+    return dir;
+  }
+
+  /// Load the base image and replay the log, truncating its invalid tail.
+  ///
+  /// \return The log path.
+  [[nodiscard]] std::filesystem::path recover();
+
+  /// Apply a record read from the base image or the log.
+  void apply(const detail::redo_record& record);
+
+  const std::filesystem::path dir_;
+
+  Db db_;
+
+  detail::redo_log log;
+
+  std::array<padded_mutex, stripe_count> stripes;
+};
+
+template <class Db>
+std::filesystem::path durable_db<Db>::recover() {
+  detail::redo_record record;
+  {
+    detail::redo_log_reader base_image{dir_ / base_image_name()};
+    while (base_image.next(record)) apply(record);
+  }
+
+  const auto log_path = dir_ / log_name();
+  std::uint64_t valid_size;
+  {
+    detail::redo_log_reader log_reader{log_path};
+    while (log_reader.next(record)) apply(record);
+    valid_size = log_reader.get_valid_size();
+  }
+  // Discard any torn tail so that the new records are appended after the last
+  // valid one.
+  if (std::filesystem::exists(log_path) &&
+      std::filesystem::file_size(log_path) != valid_size)
+    std::filesystem::resize_file(log_path, valid_size);
+  return log_path;
+}
+
+template <class Db>
+void durable_db<Db>::apply(const detail::redo_record& record) {
+  key_type k;
+  if constexpr (std::is_same_v<key_type, key_view>) {
+    k = record.key;
+  } else {
+    if (UNODB_DETAIL_UNLIKELY(record.key.size() != sizeof(k))) {
+      throw std::system_error{
+          std::make_error_code(std::errc::illegal_byte_sequence),
+          "unodb::durable_db: key size mismatch in the log"};
+    }
+    std::memcpy(&k, record.key.data(), sizeof(k));
+  }
+
+  if (record.type == detail::redo_record_type::INSERT) {
+    std::ignore = db_.insert(k, record.value);
+  } else {
+    UNODB_DETAIL_ASSERT(record.type == detail::redo_record_type::REMOVE);
+    std::ignore = db_.remove(k);
+  }
+}
+
+template <class Db>
+void durable_db<Db>::checkpoint() {
+  const auto image_path = dir_ / base_image_name();
+  auto temp_path = image_path;
+  temp_path += ".tmp";
+  {
+    detail::redo_log image{temp_path, false};
+    image.reset();
+    db_.scan([&image](const auto& v) {
+      const auto val = as_value_view(v.get_value());
+      if constexpr (std::is_same_v<key_type, key_view>) {
+        image.commit(
+            image.append(detail::redo_record_type::INSERT, v.get_key(), val));
+      } else {
+        key_type k;
+        key_decoder{v.get_key()}.decode(k);
+        image.commit(image.append(detail::redo_record_type::INSERT,
+                                  as_bytes(k), val));
+      }
+      return false;
+    });
+    image.sync();
+  }
+  std::filesystem::rename(temp_path, image_path);
+  detail::sync_directory(dir_);
+  // If a crash happens before the log is reset, the recovery replays the log
+  // over the new base image. That is still correct, as each logged operation
+  // has succeeded, and thus the last one for any key determines its state both
+  // before and after the replay.
+  log.reset();
+}
+
+}  // namespace unodb
+
+#endif  // UNODB_DETAIL_REDO_LOG_HPP
@@ -0,0 +1,1360 @@
+// Copyright 2025 UnoDB contributors
+#ifndef UNODB_DETAIL_ROWEX_ART_HPP
+#define UNODB_DETAIL_ROWEX_ART_HPP
+
+/// \file
+/// The ROWEX (Read-Optimized Write EXclusion) ART variant.
+
+// Should be the first include
+#include "global.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "art_common.hpp"
+#include "art_internal.hpp"
+#include "art_internal_impl.hpp"
+#include "assert.hpp"
+#include "node_type.hpp"
+#include "olc_art.hpp"
+#include "optimistic_lock.hpp"
+#include "portability_arch.hpp"
+#include "qsbr.hpp"
+#include "qsbr_ptr.hpp"
+
+namespace unodb {
+
+template <typename Key, typename Value>
+class rowex_db;
+
+namespace detail {
+
+template <typename Key, typename Value>
+class rowex_inode;
+
+template <typename Key, typename Value>
+class rowex_inode_4;
+
+template <typename Key, typename Value>
+class rowex_inode_16;
+
+template <typename Key, typename Value>
+class rowex_inode_48;
+
+template <typename Key, typename Value>
+class rowex_inode_256;
+
+template <typename Key, typename Value>
+using rowex_inode_defs =
+    basic_inode_def<rowex_inode<Key, Value>, rowex_inode_4<Key, Value>,
+                    rowex_inode_16<Key, Value>, rowex_inode_48<Key, Value>,
+                    rowex_inode_256<Key, Value>>;
+
+template <typename, typename, class>
+class rowex_inode_qsbr_deleter;  // IWYU pragma: keep
+
+struct rowex_impl_helpers;
+
+// ROWEX nodes share the OLC node header: its lock serializes the writers of a
+// node and its obsolete state tells them that the node has been replaced. The
+// readers never touch it.
+template <typename Key, typename Value>
+using rowex_art_policy = basic_art_policy<
+    Key, Value, unodb::rowex_db, unodb::in_critical_section,
+    unodb::optimistic_lock, unodb::optimistic_lock::read_critical_section,
+    olc_node_ptr, rowex_inode_defs, rowex_inode_qsbr_deleter,
+    db_leaf_qsbr_deleter>;
+
+template <typename Key, typename Value>
+using rowex_db_leaf_unique_ptr =
+    typename rowex_art_policy<Key, Value>::db_leaf_unique_ptr;
+
+template <typename Key, typename Value>
+using rowex_inode_base = basic_inode_impl<rowex_art_policy<Key, Value>>;
+
+template <typename Key, typename Value>
+class rowex_inode : public rowex_inode_base<Key, Value> {};
+
+template <typename Key, typename Value>
+using rowex_leaf_type = typename rowex_art_policy<Key, Value>::leaf_type;
+
+/// Make the initialized \a node reachable through \a slot.
+///
+/// The release fence orders the stores that built the node before the store
+/// that publishes it, and pairs with the acquire fence of
+/// load_published_node().
+inline void publish_node(in_critical_section<olc_node_ptr>& slot,
+                         olc_node_ptr node) noexcept {
+  std::atomic_thread_fence(std::memory_order_release);
+  slot = node;
+}
+
+/// Load a node pointer published by publish_node() from \a slot, so that the
+/// node contents may be read without any further synchronization.
+[[nodiscard]] inline olc_node_ptr load_published_node(
+    const in_critical_section<olc_node_ptr>& slot) noexcept {
+  const auto result = slot.load();
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return result;
+}
+
+}  // namespace detail
+
+/// A thread-safe Adaptive Radix Tree synchronized using Read-Optimized Write
+/// EXclusion (ROWEX). The readers take no locks, never restart, and do not
+/// check any node versions. The writers lock the nodes they change and never
+/// change a node in a way that a concurrent reader could observe half-done:
+/// the sorted unodb::detail::basic_inode_4, unodb::detail::basic_inode_16, and
+/// unodb::detail::basic_inode_48 are replaced with updated copies, the key
+/// prefixes are never changed in place, and only
+/// unodb::detail::basic_inode_256 children are added and removed in place, by
+/// single pointer stores. The replaced nodes and the removed leaves are
+/// reclaimed with Quiescent State-Based Reclamation, as in unodb::olc_db, and
+/// the same thread registration rules apply.
+///
+/// Compared to unodb::olc_db, reads are cheaper and do not suffer under write
+/// contention, while the writes to the smaller node types copy a whole node.
+template <typename Key, typename Value>
+class rowex_db final {
+ public:
+  /// The type of the keys in the index.
+  using key_type = Key;
+  /// The type of the value associated with the key in the index.
+  using value_type = Value;
+  using value_view = unodb::qsbr_value_view;
+  using get_result = std::optional<value_view>;
+  using inode_base = detail::rowex_inode_base<Key, Value>;
+  using leaf_type = detail::rowex_leaf_type<Key, Value>;
+  using db_type = rowex_db<Key, Value>;
+
+  static_assert(std::is_same_v<value_type, unodb::value_view>);
+
+ private:
+  using art_key_type = detail::basic_art_key<Key>;
+
+  /// Query for a value associated with an encoded key.
+  [[nodiscard]] get_result get_internal(
+      art_key_type search_key) const noexcept;
+
+  /// Insert a value under an encoded key iff there is no entry for
+  /// that key.
+  ///
+  /// \return true iff the key value pair was inserted.
+  [[nodiscard]] bool insert_internal(art_key_type insert_key, value_type v);
+
+  /// Remove the entry associated with the encoded key.
+  ///
+  /// \return true if the delete was successful.
+  [[nodiscard]] bool remove_internal(art_key_type remove_key);
+
+ public:
+  // Creation and destruction
+
+  /// Create an empty tree, reclaiming its memory in the default QSBR domain.
+  rowex_db() noexcept : rowex_db{qsbr::instance()} {}
+
+  /// Create an empty tree, reclaiming its memory in the QSBR \a domain, which
+  /// must outlive it. The threads accessing the tree must be registered with
+  /// the domain and pass through its quiescent states.
+  explicit rowex_db(qsbr& domain UNODB_DETAIL_LIFETIMEBOUND) noexcept
+      : qsbr_domain{domain} {}
+
+  ~rowex_db() noexcept;
+
+  /// Get the QSBR domain reclaiming the memory of this tree.
+  [[nodiscard]] qsbr& get_qsbr_domain() const noexcept { return qsbr_domain; }
+
+  /// Query for a value associated with a key.
+  ///
+  /// \param search_key If Key is a simple primitive type, then it is converted
+  /// into a binary comparable key.  If Key is unodb::key_view, then it is
+  /// assumed to already be a binary comparable key, e.g., as produced by
+  /// unodb::key_encoder.
+  [[nodiscard]] get_result get(Key search_key) const noexcept {
+    const auto k = art_key_type{search_key};
+    return get_internal(k);
+  }
+
+  /// Return true iff the tree is empty (no root leaf).
+  [[nodiscard]] auto empty() const noexcept { return root == nullptr; }
+
+  /// Insert a value under a binary comparable key iff there is no entry for
+  /// that key.
+  ///
+  /// \note Cannot be called during stack unwinding with
+  /// `std::uncaught_exceptions() > 0`.
+  ///
+  /// \return true iff the key value pair was inserted.
+  [[nodiscard]] bool insert(Key insert_key, value_type v) {
+    const auto k = art_key_type{insert_key};
+    return insert_internal(k, v);
+  }
+
+  /// Remove the entry associated with the key.
+  ///
+  /// \return true if the delete was successful (i.e. the key was found in the
+  /// tree and the associated index entry was removed).
+  [[nodiscard]] bool remove(Key search_key) {
+    const auto k = art_key_type{search_key};
+    return remove_internal(k);
+  }
+
+  /// Removes all entries in the index.
+  ///
+  /// \note Only legal in single-threaded context, as destructor
+  void clear() noexcept;
+
+  //
+  // iterator (the iterator is an internal API, the public API is scan()).
+  //
+
+  /// The position of a scan, which is the leaf it visits. The ROWEX readers
+  /// see every node they reach as a consistent snapshot, thus the scan is a
+  /// plain traversal, and this iterator cannot be moved on its own.
+  class iterator {
+    friend class rowex_db<Key, Value>;
+
+   public:
+    using key_type = Key;
+    using value_type = Value;
+
+    iterator(const iterator&) = delete;
+    iterator(iterator&&) = delete;
+    iterator& operator=(const iterator&) = delete;
+    iterator& operator=(iterator&&) = delete;
+
+    /// Return the key_view associated with the current position of the
+    /// iterator.
+    ///
+    /// \pre The iterator MUST be valid().
+    [[nodiscard]] key_view get_key() const noexcept {
+      UNODB_DETAIL_ASSERT(valid());
+      return leaf->get_key_view();
+    }
+
+    /// Return the value_view associated with the current position of the
+    /// iterator.
+    ///
+    /// \pre The iterator MUST be valid().
+    [[nodiscard]] qsbr_value_view get_val() const noexcept {
+      UNODB_DETAIL_ASSERT(valid());
+      return qsbr_ptr_span<const std::byte>{leaf->get_value_view()};
+    }
+
+    /// Return true if the iterator is positioned on a leaf.
+    [[nodiscard]] bool valid() const noexcept { return leaf != nullptr; }
+
+   private:
+    iterator() noexcept = default;
+
+    /// The current leaf, if any.
+    const leaf_type* leaf{nullptr};
+  };  // class iterator
+
+  //
+  // end of the iterator API, which is an internal API.
+  //
+
+  /// Scan the tree forward, applying the caller's lambda to each visited
+  /// leaf. The scan takes no locks and never restarts. It visits the entries
+  /// in the key order, including every entry present for its whole duration,
+  /// and may or may not visit the entries inserted or removed concurrently.
+  /// The calling thread must not pass through a quiescent state during the
+  /// scan.
+  ///
+  /// \param fn A function `f(unodb::visitor<unodb::rowex_db::iterator>&)`
+  /// returning `bool`.  The traversal will halt if the function returns \c
+  /// true.
+  template <typename FN>
+  void scan(FN fn) const {
+    const auto root_node{detail::load_published_node(root)};
+    if (root_node == nullptr) return;
+    iterator it;
+    const visitor_type v{it};
+    scan_subtree(root_node, it, v, fn);
+  }
+
+  // Stats
+
+#ifdef UNODB_DETAIL_WITH_STATS
+
+  // Return current memory use by tree nodes in bytes
+  [[nodiscard]] std::size_t get_current_memory_use() const noexcept {
+    return current_memory_use.load(std::memory_order_relaxed);
+  }
+
+  template <node_type NodeType>
+  [[nodiscard]] std::uint64_t get_node_count() const noexcept {
+    return node_counts[as_i<NodeType>].load(std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] node_type_counter_array get_node_counts() const noexcept {
+    return detail::copy_atomic_to_nonatomic(node_counts);
+  }
+
+  template <node_type NodeType>
+  [[nodiscard]] std::uint64_t get_growing_inode_count() const noexcept {
+    return growing_inode_counts[internal_as_i<NodeType>].load(
+        std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] inode_type_counter_array get_growing_inode_counts()
+      const noexcept {
+    return detail::copy_atomic_to_nonatomic(growing_inode_counts);
+  }
+
+  template <node_type NodeType>
+  [[nodiscard]] std::uint64_t get_shrinking_inode_count() const noexcept {
+    return shrinking_inode_counts[internal_as_i<NodeType>].load(
+        std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] inode_type_counter_array get_shrinking_inode_counts()
+      const noexcept {
+    return detail::copy_atomic_to_nonatomic(shrinking_inode_counts);
+  }
+
+  [[nodiscard]] std::uint64_t get_key_prefix_splits() const noexcept {
+    return key_prefix_splits.load(std::memory_order_relaxed);
+  }
+
+  /// Return the number of inodes copied to apply a change to them.
+  [[nodiscard]] std::uint64_t get_inode_copies() const noexcept {
+    return inode_copies.load(std::memory_order_relaxed);
+  }
+
+#endif  // UNODB_DETAIL_WITH_STATS
+
+  // Public utils
+  [[nodiscard]] static constexpr bool key_found(
+      const get_result& result) noexcept {
+    return static_cast<bool>(result);
+  }
+
+  // Debugging
+  [[gnu::cold]] UNODB_DETAIL_NOINLINE void dump(std::ostream& os) const;
+  [[gnu::cold]] UNODB_DETAIL_NOINLINE void dump() const;
+
+  rowex_db(const rowex_db&) noexcept = delete;
+  rowex_db(rowex_db&&) noexcept = delete;
+  rowex_db& operator=(const rowex_db&) noexcept = delete;
+  rowex_db& operator=(rowex_db&&) noexcept = delete;
+
+ private:
+  using art_policy = detail::rowex_art_policy<Key, Value>;
+  using header_type = typename art_policy::header_type;
+  using inode_type = detail::rowex_inode<Key, Value>;
+  using inode_4 = detail::rowex_inode_4<Key, Value>;
+  using tree_depth_type = detail::tree_depth<art_key_type>;
+  using rowex_db_leaf_unique_ptr_type =
+      detail::rowex_db_leaf_unique_ptr<Key, Value>;
+  using visitor_type = visitor<iterator>;
+
+  // If not present, the attempt found a node replaced under it and must be
+  // retried.
+  using try_update_result_type = std::optional<bool>;
+
+  [[nodiscard]] try_update_result_type try_insert(
+      art_key_type k, value_type v, rowex_db_leaf_unique_ptr_type& cached_leaf);
+
+  [[nodiscard]] try_update_result_type try_remove(art_key_type k);
+
+  void delete_root_subtree() noexcept;
+
+  /// Apply \a fn through \a v to the leaves under \a node in the key order,
+  /// positioning \a it on each of them.
+  ///
+  /// \return true if \a fn halted the scan.
+  template <typename FN>
+  static bool scan_subtree(detail::olc_node_ptr node, iterator& it,
+                           const visitor_type& v, FN& fn);
+
+#ifdef UNODB_DETAIL_WITH_STATS
+  void increase_memory_use(std::size_t delta) noexcept;
+  void decrease_memory_use(std::size_t delta) noexcept;
+
+  void increment_leaf_count(std::size_t leaf_size) noexcept {
+    increase_memory_use(leaf_size);
+    node_counts[as_i<node_type::LEAF>].fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void decrement_leaf_count(std::size_t leaf_size) noexcept {
+    decrease_memory_use(leaf_size);
+
+    const auto old_leaf_count UNODB_DETAIL_USED_IN_DEBUG =
+        node_counts[as_i<node_type::LEAF>].fetch_sub(1,
+                                                     std::memory_order_relaxed);
+    UNODB_DETAIL_ASSERT(old_leaf_count > 0);
+  }
+
+  template <class INode>
+  constexpr void increment_inode_count() noexcept;
+
+  template <class INode>
+  constexpr void decrement_inode_count() noexcept;
+
+  template <node_type NodeType>
+  constexpr void account_growing_inode() noexcept;
+
+  template <node_type NodeType>
+  constexpr void account_shrinking_inode() noexcept;
+
+  void account_inode_copy() noexcept {
+    inode_copies.fetch_add(1, std::memory_order_relaxed);
+  }
+
+#endif  // UNODB_DETAIL_WITH_STATS
+
+  // The lock serializing the writers of the [root].
+  alignas(
+      detail::hardware_destructive_interference_size) mutable optimistic_lock
+      root_pointer_lock;
+
+  // The root of the tree, written under the [root_pointer_lock].
+  in_critical_section<detail::olc_node_ptr> root{detail::olc_node_ptr{nullptr}};
+
+  static_assert(sizeof(root_pointer_lock) + sizeof(root) <=
+                detail::hardware_constructive_interference_size);
+
+  /// The QSBR domain reclaiming the memory of this tree.
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-const-or-ref-data-members)
+  qsbr& qsbr_domain;
+
+#ifdef UNODB_DETAIL_WITH_STATS
+
+  // Current logically allocated memory that is not scheduled to be reclaimed.
+  alignas(detail::hardware_destructive_interference_size)
+      std::atomic<std::size_t> current_memory_use{0};
+
+  alignas(detail::hardware_destructive_interference_size)
+      std::atomic<std::uint64_t> key_prefix_splits{0};
+
+  alignas(detail::hardware_destructive_interference_size)
+      std::atomic<std::uint64_t> inode_copies{0};
+
+  template <class T>
+  using atomic_array = std::array<std::atomic<typename T::value_type>,
+                                  std::tuple_size<T>::value>;
+
+  alignas(detail::hardware_destructive_interference_size)
+      atomic_array<node_type_counter_array> node_counts{};
+  alignas(detail::hardware_destructive_interference_size)
+      atomic_array<inode_type_counter_array> growing_inode_counts{};
+  alignas(detail::hardware_destructive_interference_size)
+      atomic_array<inode_type_counter_array> shrinking_inode_counts{};
+
+#endif  // UNODB_DETAIL_WITH_STATS
+
+  friend auto detail::make_db_leaf_ptr<Key, Value, rowex_db>(art_key_type,
+                                                             unodb::value_view,
+                                                             rowex_db&);
+
+  template <class>
+  friend class detail::basic_db_leaf_deleter;
+
+  template <class>
+  friend class detail::db_leaf_qsbr_deleter;
+
+  template <typename, typename, class>
+  friend class detail::rowex_inode_qsbr_deleter;
+
+  template <typename,                             // Key
+            typename,                             // Value
+            template <typename, typename> class,  // Db
+            template <class> class,               // CriticalSectionPolicy
+            class,                                // LockPolicy
+            class,                                // ReadCriticalSection
+            class,                                // NodePtr
+            template <typename, typename> class,  // INodeDefs
+            template <typename, typename, class> class,  // INodeReclamator
+            template <class> class>                      // LeafReclamator
+  friend struct detail::basic_art_policy;
+
+  template <class, class>
+  friend class detail::basic_db_inode_deleter;
+
+  friend struct detail::rowex_impl_helpers;
+};
+
+namespace detail {
+
+template <typename Key, typename Value, class INode>
+using rowex_inode_qsbr_deleter_parent =
+    unodb::detail::basic_db_inode_deleter<INode, unodb::rowex_db<Key, Value>>;
+
+template <typename Key, typename Value, class INode>
+class rowex_inode_qsbr_deleter
+    : public rowex_inode_qsbr_deleter_parent<Key, Value, INode> {
+ public:
+  using rowex_inode_qsbr_deleter_parent<Key, Value,
+                                        INode>::rowex_inode_qsbr_deleter_parent;
+
+  void operator()(INode* inode_ptr) {
+    static_assert(std::is_trivially_destructible_v<INode>);
+
+    this->get_db().get_qsbr_domain().current_thread().on_next_epoch_deallocate(
+        inode_ptr
+#ifdef UNODB_DETAIL_WITH_STATS
+        ,
+        sizeof(INode)
+#endif
+#ifndef NDEBUG
+            ,
+        olc_node_header::check_on_dealloc
+#endif
+    );
+
+#ifdef UNODB_DETAIL_WITH_STATS
+    this->get_db().template decrement_inode_count<INode>();
+#endif  // UNODB_DETAIL_WITH_STATS
+  }
+};
+
+// Wrap the ROWEX update algorithms in a struct so that it could be declared as
+// friend of rowex_db.
+struct rowex_impl_helpers {
+  /// Add a leaf for \a k under \a key_byte of \a inode if it has no such child
+  /// yet, replacing \a inode in \a node_in_parent if needed.
+  ///
+  /// \return the child slot under \a key_byte if it exists, nullptr if the
+  /// leaf was added, and nothing if \a inode was found replaced and the insert
+  /// must be retried.
+  template <typename Key, typename Value, class INode>
+  [[nodiscard]] static std::optional<in_critical_section<olc_node_ptr>*>
+  add_or_choose_subtree(INode& inode, std::byte key_byte, basic_art_key<Key> k,
+                        value_view v, rowex_db<Key, Value>& db_instance,
+                        tree_depth<basic_art_key<Key>> depth,
+                        optimistic_lock& parent_lock,
+                        in_critical_section<olc_node_ptr>* node_in_parent,
+                        rowex_db_leaf_unique_ptr<Key, Value>& cached_leaf);
+
+  /// Remove the leaf for \a k under \a key_byte of \a inode, if any, replacing
+  /// \a inode in \a node_in_parent if needed.
+  ///
+  /// \return true and the child slot in \a child_in_parent if the child is an
+  /// inode, true and nullptr if the leaf was removed, false if \a k is not
+  /// present, and nothing if a node was found replaced and the remove must be
+  /// retried.
+  template <typename Key, typename Value, class INode>
+  [[nodiscard]] static std::optional<bool> remove_or_choose_subtree(
+      INode& inode, std::byte key_byte, basic_art_key<Key> k,
+      rowex_db<Key, Value>& db_instance, optimistic_lock& parent_lock,
+      in_critical_section<olc_node_ptr>* node_in_parent,
+      in_critical_section<olc_node_ptr>** child_in_parent);
+
+  /// Return an exact copy of \a inode, which must be write-locked.
+  template <typename Key, typename Value, class INode>
+  [[nodiscard]] static auto copy(INode& inode,
+                                 rowex_db<Key, Value>& db_instance);
+
+  /// Return an exact copy of the write-locked \a node, whichever its type is.
+  template <typename Key, typename Value>
+  [[nodiscard]] static olc_node_ptr copy_node(
+      olc_node_ptr node, rowex_db<Key, Value>& db_instance);
+
+  /// Schedule the replaced \a node, whichever its type is, for reclamation.
+  template <typename Key, typename Value>
+  static void retire_node(olc_node_ptr node,
+                          rowex_db<Key, Value>& db_instance) noexcept;
+
+ private:
+  /// Call \a fn with the typed pointer to the inode \a node.
+  template <typename Key, typename Value, typename FN>
+  static auto visit_inode(olc_node_ptr node, FN fn);
+
+ public:
+  rowex_impl_helpers() = delete;
+};
+
+//
+// ROWEX inode classes extend the basic inode classes and wrap them with
+// additional policy stuff.
+//
+
+template <typename Key, typename Value>
+using rowex_inode_4_parent = basic_inode_4<rowex_art_policy<Key, Value>>;
+
+template <typename Key, typename Value>
+class [[nodiscard]] rowex_inode_4 final
+    : public rowex_inode_4_parent<Key, Value> {
+  using parent_class = rowex_inode_4_parent<Key, Value>;
+
+ public:
+  using parent_class::parent_class;
+
+  template <typename... Args>
+  [[nodiscard]] auto add_or_choose_subtree(Args&&... args) {
+    return rowex_impl_helpers::add_or_choose_subtree(
+        *this, std::forward<Args>(args)...);
+  }
+
+  template <typename... Args>
+  [[nodiscard]] auto remove_or_choose_subtree(Args&&... args) {
+    return rowex_impl_helpers::remove_or_choose_subtree(
+        *this, std::forward<Args>(args)...);
+  }
+
+  [[gnu::cold]] UNODB_DETAIL_NOINLINE void dump(std::ostream& os,
+                                                bool recursive) const {
+    os << ", ";
+    lock(*this).dump(os);
+    parent_class::dump(os, recursive);
+  }
+};
+
+template <typename Key, typename Value>
+using rowex_inode_16_parent = basic_inode_16<rowex_art_policy<Key, Value>>;
+
+template <typename Key, typename Value>
+class [[nodiscard]] rowex_inode_16 final
+    : public rowex_inode_16_parent<Key, Value> {
+  using parent_class = rowex_inode_16_parent<Key, Value>;
+
+ public:
+  using typename parent_class::find_result;
+
+  using parent_class::parent_class;
+
+  template <typename... Args>
+  [[nodiscard]] auto add_or_choose_subtree(Args&&... args) {
+    return rowex_impl_helpers::add_or_choose_subtree(
+        *this, std::forward<Args>(args)...);
+  }
+
+  template <typename... Args>
+  [[nodiscard]] auto remove_or_choose_subtree(Args&&... args) {
+    return rowex_impl_helpers::remove_or_choose_subtree(
+        *this, std::forward<Args>(args)...);
+  }
+
+  [[nodiscard]] find_result find_child(std::byte key_byte) noexcept {
+#ifdef UNODB_DETAIL_THREAD_SANITIZER
+    const auto children_count_ = this->get_children_count();
+    for (unsigned i = 0; i < children_count_; ++i)
+      if (parent_class::keys.byte_array[i] == key_byte)
+        return std::make_pair(i, &parent_class::children[i]);
+    return parent_class::child_not_found;
+#else
+    return parent_class::find_child(key_byte);
+#endif
+  }
+
+  [[gnu::cold]] UNODB_DETAIL_NOINLINE void dump(std::ostream& os,
+                                                bool recursive) const {
+    os << ", ";
+    lock(*this).dump(os);
+    parent_class::dump(os, recursive);
+  }
+};
+
+template <typename Key, typename Value>
+using rowex_inode_48_parent = basic_inode_48<rowex_art_policy<Key, Value>>;
+
+template <typename Key, typename Value>
+class [[nodiscard]] rowex_inode_48 final
+    : public rowex_inode_48_parent<Key, Value> {
+  using parent_class = rowex_inode_48_parent<Key, Value>;
+
+ public:
+  using parent_class::parent_class;
+
+  template <typename... Args>
+  [[nodiscard]] auto add_or_choose_subtree(Args&&... args) {
+    return rowex_impl_helpers::add_or_choose_subtree(
+        *this, std::forward<Args>(args)...);
+  }
+
+  template <typename... Args>
+  [[nodiscard]] auto remove_or_choose_subtree(Args&&... args) {
+    return rowex_impl_helpers::remove_or_choose_subtree(
+        *this, std::forward<Args>(args)...);
+  }
+
+  [[gnu::cold]] UNODB_DETAIL_NOINLINE void dump(std::ostream& os,
+                                                bool recursive) const {
+    os << ", ";
+    lock(*this).dump(os);
+    parent_class::dump(os, recursive);
+  }
+};
+
+template <typename Key, typename Value>
+using rowex_inode_256_parent = basic_inode_256<rowex_art_policy<Key, Value>>;
+
+template <typename Key, typename Value>
+class [[nodiscard]] rowex_inode_256 final
+    : public rowex_inode_256_parent<Key, Value> {
+  using parent_class = rowex_inode_256_parent<Key, Value>;
+
+ public:
+  using parent_class::parent_class;
+
+  template <typename... Args>
+  [[nodiscard]] auto add_or_choose_subtree(Args&&... args) {
+    return rowex_impl_helpers::add_or_choose_subtree(
+        *this, std::forward<Args>(args)...);
+  }
+
+  template <typename... Args>
+  [[nodiscard]] auto remove_or_choose_subtree(Args&&... args) {
+    return rowex_impl_helpers::remove_or_choose_subtree(
+        *this, std::forward<Args>(args)...);
+  }
+
+  [[gnu::cold]] UNODB_DETAIL_NOINLINE void dump(std::ostream& os,
+                                                bool recursive) const {
+    os << ", ";
+    lock(*this).dump(os);
+    parent_class::dump(os, recursive);
+  }
+};
+
+template <typename Key, typename Value>
+void create_leaf_if_needed(rowex_db_leaf_unique_ptr<Key, Value>& cached_leaf,
+                           basic_art_key<Key> k, unodb::value_view v,
+                           unodb::rowex_db<Key, Value>& db_instance) {
+  if (UNODB_DETAIL_LIKELY(cached_leaf == nullptr)) {
+    UNODB_DETAIL_ASSERT(&cached_leaf.get_deleter().get_db() == &db_instance);
+    // Do not assign because we do not need to assign the deleter
+    // NOLINTNEXTLINE(misc-uniqueptr-reset-release)
+    cached_leaf.reset(
+        rowex_art_policy<Key, Value>::make_db_leaf_ptr(k, v, db_instance)
+            .release());
+  }
+}
+
+template <typename Key, typename Value, class INode>
+auto rowex_impl_helpers::copy(INode& inode, rowex_db<Key, Value>& db_instance) {
+  UNODB_DETAIL_ASSERT(lock(inode).is_write_locked());
+
+#ifdef UNODB_DETAIL_WITH_STATS
+  db_instance.account_inode_copy();
+#endif  // UNODB_DETAIL_WITH_STATS
+
+  return INode::create(db_instance, inode, node_clone_tag{});
+}
+
+template <typename Key, typename Value, typename FN>
+auto rowex_impl_helpers::visit_inode(olc_node_ptr node, FN fn) {
+  switch (node.type()) {
+    case node_type::I4:
+      return fn(node.ptr<rowex_inode_4<Key, Value>*>());
+    case node_type::I16:
+      return fn(node.ptr<rowex_inode_16<Key, Value>*>());
+    case node_type::I48:
+      return fn(node.ptr<rowex_inode_48<Key, Value>*>());
+    case node_type::I256:
+      return fn(node.ptr<rowex_inode_256<Key, Value>*>());
+      // LCOV_EXCL_START
+    case node_type::LEAF:
+      UNODB_DETAIL_CANNOT_HAPPEN();
+  }
+  UNODB_DETAIL_CANNOT_HAPPEN();
+  // LCOV_EXCL_STOP
+}
+
+template <typename Key, typename Value>
+olc_node_ptr rowex_impl_helpers::copy_node(olc_node_ptr node,
+                                           rowex_db<Key, Value>& db_instance) {
+  return visit_inode<Key, Value>(node, [&db_instance](auto* inode) {
+    using inode_type = std::remove_pointer_t<decltype(inode)>;
+    return olc_node_ptr{copy(*inode, db_instance).release(), inode_type::type};
+  });
+}
+
+template <typename Key, typename Value>
+void rowex_impl_helpers::retire_node(
+    olc_node_ptr node, rowex_db<Key, Value>& db_instance) noexcept {
+  visit_inode<Key, Value>(node, [&db_instance](auto* inode) noexcept {
+    const auto r{rowex_art_policy<Key, Value>::make_db_inode_reclaimable_ptr(
+        inode, db_instance)};
+  });
+}
+
+UNODB_DETAIL_DISABLE_MSVC_WARNING(26460)
+template <typename Key, typename Value, class INode>
+std::optional<in_critical_section<olc_node_ptr>*>
+rowex_impl_helpers::add_or_choose_subtree(
+    INode& inode, std::byte key_byte, basic_art_key<Key> k, value_view v,
+    rowex_db<Key, Value>& db_instance, tree_depth<basic_art_key<Key>> depth,
+    optimistic_lock& parent_lock,
+    in_critical_section<olc_node_ptr>* node_in_parent,
+    rowex_db_leaf_unique_ptr<Key, Value>& cached_leaf) {
+  auto* const child_in_parent = inode.find_child(key_byte).second;
+  if (child_in_parent != nullptr) return child_in_parent;
+
+  create_leaf_if_needed(cached_leaf, k, v, db_instance);
+
+  std::optional<optimistic_lock::write_guard> node_guard;
+
+  if constexpr (std::is_same_v<INode, rowex_inode_256<Key, Value>>) {
+    // A single pointer store, the readers either see the new child or not.
+    if (UNODB_DETAIL_UNLIKELY(!olc_write_lock_wait(lock(inode), node_guard)))
+      return {};
+    if (UNODB_DETAIL_UNLIKELY(inode.find_child(key_byte).second != nullptr))
+      return {};
+
+    std::atomic_thread_fence(std::memory_order_release);
+    inode.add_to_nonfull(std::move(cached_leaf), depth,
+                         static_cast<std::uint8_t>(inode.get_children_count()));
+    return nullptr;
+  } else {
+    std::optional<optimistic_lock::write_guard> parent_guard;
+    if (UNODB_DETAIL_UNLIKELY(!olc_write_lock_wait(parent_lock, parent_guard)))
+      return {};
+    if (UNODB_DETAIL_UNLIKELY(!olc_write_lock_wait(lock(inode), node_guard)))
+      return {};
+    if (UNODB_DETAIL_UNLIKELY(node_in_parent->load().template ptr<INode*>() !=
+                              &inode))
+      return {};  // LCOV_EXCL_LINE
+
+    const auto children_count = inode.get_children_count();
+
+    if (UNODB_DETAIL_UNLIKELY(children_count == INode::capacity)) {
+      // The larger node retires the source node by itself, which may free it
+      // immediately in the single-threaded QSBR mode. Its writers are locked
+      // out already, and the readers may keep reading it until the larger node
+      // is published.
+      node_guard->unlock_and_obsolete();
+      auto larger_node{INode::larger_derived_type::create(
+          db_instance, inode, std::move(cached_leaf), depth)};
+      publish_node(*node_in_parent,
+                   olc_node_ptr{larger_node.release(),
+                                INode::larger_derived_type::type});
+
+#ifdef UNODB_DETAIL_WITH_STATS
+      db_instance
+          .template account_growing_inode<INode::larger_derived_type::type>();
+#endif  // UNODB_DETAIL_WITH_STATS
+
+      return nullptr;
+    }
+
+    const auto reclaim_node{
+        rowex_art_policy<Key, Value>::make_db_inode_reclaimable_ptr(
+            &inode, db_instance)};
+    auto new_node{copy(inode, db_instance)};
+    new_node->add_to_nonfull(std::move(cached_leaf), depth,
+                             static_cast<std::uint8_t>(children_count));
+    publish_node(*node_in_parent,
+                 olc_node_ptr{new_node.release(), INode::type});
+    node_guard->unlock_and_obsolete();
+    return nullptr;
+  }
+}
+
+template <typename Key, typename Value, class INode>
+std::optional<bool> rowex_impl_helpers::remove_or_choose_subtree(
+    INode& inode, std::byte key_byte, basic_art_key<Key> k,
+    rowex_db<Key, Value>& db_instance, optimistic_lock& parent_lock,
+    in_critical_section<olc_node_ptr>* node_in_parent,
+    in_critical_section<olc_node_ptr>** child_in_parent) {
+  const auto [child_i, found_child]{inode.find_child(key_byte)};
+  if (found_child == nullptr) return false;
+
+  const auto child = load_published_node(*found_child);
+  // A concurrent in-place removal from an I256 may have cleared the slot
+  if (UNODB_DETAIL_UNLIKELY(child == nullptr)) return false;
+
+  if (child.type() != node_type::LEAF) {
+    *child_in_parent = found_child;
+    return true;
+  }
+
+  const auto* const leaf{child.template ptr<rowex_leaf_type<Key, Value>*>()};
+  if (!leaf->matches(k)) return false;
+
+  *child_in_parent = nullptr;
+  std::optional<optimistic_lock::write_guard> node_guard;
+
+  if constexpr (std::is_same_v<INode, rowex_inode_256<Key, Value>>) {
+    if (!inode.is_min_size()) {
+      // A single pointer store, the readers either see the child or not.
+      if (UNODB_DETAIL_UNLIKELY(!olc_write_lock_wait(lock(inode), node_guard)))
+        return {};
+      if (UNODB_DETAIL_UNLIKELY(found_child->load() != child)) return {};
+      if (UNODB_DETAIL_UNLIKELY(inode.is_min_size())) return {};
+
+      inode.remove(child_i, db_instance);
+      return true;
+    }
+  }
+
+  std::optional<optimistic_lock::write_guard> parent_guard;
+  if (UNODB_DETAIL_UNLIKELY(!olc_write_lock_wait(parent_lock, parent_guard)))
+    return {};
+  if (UNODB_DETAIL_UNLIKELY(!olc_write_lock_wait(lock(inode), node_guard)))
+    return {};
+  if (UNODB_DETAIL_UNLIKELY(
+          node_in_parent->load().template ptr<INode*>() != &inode ||
+          found_child->load() != child))
+    return {};  // LCOV_EXCL_LINE
+
+  if (UNODB_DETAIL_LIKELY(!inode.is_min_size())) {
+    const auto reclaim_node{
+        rowex_art_policy<Key, Value>::make_db_inode_reclaimable_ptr(
+            &inode, db_instance)};
+    auto new_node{copy(inode, db_instance)};
+    new_node->remove(child_i, db_instance);
+    publish_node(*node_in_parent,
+                 olc_node_ptr{new_node.release(), INode::type});
+    node_guard->unlock_and_obsolete();
+    return true;
+  }
+
+  if constexpr (std::is_same_v<INode, rowex_inode_4<Key, Value>>) {
+    // The remaining child replaces this node. Its key prefix must absorb the
+    // prefix of this node, but the readers already in it must keep seeing
+    // the old one, thus copy it.
+    const auto reclaim_node{
+        rowex_art_policy<Key, Value>::make_db_inode_reclaimable_ptr(
+            &inode, db_instance)};
+    const auto reclaim_leaf{
+        rowex_art_policy<Key, Value>::reclaim_leaf_on_scope_exit(
+            child.template ptr<rowex_leaf_type<Key, Value>*>(), db_instance)};
+    const auto remaining{child_i == 0 ? inode.last() : inode.begin()};
+    const auto remaining_child = inode.get_child(remaining.child_index);
+
+    if (remaining_child.type() == node_type::LEAF) {
+      publish_node(*node_in_parent, remaining_child);
+    } else {
+      // Only the writers holding the lock of this node replace its children,
+      // thus the remaining child cannot be obsolete.
+      std::optional<optimistic_lock::write_guard> remaining_guard;
+      const auto remaining_locked UNODB_DETAIL_USED_IN_DEBUG =
+          olc_write_lock_wait(node_ptr_lock(remaining_child), remaining_guard);
+      UNODB_DETAIL_ASSERT(remaining_locked);
+      const auto remaining_copy{copy_node(remaining_child, db_instance)};
+      remaining_copy.template ptr<rowex_inode<Key, Value>*>()
+          ->get_key_prefix()
+          .prepend(inode.get_key_prefix(), remaining.key_byte);
+      publish_node(*node_in_parent, remaining_copy);
+      remaining_guard->unlock_and_obsolete();
+      retire_node(remaining_child, db_instance);
+    }
+    node_guard->unlock_and_obsolete();
+  } else {
+    // The smaller node retires the source node and the leaf by itself
+    node_guard->unlock_and_obsolete();
+    auto smaller_node{
+        INode::smaller_derived_type::create(db_instance, inode, child_i)};
+    publish_node(*node_in_parent,
+                 olc_node_ptr{smaller_node.release(),
+                              INode::smaller_derived_type::type});
+  }
+
+#ifdef UNODB_DETAIL_WITH_STATS
+  db_instance.template account_shrinking_inode<INode::type>();
+#endif  // UNODB_DETAIL_WITH_STATS
+
+  return true;
+}
+UNODB_DETAIL_RESTORE_MSVC_WARNINGS()
+
+}  // namespace detail
+
+//
+// rowex_db implementation
+//
+
+template <typename Key, typename Value>
+rowex_db<Key, Value>::~rowex_db() noexcept {
+  UNODB_DETAIL_ASSERT(
+      qsbr_state::single_thread_mode(qsbr_domain.get_state()));
+
+  delete_root_subtree();
+}
+
+template <typename Key, typename Value>
+void rowex_db<Key, Value>::delete_root_subtree() noexcept {
+  UNODB_DETAIL_ASSERT(
+      qsbr_state::single_thread_mode(qsbr_domain.get_state()));
+
+  if (root != nullptr) art_policy::delete_subtree(root, *this);
+
+#ifdef UNODB_DETAIL_WITH_STATS
+  UNODB_DETAIL_ASSERT(
+      node_counts[as_i<node_type::LEAF>].load(std::memory_order_relaxed) == 0);
+#endif  // UNODB_DETAIL_WITH_STATS
+}
+
+template <typename Key, typename Value>
+void rowex_db<Key, Value>::clear() noexcept {
+  UNODB_DETAIL_ASSERT(
+      qsbr_state::single_thread_mode(qsbr_domain.get_state()));
+
+  delete_root_subtree();
+
+  root = detail::olc_node_ptr{nullptr};
+
+#ifdef UNODB_DETAIL_WITH_STATS
+  current_memory_use.store(0, std::memory_order_relaxed);
+
+  node_counts[as_i<node_type::I4>].store(0, std::memory_order_relaxed);
+  node_counts[as_i<node_type::I16>].store(0, std::memory_order_relaxed);
+  node_counts[as_i<node_type::I48>].store(0, std::memory_order_relaxed);
+  node_counts[as_i<node_type::I256>].store(0, std::memory_order_relaxed);
+#endif  // UNODB_DETAIL_WITH_STATS
+}
+
+template <typename Key, typename Value>
+typename rowex_db<Key, Value>::get_result rowex_db<Key, Value>::get_internal(
+    art_key_type k) const noexcept {
+  auto node{detail::load_published_node(root)};
+  auto remaining_key{k};
+
+  while (node != nullptr) {
+    const auto node_type = node.type();
+
+    if (node_type == node_type::LEAF) {
+      const auto* const leaf{node.template ptr<leaf_type*>()};
+      if (leaf->matches(k))
+        return qsbr_ptr_span<const std::byte>{leaf->get_value_view()};
+      return {};
+    }
+
+    auto* const inode{node.template ptr<inode_type*>()};
+    const auto& key_prefix{inode->get_key_prefix()};
+    const auto key_prefix_length{key_prefix.length()};
+    if (key_prefix.get_shared_length(remaining_key) < key_prefix_length)
+      return {};
+
+    remaining_key.shift_right(key_prefix_length);
+
+    const auto* const child_in_parent{
+        inode->find_child(node_type, remaining_key[0]).second};
+    if (child_in_parent == nullptr) return {};
+
+    node = detail::load_published_node(*child_in_parent);
+    remaining_key.shift_right(1);
+  }
+
+  return {};
+}
+
+template <typename Key, typename Value>
+template <typename FN>
+bool rowex_db<Key, Value>::scan_subtree(detail::olc_node_ptr node,
+                                        iterator& it, const visitor_type& v,
+                                        FN& fn) {
+  const auto node_type = node.type();
+
+  if (node_type == node_type::LEAF) {
+    it.leaf = node.template ptr<leaf_type*>();
+    return UNODB_DETAIL_UNLIKELY(fn(v));
+  }
+
+  auto* const inode{node.template ptr<inode_type*>()};
+  for (typename inode_type::iter_result_opt child_pos{inode->begin(node_type)};
+       child_pos; child_pos = inode->next(node_type, child_pos->child_index)) {
+    const auto* const child_in_parent{
+        inode->find_child(node_type, child_pos->key_byte).second};
+    // A concurrent in-place removal from an I256 may have cleared the slot
+    if (UNODB_DETAIL_UNLIKELY(child_in_parent == nullptr)) continue;
+    const auto child{detail::load_published_node(*child_in_parent)};
+    if (UNODB_DETAIL_UNLIKELY(child == nullptr)) continue;
+    if (scan_subtree(child, it, v, fn)) return true;
+  }
+  return false;
+}
+
+template <typename Key, typename Value>
+bool rowex_db<Key, Value>::insert_internal(art_key_type insert_key,
+                                           value_type v) {
+  try_update_result_type result;
+  rowex_db_leaf_unique_ptr_type cached_leaf{
+      nullptr, detail::basic_db_leaf_deleter<rowex_db<Key, Value>>{*this}};
+  spin_wait_backoff backoff;
+
+  while (true) {
+    result = try_insert(insert_key, v, cached_leaf);
+    if (result) break;
+    backoff();
+  }
+
+  return *result;
+}
+
+template <typename Key, typename Value>
+typename rowex_db<Key, Value>::try_update_result_type
+rowex_db<Key, Value>::try_insert(art_key_type k, value_type v,
+                                 rowex_db_leaf_unique_ptr_type& cached_leaf) {
+  auto* parent_lock{&root_pointer_lock};
+  auto* node_in_parent{&root};
+  auto node{detail::load_published_node(root)};
+  tree_depth_type depth{};
+  auto remaining_key{k};
+
+  if (UNODB_DETAIL_UNLIKELY(node == nullptr)) {
+    detail::create_leaf_if_needed(cached_leaf, k, v, *this);
+
+    const optimistic_lock::write_guard root_guard{
+        root_pointer_lock.try_read_lock()};
+    if (UNODB_DETAIL_UNLIKELY(root_guard.must_restart())) return {};
+    if (UNODB_DETAIL_UNLIKELY(root != nullptr)) return {};
+
+    detail::publish_node(
+        root, detail::olc_node_ptr{cached_leaf.release(), node_type::LEAF});
+    return true;
+  }
+
+  while (true) {
+    const auto node_type = node.type();
+
+    if (node_type == node_type::LEAF) {
+      auto* const leaf{node.template ptr<leaf_type*>()};
+      const auto existing_key{leaf->get_key_view()};
+      if (UNODB_DETAIL_UNLIKELY(k.cmp(existing_key) == 0)) {
+        if (UNODB_DETAIL_UNLIKELY(cached_leaf != nullptr)) {
+          cached_leaf.reset();  // LCOV_EXCL_LINE
+        }
+        return false;  // exists
+      }
+
+      detail::create_leaf_if_needed(cached_leaf, k, v, *this);
+
+      std::optional<optimistic_lock::write_guard> parent_guard;
+      if (UNODB_DETAIL_UNLIKELY(
+              !detail::olc_write_lock_wait(*parent_lock, parent_guard)))
+        return {};
+      if (UNODB_DETAIL_UNLIKELY(node_in_parent->load() != node)) return {};
+
+      auto new_node{inode_4::create(*this, existing_key, remaining_key, depth,
+                                    leaf, std::move(cached_leaf))};
+      detail::publish_node(
+          *node_in_parent,
+          detail::olc_node_ptr{new_node.release(), node_type::I4});
+
+#ifdef UNODB_DETAIL_WITH_STATS
+      account_growing_inode<node_type::I4>();
+#endif  // UNODB_DETAIL_WITH_STATS
+      return true;
+    }
+
+    auto* const inode{node.template ptr<inode_type*>()};
+    const auto& key_prefix{inode->get_key_prefix()};
+    const auto key_prefix_length{key_prefix.length()};
+    const auto shared_prefix_length{
+        key_prefix.get_shared_length(remaining_key)};
+
+    if (shared_prefix_length < key_prefix_length) {
+      detail::create_leaf_if_needed(cached_leaf, k, v, *this);
+
+      std::optional<optimistic_lock::write_guard> parent_guard;
+      if (UNODB_DETAIL_UNLIKELY(
+              !detail::olc_write_lock_wait(*parent_lock, parent_guard)))
+        return {};
+      std::optional<optimistic_lock::write_guard> node_guard;
+      if (UNODB_DETAIL_UNLIKELY(
+              !detail::olc_write_lock_wait(node_ptr_lock(node), node_guard)))
+        return {};
+      if (UNODB_DETAIL_UNLIKELY(node_in_parent->load() != node)) return {};
+
+      // The new node cuts the key prefix of its child, thus the child is a
+      // copy, leaving the original intact for the readers in it
+      const auto node_copy{
+          detail::rowex_impl_helpers::copy_node(node, *this)};
+      auto new_node{inode_4::create(*this, node_copy, shared_prefix_length,
+                                    depth, std::move(cached_leaf))};
+      detail::publish_node(
+          *node_in_parent,
+          detail::olc_node_ptr{new_node.release(), node_type::I4});
+      node_guard->unlock_and_obsolete();
+      detail::rowex_impl_helpers::retire_node(node, *this);
+
+#ifdef UNODB_DETAIL_WITH_STATS
+      account_growing_inode<node_type::I4>();
+      key_prefix_splits.fetch_add(1, std::memory_order_relaxed);
+#endif  // UNODB_DETAIL_WITH_STATS
+
+      return true;
+    }
+
+    UNODB_DETAIL_ASSERT(shared_prefix_length == key_prefix_length);
+
+    depth += key_prefix_length;
+    remaining_key.shift_right(key_prefix_length);
+
+    const auto add_result{inode->template add_or_choose_subtree<
+        std::optional<in_critical_section<detail::olc_node_ptr>*>>(
+        node_type, remaining_key[0], k, v, *this, depth, *parent_lock,
+        node_in_parent, cached_leaf)};
+
+    if (UNODB_DETAIL_UNLIKELY(!add_result)) return {};
+
+    auto* const child_in_parent = *add_result;
+    if (child_in_parent == nullptr) return true;
+
+    parent_lock = &node_ptr_lock(node);
+    node = detail::load_published_node(*child_in_parent);
+    node_in_parent = child_in_parent;
+    ++depth;
+    remaining_key.shift_right(1);
+
+    // A concurrent in-place removal from an I256 may have cleared the slot
+    if (UNODB_DETAIL_UNLIKELY(node == nullptr)) return {};
+  }
+}
+
+template <typename Key, typename Value>
+bool rowex_db<Key, Value>::remove_internal(art_key_type remove_key) {
+  try_update_result_type result;
+  spin_wait_backoff backoff;
+
+  while (true) {
+    result = try_remove(remove_key);
+    if (result) break;
+    backoff();
+  }
+
+  return *result;
+}
+
+template <typename Key, typename Value>
+typename rowex_db<Key, Value>::try_update_result_type
+rowex_db<Key, Value>::try_remove(art_key_type k) {
+  auto* parent_lock{&root_pointer_lock};
+  auto* node_in_parent{&root};
+  auto node{detail::load_published_node(root)};
+  auto remaining_key{k};
+
+  if (UNODB_DETAIL_UNLIKELY(node == nullptr)) return false;
+
+  if (node.type() == node_type::LEAF) {
+    auto* const leaf{node.template ptr<leaf_type*>()};
+    if (!leaf->matches(k)) return false;
+
+    const optimistic_lock::write_guard root_guard{
+        root_pointer_lock.try_read_lock()};
+    if (UNODB_DETAIL_UNLIKELY(root_guard.must_restart())) return {};
+    if (UNODB_DETAIL_UNLIKELY(root.load() != node)) return {};
+
+    const auto r{art_policy::reclaim_leaf_on_scope_exit(leaf, *this)};
+    root = detail::olc_node_ptr{nullptr};
+    return true;
+  }
+
+  while (true) {
+    auto* const inode{node.template ptr<inode_type*>()};
+    const auto& key_prefix{inode->get_key_prefix()};
+    const auto key_prefix_length{key_prefix.length()};
+    const auto shared_prefix_length{
+        key_prefix.get_shared_length(remaining_key)};
+
+    if (shared_prefix_length < key_prefix_length) return false;
+
+    remaining_key.shift_right(key_prefix_length);
+
+    in_critical_section<detail::olc_node_ptr>* child_in_parent{nullptr};
+    const auto opt_remove_result{
+        inode->template remove_or_choose_subtree<std::optional<bool>>(
+            node.type(), remaining_key[0], k, *this, *parent_lock,
+            node_in_parent, &child_in_parent)};
+
+    if (UNODB_DETAIL_UNLIKELY(!opt_remove_result)) return {};
+
+    if (const auto remove_result{*opt_remove_result}; !remove_result)
+      return false;
+
+    if (child_in_parent == nullptr) return true;
+
+    parent_lock = &node_ptr_lock(node);
+    node = detail::load_published_node(*child_in_parent);
+    node_in_parent = child_in_parent;
+    remaining_key.shift_right(1);
+
+    if (UNODB_DETAIL_UNLIKELY(node == nullptr)) return {};
+  }
+}
+
+#ifdef UNODB_DETAIL_WITH_STATS
+
+UNODB_DETAIL_DISABLE_GCC_WARNING("-Wsuggest-attribute=cold")
+
+template <typename Key, typename Value>
+void rowex_db<Key, Value>::increase_memory_use(std::size_t delta) noexcept {
+  UNODB_DETAIL_ASSERT(delta > 0);
+
+  current_memory_use.fetch_add(delta, std::memory_order_relaxed);
+}
+
+UNODB_DETAIL_RESTORE_GCC_WARNINGS()
+
+template <typename Key, typename Value>
+void rowex_db<Key, Value>::decrease_memory_use(std::size_t delta) noexcept {
+  UNODB_DETAIL_ASSERT(delta > 0);
+  UNODB_DETAIL_ASSERT(delta <=
+                      current_memory_use.load(std::memory_order_relaxed));
+
+  current_memory_use.fetch_sub(delta, std::memory_order_relaxed);
+}
+
+template <typename Key, typename Value>
+template <class INode>
+constexpr void rowex_db<Key, Value>::increment_inode_count() noexcept {
+  static_assert(
+      detail::rowex_inode_defs<Key, Value>::template is_inode<INode>());
+
+  node_counts[as_i<INode::type>].fetch_add(1, std::memory_order_relaxed);
+  increase_memory_use(sizeof(INode));
+}
+
+template <typename Key, typename Value>
+template <class INode>
+constexpr void rowex_db<Key, Value>::decrement_inode_count() noexcept {
+  static_assert(
+      detail::rowex_inode_defs<Key, Value>::template is_inode<INode>());
+
+  const auto old_inode_count UNODB_DETAIL_USED_IN_DEBUG =
+      node_counts[as_i<INode::type>].fetch_sub(1, std::memory_order_relaxed);
+  UNODB_DETAIL_ASSERT(old_inode_count > 0);
+
+  decrease_memory_use(sizeof(INode));
+}
+
+template <typename Key, typename Value>
+template <node_type NodeType>
+constexpr void rowex_db<Key, Value>::account_growing_inode() noexcept {
+  static_assert(NodeType != node_type::LEAF);
+
+  growing_inode_counts[internal_as_i<NodeType>].fetch_add(
+      1, std::memory_order_relaxed);
+}
+
+template <typename Key, typename Value>
+template <node_type NodeType>
+constexpr void rowex_db<Key, Value>::account_shrinking_inode() noexcept {
+  static_assert(NodeType != node_type::LEAF);
+
+  shrinking_inode_counts[internal_as_i<NodeType>].fetch_add(
+      1, std::memory_order_relaxed);
+}
+
+#endif  // UNODB_DETAIL_WITH_STATS
+
+template <typename Key, typename Value>
+void rowex_db<Key, Value>::dump(std::ostream& os) const {
+#ifdef UNODB_DETAIL_WITH_STATS
+  os << "rowex_db dump, current memory use = " << get_current_memory_use()
+     << '\n';
+#else
+  os << "rowex_db dump\n";
+#endif  // UNODB_DETAIL_WITH_STATS
+  art_policy::dump_node(os, root.load());
+}
+
+// LCOV_EXCL_START
+template <typename Key, typename Value>
+void rowex_db<Key, Value>::dump() const {
+  dump(std::cerr);
+}
+// LCOV_EXCL_STOP
+
+}  // namespace unodb
+
+#endif  // UNODB_DETAIL_ROWEX_ART_HPP
@@ -0,0 +1,432 @@
+// Copyright 2025 UnoDB contributors
+#ifndef UNODB_DETAIL_SHARDED_MUTEX_ART_HPP
+#define UNODB_DETAIL_SHARDED_MUTEX_ART_HPP
+
+// Should be the first include
+#include "global.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "art.hpp"
+#include "art_common.hpp"
+#include "art_internal.hpp"
+#include "node_type.hpp"
+#include "portability_arch.hpp"
+
+namespace unodb {
+
+/// A thread-safe implementation of the Adaptive Radix Tree (ART) that
+/// partitions the key space into shards by the leading bits of the first key
+/// byte, each shard being a unodb::db with its own reader-writer lock.  Get
+/// takes the shard lock in the shared mode, insert and remove take it in the
+/// exclusive mode, so that the operations on different shards, and the reads
+/// of the same shard, proceed in parallel.
+///
+/// The shards are key ranges, thus the scans visit them one after another to
+/// produce the entries in the key order.  A scan takes the shared locks of all
+/// the shards it covers, in the shard order, before visiting any of them, and
+/// holds them until it completes.
+///
+/// \sa unodb::mutex_db for a single global lock, and unodb::olc_db for a
+/// highly concurrent implementation that requires QSBR.
+template <typename Key, typename Value>
+class sharded_mutex_db final {
+ public:
+  /// The type of the keys in the index.
+  using key_type = Key;
+  /// The type of the value associated with the keys in the index.
+  using value_type = Value;
+  using value_view = unodb::value_view;
+
+  /// If the search key was found, that is, the first pair member has a value,
+  /// then the second member is a shared lock of the key shard, which must be
+  /// released ASAP after reading the first pair member. Otherwise, the second
+  /// member is undefined.
+  using get_result = std::pair<typename db<Key, value_view>::get_result,
+                               std::shared_lock<std::shared_mutex>>;
+
+  /// The number of shards used by the default constructor.
+  static constexpr std::size_t default_shard_count = 16;
+
+  /// The largest number of shards, one per first key byte value.
+  static constexpr std::size_t max_shard_count = 256;
+
+  // TODO(laurynas): added temporarily during development
+  static_assert(std::is_same_v<value_type, unodb::value_view>);
+
+ private:
+  using art_key_type = detail::basic_art_key<Key>;
+
+  /// One partition of the key space.
+  struct alignas(detail::hardware_destructive_interference_size) shard final {
+    db<Key, Value> db_;
+    mutable std::shared_mutex mutex;
+  };
+
+  [[nodiscard]] std::size_t shard_index(Key key) const noexcept {
+    const art_key_type k{key};
+    if (k.size() == 0) return 0;  // An empty key_view precedes all the others
+    return static_cast<std::size_t>(k[0]) >> shard_shift;
+  }
+
+  [[nodiscard]] shard& shard_for(Key key) noexcept {
+    return shards[shard_index(key)];
+  }
+
+  [[nodiscard]] const shard& shard_for(Key key) const noexcept {
+    return shards[shard_index(key)];
+  }
+
+  /// Visit the shards \a first through \a last, inclusive, in that order,
+  /// holding the shared locks of all of them, and calling \a shard_scan for
+  /// each until the user scan function halts.
+  template <typename FN, typename ShardScan>
+  void scan_shards(std::size_t first, std::size_t last, FN& fn,
+                   ShardScan shard_scan) noexcept {
+    const auto low = std::min(first, last);
+    const auto high = std::max(first, last);
+    // Lock in the ascending shard order regardless of the scan direction, so
+    // that the scans never deadlock each other
+    for (auto i = low; i <= high; ++i) shards[i].mutex.lock_shared();
+
+    bool halted = false;
+    auto halting_fn = [&fn, &halted](auto& visitor) {
+      halted = fn(visitor);
+      return halted;
+    };
+    for (auto i = first;; i = (first <= last) ? i + 1 : i - 1) {
+      shard_scan(shards[i].db_, halting_fn);
+      if (halted || i == last) break;
+    }
+    for (auto i = low; i <= high; ++i) shards[i].mutex.unlock_shared();
+  }
+
+  [[nodiscard]] static std::size_t checked_shard_count(std::size_t count) {
+    if (UNODB_DETAIL_UNLIKELY(!std::has_single_bit(count) ||
+                              count > max_shard_count)) {
+      throw std::invalid_argument(
+          "unodb::sharded_mutex_db: the shard count must be a power of two "
+          "not over 256");
+    }
+    return count;
+  }
+
+  /// Apply \a fn to each shard database under its shared lock, summing the
+  /// results.
+  template <typename FN>
+  [[nodiscard]] auto sum_over_shards(FN fn) const {
+    std::shared_lock guard{shards[0].mutex};
+    auto result = fn(shards[0].db_);
+    guard.unlock();
+    for (std::size_t i = 1; i < shard_count; ++i) {
+      const std::shared_lock shard_guard{shards[i].mutex};
+      const auto shard_result = fn(shards[i].db_);
+      if constexpr (std::is_arithmetic_v<decltype(result)>) {
+        result += shard_result;
+      } else {
+        for (std::size_t j = 0; j < result.size(); ++j)
+          result[j] += shard_result[j];
+      }
+    }
+    return result;
+  }
+
+ public:
+  // Creation and destruction
+
+  /// Create an empty index with \a shard_count_ shards.
+  ///
+  /// \throw std::invalid_argument if \a shard_count_ is not a power of two
+  /// between 1 and max_shard_count.
+  explicit sharded_mutex_db(std::size_t shard_count_ = default_shard_count)
+      : shard_count{checked_shard_count(shard_count_)},
+        shard_shift{8U - static_cast<unsigned>(std::countr_zero(shard_count))},
+        shards{std::make_unique<shard[]>(shard_count)} {}
+
+  /// Return the number of shards.
+  [[nodiscard]] std::size_t get_shard_count() const noexcept {
+    return shard_count;
+  }
+
+  /// Query for a value associated with a key.
+  ///
+  /// \param search_key If Key is a simple primitive type, then it is converted
+  /// into a binary comparable key.  If Key is unodb::key_view, then it is
+  /// assumed to already be a binary comparable key, e.g., as produced by
+  /// unodb::key_encoder.
+  [[nodiscard, gnu::pure]] get_result get(Key search_key) const noexcept {
+    const auto& key_shard = shard_for(search_key);
+    std::shared_lock guard{key_shard.mutex};
+    const auto db_get_result{key_shard.db_.get(search_key)};
+    if (!db_get_result) {
+      guard.unlock();
+      return std::make_pair(db_get_result,
+                            std::shared_lock<std::shared_mutex>{});
+    }
+    return std::make_pair(db_get_result, std::move(guard));
+  }
+
+  [[nodiscard]] bool empty() const {
+    for (std::size_t i = 0; i < shard_count; ++i) {
+      const std::shared_lock guard{shards[i].mutex};
+      if (!shards[i].db_.empty()) return false;
+    }
+    return true;
+  }
+
+  /// Insert a value under a key iff there is no entry for that key.
+  ///
+  /// \note Cannot be called during stack unwinding with
+  /// `std::uncaught_exceptions() > 0`.
+  ///
+  /// \param insert_key If Key is a simple primitive type, then it is converted
+  /// into a binary comparable key.  If Key is unodb::key_view, then it is
+  /// assumed to already be a binary comparable key, e.g., as produced by
+  /// unodb::key_encoder.
+  ///
+  /// \param v The value of type `value_type` to be inserted under
+  /// that key.
+  ///
+  /// \return true iff the key value pair was inserted.
+  [[nodiscard]] bool insert(Key insert_key, value_type v) {
+    auto& key_shard = shard_for(insert_key);
+    const std::lock_guard guard{key_shard.mutex};
+    return key_shard.db_.insert(insert_key, v);
+  }
+
+  /// Insert the key value pairs of \a batch, skipping the keys already
+  /// present, locking each shard once for every run of consecutive pairs that
+  /// fall into it. A sorted batch thus locks each shard at most once.
+  ///
+  /// \sa unodb::db::insert_batch
+  ///
+  /// \return the number of inserted pairs.
+  std::size_t insert_batch(std::span<const std::pair<Key, value_type>> batch) {
+    std::size_t inserted{0};
+    std::size_t run_start{0};
+    while (run_start < batch.size()) {
+      const auto run_shard = shard_index(batch[run_start].first);
+      auto run_end = run_start + 1;
+      while (run_end < batch.size() &&
+             shard_index(batch[run_end].first) == run_shard)
+        ++run_end;
+
+      const std::lock_guard guard{shards[run_shard].mutex};
+      inserted += shards[run_shard].db_.insert_batch(
+          batch.subspan(run_start, run_end - run_start));
+      run_start = run_end;
+    }
+    return inserted;
+  }
+
+  /// Remove the entry associated with the key.
+  ///
+  /// \param search_key If Key is a simple primitive type, then it is converted
+  /// into a binary comparable key.  If Key is unodb::key_view, then it is
+  /// assumed to already be a binary comparable key, e.g., as produced by
+  /// unodb::key_encoder.
+  [[nodiscard]] bool remove(Key search_key) {
+    auto& key_shard = shard_for(search_key);
+    const std::lock_guard guard{key_shard.mutex};
+    return key_shard.db_.remove(search_key);
+  }
+
+  /// Removes all entries in the index, one shard at a time.
+  void clear() {
+    for (std::size_t i = 0; i < shard_count; ++i) {
+      const std::lock_guard guard{shards[i].mutex};
+      shards[i].db_.clear();
+    }
+  }
+
+  /// Set the number of children, ahead of the one being visited, which the
+  /// scans prefetch, in every shard.
+  ///
+  /// \sa unodb::db::set_scan_prefetch_distance
+  void set_scan_prefetch_distance(std::uint8_t distance) {
+    for (std::size_t i = 0; i < shard_count; ++i) {
+      const std::lock_guard guard{shards[i].mutex};
+      shards[i].db_.set_scan_prefetch_distance(distance);
+    }
+  }
+
+  /// Return the scan prefetch distance.
+  [[nodiscard]] std::uint8_t get_scan_prefetch_distance() const {
+    const std::shared_lock guard{shards[0].mutex};
+    return shards[0].db_.get_scan_prefetch_distance();
+  }
+
+  //
+  // scan API.
+  //
+
+  using iterator = typename unodb::db<Key, Value>::iterator;
+
+  /// Scan the tree, applying the caller's lambda to each visited leaf.
+  ///
+  /// \param fn A function
+  /// `f(unodb::visitor<unodb::sharded_mutex_db::iterator>&)` returning `bool`.
+  /// The traversal will halt if the function returns \c true.
+  ///
+  /// \param fwd When \c true perform a forward scan, otherwise perform a
+  /// reverse scan.
+  template <typename FN>
+  void scan(FN fn, bool fwd = true) noexcept {
+    const auto first = fwd ? 0 : shard_count - 1;
+    const auto last = fwd ? shard_count - 1 : 0;
+    scan_shards(first, last, fn, [fwd](auto& shard_db, auto& shard_fn) {
+      shard_db.scan(shard_fn, fwd);
+    });
+  }
+
+  /// Scan in the indicated direction, applying the caller's lambda to each
+  /// visited leaf.
+  ///
+  /// \param from_key is an inclusive lower bound for the starting point of the
+  /// scan.
+  ///
+  /// \param fn A function
+  /// `f(unodb::visitor<unodb::sharded_mutex_db::iterator>&)` returning `bool`.
+  /// The traversal will halt if the function returns \c true.
+  ///
+  /// \param fwd When \c true perform a forward scan, otherwise perform a
+  /// reverse scan.
+  template <typename FN>
+  void scan_from(Key from_key, FN fn, bool fwd = true) noexcept {
+    const auto first = shard_index(from_key);
+    const auto last = fwd ? shard_count - 1 : 0;
+    // The shards past the first one lie entirely on the scan side of from_key
+    scan_shards(first, last, fn,
+                [this, first, from_key, fwd](auto& shard_db, auto& shard_fn) {
+                  if (&shard_db == &shards[first].db_) {
+                    shard_db.scan_from(from_key, shard_fn, fwd);
+                  } else {
+                    shard_db.scan(shard_fn, fwd);
+                  }
+                });
+  }
+
+  /// Scan a half-open key range, applying the caller's lambda to each visited
+  /// leaf.  The scan will proceed in lexicographic order iff \a from_key is
+  /// less than \a to_key and in reverse lexicographic order iff \a to_key is
+  /// less than \a from_key.  When `from_key < to_key`, the scan will visit all
+  /// index entries in the half-open range `[from_key,to_key)` in forward order.
+  /// Otherwise the scan will visit all index entries in the half-open range
+  /// `(from_key,to_key]` in reverse order.
+  ///
+  /// \param from_key is an inclusive bound for the starting point of the scan.
+  ///
+  /// \param to_key is an exclusive bound for the ending point of the scan.
+  ///
+  /// \param fn A function
+  /// `f(unodb::visitor<unodb::sharded_mutex_db::iterator>&)` returning `bool`.
+  /// The traversal will halt if the function returns \c true.
+  template <typename FN>
+  void scan_range(Key from_key, Key to_key, FN fn) noexcept {
+    // Each shard clips the range to its own keys, so the same range works for
+    // all of them, and the shard order follows the key order.
+    scan_shards(shard_index(from_key), shard_index(to_key), fn,
+                [from_key, to_key](auto& shard_db, auto& shard_fn) {
+                  shard_db.scan_range(from_key, to_key, shard_fn);
+                });
+  }
+
+  // Stats
+#ifdef UNODB_DETAIL_WITH_STATS
+
+  [[nodiscard]] std::size_t get_current_memory_use() const {
+    return sum_over_shards(
+        [](const auto& shard_db) { return shard_db.get_current_memory_use(); });
+  }
+
+  template <node_type NodeType>
+  [[nodiscard]] std::uint64_t get_node_count() const {
+    return sum_over_shards([](const auto& shard_db) {
+      return shard_db.template get_node_count<NodeType>();
+    });
+  }
+
+  [[nodiscard]] node_type_counter_array get_node_counts() const {
+    return sum_over_shards(
+        [](const auto& shard_db) { return shard_db.get_node_counts(); });
+  }
+
+  template <node_type NodeType>
+  [[nodiscard]] std::uint64_t get_growing_inode_count() const {
+    return sum_over_shards([](const auto& shard_db) {
+      return shard_db.template get_growing_inode_count<NodeType>();
+    });
+  }
+
+  [[nodiscard]] inode_type_counter_array get_growing_inode_counts() const {
+    return sum_over_shards([](const auto& shard_db) {
+      return shard_db.get_growing_inode_counts();
+    });
+  }
+
+  template <node_type NodeType>
+  [[nodiscard]] std::uint64_t get_shrinking_inode_count() const {
+    return sum_over_shards([](const auto& shard_db) {
+      return shard_db.template get_shrinking_inode_count<NodeType>();
+    });
+  }
+
+  [[nodiscard]] inode_type_counter_array get_shrinking_inode_counts() const {
+    return sum_over_shards([](const auto& shard_db) {
+      return shard_db.get_shrinking_inode_counts();
+    });
+  }
+
+  [[nodiscard]] std::uint64_t get_key_prefix_splits() const {
+    return sum_over_shards(
+        [](const auto& shard_db) { return shard_db.get_key_prefix_splits(); });
+  }
+
+#endif  // UNODB_DETAIL_WITH_STATS
+
+  // Public utils
+
+  // Releases the shard lock in the case key was not found, keeps it locked
+  // otherwise.
+  [[nodiscard]] static bool key_found(const get_result& result) noexcept {
+#ifndef NDEBUG
+    const auto& lock{result.second};
+    // NOLINTNEXTLINE(readability-simplify-boolean-expr)
+    assert(!result.first || lock.owns_lock());
+#endif
+
+    return static_cast<bool>(result.first);
+  }
+
+  // Debugging
+  [[gnu::cold]] UNODB_DETAIL_NOINLINE void dump(std::ostream& os) const {
+    os << "sharded_mutex_db dump, " << shard_count << " shards\n";
+    for (std::size_t i = 0; i < shard_count; ++i) {
+      const std::shared_lock guard{shards[i].mutex};
+      os << "shard " << i << ":\n";
+      shards[i].db_.dump(os);
+    }
+  }
+
+ private:
+  const std::size_t shard_count;
+  /// Shift of the first key byte that leaves its shard index.
+  const unsigned shard_shift;
+  std::unique_ptr<shard[]> shards;
+};
+
+}  // namespace unodb
+
+#endif  // UNODB_DETAIL_SHARDED_MUTEX_ART_HPP
@@ -23,6 +23,7 @@
 #include <thread>
 #include <tuple>
 #include <type_traits>
+#include <utility>
 #include <vector>  // IWYU pragma: keep
 
 #include <gmock/gmock.h>
@@ -37,6 +38,7 @@
 #include "node_type.hpp"
 #include "olc_art.hpp"
 #include "qsbr.hpp"
+#include "qsbr_test_utils.hpp"
 #include "test_heap.hpp"
 
 extern template class unodb::db<std::uint64_t, unodb::value_view>;
@@ -84,6 +86,53 @@ constexpr std::array<unodb::value_view, 6> test_values = {
     unodb::value_view{empty_test_value}  // [5] {                 }
 };
 
+/// Return the test value for \a k, as the key range inserts use.
+[[nodiscard]] constexpr unodb::value_view value_for(std::uint64_t k) noexcept {
+  return test_values[k % test_values.size()];
+}
+
+/// Decode an encoded \a akey of a std::uint64_t key.
+[[nodiscard]] inline std::uint64_t decode(unodb::key_view akey) noexcept {
+  unodb::key_decoder dec{akey};
+  std::uint64_t k{};
+  dec.decode(k);
+  return k;
+}
+
+/// Expect in Google Test that \a db maps \a k to \a expected.
+template <class Db>
+void expect_value(const Db& db, typename Db::key_type k,
+                  unodb::value_view expected) {
+  const auto result = db.get(k);
+  UNODB_ASSERT_TRUE(Db::key_found(result));
+  if constexpr (requires { result.first; }) {
+    UNODB_EXPECT_TRUE(std::ranges::equal(*result.first, expected));
+  } else {
+    UNODB_EXPECT_TRUE(std::ranges::equal(*result, expected));
+  }
+}
+
+/// Test fixture expecting the default QSBR domain to be idle before and after
+/// each test.
+class QSBRIdleTest : public ::testing::Test {
+ public:
+  UNODB_DETAIL_DISABLE_MSVC_WARNING(26447)
+  ~QSBRIdleTest() noexcept override {
+    unodb::this_thread().quiescent();
+    expect_idle_qsbr();
+  }
+  UNODB_DETAIL_RESTORE_MSVC_WARNINGS()
+
+  QSBRIdleTest(const QSBRIdleTest&) = delete;
+  QSBRIdleTest(QSBRIdleTest&&) = delete;
+  QSBRIdleTest& operator=(const QSBRIdleTest&) = delete;
+  QSBRIdleTest& operator=(QSBRIdleTest&&) = delete;
+
+ protected:
+  // NOLINTNEXTLINE(bugprone-exception-escape)
+  QSBRIdleTest() noexcept { expect_idle_qsbr(); }
+};
+
 namespace detail {
 
 UNODB_DETAIL_DISABLE_CLANG_WARNING("-Wused-but-marked-unused")
@@ -467,6 +516,34 @@ class [[nodiscard]] tree_verifier final {
     insert_key_range_internal(coerce_key(start_key), count, bypass_verifier);
   }
 
+  /// Insert \a keys with the test values through a single Db::insert_batch
+  /// call, checking that exactly the keys not present before were inserted.
+  void insert_batch(const std::vector<std::uint64_t>& keys) {
+    std::vector<std::pair<key_type, unodb::value_view>> batch;
+    // Unlike make_key, keep all the encoded keys valid until the batch is done
+    std::vector<std::array<std::byte, sizeof(std::uint64_t)>> encoded_keys;
+    std::size_t new_key_count{0};
+    {
+      UNODB_DETAIL_PAUSE_HEAP_TRACKING_GUARD();
+      batch.reserve(keys.size());
+      encoded_keys.reserve(keys.size());
+      for (const auto k : keys) {
+        const auto v = test_values[k % test_values.size()];
+        if constexpr (std::is_same_v<key_type, unodb::key_view>) {
+          unodb::key_encoder enc;
+          std::ranges::copy(enc.encode(k).get_key_view(),
+                            encoded_keys.emplace_back().begin());
+          batch.emplace_back(unodb::key_view{encoded_keys.back()}, v);
+        } else {
+          batch.emplace_back(k, v);
+        }
+        if (values.try_emplace(to_ikey(batch.back().first), v).second)
+          ++new_key_count;
+      }
+    }
+    UNODB_ASSERT_EQ(test_db.insert_batch(batch), new_key_count);
+  }
+
   template <typename T>
   bool try_insert(T k, unodb::value_view v) {
     return test_db.insert(coerce_key(k), v);
@@ -207,6 +207,16 @@
     UNODB_DETAIL_RESTORE_MSVC_WARNINGS()     \
   } while (0)
 
+/// Wrapper for Google Test `EXPECT_LE` macro.
+#define UNODB_EXPECT_LE(x, y)                \
+  do {                                       \
+    UNODB_DETAIL_DISABLE_MSVC_WARNING(6326)  \
+    UNODB_DETAIL_DISABLE_MSVC_WARNING(26818) \
+    EXPECT_LE((x), (y));                     \
+    UNODB_DETAIL_RESTORE_MSVC_WARNINGS()     \
+    UNODB_DETAIL_RESTORE_MSVC_WARNINGS()     \
+  } while (0)
+
 /// Wrapper for Google Test `EXPECT_TRUE` macro.
 // Do not wrap in a block to support streaming to EXPECT_TRUE. Happens to be OK
 // because the warning macros are not statements.
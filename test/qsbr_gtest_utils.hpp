@@ -57,16 +57,9 @@ class QSBRTestBase : public ::testing::Test {
         []() noexcept { return unodb::this_thread().is_qsbr_paused(); });
   }
 
-  static void qsbr_pause()
-#ifndef UNODB_DETAIL_WITH_STATS
-      noexcept
-#endif
-  {
-    unodb::test::must_not_allocate([]()
-#ifndef UNODB_DETAIL_WITH_STATS
-                                       noexcept
-#endif
-                                   { unodb::this_thread().qsbr_pause(); });
+  static void qsbr_pause() noexcept {
+    unodb::test::must_not_allocate(
+        []() noexcept { unodb::this_thread().qsbr_pause(); });
   }
 
 #ifdef UNODB_DETAIL_WITH_STATS
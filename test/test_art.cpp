@@ -12,12 +12,15 @@
 #include <limits>
 #include <stdexcept>
 #include <tuple>
+#include <vector>
 
 #include <gtest/gtest.h>
 
 #include "art_common.hpp"
 #include "db_test_utils.hpp"
 #include "gtest_utils.hpp"
+#include "node_type.hpp"
+#include "qsbr.hpp"
 #include "test_utils.hpp"
 #include "thread_sync.hpp"
 
@@ -965,6 +968,72 @@ UNODB_TYPED_TEST(ARTCorrectnessTest, Clear) {
 #endif  // UNODB_DETAIL_WITH_STATS
 }
 
+// Dense increasing keys grow the nodes under the retained insert path, then a
+// second batch overlaps the first one and repeats a key.
+UNODB_TYPED_TEST(ARTCorrectnessTest, InsertBatchSorted) {
+  unodb::test::tree_verifier<TypeParam> verifier;
+  std::vector<std::uint64_t> keys;
+  for (std::uint64_t k = 0; k < 1000; ++k) keys.push_back(k);
+  verifier.insert_batch(keys);
+  verifier.check_present_values();
+  verifier.check_absent_keys({1000});
+
+  keys.clear();
+  for (std::uint64_t k = 900; k < 1100; ++k) keys.push_back(k);
+  keys.push_back(1099);
+  keys.push_back(0x100000000ULL);
+  verifier.insert_batch(keys);
+  verifier.check_present_values();
+
+#ifdef UNODB_DETAIL_WITH_STATS
+  verifier.assert_node_counts({1101, 1, 1, 0, 5});
+#endif  // UNODB_DETAIL_WITH_STATS
+}
+
+// Keys in no particular order, splitting the key prefixes above and below the
+// retained path, must be inserted as if one at a time.
+UNODB_TYPED_TEST(ARTCorrectnessTest, InsertBatchUnsorted) {
+  unodb::test::tree_verifier<TypeParam> verifier;
+  verifier.insert_batch({});
+  verifier.assert_empty();
+
+  verifier.insert(0x0102030405060708ULL, unodb::test::test_values[0]);
+  verifier.insert_batch({0x0102030405060709ULL, 0x01020304FF060708ULL,
+                         0x0102030405060700ULL, 0x01FF030405060708ULL,
+                         0x0102030405060708ULL, 0x0102030405FF0708ULL, 0,
+                         0xFFFFFFFFFFFFFFFFULL, 0x0102030405060701ULL});
+  verifier.check_present_values();
+  verifier.check_absent_keys({0x0102030405060702ULL, 1ULL});
+}
+
+// Appends interleaved with the inserts and the removes that grow, shrink,
+// split, and collapse the nodes on the rightmost path, or remove its leaf.
+UNODB_TYPED_TEST(ARTCorrectnessTest, AppendAroundRightmostPathChanges) {
+  unodb::test::tree_verifier<TypeParam> verifier;
+  for (std::uint64_t k = 0; k < 300; ++k)
+    verifier.insert(k, unodb::test::test_values[k % 5]);
+
+  verifier.remove(299);
+  verifier.remove(298);
+  verifier.insert(298, unodb::test::test_values[0]);
+  verifier.insert(0x10000ULL, unodb::test::test_values[1]);
+  verifier.insert(0x0100ULL | 0xF000ULL, unodb::test::test_values[2]);
+  verifier.insert(0x10001ULL, unodb::test::test_values[3]);
+  for (std::uint64_t k = 256; k < 298; ++k) verifier.remove(k);
+  verifier.remove(0x10000ULL);
+  verifier.insert(0x10002ULL, unodb::test::test_values[4]);
+  verifier.remove(0x10002ULL);
+  verifier.remove(0x10001ULL);
+  verifier.insert(0x0100000000000000ULL, unodb::test::test_values[0]);
+  verifier.insert(0x0100000000000001ULL, unodb::test::test_values[1]);
+  verifier.check_present_values();
+  verifier.check_absent_keys({299ULL, 0x10000ULL, 0x10002ULL, 300ULL});
+
+  for (std::uint64_t k = 0; k < 255; ++k) verifier.remove(k);
+  verifier.insert(0x0100000000000002ULL, unodb::test::test_values[2]);
+  verifier.check_present_values();
+}
+
 UNODB_TYPED_TEST(ARTCorrectnessTest, TwoInstances) {
   unodb::test::tree_verifier<TypeParam> v1;
   unodb::test::tree_verifier<TypeParam> v2;
@@ -986,4 +1055,59 @@ UNODB_TYPED_TEST(ARTCorrectnessTest, TwoInstances) {
   second_thread.join();
 }
 
+using ARTOLCRecyclingTest = unodb::test::QSBRIdleTest;
+
+// The nodes removed from an olc_db go to the free lists of the removing thread
+// once their epoch is over, and its next inserts take them from there.
+UNODB_TEST_F(ARTOLCRecyclingTest, ReinsertAfterEpochChange) {
+  constexpr auto leaf_list = unodb::as_i<unodb::node_type::LEAF>;
+  constexpr auto i4_list = unodb::as_i<unodb::node_type::I4>;
+
+  // Empty the lists, as the blocks of the other tests may have other sizes
+  unodb::this_thread().set_free_list_capacity(0);
+  unodb::this_thread().set_free_list_capacity(
+      unodb::detail::qsbr_free_lists::default_capacity);
+
+  unodb::test::u64_olc_db db;
+  UNODB_ASSERT_TRUE(db.insert(0, test_values[0]));
+  UNODB_ASSERT_TRUE(db.insert(1, test_values[0]));
+
+  unodb::qsbr_thread second_thread([] {
+    thread_syncs[0].notify();
+    thread_syncs[1].wait();
+
+    unodb::this_thread().quiescent();
+    thread_syncs[0].notify();
+    thread_syncs[1].wait();
+
+    unodb::this_thread().quiescent();
+    thread_syncs[0].notify();
+    thread_syncs[1].wait();
+  });
+
+  thread_syncs[0].wait();
+  // Shrinks the root I4 to the remaining leaf, retiring the I4 and a leaf
+  UNODB_ASSERT_TRUE(db.remove(1));
+  unodb::this_thread().quiescent();
+  UNODB_EXPECT_EQ(unodb::this_thread().get_free_list_size(leaf_list), 0);
+
+  thread_syncs[1].notify();
+  thread_syncs[0].wait();
+  unodb::this_thread().quiescent();
+  thread_syncs[1].notify();
+  thread_syncs[0].wait();
+  unodb::this_thread().quiescent();
+
+  UNODB_EXPECT_EQ(unodb::this_thread().get_free_list_size(leaf_list), 1);
+  UNODB_EXPECT_EQ(unodb::this_thread().get_free_list_size(i4_list), 1);
+
+  UNODB_ASSERT_TRUE(db.insert(1, test_values[0]));
+  UNODB_EXPECT_EQ(unodb::this_thread().get_free_list_size(leaf_list), 0);
+  UNODB_EXPECT_EQ(unodb::this_thread().get_free_list_size(i4_list), 0);
+  UNODB_EXPECT_TRUE(db.get(1).has_value());
+
+  thread_syncs[1].notify();
+  second_thread.join();
+}
+
 }  // namespace
@@ -8,10 +8,13 @@
 
 #include <algorithm>
 #include <array>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <random>
+#include <thread>
 #include <tuple>
+#include <utility>
 
 #include <gtest/gtest.h>
 
@@ -19,6 +22,7 @@
 #include "assert.hpp"
 #include "db_test_utils.hpp"
 #include "gtest_utils.hpp"
+#include "optimistic_lock.hpp"
 #include "qsbr.hpp"
 #include "qsbr_test_utils.hpp"
 
@@ -211,6 +215,36 @@ class ARTConcurrencyTest : public ::testing::Test {
     }
   }
 
+  // Thread zero moves a key back and forth between two leaves under different
+  // parents, always inserting the new one before removing the old one. The
+  // other threads read both with a read transaction and must find at least
+  // one.
+  static void consistent_read_thread(unodb::test::tree_verifier<Db>* verifier,
+                                     std::size_t thread_i,
+                                     std::size_t ops_per_thread) {
+    constexpr std::uint64_t key_a = 1;
+    constexpr std::uint64_t key_b = std::uint64_t{1} << 40U;
+    const auto value = unodb::test::test_values[0];
+    auto& db = verifier->get_db();
+    for (decltype(ops_per_thread) i = 0; i < ops_per_thread; ++i) {
+      if (thread_i == 0) {
+        verifier->try_insert(key_b, value);
+        verifier->try_remove(key_a);
+        verifier->try_insert(key_a, value);
+        verifier->try_remove(key_b);
+      } else {
+        bool a_found{false};
+        bool b_found{false};
+        db.read_consistent([&a_found, &b_found](auto& transaction) {
+          a_found = Db::key_found(transaction.get(key_a));
+          b_found = Db::key_found(transaction.get(key_b));
+        });
+        UNODB_EXPECT_TRUE(a_found || b_found);
+      }
+      unodb::this_thread().quiescent();
+    }
+  }
+
   unodb::test::tree_verifier<Db> verifier{true};
 
  public:
@@ -278,6 +312,150 @@ UNODB_TYPED_TEST(ARTConcurrencyTest, ParallelRandomInsertDeleteGetScan) {
       TestFixture::random_op_thread);
 }
 
+// Oversubscribed threads with backoff between the optimistic lock retries.
+UNODB_TYPED_TEST(ARTConcurrencyTest, ParallelRandomOpsWithSpinBackoff) {
+  constexpr auto thread_count = 8;
+  constexpr auto initial_keys = 128;
+  constexpr auto ops_per_thread = 500;
+
+  unodb::set_spin_backoff(unodb::spin_backoff::exponential_yield, 64, 4);
+  this->verifier.insert_key_range(0, initial_keys, true);
+  this->template parallel_test<thread_count, ops_per_thread>(
+      TestFixture::random_op_thread);
+  unodb::set_spin_backoff(unodb::spin_backoff::none);
+}
+
+// Threads that wait on write-locked OLC nodes park and get woken up by the
+// writers. Without UNODB_DETAIL_LOCK_PARKING they yield instead.
+UNODB_TYPED_TEST(ARTConcurrencyTest, ParallelRandomOpsWithLockParking) {
+  constexpr auto thread_count = 8;
+  constexpr auto initial_keys = 128;
+  constexpr auto ops_per_thread = 500;
+
+  unodb::set_spin_backoff(unodb::spin_backoff::exponential_park, 4, 1);
+  this->verifier.insert_key_range(0, initial_keys, true);
+  this->template parallel_test<thread_count, ops_per_thread>(
+      TestFixture::random_op_thread);
+  unodb::set_spin_backoff(unodb::spin_backoff::none);
+}
+
+// A thread parked on a write-locked lock gets woken up even if the backoff
+// policy changes before the unlock. Without UNODB_DETAIL_LOCK_PARKING it yields
+// instead.
+UNODB_TEST(OptimisticLock, ParkedWaiterAcrossBackoffPolicySwitch) {
+  unodb::optimistic_lock lock;
+  auto read_lock = lock.try_read_lock();
+  UNODB_ASSERT_FALSE(read_lock.must_restart());
+  unodb::optimistic_lock::write_guard guard{std::move(read_lock)};
+  UNODB_ASSERT_FALSE(guard.must_restart());
+
+  unodb::set_spin_backoff(unodb::spin_backoff::exponential_park, 4, 1);
+  std::thread waiter{[&lock] {
+    auto waiter_read_lock = lock.try_read_lock();
+    UNODB_EXPECT_FALSE(waiter_read_lock.must_restart());
+    UNODB_EXPECT_TRUE(waiter_read_lock.try_read_unlock());
+  }};
+  std::this_thread::sleep_for(std::chrono::milliseconds{100});
+
+  unodb::set_spin_backoff(unodb::spin_backoff::none);
+  guard.unlock();
+  waiter.join();
+}
+
+// With no restart budget every OLC get locks the nodes whose reads fail,
+// concurrently with the writers and the optimistic scans.
+UNODB_TYPED_TEST(ARTConcurrencyTest, ParallelPessimisticGet) {
+  constexpr auto thread_count = 4;
+  constexpr auto initial_keys = 128;
+  constexpr auto ops_per_thread = 500;
+
+  if constexpr (unodb::test::is_olc_db<TypeParam>)
+    this->verifier.get_db().set_read_restart_budget(0);
+  this->verifier.insert_key_range(0, initial_keys, true);
+  this->template parallel_test<thread_count, ops_per_thread>(
+      TestFixture::random_op_thread);
+
+#ifdef UNODB_DETAIL_WITH_STATS
+  if constexpr (unodb::test::is_olc_db<TypeParam>) {
+    UNODB_EXPECT_EQ(this->verifier.get_db().get_read_restarts(), 0);
+    // Only one thread in four runs gets
+    UNODB_EXPECT_LE(ops_per_thread,
+                    this->verifier.get_db().get_pessimistic_reads());
+  }
+#endif  // UNODB_DETAIL_WITH_STATS
+}
+
+// A read transaction commits iff no write has changed any of its results.
+UNODB_TYPED_TEST(ARTConcurrencyTest, ReadTransactionValidation) {
+  if constexpr (unodb::test::is_olc_db<TypeParam>) {
+    // The writes bypass the verifier, which passes through quiescent states,
+    // and run in another thread, as the only QSBR thread frees the nodes at
+    // once. Either would free the nodes the transaction depends on.
+    auto& db = this->verifier.get_db();
+    const auto insert = [&db](std::uint64_t k) {
+      unodb::test::thread<TypeParam>{[&db, k] {
+        UNODB_EXPECT_TRUE(db.insert(k, unodb::test::test_values[0]));
+      }}.join();
+    };
+    const auto remove = [&db](std::uint64_t k) {
+      unodb::test::thread<TypeParam>{[&db, k] {
+        UNODB_EXPECT_TRUE(db.remove(k));
+      }}.join();
+    };
+    typename TypeParam::read_transaction transaction{db};
+    // Empty tree
+    UNODB_EXPECT_FALSE(TypeParam::key_found(transaction.get(1)));
+    UNODB_EXPECT_TRUE(transaction.try_commit());
+    insert(1);
+    UNODB_EXPECT_FALSE(transaction.try_commit());
+
+    insert(2);
+    insert(0x10000);
+    const auto read_all = [&transaction] {
+      transaction.reset();
+      // Found, a missing child, a leaf mismatch, and a key prefix mismatch
+      UNODB_EXPECT_TRUE(TypeParam::key_found(transaction.get(1)));
+      UNODB_EXPECT_FALSE(TypeParam::key_found(transaction.get(3)));
+      UNODB_EXPECT_FALSE(TypeParam::key_found(transaction.get(0x10001)));
+      UNODB_EXPECT_FALSE(TypeParam::key_found(transaction.get(0x1000000)));
+      UNODB_EXPECT_TRUE(transaction.try_commit());
+    };
+
+    read_all();
+    remove(1);
+    UNODB_EXPECT_FALSE(transaction.try_commit());
+    insert(1);
+
+    read_all();
+    insert(3);
+    UNODB_EXPECT_FALSE(transaction.try_commit());
+    remove(3);
+
+    read_all();
+    insert(0x10002);
+    UNODB_EXPECT_FALSE(transaction.try_commit());
+    remove(0x10002);
+
+    read_all();
+    insert(0x1000001);
+    UNODB_EXPECT_FALSE(transaction.try_commit());
+
+    // Writes elsewhere do not invalidate the transaction
+    transaction.reset();
+    UNODB_EXPECT_TRUE(TypeParam::key_found(transaction.get(1)));
+    insert(0x1000002);
+    UNODB_EXPECT_TRUE(transaction.try_commit());
+  }
+}
+
+UNODB_TYPED_TEST(ARTConcurrencyTest, ParallelConsistentReads) {
+  if constexpr (unodb::test::is_olc_db<TypeParam>) {
+    this->verifier.insert(1, unodb::test::test_values[0]);
+    this->template parallel_test<4, 2000>(
+        TestFixture::consistent_read_thread);
+  }
+}
+
 UNODB_TYPED_TEST(ARTConcurrencyTest,
                  DISABLED_MediumParallelRandomInsertDeleteGetScan) {
   constexpr auto thread_count = 4 * 3;
@@ -317,6 +495,108 @@ UNODB_TYPED_TEST(ARTConcurrencyTest,
       TestFixture::random_op_thread);
 }
 
+// A tree bound to its own QSBR domain is reclaimed there, and its threads
+// pass through the quiescent states of that domain only.
+UNODB_TYPED_TEST(ARTConcurrencyTest, ParallelOpsInOwnQSBRDomain) {
+  if constexpr (unodb::test::is_olc_db<TypeParam>) {
+    constexpr std::uint64_t keys_per_thread = 500;
+    unodb::qsbr domain;
+    {
+      TypeParam db{domain};
+      UNODB_EXPECT_EQ(&db.get_qsbr_domain(), &domain);
+      std::array<unodb::test::thread<TypeParam>, 4> threads;
+      for (std::uint64_t i = 0; i < threads.size(); ++i) {
+        threads[i] = unodb::test::thread<TypeParam>{[&db, &domain, i] {
+          auto& in_domain = domain.current_thread();
+          for (std::uint64_t k = i; k < keys_per_thread * 4; k += 4) {
+            UNODB_EXPECT_TRUE(db.insert(k, unodb::test::test_values[0]));
+            in_domain.quiescent();
+            // Remove the key inserted in the previous iteration
+            if (odd(k / 4)) {
+              UNODB_EXPECT_TRUE(db.remove(k - 4));
+            }
+            in_domain.quiescent();
+          }
+        }};
+      }
+      for (auto& thread : threads) thread.join();
+
+      std::ignore = domain.current_thread();
+      for (std::uint64_t k = 0; k < keys_per_thread * 4; ++k) {
+        UNODB_EXPECT_EQ(TypeParam::key_found(db.get(k)), odd(k / 4));
+      }
+#ifdef UNODB_DETAIL_WITH_STATS
+      UNODB_EXPECT_EQ(db.template get_node_count<unodb::node_type::LEAF>(),
+                      keys_per_thread * 2);
+#endif  // UNODB_DETAIL_WITH_STATS
+    }
+    UNODB_EXPECT_EQ(unodb::qsbr_state::get_thread_count(domain.get_state()), 1);
+  }
+}
+
+// Threads wrapping each operation in an unodb::ebr_guard read the keys the
+// others keep removing, while one thread stays out of the guard mode. The
+// epoch keeps changing, thus the removed leaves are reclaimed concurrently.
+UNODB_TYPED_TEST(ARTConcurrencyTest, ParallelOpsInEbrGuards) {
+  if constexpr (unodb::test::is_olc_db<TypeParam>) {
+    constexpr std::uint64_t keys_per_thread = 500;
+    constexpr std::size_t thread_count = 4;
+    auto& db = this->verifier.get_db();
+#ifdef UNODB_DETAIL_WITH_STATS
+    const auto epoch_changes_before =
+        unodb::qsbr::instance().get_epoch_change_count();
+#endif  // UNODB_DETAIL_WITH_STATS
+    unodb::this_thread().qsbr_pause();
+
+    std::array<unodb::test::thread<TypeParam>, thread_count> threads;
+    for (std::uint64_t i = 0; i < threads.size(); ++i) {
+      threads[i] = unodb::test::thread<TypeParam>{[&db, i] {
+        const auto guarded = i != 0;
+        const auto run = [guarded](auto op) {
+          if (guarded) {
+            const unodb::ebr_guard guard;
+            op();
+          } else {
+            op();
+            unodb::this_thread().quiescent();
+          }
+        };
+        for (std::uint64_t k = i; k < keys_per_thread * thread_count;
+             k += thread_count) {
+          const auto value =
+              unodb::test::test_values[k % unodb::test::test_values.size()];
+          run([&db, k, value] { UNODB_EXPECT_TRUE(db.insert(k, value)); });
+          // The key of the next thread may be getting removed meanwhile
+          run([&db, k] {
+            const auto other = k + 1;
+            const auto result = db.get(other);
+            if (TypeParam::key_found(result)) {
+              UNODB_EXPECT_TRUE(std::ranges::equal(
+                  *result, unodb::test::test_values
+                               [other % unodb::test::test_values.size()]));
+            }
+          });
+          // Remove the key inserted in the previous iteration
+          if (odd(k / thread_count)) {
+            run([&db, k] { UNODB_EXPECT_TRUE(db.remove(k - thread_count)); });
+          }
+        }
+      }};
+    }
+    for (auto& thread : threads) thread.join();
+
+    unodb::this_thread().qsbr_resume();
+    for (std::uint64_t k = 0; k < keys_per_thread * thread_count; ++k) {
+      UNODB_EXPECT_EQ(TypeParam::key_found(db.get(k)),
+                      odd(k / thread_count));
+    }
+#ifdef UNODB_DETAIL_WITH_STATS
+    UNODB_EXPECT_GT(unodb::qsbr::instance().get_epoch_change_count(),
+                    epoch_changes_before);
+#endif  // UNODB_DETAIL_WITH_STATS
+  }
+}
+
 // Optionally enable this for more confidence in debug builds. Set the
 // thread_count for your machine.  Fewer keys, more threads, and more
 // operations per thread is more challenging.
@@ -0,0 +1,243 @@
+// Copyright 2025 UnoDB contributors
+
+// Should be the first include
+#include "global.hpp"  // IWYU pragma: keep
+
+// IWYU pragma: no_include <__ostream/basic_ostream.h>
+// IWYU pragma: no_include <array>
+// IWYU pragma: no_include <string>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "art_common.hpp"
+#include "db_test_utils.hpp"
+#include "frozen_art.hpp"
+#include "gtest_utils.hpp"
+
+namespace {
+
+// Test suite for the frozen ART, parameterized on the source tree type.
+template <class Db>
+class ARTFrozenTest : public ::testing::Test {
+ public:
+  using Test::Test;
+};
+
+using ARTTypes =
+    ::testing::Types<unodb::test::u64_db, unodb::test::u64_mutex_db,
+                     unodb::test::u64_olc_db, unodb::test::key_view_db,
+                     unodb::test::key_view_mutex_db,
+                     unodb::test::key_view_olc_db>;
+
+UNODB_TYPED_TEST_SUITE(ARTFrozenTest, ARTTypes)
+
+template <class Db>
+using frozen_type =
+    unodb::frozen_db<typename Db::key_type, typename Db::value_type>;
+
+using entry_vector =
+    std::vector<std::pair<std::vector<std::byte>, std::vector<std::byte>>>;
+
+// Return a copy of the entries visited by the scan_fn(fn) call.
+template <class Iterator, typename ScanFn>
+[[nodiscard]] entry_vector collect(ScanFn scan_fn) {
+  entry_vector result;
+  scan_fn([&result](const unodb::visitor<Iterator>& v) {
+    const auto k = v.get_key();
+    const auto val = v.get_value();
+    result.emplace_back(std::vector<std::byte>(k.begin(), k.end()),
+                        std::vector<std::byte>{});
+    for (const auto b : val) result.back().second.push_back(b);
+    return false;
+  });
+  return result;
+}
+
+// Check that the source and frozen trees return the same entries for the full
+// and the partial scans.
+template <class Db>
+void check_scans(unodb::test::tree_verifier<Db>& verifier,
+                 const frozen_type<Db>& frozen, std::uint64_t from,
+                 std::uint64_t to) {
+  using frozen_iterator = typename frozen_type<Db>::iterator;
+  auto& db = verifier.get_db();
+  const auto from_key = verifier.coerce_key(from);
+  const auto to_key = verifier.coerce_key(to);
+
+  for (const auto fwd : {true, false}) {
+    UNODB_EXPECT_EQ(
+        collect<typename Db::iterator>([&](auto fn) { db.scan(fn, fwd); }),
+        collect<frozen_iterator>([&](auto fn) { frozen.scan(fn, fwd); }));
+    UNODB_EXPECT_EQ(collect<typename Db::iterator>(
+                        [&](auto fn) { db.scan_from(from_key, fn, fwd); }),
+                    collect<frozen_iterator>(
+                        [&](auto fn) { frozen.scan_from(from_key, fn, fwd); }));
+  }
+  UNODB_EXPECT_EQ(collect<typename Db::iterator>(
+                      [&](auto fn) { db.scan_range(from_key, to_key, fn); }),
+                  collect<frozen_iterator>([&](auto fn) {
+                    frozen.scan_range(from_key, to_key, fn);
+                  }));
+  UNODB_EXPECT_EQ(collect<typename Db::iterator>(
+                      [&](auto fn) { db.scan_range(to_key, from_key, fn); }),
+                  collect<frozen_iterator>([&](auto fn) {
+                    frozen.scan_range(to_key, from_key, fn);
+                  }));
+}
+
+template <class Db>
+void check_value(const frozen_type<Db>& frozen, typename Db::key_type k,
+                 unodb::value_view expected) {
+  const auto result = frozen.get(k);
+  UNODB_ASSERT_TRUE(frozen_type<Db>::key_found(result));
+  UNODB_EXPECT_TRUE(std::ranges::equal(*result, expected));
+}
+
+UNODB_TYPED_TEST(ARTFrozenTest, EmptyTree) {
+  unodb::test::tree_verifier<TypeParam> verifier;
+  const frozen_type<TypeParam> frozen{verifier.get_db()};
+
+  UNODB_EXPECT_TRUE(frozen.empty());
+  UNODB_EXPECT_EQ(frozen.size(), 0);
+  UNODB_EXPECT_FALSE(
+      frozen_type<TypeParam>::key_found(frozen.get(verifier.coerce_key(0))));
+  auto it = frozen.test_only_iterator();
+  it.first();
+  UNODB_EXPECT_FALSE(it.valid());
+  it.last();
+  UNODB_EXPECT_FALSE(it.valid());
+  check_scans(verifier, frozen, 0, 10);
+}
+
+UNODB_TYPED_TEST(ARTFrozenTest, MovedFromTree) {
+  unodb::test::tree_verifier<TypeParam> verifier;
+  verifier.insert_key_range(1, 100);
+  frozen_type<TypeParam> frozen{verifier.get_db()};
+  const auto moved_to{std::move(frozen)};
+  UNODB_EXPECT_EQ(moved_to.size(), 100);
+
+  // NOLINTBEGIN(bugprone-use-after-move,clang-analyzer-cplusplus.Move)
+  UNODB_EXPECT_TRUE(frozen.empty());
+  UNODB_EXPECT_EQ(frozen.size(), 0);
+  UNODB_EXPECT_FALSE(
+      frozen_type<TypeParam>::key_found(frozen.get(verifier.coerce_key(1))));
+  auto it = frozen.test_only_iterator();
+  it.first();
+  UNODB_EXPECT_FALSE(it.valid());
+  // NOLINTEND(bugprone-use-after-move,clang-analyzer-cplusplus.Move)
+}
+
+UNODB_TYPED_TEST(ARTFrozenTest, SingleLeaf) {
+  unodb::test::tree_verifier<TypeParam> verifier;
+  verifier.insert(1, unodb::test::test_values[0]);
+  const frozen_type<TypeParam> frozen{verifier.get_db()};
+
+  UNODB_EXPECT_FALSE(frozen.empty());
+  UNODB_EXPECT_EQ(frozen.size(), 1);
+  check_value<TypeParam>(frozen, verifier.coerce_key(1),
+                         unodb::test::test_values[0]);
+  UNODB_EXPECT_FALSE(
+      frozen_type<TypeParam>::key_found(frozen.get(verifier.coerce_key(0))));
+  UNODB_EXPECT_FALSE(
+      frozen_type<TypeParam>::key_found(frozen.get(verifier.coerce_key(2))));
+  check_scans(verifier, frozen, 0, 2);
+  check_scans(verifier, frozen, 1, 2);
+}
+
+UNODB_TYPED_TEST(ARTFrozenTest, DenseTree) {
+  constexpr auto key_count = 2000;
+  unodb::test::tree_verifier<TypeParam> verifier;
+  verifier.insert_key_range(1, key_count);
+  const frozen_type<TypeParam> frozen{verifier.get_db()};
+
+  UNODB_EXPECT_EQ(frozen.size(), key_count);
+  for (std::uint64_t i = 1; i <= key_count; ++i) {
+    check_value<TypeParam>(
+        frozen, verifier.coerce_key(i),
+        unodb::test::test_values[i % unodb::test::test_values.size()]);
+  }
+  for (const std::uint64_t absent : {0ULL, key_count + 1ULL, 1ULL << 40U}) {
+    UNODB_EXPECT_FALSE(frozen_type<TypeParam>::key_found(
+        frozen.get(verifier.coerce_key(absent))));
+  }
+  check_scans(verifier, frozen, 100, 1000);
+  check_scans(verifier, frozen, 0, key_count + 10);
+
+#ifdef UNODB_DETAIL_WITH_STATS
+  UNODB_EXPECT_LT(frozen.get_current_memory_use(),
+                  verifier.get_db().get_current_memory_use());
+#endif  // UNODB_DETAIL_WITH_STATS
+}
+
+UNODB_TYPED_TEST(ARTFrozenTest, SparseTree) {
+  unodb::test::tree_verifier<TypeParam> verifier;
+  std::vector<std::uint64_t> keys;
+  // Keys with varying shared prefix lengths and node fanouts
+  for (std::uint64_t i = 0; i < 300; ++i) {
+    const auto k = (i * 0x9E3779B97F4A7C15ULL) >> (i % 48U);
+    if (std::ranges::find(keys, k) != keys.end()) continue;
+    keys.push_back(k);
+    verifier.insert(k, unodb::test::test_values[i % 5]);
+  }
+  const frozen_type<TypeParam> frozen{verifier.get_db()};
+
+  UNODB_EXPECT_EQ(frozen.size(), keys.size());
+  for (const auto k : keys) {
+    UNODB_EXPECT_TRUE(
+        frozen_type<TypeParam>::key_found(frozen.get(verifier.coerce_key(k))));
+    const auto absent = k ^ 0x100U;
+    if (std::ranges::find(keys, absent) != keys.end()) continue;
+    UNODB_EXPECT_FALSE(frozen_type<TypeParam>::key_found(
+        frozen.get(verifier.coerce_key(absent))));
+  }
+  std::ranges::sort(keys);
+  check_scans(verifier, frozen, keys[10], keys[keys.size() - 10]);
+  check_scans(verifier, frozen, keys[20] + 1, keys[keys.size() - 20] - 1);
+
+  std::ostringstream dump_sink;
+  frozen.dump(dump_sink);
+}
+
+UNODB_TYPED_TEST(ARTFrozenTest, IteratorSeek) {
+  unodb::test::tree_verifier<TypeParam> verifier;
+  for (std::uint64_t i = 10; i <= 50; i += 10)
+    verifier.insert(i, unodb::test::test_values[0]);
+  const frozen_type<TypeParam> frozen{verifier.get_db()};
+  using art_key_type = unodb::detail::basic_art_key<typename TypeParam::key_type>;
+
+  auto it = frozen.test_only_iterator();
+  bool match{};
+  it.seek(art_key_type{verifier.coerce_key(30)}, match, true);
+  UNODB_EXPECT_TRUE(match);
+  UNODB_ASSERT_TRUE(it.valid());
+  UNODB_EXPECT_EQ(it.get_key().size(), sizeof(std::uint64_t));
+
+  it.seek(art_key_type{verifier.coerce_key(35)}, match, true);
+  UNODB_EXPECT_FALSE(match);
+  UNODB_ASSERT_TRUE(it.valid());
+  it.prior();
+  it.prior();
+  it.prior();
+  UNODB_ASSERT_TRUE(it.valid());
+  it.prior();
+  UNODB_EXPECT_FALSE(it.valid());
+
+  it.seek(art_key_type{verifier.coerce_key(5)}, match, false);
+  UNODB_EXPECT_FALSE(match);
+  UNODB_EXPECT_FALSE(it.valid());
+  it.seek(art_key_type{verifier.coerce_key(55)}, match, true);
+  UNODB_EXPECT_FALSE(it.valid());
+  it.seek(art_key_type{verifier.coerce_key(55)}, match, false);
+  UNODB_ASSERT_TRUE(it.valid());
+  it.next();
+  UNODB_EXPECT_FALSE(it.valid());
+}
+
+}  // namespace
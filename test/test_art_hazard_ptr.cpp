@@ -0,0 +1,272 @@
+// Copyright 2025 UnoDB contributors
+
+// Should be the first include
+#include "global.hpp"  // IWYU pragma: keep
+
+// IWYU pragma: no_include <string>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "art_common.hpp"
+#include "db_test_utils.hpp"
+#include "gtest_utils.hpp"
+#include "hazard_ptr.hpp"
+#include "heap.hpp"
+#include "olc_art.hpp"
+#include "qsbr.hpp"
+#include "qsbr_test_utils.hpp"
+
+namespace {
+
+using u64_olc_db = unodb::olc_db<std::uint64_t, unodb::value_view>;
+
+using unodb::test::decode;
+using unodb::test::expect_value;
+using unodb::test::value_for;
+
+// The retired node count above which the current thread must have reclaimed.
+[[nodiscard]] std::size_t reclaim_bound() noexcept {
+  return std::max(unodb::hazard_pointer_thread::min_reclaim_threshold,
+                  2 * unodb::hazard_pointer_thread::get_total_slot_count());
+}
+
+using ARTHazardPointerTest = unodb::test::QSBRIdleTest;
+
+TEST_F(ARTHazardPointerTest, ProtectedNodeSurvivesReclaim) {
+  auto& hazards = unodb::hazard_pointer_thread::current();
+  auto* const protected_node = unodb::detail::allocate_aligned(64);
+  auto* const unprotected_node = unodb::detail::allocate_aligned(64);
+  {
+    unodb::hazard_pointer_slots slots;
+    slots.protect(0, protected_node);
+    hazards.retire(protected_node
+#ifndef NDEBUG
+                   ,
+                   nullptr
+#endif
+    );
+    hazards.retire(unprotected_node
+#ifndef NDEBUG
+                   ,
+                   nullptr
+#endif
+    );
+    hazards.reclaim();
+    UNODB_EXPECT_EQ(hazards.get_retired_count(), 1);
+  }
+  hazards.reclaim();
+  UNODB_EXPECT_EQ(hazards.get_retired_count(), 0);
+}
+
+TEST_F(ARTHazardPointerTest, SlotsAreReused) {
+  const auto slots_before =
+      unodb::hazard_pointer_thread::get_total_slot_count();
+  for (int i = 0; i < 3; ++i) {
+    // More than a block of slots
+    unodb::hazard_pointer_slots slots;
+    slots.reserve(40);
+    UNODB_EXPECT_EQ(slots.size(), 40);
+  }
+  UNODB_EXPECT_LE(unodb::hazard_pointer_thread::get_total_slot_count(),
+                  slots_before + 48);
+}
+
+// Fill one node with all the 256 key bytes and drain it again, so that every
+// node type is retired while being scanned and read.
+TEST_F(ARTHazardPointerTest, SingleThreadOperations) {
+  u64_olc_db db{unodb::hazard_pointer_reclamation};
+  UNODB_EXPECT_TRUE(db.uses_hazard_pointers());
+  UNODB_EXPECT_FALSE(u64_olc_db{}.uses_hazard_pointers());
+
+  for (std::uint64_t i = 0; i < 256; ++i)
+    UNODB_ASSERT_TRUE(db.insert(i << 8U, value_for(i)));
+  for (std::uint64_t i = 0; i < 256; ++i)
+    expect_value(db, i << 8U, value_for(i));
+
+  std::uint64_t visited{0};
+  db.scan([&visited](const auto& v) {
+    UNODB_EXPECT_EQ(decode(v.get_key()), visited << 8U);
+    UNODB_EXPECT_TRUE(std::ranges::equal(v.get_value(), value_for(visited)));
+    ++visited;
+    return false;
+  });
+  UNODB_EXPECT_EQ(visited, 256);
+
+  visited = 0;
+  db.scan_batched(0, 256 << 8U, [&visited](auto batch) {
+    for (const auto& e : batch) {
+      UNODB_EXPECT_EQ(decode(e.key), visited << 8U);
+      UNODB_EXPECT_TRUE(std::ranges::equal(e.value, value_for(visited)));
+      ++visited;
+    }
+    return false;
+  });
+  UNODB_EXPECT_EQ(visited, 256);
+
+  db.read_consistent([](u64_olc_db::read_transaction& transaction) {
+    for (std::uint64_t i = 0; i < 256; i += 16) {
+      const auto result = transaction.get(i << 8U);
+      UNODB_ASSERT_TRUE(result.has_value());
+      UNODB_EXPECT_TRUE(std::ranges::equal(*result, value_for(i)));
+    }
+  });
+
+  for (std::uint64_t i = 0; i < 256; ++i) {
+    UNODB_ASSERT_TRUE(db.remove(i << 8U));
+    UNODB_EXPECT_FALSE(db.get(i << 8U).has_value());
+  }
+  UNODB_EXPECT_TRUE(db.empty());
+  UNODB_EXPECT_LT(unodb::hazard_pointer_thread::current().get_retired_count(),
+                  reclaim_bound());
+}
+
+TEST_F(ARTHazardPointerTest, KeyViewScanOverRemovedLeaves) {
+  unodb::olc_db<unodb::key_view, unodb::value_view> db{
+      unodb::hazard_pointer_reclamation};
+  unodb::key_encoder enc;
+  const auto key = [&enc](std::string_view text) {
+    return enc.reset().encode_text(text).get_key_view();
+  };
+  constexpr std::array<std::string_view, 5> words{"blue", "blueberry", "green",
+                                                  "red", "redwood"};
+  for (std::size_t i = 0; i < words.size(); ++i)
+    UNODB_ASSERT_TRUE(db.insert(key(words[i]), value_for(i)));
+
+  // Remove the leaf being visited, so that the scan moves on from its key
+  std::size_t visited{0};
+  unodb::key_encoder remove_enc;
+  db.scan([&](const auto& v) {
+    UNODB_EXPECT_TRUE(std::ranges::equal(v.get_value(), value_for(visited)));
+    UNODB_EXPECT_TRUE(db.remove(
+        remove_enc.reset().encode_text(words[visited]).get_key_view()));
+    ++visited;
+    return false;
+  });
+  UNODB_EXPECT_EQ(visited, words.size());
+  UNODB_EXPECT_TRUE(db.empty());
+}
+
+// A scan stalled on a leaf must keep only the nodes it is on, while the
+// writers keep reclaiming everything else they remove, including that leaf.
+TEST_F(ARTHazardPointerTest, StalledScanDoesNotHoldBackReclamation) {
+  constexpr std::uint64_t key_count = 1024;
+  constexpr std::size_t rounds = 20;
+
+  u64_olc_db db{unodb::hazard_pointer_reclamation};
+  for (std::uint64_t k = 0; k < key_count; ++k)
+    UNODB_ASSERT_TRUE(db.insert(k, value_for(k)));
+
+  std::size_t max_retired{0};
+  std::uint64_t visited_key{key_count};
+  db.scan([&db, &max_retired, &visited_key](const auto& v) {
+    visited_key = decode(v.get_key());
+    const auto value = v.get_value();
+
+    unodb::qsbr_thread writer{[&db, &max_retired] {
+      auto& hazards = unodb::hazard_pointer_thread::current();
+      for (std::size_t round = 0; round < rounds; ++round) {
+        for (std::uint64_t k = 0; k < key_count; ++k) {
+          UNODB_ASSERT_TRUE(db.remove(k));
+          max_retired = std::max(max_retired, hazards.get_retired_count());
+        }
+        for (std::uint64_t k = 0; k < key_count; ++k)
+          UNODB_ASSERT_TRUE(db.insert(k, value_for(k)));
+      }
+    }};
+    writer.join();
+
+    // The leaf has been removed, but not freed
+    UNODB_EXPECT_TRUE(std::ranges::equal(value, value_for(visited_key)));
+    return true;
+  });
+
+  UNODB_EXPECT_EQ(visited_key, 0);
+  UNODB_EXPECT_LT(max_retired, reclaim_bound());
+  for (std::uint64_t k = 0; k < key_count; ++k)
+    expect_value(db, k, value_for(k));
+}
+
+// The readers must always find the keys nobody removes, while the writers keep
+// retiring the nodes around them.
+TEST_F(ARTHazardPointerTest, ParallelReadersAndWriters) {
+  constexpr std::uint64_t key_count = 512;
+  constexpr std::size_t writer_count = 2;
+  constexpr std::size_t reader_count = 2;
+  constexpr std::size_t rounds = 20;
+
+  u64_olc_db db{unodb::hazard_pointer_reclamation};
+  // The even keys are permanent, the odd ones belong to the writers
+  for (std::uint64_t k = 0; k < key_count; k += 2)
+    UNODB_ASSERT_TRUE(db.insert(k, value_for(k)));
+
+  std::atomic<std::size_t> writers_done{0};
+  std::atomic<std::uint64_t> missing{0};
+  std::atomic<std::uint64_t> wrong_values{0};
+
+  std::array<unodb::qsbr_thread, writer_count + reader_count> threads;
+  for (std::size_t i = 0; i < writer_count; ++i) {
+    threads[i] = unodb::qsbr_thread{[&db, &writers_done, i] {
+      for (std::size_t round = 0; round < rounds; ++round) {
+        for (auto k = 1 + 2 * i; k < key_count; k += 2 * writer_count)
+          UNODB_ASSERT_TRUE(db.insert(k, value_for(k)));
+        for (auto k = 1 + 2 * i; k < key_count; k += 2 * writer_count)
+          UNODB_ASSERT_TRUE(db.remove(k));
+      }
+      writers_done.fetch_add(1, std::memory_order_release);
+    }};
+  }
+  for (std::size_t i = 0; i < reader_count; ++i) {
+    threads[writer_count + i] = unodb::qsbr_thread{[&db, &writers_done,
+                                                    &missing, &wrong_values,
+                                                    i] {
+      do {
+        if (i == 0) {
+          for (std::uint64_t k = 0; k < key_count; ++k) {
+            const auto result = db.get(k);
+            if (result.has_value()) {
+              if (!std::ranges::equal(*result, value_for(k)))
+                wrong_values.fetch_add(1, std::memory_order_relaxed);
+            } else if (k % 2 == 0) {
+              missing.fetch_add(1, std::memory_order_relaxed);
+            }
+          }
+        } else {
+          std::uint64_t expected{0};
+          db.scan([&expected, &missing, &wrong_values](const auto& v) {
+            const auto k = decode(v.get_key());
+            if (!std::ranges::equal(v.get_value(), value_for(k)))
+              wrong_values.fetch_add(1, std::memory_order_relaxed);
+            if (k > expected) missing.fetch_add(1, std::memory_order_relaxed);
+            if (k % 2 == 0) expected = k + 2;
+            return false;
+          });
+          if (expected != key_count)
+            missing.fetch_add(1, std::memory_order_relaxed);
+        }
+      } while (writers_done.load(std::memory_order_acquire) < writer_count);
+    }};
+  }
+  for (auto& t : threads) t.join();
+
+  UNODB_EXPECT_EQ(missing.load(), 0);
+  UNODB_EXPECT_EQ(wrong_values.load(), 0);
+  for (std::uint64_t k = 0; k < key_count; ++k) {
+    if (k % 2 == 0) {
+      expect_value(db, k, value_for(k));
+    } else {
+      UNODB_EXPECT_FALSE(db.get(k).has_value());
+    }
+  }
+}
+
+}  // namespace
@@ -4,20 +4,22 @@
 #include "global.hpp"  // IWYU pragma: keep
 
 // IWYU pragma: no_include <__cstddef/byte.h>
-// IWYU pragma: no_include <array>
 // IWYU pragma: no_include <span>
 // IWYU pragma: no_include <string>
 // IWYU pragma: no_include <string_view>
 
+#include <array>
 #include <cstddef>  // IWYU pragma: keep
 #include <cstdint>
 #include <limits>
 #include <stdexcept>
 #include <tuple>
+#include <vector>
 
 #include <gtest/gtest.h>
 
 #include "art_common.hpp"
+#include "art_internal.hpp"
 #include "db_test_utils.hpp"
 #include "gtest_utils.hpp"
 
@@ -73,4 +75,30 @@ UNODB_TYPED_TEST(ARTKeyViewCorrectnessTest, EncodedTextKeys) {
   verifier.check_present_values();  // checks keys and key ordering.
 }
 
+/// Unit test scans a path deeper than the inline capacity of the iterator
+/// stack, so that the stack moves to the heap.
+UNODB_TYPED_TEST(ARTKeyViewCorrectnessTest, DeepPathScan) {
+  constexpr auto key_size = unodb::detail::key_view_iterator_stack_capacity + 8;
+  // The all-zero key and the keys with a single byte set, which branch off its
+  // path at every depth.
+  std::vector<std::array<std::byte, key_size>> keys(key_size + 1);
+  for (std::size_t i = 0; i < key_size; ++i) keys[i + 1][i] = std::byte{1};
+
+  unodb::test::tree_verifier<TypeParam> verifier;
+  for (const auto& k : keys)
+    verifier.insert(unodb::key_view{k}, unodb::test::test_values[0]);
+  verifier.check_present_values();
+
+  for (const auto fwd : {true, false}) {
+    std::size_t n = 0;
+    verifier.get_db().scan(
+        [&n](const unodb::visitor<typename TypeParam::iterator>&) noexcept {
+          ++n;
+          return false;
+        },
+        fwd);
+    UNODB_EXPECT_EQ(n, keys.size());
+  }
+}
+
 }  // namespace
@@ -0,0 +1,205 @@
+// Copyright 2025 UnoDB contributors
+
+// Should be the first include
+#include "global.hpp"  // IWYU pragma: keep
+
+// IWYU pragma: no_include <__ostream/basic_ostream.h>
+// IWYU pragma: no_include <string>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <string_view>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "art_common.hpp"
+#include "db_test_utils.hpp"
+#include "gtest_utils.hpp"
+#include "multimap_art.hpp"
+#include "node_type.hpp"
+
+namespace {
+
+using u64_multimap_db = unodb::multimap_db<std::uint64_t>;
+
+using value_vector = std::vector<std::vector<std::byte>>;
+
+// Return a row ID value in a buffer, big-endian so that the values sort in the
+// numeric order.
+[[nodiscard]] std::array<std::byte, sizeof(std::uint64_t)> row_id(
+    std::uint64_t id) noexcept {
+  std::array<std::byte, sizeof(std::uint64_t)> result{};
+  for (std::size_t i = 0; i < result.size(); ++i)
+    result[result.size() - 1 - i] = static_cast<std::byte>(id >> (i * 8U));
+  return result;
+}
+
+template <typename Key>
+[[nodiscard]] value_vector collect(const unodb::multimap_db<Key>& db, Key k) {
+  value_vector result;
+  db.scan_values(k, [&result](unodb::value_view v) {
+    result.emplace_back(v.begin(), v.end());
+    return false;
+  });
+  return result;
+}
+
+[[nodiscard]] value_vector row_ids(std::uint64_t begin, std::uint64_t end,
+                                   std::uint64_t step = 1) {
+  value_vector result;
+  for (auto i = begin; i < end; i += step) {
+    const auto v = row_id(i);
+    result.emplace_back(v.begin(), v.end());
+  }
+  return result;
+}
+
+TEST(ARTMultimap, EmptyTree) {
+  u64_multimap_db db;
+  UNODB_EXPECT_TRUE(db.empty());
+  UNODB_EXPECT_EQ(db.value_count(1), 0);
+  UNODB_EXPECT_TRUE(collect(db, std::uint64_t{1}).empty());
+  UNODB_EXPECT_FALSE(db.remove_value(1, unodb::test::test_values[0]));
+  UNODB_EXPECT_FALSE(db.remove(1));
+}
+
+TEST(ARTMultimap, InsertDupSortsAndRejectsDuplicates) {
+  u64_multimap_db db;
+  // Shorter values sort before their extensions, the empty value first
+  for (const auto& v : unodb::test::test_values)
+    UNODB_ASSERT_TRUE(db.insert_dup(1, v));
+  for (const auto& v : unodb::test::test_values)
+    UNODB_EXPECT_FALSE(db.insert_dup(1, v));
+
+  value_vector expected;
+  for (const auto& v : unodb::test::test_values)
+    expected.emplace_back(v.begin(), v.end());
+  std::ranges::sort(expected, [](const auto& a, const auto& b) {
+    return std::ranges::lexicographical_compare(
+        a, b, [](std::byte x, std::byte y) {
+          return static_cast<std::uint8_t>(x) < static_cast<std::uint8_t>(y);
+        });
+  });
+  UNODB_EXPECT_EQ(collect(db, std::uint64_t{1}), expected);
+  UNODB_EXPECT_EQ(db.value_count(1), expected.size());
+  UNODB_EXPECT_EQ(db.value_count(2), 0);
+}
+
+TEST(ARTMultimap, ManyValuesPerKey) {
+  constexpr std::uint64_t key_count = 50;
+  constexpr std::uint64_t values_per_key = 300;
+  u64_multimap_db db;
+  // Insert the values out of order to exercise the in-place insertion
+  for (std::uint64_t i = 0; i < values_per_key; ++i) {
+    const auto id = (i * 7) % values_per_key;
+    for (std::uint64_t k = 0; k < key_count; ++k)
+      UNODB_ASSERT_TRUE(db.insert_dup(k, row_id(id)));
+  }
+#ifdef UNODB_DETAIL_WITH_STATS
+  UNODB_EXPECT_EQ(db.get_node_count<unodb::node_type::LEAF>(), key_count);
+#endif  // UNODB_DETAIL_WITH_STATS
+
+  for (std::uint64_t k = 0; k < key_count; ++k)
+    UNODB_EXPECT_EQ(collect(db, k), row_ids(0, values_per_key));
+
+  // Remove the odd values, shrinking the lists
+  for (std::uint64_t id = 1; id < values_per_key; id += 2) {
+    for (std::uint64_t k = 0; k < key_count; ++k)
+      UNODB_ASSERT_TRUE(db.remove_value(k, row_id(id)));
+    UNODB_ASSERT_FALSE(db.remove_value(0, row_id(id)));
+  }
+  for (std::uint64_t k = 0; k < key_count; ++k)
+    UNODB_EXPECT_EQ(collect(db, k), row_ids(0, values_per_key, 2));
+
+  // Removing the last value removes the key
+  for (std::uint64_t id = 0; id < values_per_key; id += 2)
+    UNODB_ASSERT_TRUE(db.remove_value(0, row_id(id)));
+  UNODB_EXPECT_EQ(db.value_count(0), 0);
+  UNODB_EXPECT_FALSE(db.insert_dup(1, row_id(0)));
+  UNODB_EXPECT_TRUE(db.insert_dup(0, row_id(0)));
+  UNODB_EXPECT_EQ(db.value_count(0), 1);
+
+  std::ostringstream dump_sink;
+  db.dump(dump_sink);
+
+  for (std::uint64_t k = 0; k < key_count; ++k)
+    UNODB_ASSERT_TRUE(db.remove(k));
+  UNODB_EXPECT_TRUE(db.empty());
+#ifdef UNODB_DETAIL_WITH_STATS
+  UNODB_EXPECT_EQ(db.get_current_memory_use(), 0);
+#endif  // UNODB_DETAIL_WITH_STATS
+}
+
+TEST(ARTMultimap, LongValues) {
+  u64_multimap_db db;
+  // Lengths needing one, two, and three varint bytes
+  std::vector<std::vector<std::byte>> values;
+  for (const std::size_t size : {1U, 127U, 128U, 300U, 20000U})
+    values.emplace_back(size, static_cast<std::byte>(size % 256));
+  for (const auto& v : values) UNODB_ASSERT_TRUE(db.insert_dup(5, v));
+  UNODB_EXPECT_EQ(collect(db, std::uint64_t{5}).size(), values.size());
+  for (const auto& v : values) {
+    UNODB_ASSERT_TRUE(db.remove_value(5, v));
+    UNODB_EXPECT_FALSE(db.remove_value(5, v));
+  }
+  UNODB_EXPECT_TRUE(db.empty());
+}
+
+TEST(ARTMultimap, ScanValuesHalts) {
+  u64_multimap_db db;
+  for (std::uint64_t i = 0; i < 10; ++i)
+    UNODB_ASSERT_TRUE(db.insert_dup(3, row_id(i)));
+
+  std::size_t visited = 0;
+  db.scan_values(3, [&visited](unodb::value_view) {
+    ++visited;
+    return visited == 4;
+  });
+  UNODB_EXPECT_EQ(visited, 4);
+}
+
+TEST(ARTMultimap, KeyView) {
+  unodb::multimap_db<unodb::key_view> db;
+  unodb::key_encoder enc;
+  const auto key = [&enc](std::string_view text) {
+    return enc.reset().encode_text(text).get_key_view();
+  };
+  UNODB_ASSERT_TRUE(db.insert_dup(key("blue"), row_id(2)));
+  UNODB_ASSERT_TRUE(db.insert_dup(key("red"), row_id(1)));
+  UNODB_ASSERT_TRUE(db.insert_dup(key("blue"), row_id(1)));
+  UNODB_EXPECT_FALSE(db.insert_dup(key("blue"), row_id(2)));
+  UNODB_EXPECT_EQ(collect(db, key("blue")), row_ids(1, 3));
+  UNODB_EXPECT_EQ(collect(db, key("red")), row_ids(1, 2));
+  UNODB_ASSERT_TRUE(db.remove_value(key("red"), row_id(1)));
+  UNODB_EXPECT_EQ(db.value_count(key("red")), 0);
+  UNODB_EXPECT_EQ(db.value_count(key("blue")), 2);
+  db.clear();
+  UNODB_EXPECT_TRUE(db.empty());
+}
+
+#ifdef UNODB_DETAIL_WITH_STATS
+
+TEST(ARTMultimap, LessMemoryThanCompoundKeys) {
+  constexpr std::uint64_t key_count = 100;
+  constexpr std::uint64_t values_per_key = 20;
+  u64_multimap_db multimap;
+  // The alternative of making the keys unique by appending the row ID
+  unodb::db<std::uint64_t, unodb::value_view> compound;
+  for (std::uint64_t k = 0; k < key_count; ++k) {
+    for (std::uint64_t id = 0; id < values_per_key; ++id) {
+      UNODB_ASSERT_TRUE(multimap.insert_dup(k, row_id(id)));
+      UNODB_ASSERT_TRUE(compound.insert((k << 32U) | id, unodb::value_view{}));
+    }
+  }
+  UNODB_EXPECT_LT(multimap.get_current_memory_use(),
+                  compound.get_current_memory_use());
+}
+
+#endif  // UNODB_DETAIL_WITH_STATS
+
+}  // namespace
@@ -0,0 +1,332 @@
+// Copyright 2025 UnoDB contributors
+
+// Should be the first include
+#include "global.hpp"  // IWYU pragma: keep
+
+// IWYU pragma: no_include <string>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <sstream>
+#include <string_view>
+
+#include <gtest/gtest.h>
+
+#include "art_common.hpp"
+#include "db_test_utils.hpp"
+#include "gtest_utils.hpp"
+#include "node_type.hpp"
+#include "qsbr.hpp"
+#include "qsbr_test_utils.hpp"
+#include "rowex_art.hpp"
+
+namespace {
+
+using u64_rowex_db = unodb::rowex_db<std::uint64_t, unodb::value_view>;
+
+using unodb::test::expect_value;
+using unodb::test::value_for;
+
+using ARTRowexTest = unodb::test::QSBRIdleTest;
+
+TEST_F(ARTRowexTest, EmptyTree) {
+  u64_rowex_db db;
+  UNODB_EXPECT_TRUE(db.empty());
+  UNODB_EXPECT_FALSE(db.get(1).has_value());
+  UNODB_EXPECT_FALSE(db.remove(1));
+  std::ostringstream dump_sink;
+  db.dump(dump_sink);
+}
+
+TEST_F(ARTRowexTest, SingleLeaf) {
+  u64_rowex_db db;
+  UNODB_ASSERT_TRUE(db.insert(1, value_for(1)));
+  UNODB_EXPECT_FALSE(db.insert(1, value_for(2)));
+  expect_value(db, std::uint64_t{1}, value_for(1));
+  UNODB_EXPECT_FALSE(db.get(2).has_value());
+  UNODB_EXPECT_FALSE(db.remove(2));
+  UNODB_ASSERT_TRUE(db.remove(1));
+  UNODB_EXPECT_TRUE(db.empty());
+}
+
+// Fill one node with all the 256 key bytes and drain it again, so that it goes
+// through every node type in both directions.
+TEST_F(ARTRowexTest, GrowAndShrinkThroughAllNodeTypes) {
+  u64_rowex_db db;
+  for (std::uint64_t i = 0; i < 256; ++i) {
+    UNODB_ASSERT_TRUE(db.insert(i, value_for(i)));
+    UNODB_ASSERT_FALSE(db.insert(i, value_for(i + 1)));
+  }
+  for (std::uint64_t i = 0; i < 256; ++i) expect_value(db, i, value_for(i));
+  UNODB_EXPECT_FALSE(db.get(256).has_value());
+
+#ifdef UNODB_DETAIL_WITH_STATS
+  UNODB_EXPECT_EQ(db.get_node_count<unodb::node_type::LEAF>(), 256);
+  UNODB_EXPECT_EQ(db.get_node_count<unodb::node_type::I4>(), 0);
+  UNODB_EXPECT_EQ(db.get_node_count<unodb::node_type::I256>(), 1);
+  UNODB_EXPECT_EQ(db.get_growing_inode_count<unodb::node_type::I4>(), 1);
+  UNODB_EXPECT_EQ(db.get_growing_inode_count<unodb::node_type::I16>(), 1);
+  UNODB_EXPECT_EQ(db.get_growing_inode_count<unodb::node_type::I48>(), 1);
+  UNODB_EXPECT_EQ(db.get_growing_inode_count<unodb::node_type::I256>(), 1);
+  UNODB_EXPECT_LT(0, db.get_inode_copies());
+#endif  // UNODB_DETAIL_WITH_STATS
+
+  std::ostringstream dump_sink;
+  db.dump(dump_sink);
+
+  for (std::uint64_t i = 0; i < 256; ++i) {
+    UNODB_ASSERT_TRUE(db.remove(i));
+    UNODB_ASSERT_FALSE(db.remove(i));
+    UNODB_ASSERT_FALSE(db.get(i).has_value());
+    for (auto j = i + 1; j < 256; j += 37) expect_value(db, j, value_for(j));
+  }
+  UNODB_EXPECT_TRUE(db.empty());
+
+#ifdef UNODB_DETAIL_WITH_STATS
+  UNODB_EXPECT_EQ(db.get_shrinking_inode_count<unodb::node_type::I4>(), 1);
+  UNODB_EXPECT_EQ(db.get_shrinking_inode_count<unodb::node_type::I16>(), 1);
+  UNODB_EXPECT_EQ(db.get_shrinking_inode_count<unodb::node_type::I48>(), 1);
+  UNODB_EXPECT_EQ(db.get_shrinking_inode_count<unodb::node_type::I256>(), 1);
+  UNODB_EXPECT_EQ(db.get_current_memory_use(), 0);
+#endif  // UNODB_DETAIL_WITH_STATS
+}
+
+// A key prefix split, followed by the removals that collapse the new I4 and
+// make its remaining inode child absorb its key prefix.
+TEST_F(ARTRowexTest, KeyPrefixSplitAndCollapse) {
+  u64_rowex_db db;
+  UNODB_ASSERT_TRUE(db.insert(0x0102030405060708ULL, value_for(0)));
+  UNODB_ASSERT_TRUE(db.insert(0x0102030405060709ULL, value_for(1)));
+  UNODB_ASSERT_TRUE(db.insert(0x0102FF0405060708ULL, value_for(2)));
+  UNODB_ASSERT_TRUE(db.insert(0x01FF030405060708ULL, value_for(3)));
+
+#ifdef UNODB_DETAIL_WITH_STATS
+  UNODB_EXPECT_EQ(db.get_key_prefix_splits(), 2);
+#endif  // UNODB_DETAIL_WITH_STATS
+
+  expect_value(db, 0x0102030405060708ULL, value_for(0));
+  expect_value(db, 0x0102030405060709ULL, value_for(1));
+  expect_value(db, 0x0102FF0405060708ULL, value_for(2));
+  expect_value(db, 0x01FF030405060708ULL, value_for(3));
+  UNODB_EXPECT_FALSE(db.get(0x0102030405FF0708ULL).has_value());
+  UNODB_EXPECT_FALSE(db.remove(0x0102030405FF0708ULL));
+
+  UNODB_ASSERT_TRUE(db.remove(0x01FF030405060708ULL));
+  UNODB_ASSERT_TRUE(db.remove(0x0102FF0405060708ULL));
+  expect_value(db, 0x0102030405060708ULL, value_for(0));
+  expect_value(db, 0x0102030405060709ULL, value_for(1));
+  UNODB_EXPECT_FALSE(db.get(0x0102FF0405060708ULL).has_value());
+
+  UNODB_ASSERT_TRUE(db.remove(0x0102030405060709ULL));
+  expect_value(db, 0x0102030405060708ULL, value_for(0));
+  UNODB_ASSERT_TRUE(db.remove(0x0102030405060708ULL));
+  UNODB_EXPECT_TRUE(db.empty());
+
+#ifdef UNODB_DETAIL_WITH_STATS
+  UNODB_EXPECT_EQ(db.get_current_memory_use(), 0);
+#endif  // UNODB_DETAIL_WITH_STATS
+}
+
+TEST_F(ARTRowexTest, KeyView) {
+  unodb::rowex_db<unodb::key_view, unodb::value_view> db;
+  unodb::key_encoder enc;
+  const auto key = [&enc](std::string_view text) {
+    return enc.reset().encode_text(text).get_key_view();
+  };
+  UNODB_ASSERT_TRUE(db.insert(key("blue"), value_for(0)));
+  UNODB_ASSERT_TRUE(db.insert(key("blueberry"), value_for(1)));
+  UNODB_ASSERT_TRUE(db.insert(key("red"), value_for(2)));
+  UNODB_EXPECT_FALSE(db.insert(key("red"), value_for(3)));
+  expect_value(db, key("blue"), value_for(0));
+  expect_value(db, key("blueberry"), value_for(1));
+  expect_value(db, key("red"), value_for(2));
+  UNODB_EXPECT_FALSE(db.get(key("green")).has_value());
+  UNODB_ASSERT_TRUE(db.remove(key("blue")));
+  expect_value(db, key("blueberry"), value_for(1));
+  db.clear();
+  UNODB_EXPECT_TRUE(db.empty());
+}
+
+TEST_F(ARTRowexTest, ScanEmptyTree) {
+  const u64_rowex_db db;
+  std::size_t visited = 0;
+  db.scan([&visited](const unodb::visitor<u64_rowex_db::iterator>&) {
+    ++visited;
+    return false;
+  });
+  UNODB_EXPECT_EQ(visited, 0);
+}
+
+// Scan the tree as it grows through every node type, and halt a scan midway.
+TEST_F(ARTRowexTest, ScanInKeyOrder) {
+  u64_rowex_db db;
+  for (std::uint64_t i = 0; i < 256; ++i) {
+    UNODB_ASSERT_TRUE(db.insert(i * 3, value_for(i)));
+
+    std::uint64_t expected = 0;
+    db.scan([&expected](const unodb::visitor<u64_rowex_db::iterator>& v) {
+      UNODB_EXPECT_EQ(unodb::test::decode(v.get_key()), expected * 3);
+      UNODB_EXPECT_TRUE(std::ranges::equal(v.get_value(), value_for(expected)));
+      ++expected;
+      return false;
+    });
+    UNODB_ASSERT_EQ(expected, i + 1);
+  }
+
+  std::uint64_t last_key = 0;
+  db.scan([&last_key](const unodb::visitor<u64_rowex_db::iterator>& v) {
+    last_key = unodb::test::decode(v.get_key());
+    return last_key == 300;
+  });
+  UNODB_EXPECT_EQ(last_key, 300);
+}
+
+TEST_F(ARTRowexTest, ScanKeyView) {
+  using key_view_rowex_db = unodb::rowex_db<unodb::key_view, unodb::value_view>;
+  key_view_rowex_db db;
+  unodb::key_encoder enc;
+  const auto key = [&enc](std::string_view text) {
+    return enc.reset().encode_text(text).get_key_view();
+  };
+  UNODB_ASSERT_TRUE(db.insert(key("red"), value_for(2)));
+  UNODB_ASSERT_TRUE(db.insert(key("blueberry"), value_for(1)));
+  UNODB_ASSERT_TRUE(db.insert(key("blue"), value_for(0)));
+
+  std::uint64_t expected = 0;
+  db.scan([&expected](const unodb::visitor<key_view_rowex_db::iterator>& v) {
+    UNODB_EXPECT_TRUE(std::ranges::equal(v.get_value(), value_for(expected)));
+    ++expected;
+    return false;
+  });
+  UNODB_EXPECT_EQ(expected, 3);
+}
+
+// The scans must visit the keys nobody removes, in the key order, while the
+// writers keep replacing the nodes under them.
+TEST_F(ARTRowexTest, ParallelScansAndWriters) {
+  constexpr std::uint64_t key_count = 512;
+  constexpr std::size_t rounds = 20;
+
+  u64_rowex_db db;
+  for (std::uint64_t k = 0; k < key_count; k += 2)
+    UNODB_ASSERT_TRUE(db.insert(k, value_for(k)));
+
+  std::atomic<bool> writer_done{false};
+  std::atomic<std::uint64_t> missing{0};
+  std::atomic<std::uint64_t> out_of_order{0};
+
+  unodb::this_thread().qsbr_pause();
+
+  unodb::qsbr_thread writer{[&db, &writer_done] {
+    for (std::size_t round = 0; round < rounds; ++round) {
+      for (std::uint64_t k = 1; k < key_count; k += 2)
+        UNODB_ASSERT_TRUE(db.insert(k, value_for(k)));
+      unodb::this_thread().quiescent();
+      for (std::uint64_t k = 1; k < key_count; k += 2)
+        UNODB_ASSERT_TRUE(db.remove(k));
+      unodb::this_thread().quiescent();
+    }
+    writer_done.store(true, std::memory_order_release);
+  }};
+  unodb::qsbr_thread scanner{[&db, &writer_done, &missing, &out_of_order] {
+    do {
+      std::uint64_t next_even = 0;
+      std::uint64_t prev_key = 0;
+      bool first = true;
+      db.scan([&](const unodb::visitor<u64_rowex_db::iterator>& v) {
+        const auto k = unodb::test::decode(v.get_key());
+        if (!first && k <= prev_key)
+          out_of_order.fetch_add(1, std::memory_order_relaxed);
+        first = false;
+        prev_key = k;
+        if (k % 2 == 0) {
+          if (k != next_even)
+            missing.fetch_add(1, std::memory_order_relaxed);
+          next_even = k + 2;
+        }
+        return false;
+      });
+      if (next_even != key_count)
+        missing.fetch_add(1, std::memory_order_relaxed);
+      unodb::this_thread().quiescent();
+    } while (!writer_done.load(std::memory_order_acquire));
+  }};
+  writer.join();
+  scanner.join();
+
+  unodb::this_thread().qsbr_resume();
+
+  UNODB_EXPECT_EQ(missing.load(), 0);
+  UNODB_EXPECT_EQ(out_of_order.load(), 0);
+}
+
+// The readers must always find the keys nobody removes, while the writers keep
+// growing, shrinking, and copying the nodes around them.
+TEST_F(ARTRowexTest, ParallelReadersAndWriters) {
+  constexpr std::uint64_t key_count = 512;
+  constexpr std::size_t writer_count = 2;
+  constexpr std::size_t reader_count = 2;
+  constexpr std::size_t rounds = 20;
+
+  u64_rowex_db db;
+  // The even keys are permanent, the odd ones belong to the writers
+  for (std::uint64_t k = 0; k < key_count; k += 2)
+    UNODB_ASSERT_TRUE(db.insert(k, value_for(k)));
+
+  std::atomic<std::size_t> writers_done{0};
+  std::atomic<std::uint64_t> missing{0};
+  std::atomic<std::uint64_t> wrong_values{0};
+
+  unodb::this_thread().qsbr_pause();
+
+  std::array<unodb::qsbr_thread, writer_count + reader_count> threads;
+  for (std::size_t i = 0; i < writer_count; ++i) {
+    threads[i] = unodb::qsbr_thread{[&db, &writers_done, i] {
+      for (std::size_t round = 0; round < rounds; ++round) {
+        for (auto k = 1 + 2 * i; k < key_count; k += 2 * writer_count)
+          UNODB_ASSERT_TRUE(db.insert(k, value_for(k)));
+        unodb::this_thread().quiescent();
+        for (auto k = 1 + 2 * i; k < key_count; k += 2 * writer_count)
+          UNODB_ASSERT_TRUE(db.remove(k));
+        unodb::this_thread().quiescent();
+      }
+      writers_done.fetch_add(1, std::memory_order_release);
+    }};
+  }
+  for (std::size_t i = 0; i < reader_count; ++i) {
+    threads[writer_count + i] =
+        unodb::qsbr_thread{[&db, &writers_done, &missing, &wrong_values] {
+          do {
+            for (std::uint64_t k = 0; k < key_count; ++k) {
+              const auto result = db.get(k);
+              if (result.has_value()) {
+                if (!std::ranges::equal(*result, value_for(k)))
+                  wrong_values.fetch_add(1, std::memory_order_relaxed);
+              } else if (k % 2 == 0) {
+                missing.fetch_add(1, std::memory_order_relaxed);
+              }
+            }
+            unodb::this_thread().quiescent();
+          } while (writers_done.load(std::memory_order_acquire) <
+                   writer_count);
+        }};
+  }
+  for (auto& t : threads) t.join();
+
+  unodb::this_thread().qsbr_resume();
+
+  UNODB_EXPECT_EQ(missing.load(), 0);
+  UNODB_EXPECT_EQ(wrong_values.load(), 0);
+  for (std::uint64_t k = 0; k < key_count; ++k) {
+    if (k % 2 == 0) {
+      expect_value(db, k, value_for(k));
+    } else {
+      UNODB_EXPECT_FALSE(db.get(k).has_value());
+    }
+  }
+}
+
+}  // namespace
@@ -6,18 +6,19 @@
 // IWYU pragma: no_include <__ostream/basic_ostream.h>
 // IWYU pragma: no_include <__vector/vector.h>
 // IWYU pragma: no_include <array>
-// IWYU pragma: no_include <span>
 // IWYU pragma: no_include <string>
 
 #include <algorithm>
 #include <cstdint>
 #include <iostream>
+#include <span>
 #include <utility>
 #include <vector>  // IWYU pragma: keep
 
 #include <gtest/gtest.h>
 
 #include "art_common.hpp"
+#include "art_internal.hpp"
 #include "db_test_utils.hpp"
 #include "gtest_utils.hpp"
 
@@ -1083,4 +1084,105 @@ UNODB_TYPED_TEST(ARTScanTest, scanRangeC143) {
   do_scan_range_test<TypeParam>(823, 247, 999);
 }
 
+// The scan results do not depend on the prefetch distance, including ones
+// reaching past the end of an inode.
+UNODB_TYPED_TEST(ARTScanTest, scanPrefetchDistances) {
+  unodb::test::tree_verifier<TypeParam> verifier;
+  TypeParam& db = verifier.get_db();  // reference to test db instance.
+  // Every inode type on the leaf level
+  constexpr std::uint64_t key_limit = 256 * 4;
+  for (std::uint64_t i = 0; i < key_limit; ++i) {
+    const auto fanout = std::uint64_t{1} << ((i / 256) * 2);
+    if (i % 256 < fanout + 2) verifier.insert(i, unodb::test::test_values[0]);
+  }
+  UNODB_EXPECT_EQ(db.get_scan_prefetch_distance(),
+                  unodb::detail::default_scan_prefetch_distance);
+  for (const auto distance : {std::uint8_t{0}, std::uint8_t{1}, std::uint8_t{4},
+                              std::uint8_t{255}}) {
+    db.set_scan_prefetch_distance(distance);
+    UNODB_EXPECT_EQ(db.get_scan_prefetch_distance(), distance);
+    for (const auto fwd : {true, false}) {
+      std::vector<std::uint64_t> keys;
+      db.scan(
+          [&keys](const unodb::visitor<typename TypeParam::iterator>& v) {
+            keys.push_back(decode(v.get_key()));
+            return false;
+          },
+          fwd);
+      UNODB_EXPECT_EQ(keys.size(), 3 + 6 + 18 + 66);
+      if (!fwd) std::ranges::reverse(keys);
+      UNODB_EXPECT_TRUE(std::ranges::is_sorted(keys));
+    }
+  }
+}
+
+// The batched scan visits the same entries as scan_range(), grouping the
+// leaves under the same parent, and respects the range bounds and the halt
+// of the caller inside a batch.
+TEST(ARTScanBatchedTest, MatchesScanRange) {
+  using db_type = unodb::test::u64_olc_db;
+  unodb::test::tree_verifier<db_type> verifier;
+  db_type& db = verifier.get_db();
+  // Runs of leaves under every inode type, separated by inode children
+  constexpr std::uint64_t key_limit = 256 * 4;
+  for (std::uint64_t i = 0; i < key_limit; ++i) {
+    const auto fanout = std::uint64_t{1} << ((i / 256) * 2);
+    if (i % 256 < fanout + 2) verifier.insert(i, unodb::test::test_values[0]);
+  }
+  for (std::uint64_t i = 0; i < 5; ++i)
+    verifier.insert((i << 16U) | 0x3000U, unodb::test::test_values[1]);
+
+  const auto scanned = [&db](std::uint64_t from, std::uint64_t to) {
+    std::vector<std::uint64_t> result;
+    db.scan_range(from, to,
+                  [&result](const unodb::visitor<db_type::iterator>& v) {
+                    result.push_back(decode(v.get_key()));
+                    return false;
+                  });
+    return result;
+  };
+  for (const auto& [from, to] :
+       {std::pair<std::uint64_t, std::uint64_t>{0, key_limit},
+        {0, 0x50000}, {5, 700}, {300, 301}, {513, 600}, {1024, 0x30000}}) {
+    std::vector<std::uint64_t> keys;
+    std::size_t max_batch_size{0};
+    db.scan_batched(
+        from, to,
+        [&keys,
+         &max_batch_size](std::span<const db_type::scan_batch_entry> batch) {
+          UNODB_EXPECT_FALSE(batch.empty());
+          UNODB_EXPECT_LE(batch.size(), db_type::scan_batch_capacity);
+          max_batch_size = std::max(max_batch_size, batch.size());
+          for (const auto& e : batch) {
+            keys.push_back(decode(e.key));
+            const auto& expected_value =
+                unodb::test::test_values[keys.back() < 0x3000 ? 0 : 1];
+            UNODB_EXPECT_TRUE(std::ranges::equal(e.value, expected_value));
+          }
+          return false;
+        });
+    UNODB_EXPECT_EQ(keys, scanned(from, to));
+    if (keys.size() > 2) UNODB_EXPECT_LT(1, max_batch_size);
+  }
+
+  // An empty range and a reversed one visit nothing
+  db.scan_batched(5, 5, [](std::span<const db_type::scan_batch_entry>) {
+    UNODB_EXPECT_TRUE(false);
+    return false;
+  });
+  db.scan_batched(700, 5, [](std::span<const db_type::scan_batch_entry>) {
+    UNODB_EXPECT_TRUE(false);
+    return false;
+  });
+
+  // Halting after the first batch
+  std::size_t batches{0};
+  db.scan_batched(0, key_limit,
+                  [&batches](std::span<const db_type::scan_batch_entry>) {
+                    ++batches;
+                    return true;
+                  });
+  UNODB_EXPECT_EQ(batches, 1);
+}
+
 }  // namespace
@@ -0,0 +1,239 @@
+// Copyright 2025 UnoDB contributors
+
+// Should be the first include
+#include "global.hpp"  // IWYU pragma: keep
+
+// IWYU pragma: no_include <string>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "art_common.hpp"
+#include "db_test_utils.hpp"
+#include "gtest_utils.hpp"
+#include "node_type.hpp"
+#include "sharded_mutex_art.hpp"
+
+namespace {
+
+using u64_sharded_db =
+    unodb::sharded_mutex_db<std::uint64_t, unodb::value_view>;
+
+using unodb::test::decode;
+using unodb::test::expect_value;
+using unodb::test::value_for;
+
+// A key with the given first byte, so that the keys spread over the shards
+[[nodiscard]] constexpr std::uint64_t spread_key(std::uint64_t i) noexcept {
+  return (i << 56U) | i;
+}
+
+// Return the keys visited by a scan, in the visiting order
+template <typename Scan>
+[[nodiscard]] std::vector<std::uint64_t> scanned_keys(Scan scan) {
+  std::vector<std::uint64_t> result;
+  scan([&result](const unodb::visitor<u64_sharded_db::iterator>& v) {
+    result.push_back(decode(v.get_key()));
+    return false;
+  });
+  return result;
+}
+
+TEST(ARTShardedMutex, EmptyTree) {
+  u64_sharded_db db;
+  UNODB_EXPECT_EQ(db.get_shard_count(), u64_sharded_db::default_shard_count);
+  UNODB_EXPECT_TRUE(db.empty());
+  UNODB_EXPECT_FALSE(u64_sharded_db::key_found(db.get(1)));
+  UNODB_EXPECT_FALSE(db.remove(1));
+  UNODB_EXPECT_TRUE(scanned_keys([&db](auto fn) { db.scan(fn); }).empty());
+  std::ostringstream dump_sink;
+  db.dump(dump_sink);
+}
+
+TEST(ARTShardedMutex, InvalidShardCount) {
+  for (const std::size_t count : {0U, 3U, 48U, 512U}) {
+    UNODB_ASSERT_THROW(u64_sharded_db{count}, std::invalid_argument);
+  }
+}
+
+TEST(ARTShardedMutex, InsertGetRemoveAcrossShards) {
+  for (const std::size_t shard_count : {1U, 4U, 256U}) {
+    u64_sharded_db db{shard_count};
+    for (std::uint64_t i = 0; i < 256; ++i)
+      UNODB_ASSERT_TRUE(db.insert(spread_key(i), value_for(i)));
+    UNODB_EXPECT_FALSE(db.insert(spread_key(7), value_for(8)));
+    for (std::uint64_t i = 0; i < 256; ++i)
+      expect_value(db, spread_key(i), value_for(i));
+    UNODB_EXPECT_FALSE(u64_sharded_db::key_found(db.get(spread_key(7) + 1)));
+
+#ifdef UNODB_DETAIL_WITH_STATS
+    UNODB_EXPECT_EQ(db.get_node_count<unodb::node_type::LEAF>(), 256);
+    UNODB_EXPECT_EQ(db.get_node_counts()[0], 256);
+    UNODB_EXPECT_LT(0, db.get_current_memory_use());
+#endif  // UNODB_DETAIL_WITH_STATS
+
+    for (std::uint64_t i = 0; i < 256; i += 2)
+      UNODB_ASSERT_TRUE(db.remove(spread_key(i)));
+    for (std::uint64_t i = 0; i < 256; ++i) {
+      UNODB_EXPECT_EQ(u64_sharded_db::key_found(db.get(spread_key(i))),
+                      i % 2 == 1);
+    }
+    UNODB_EXPECT_FALSE(db.empty());
+    db.clear();
+    UNODB_EXPECT_TRUE(db.empty());
+
+#ifdef UNODB_DETAIL_WITH_STATS
+    UNODB_EXPECT_EQ(db.get_current_memory_use(), 0);
+#endif  // UNODB_DETAIL_WITH_STATS
+  }
+}
+
+// The scans must visit the shards in the key order in both directions, and
+// stop in the middle of a shard when the visitor halts.
+TEST(ARTShardedMutex, ScansStitchShardsInKeyOrder) {
+  u64_sharded_db db{4};
+  std::vector<std::uint64_t> keys;
+  for (std::uint64_t i = 0; i < 256; i += 5) {
+    keys.push_back(spread_key(i));
+    UNODB_ASSERT_TRUE(db.insert(spread_key(i), value_for(i)));
+  }
+  std::vector<std::uint64_t> reverse_keys{keys.rbegin(), keys.rend()};
+
+  UNODB_EXPECT_EQ(scanned_keys([&db](auto fn) { db.scan(fn); }), keys);
+  UNODB_EXPECT_EQ(scanned_keys([&db](auto fn) { db.scan(fn, false); }),
+                  reverse_keys);
+
+  // From the middle of the second shard
+  const auto from = spread_key(100);
+  std::vector<std::uint64_t> expected;
+  std::ranges::copy_if(keys, std::back_inserter(expected),
+                       [from](std::uint64_t k) { return k >= from; });
+  UNODB_EXPECT_EQ(
+      scanned_keys([&db, from](auto fn) { db.scan_from(from, fn); }),
+      expected);
+  expected.clear();
+  std::ranges::copy_if(reverse_keys, std::back_inserter(expected),
+                       [from](std::uint64_t k) { return k <= from; });
+  UNODB_EXPECT_EQ(
+      scanned_keys([&db, from](auto fn) { db.scan_from(from, fn, false); }),
+      expected);
+
+  // From the second shard into the fourth one and back
+  const auto to = spread_key(200);
+  expected.clear();
+  std::ranges::copy_if(keys, std::back_inserter(expected),
+                       [from, to](std::uint64_t k) {
+                         return k >= from && k < to;
+                       });
+  UNODB_EXPECT_EQ(
+      scanned_keys([&db, from, to](auto fn) { db.scan_range(from, to, fn); }),
+      expected);
+  expected.clear();
+  std::ranges::copy_if(reverse_keys, std::back_inserter(expected),
+                       [from, to](std::uint64_t k) {
+                         return k <= to && k > from;
+                       });
+  UNODB_EXPECT_EQ(
+      scanned_keys([&db, from, to](auto fn) { db.scan_range(to, from, fn); }),
+      expected);
+
+  std::size_t visited = 0;
+  db.scan([&visited](const unodb::visitor<u64_sharded_db::iterator>&) {
+    ++visited;
+    return visited == 20;
+  });
+  UNODB_EXPECT_EQ(visited, 20);
+}
+
+// A sorted batch crosses the shards in runs, an unsorted one goes back and
+// forth between them.
+TEST(ARTShardedMutex, InsertBatch) {
+  u64_sharded_db db{4};
+  std::vector<std::pair<std::uint64_t, unodb::value_view>> batch;
+  for (std::uint64_t i = 0; i < 256; i += 3)
+    batch.emplace_back(spread_key(i), value_for(i));
+  UNODB_EXPECT_EQ(db.insert_batch(batch), batch.size());
+
+  batch.clear();
+  for (std::uint64_t i = 0; i < 256; i += 2)
+    batch.emplace_back(spread_key(255 - i), value_for(255 - i));
+  UNODB_EXPECT_EQ(db.insert_batch(batch), 85);
+
+  for (std::uint64_t i = 0; i < 256; ++i) {
+    if (i % 3 == 0 || i % 2 == 1) {
+      expect_value(db, spread_key(i), value_for(i));
+    } else {
+      UNODB_EXPECT_FALSE(u64_sharded_db::key_found(db.get(spread_key(i))));
+    }
+  }
+}
+
+TEST(ARTShardedMutex, KeyView) {
+  unodb::sharded_mutex_db<unodb::key_view, unodb::value_view> db{8};
+  unodb::key_encoder enc;
+  const auto key = [&enc](std::string_view text) {
+    return enc.reset().encode_text(text).get_key_view();
+  };
+  UNODB_ASSERT_TRUE(db.insert(key("apple"), value_for(0)));
+  UNODB_ASSERT_TRUE(db.insert(key("zebra"), value_for(1)));
+  UNODB_ASSERT_TRUE(db.insert(key("Mango"), value_for(2)));
+  UNODB_EXPECT_FALSE(db.insert(key("zebra"), value_for(3)));
+  expect_value(db, key("apple"), value_for(0));
+  expect_value(db, key("zebra"), value_for(1));
+  expect_value(db, key("Mango"), value_for(2));
+  UNODB_ASSERT_TRUE(db.remove(key("apple")));
+  UNODB_EXPECT_FALSE(db.get(key("apple")).first.has_value());
+  db.clear();
+  UNODB_EXPECT_TRUE(db.empty());
+}
+
+// The writers of different shards and the readers of all of them run in
+// parallel.
+TEST(ARTShardedMutex, ParallelReadersAndWriters) {
+  constexpr std::size_t shard_count = 4;
+  constexpr std::uint64_t keys_per_thread = 64;
+  u64_sharded_db db{shard_count};
+  // The first key of each shard is permanent
+  for (std::uint64_t s = 0; s < shard_count; ++s)
+    UNODB_ASSERT_TRUE(db.insert(s << 62U, value_for(s)));
+
+  std::array<std::thread, shard_count * 2> threads;
+  for (std::uint64_t s = 0; s < shard_count; ++s) {
+    threads[s] = std::thread{[&db, s] {
+      for (std::uint64_t i = 1; i <= keys_per_thread; ++i)
+        UNODB_ASSERT_TRUE(db.insert((s << 62U) | i, value_for(i)));
+      for (std::uint64_t i = 1; i <= keys_per_thread; i += 2)
+        UNODB_ASSERT_TRUE(db.remove((s << 62U) | i));
+    }};
+    threads[shard_count + s] = std::thread{[&db] {
+      for (std::size_t round = 0; round < 100; ++round) {
+        for (std::uint64_t t = 0; t < shard_count; ++t)
+          expect_value(db, t << 62U, value_for(t));
+        db.scan([](const unodb::visitor<u64_sharded_db::iterator>&) {
+          return false;
+        });
+      }
+    }};
+  }
+  for (auto& t : threads) t.join();
+
+  for (std::uint64_t s = 0; s < shard_count; ++s) {
+    for (std::uint64_t i = 1; i <= keys_per_thread; ++i) {
+      UNODB_EXPECT_EQ(u64_sharded_db::key_found(db.get((s << 62U) | i)),
+                      i % 2 == 0);
+    }
+  }
+}
+
+}  // namespace
@@ -4,14 +4,19 @@
 #include "global.hpp"  // IWYU pragma: keep
 
 // IWYU pragma: no_include <__math/traits.h>
-// IWYU pragma: no_include <array>
 // IWYU pragma: no_include <string>
 // IWYU pragma: no_include <gtest/gtest.h>
 
+#include <array>
+#include <atomic>
 #include <cmath>
+#include <cstddef>
+#include <memory>
 #include <sstream>
 #include <system_error>
+#include <thread>
 #include <utility>
+#include <vector>
 
 #include "gtest_utils.hpp"
 #include "qsbr.hpp"
@@ -58,11 +63,7 @@ UNODB_TEST_F(QSBR, TwoThreads) {
 }
 
 UNODB_TEST_F(QSBR, TwoThreadsSecondQuitPaused) {
-  unodb::qsbr_thread second_thread([]()
-#ifndef UNODB_DETAIL_WITH_STATS
-                                       noexcept
-#endif
-                                   { qsbr_pause(); });
+  unodb::qsbr_thread second_thread([]() noexcept { qsbr_pause(); });
   join(second_thread);
 }
 
@@ -401,6 +402,560 @@ UNODB_TEST_F(QSBR, TwoThreadAllocations) {
   join(second_thread);
 }
 
+// The recycled blocks go to the free list of the thread that retired them
+// once their epoch is over, up to the list capacity.
+UNODB_TEST_F(QSBR, TwoThreadRecycling) {
+  constexpr std::size_t block_size = 16;
+  constexpr std::size_t free_list = 1;
+  unodb::this_thread().set_free_list_capacity(2);
+  std::array<void*, 3> blocks{};
+  for (auto& block : blocks)
+    block = unodb::detail::allocate_aligned(block_size);
+
+  unodb::qsbr_thread second_thread([] {
+    thread_syncs[0].notify();
+    thread_syncs[1].wait();
+
+    quiescent();
+    thread_syncs[0].notify();
+    thread_syncs[1].wait();
+
+    quiescent();
+    thread_syncs[0].notify();
+    thread_syncs[1].wait();
+  });
+
+  thread_syncs[0].wait();
+  for (auto* const block : blocks) {
+    unodb::this_thread().on_next_epoch_recycle(block, free_list, block_size
+#ifndef NDEBUG
+                                               ,
+                                               check_ptr_on_qsbr_dealloc
+#endif
+    );
+  }
+  quiescent();
+  UNODB_EXPECT_EQ(unodb::this_thread().get_free_list_size(free_list), 0);
+
+  thread_syncs[1].notify();
+  thread_syncs[0].wait();
+  quiescent();
+  thread_syncs[1].notify();
+  thread_syncs[0].wait();
+  quiescent();
+
+  UNODB_EXPECT_EQ(unodb::this_thread().get_free_list_size(free_list), 2);
+  UNODB_EXPECT_EQ(unodb::this_thread().take_free_block(free_list, 8), nullptr);
+  UNODB_EXPECT_EQ(unodb::this_thread().take_free_block(0, block_size),
+                  nullptr);
+  auto* const recycled =
+      unodb::this_thread().take_free_block(free_list, block_size);
+  UNODB_EXPECT_NE(recycled, nullptr);
+  UNODB_EXPECT_EQ(unodb::this_thread().get_free_list_size(free_list), 1);
+  unodb::detail::free_aligned(recycled);
+
+  unodb::this_thread().set_free_list_capacity(0);
+  UNODB_EXPECT_EQ(unodb::this_thread().get_free_list_size(free_list), 0);
+  unodb::this_thread().set_free_list_capacity(
+      unodb::detail::qsbr_free_lists::default_capacity);
+
+  thread_syncs[1].notify();
+  join(second_thread);
+}
+
+// With the background reclaimer running, the expired requests are executed by
+// it instead of the thread seeing the epoch change, except for the recycled
+// blocks fitting into the free lists of that thread.
+UNODB_TEST_F(QSBR, TwoThreadBackgroundReclaimer) {
+  constexpr std::size_t block_size = 16;
+  constexpr std::size_t free_list = 1;
+  UNODB_EXPECT_FALSE(unodb::qsbr::instance().has_background_reclaimer());
+  unodb::qsbr::instance().start_background_reclaimer();
+  unodb::qsbr::instance().start_background_reclaimer();
+  UNODB_EXPECT_TRUE(unodb::qsbr::instance().has_background_reclaimer());
+  auto* const block = unodb::detail::allocate_aligned(block_size);
+  auto* const ptr = static_cast<char*>(allocate());
+
+  unodb::qsbr_thread second_thread([] {
+    thread_syncs[0].notify();
+    thread_syncs[1].wait();
+
+    quiescent();
+    thread_syncs[0].notify();
+    thread_syncs[1].wait();
+
+    quiescent();
+    thread_syncs[0].notify();
+    thread_syncs[1].wait();
+  });
+
+  thread_syncs[0].wait();
+  unodb::this_thread().on_next_epoch_recycle(block, free_list, block_size
+#ifndef NDEBUG
+                                             ,
+                                             check_ptr_on_qsbr_dealloc
+#endif
+  );
+  qsbr_deallocate(ptr);
+  quiescent();
+
+  thread_syncs[1].notify();
+  thread_syncs[0].wait();
+  quiescent();
+  thread_syncs[1].notify();
+  thread_syncs[0].wait();
+  quiescent();
+
+  UNODB_EXPECT_EQ(unodb::this_thread().get_free_list_size(free_list), 1);
+  unodb::detail::free_aligned(
+      unodb::this_thread().take_free_block(free_list, block_size));
+
+  thread_syncs[1].notify();
+  join(second_thread);
+
+  unodb::qsbr::instance().stop_background_reclaimer();
+  UNODB_EXPECT_FALSE(unodb::qsbr::instance().has_background_reclaimer());
+  unodb::qsbr::instance().stop_background_reclaimer();
+}
+
+// Concurrent starts and stops of the background reclaimer never replace a
+// reclaimer thread that has not been joined yet.
+UNODB_TEST_F(QSBR, ConcurrentBackgroundReclaimerStartStop) {
+  constexpr auto iterations = 200;
+  std::thread stopper{[] {
+    for (auto i = 0; i < iterations; ++i)
+      unodb::qsbr::instance().stop_background_reclaimer();
+  }};
+  for (auto i = 0; i < iterations; ++i)
+    unodb::qsbr::instance().start_background_reclaimer();
+  stopper.join();
+
+  unodb::qsbr::instance().stop_background_reclaimer();
+  UNODB_EXPECT_FALSE(unodb::qsbr::instance().has_background_reclaimer());
+}
+
+// A thread going over the backlog limit reports the threads holding back the
+// epoch change, once per going over it.
+UNODB_TEST_F(QSBR, BacklogLimitNotify) {
+  std::vector<std::thread::id> lagging;
+  std::size_t lagging_in_callback = 0;
+  // The callback runs unlocked, thus it may call the domain API taking locks
+  unodb::qsbr::instance().set_backlog_limit(
+      2, unodb::qsbr_backlog_policy::notify,
+      [&lagging, &lagging_in_callback](std::thread::id id) {
+        lagging.push_back(id);
+        unodb::qsbr::instance().for_each_lagging_thread(
+            [&lagging_in_callback](std::thread::id) {
+              ++lagging_in_callback;
+            });
+      });
+  UNODB_EXPECT_EQ(unodb::qsbr::instance().get_backlog_limit(), 2);
+  std::thread::id second_thread_id;
+
+  unodb::qsbr_thread second_thread([&second_thread_id] {
+    second_thread_id = std::this_thread::get_id();
+    thread_syncs[0].notify();
+    thread_syncs[1].wait();
+
+    quiescent();
+    thread_syncs[0].notify();
+    thread_syncs[1].wait();
+  });
+
+  thread_syncs[0].wait();
+  quiescent();
+  std::vector<std::thread::id> lagging_now;
+  unodb::qsbr::instance().for_each_lagging_thread(
+      [&lagging_now](std::thread::id id) { lagging_now.push_back(id); });
+  UNODB_ASSERT_EQ(lagging_now.size(), 1);
+  UNODB_EXPECT_EQ(lagging_now[0], second_thread_id);
+
+  std::array<void*, 3> ptrs{allocate(), allocate(), allocate()};
+  qsbr_deallocate(ptrs[0]);
+  qsbr_deallocate(ptrs[1]);
+  quiescent();
+  UNODB_EXPECT_TRUE(lagging.empty());
+  qsbr_deallocate(ptrs[2]);
+  UNODB_EXPECT_EQ(unodb::this_thread().get_pending_request_count(), 3);
+  quiescent();
+  UNODB_ASSERT_EQ(lagging.size(), 1);
+  UNODB_EXPECT_EQ(lagging[0], second_thread_id);
+  UNODB_EXPECT_EQ(lagging_in_callback, 1);
+  quiescent();
+  UNODB_EXPECT_EQ(lagging.size(), 1);
+
+  thread_syncs[1].notify();
+  thread_syncs[0].wait();
+  quiescent();
+  UNODB_EXPECT_EQ(unodb::this_thread().get_pending_request_count(), 3);
+
+  thread_syncs[1].notify();
+  join(second_thread);
+  quiescent();
+  UNODB_EXPECT_EQ(unodb::this_thread().get_pending_request_count(), 0);
+  UNODB_EXPECT_EQ(lagging.size(), 1);
+
+  unodb::qsbr::instance().set_backlog_limit(0,
+                                            unodb::qsbr_backlog_policy::notify);
+}
+
+// A throttled thread waits in its quiescent state until the other thread lets
+// enough epochs change.
+UNODB_TEST_F(QSBR, BacklogLimitThrottle) {
+  unodb::qsbr::instance().set_backlog_limit(
+      1, unodb::qsbr_backlog_policy::throttle);
+  UNODB_EXPECT_EQ(unodb::qsbr::instance().get_backlog_policy(),
+                  unodb::qsbr_backlog_policy::throttle);
+  std::atomic<bool> done{false};
+
+  unodb::qsbr_thread second_thread([&done] {
+    thread_syncs[0].notify();
+    thread_syncs[1].wait();
+
+    while (!done.load(std::memory_order_acquire)) {
+      quiescent();
+      std::this_thread::yield();
+    }
+  });
+
+  thread_syncs[0].wait();
+  qsbr_deallocate(allocate());
+  qsbr_deallocate(allocate());
+  UNODB_EXPECT_EQ(unodb::this_thread().get_pending_request_count(), 2);
+
+  thread_syncs[1].notify();
+  quiescent();
+  UNODB_EXPECT_EQ(unodb::this_thread().get_pending_request_count(), 0);
+
+  done.store(true, std::memory_order_release);
+  join(second_thread);
+  unodb::qsbr::instance().set_backlog_limit(0,
+                                            unodb::qsbr_backlog_policy::notify);
+}
+
+// An idle thread in the guard mode does not hold back the reclamation, and
+// executes its own expired requests on entering the next guard.
+UNODB_TEST_F(QSBR, EbrGuardIdleThreadDoesNotStallReclamation) {
+  unodb::qsbr_thread second_thread([] {
+    {
+      const unodb::ebr_guard guard;
+      qsbr_deallocate(allocate());
+    }
+    UNODB_EXPECT_EQ(unodb::this_thread().get_pending_request_count(), 1);
+    thread_syncs[0].notify();
+    thread_syncs[1].wait();
+
+    {
+      const unodb::ebr_guard guard;
+      UNODB_EXPECT_EQ(unodb::this_thread().get_pending_request_count(), 0);
+    }
+    thread_syncs[0].notify();
+    thread_syncs[1].wait();
+  });
+
+  thread_syncs[0].wait();
+  qsbr_deallocate(allocate());
+  for (int i = 0; i < 1000; ++i) {
+    quiescent();
+    if (unodb::this_thread().get_pending_request_count() == 0) break;
+  }
+  UNODB_EXPECT_EQ(unodb::this_thread().get_pending_request_count(), 0);
+
+  thread_syncs[1].notify();
+  thread_syncs[0].wait();
+  thread_syncs[1].notify();
+  join(second_thread);
+}
+
+UNODB_TEST_F(QSBR, EbrGuardNested) {
+  unodb::qsbr_thread second_thread([] {
+    thread_syncs[0].notify();
+    thread_syncs[1].wait();
+  });
+  thread_syncs[0].wait();
+
+  {
+    const unodb::ebr_guard outer;
+    {
+      const unodb::ebr_guard inner;
+      qsbr_deallocate(allocate());
+    }
+    qsbr_deallocate(allocate());
+  }
+  UNODB_EXPECT_EQ(unodb::this_thread().get_pending_request_count(), 2);
+  // A quiescent state outside of the guards is allowed
+  quiescent();
+
+  thread_syncs[1].notify();
+  join(second_thread);
+  quiescent();
+  quiescent();
+  UNODB_EXPECT_EQ(unodb::this_thread().get_pending_request_count(), 0);
+
+  // Leave the guard mode
+  unodb::this_thread().qsbr_pause();
+  unodb::this_thread().qsbr_resume();
+}
+
+UNODB_TEST_F(QSBR, WorkerQuiescentStateInterval) {
+  {
+    unodb::qsbr_worker worker{3};
+    mark_epoch();
+    worker.run([] {});
+    worker.run([] {});
+    check_epoch_same();
+    worker.run([] {});
+    check_epoch_advanced();
+    worker.run([] {});
+    check_epoch_same();
+  }
+  // The last task is followed by a quiescent state on destruction
+  check_epoch_advanced();
+}
+
+// A parked worker does not hold back the reclamation, and resumes on its next
+// task.
+UNODB_TEST_F(QSBR, WorkerParkDoesNotStallReclamation) {
+  unodb::qsbr_thread second_thread([] {
+    unodb::qsbr_worker worker;
+    worker.run([] { qsbr_deallocate(allocate()); });
+    worker.park();
+    UNODB_EXPECT_TRUE(worker.is_parked());
+    UNODB_EXPECT_TRUE(is_qsbr_paused());
+    thread_syncs[0].notify();  // 1 ->
+    thread_syncs[1].wait();    // 2 <-
+
+    worker.run([] { UNODB_EXPECT_EQ(get_qsbr_thread_count(), 2); });
+    UNODB_EXPECT_FALSE(worker.is_parked());
+    UNODB_EXPECT_FALSE(is_qsbr_paused());
+    thread_syncs[0].notify();  // 3 ->
+  });
+
+  thread_syncs[0].wait();  // 1 <-
+  UNODB_EXPECT_EQ(get_qsbr_thread_count(), 1);
+  qsbr_deallocate(allocate());
+  quiescent();
+  quiescent();
+  UNODB_EXPECT_EQ(unodb::this_thread().get_pending_request_count(), 0);
+
+  thread_syncs[1].notify();  // 2 ->
+  thread_syncs[0].wait();    // 3 <-
+  join(second_thread);
+}
+
+[[nodiscard]] unodb::qsbr_thread_count_type domain_thread_count(
+    const unodb::qsbr& domain) noexcept {
+  return unodb::qsbr_state::get_thread_count(domain.get_state());
+}
+
+// A thread that does not pass through a quiescent state in one domain holds
+// back the reclamation only there.
+UNODB_TEST_F(QSBR, DomainsAreIsolated) {
+  constexpr std::size_t block_size = 16;
+  constexpr std::size_t free_list = 1;
+  unodb::qsbr domain;
+  UNODB_EXPECT_EQ(domain_thread_count(domain), 0);
+  auto& main_in_domain = domain.current_thread();
+  UNODB_EXPECT_EQ(&domain.current_thread(), &main_in_domain);
+  UNODB_EXPECT_EQ(&main_in_domain.get_domain(), &domain);
+  UNODB_EXPECT_EQ(&unodb::this_thread().get_domain(),
+                  &unodb::qsbr::instance());
+  UNODB_EXPECT_EQ(domain_thread_count(domain), 1);
+  UNODB_EXPECT_EQ(get_qsbr_thread_count(), 1);
+
+  // Not registered with the default domain
+  std::thread second_thread([&domain] {
+    auto& second_in_domain = domain.current_thread();
+    thread_syncs[0].notify();
+    thread_syncs[1].wait();
+
+    second_in_domain.quiescent();
+    thread_syncs[0].notify();
+    thread_syncs[1].wait();
+
+    second_in_domain.quiescent();
+    thread_syncs[0].notify();
+    thread_syncs[1].wait();
+  });
+
+  thread_syncs[0].wait();
+  UNODB_EXPECT_EQ(domain_thread_count(domain), 2);
+  UNODB_EXPECT_EQ(get_qsbr_thread_count(), 1);
+
+  auto* const block = unodb::detail::allocate_aligned(block_size);
+  main_in_domain.on_next_epoch_recycle(block, free_list, block_size
+#ifndef NDEBUG
+                                       ,
+                                       check_ptr_on_qsbr_dealloc
+#endif
+  );
+  mark_epoch();
+  for (int i = 0; i < 3; ++i) {
+    main_in_domain.quiescent();
+    quiescent();
+    check_epoch_advanced();
+  }
+  UNODB_EXPECT_EQ(main_in_domain.get_free_list_size(free_list), 0);
+
+  thread_syncs[1].notify();
+  thread_syncs[0].wait();
+  main_in_domain.quiescent();
+  thread_syncs[1].notify();
+  thread_syncs[0].wait();
+  main_in_domain.quiescent();
+  UNODB_EXPECT_EQ(main_in_domain.get_free_list_size(free_list), 1);
+  UNODB_EXPECT_EQ(unodb::this_thread().get_free_list_size(free_list), 0);
+
+  thread_syncs[1].notify();
+  second_thread.join();
+  UNODB_EXPECT_EQ(domain_thread_count(domain), 1);
+
+  domain.leave_current_thread();
+  UNODB_EXPECT_EQ(domain_thread_count(domain), 0);
+  domain.leave_current_thread();
+}
+
+// More domains than the per-thread state cache holds are still looked up
+// correctly, and a domain reusing the cache slot of a destroyed one starts with
+// no threads.
+UNODB_TEST_F(QSBR, ManyDomains) {
+  constexpr std::size_t domain_count = 100;
+  std::vector<std::unique_ptr<unodb::qsbr>> domains;
+  const auto join_new_domain = [&domains] {
+    domains.push_back(std::make_unique<unodb::qsbr>());
+    auto& domain = *domains.back();
+    UNODB_EXPECT_EQ(domain_thread_count(domain), 0);
+    auto& in_domain = domain.current_thread();
+    UNODB_EXPECT_EQ(&in_domain.get_domain(), &domain);
+    UNODB_EXPECT_EQ(&domain.current_thread(), &in_domain);
+    UNODB_EXPECT_EQ(domain_thread_count(domain), 1);
+  };
+
+  for (std::size_t i = 0; i < domain_count; ++i) join_new_domain();
+  domains.erase(domains.begin(), domains.begin() + domain_count / 2);
+  for (std::size_t i = 0; i < domain_count / 2; ++i) join_new_domain();
+
+  for (const auto& domain : domains) {
+    UNODB_EXPECT_EQ(&domain->current_thread().get_domain(), domain.get());
+    UNODB_EXPECT_EQ(domain_thread_count(*domain), 1);
+  }
+}
+
+UNODB_TEST_F(QSBR, ThreadsSharingQuiescenceShards) {
+  // More threads than the quiescence shards, which then count the quiescent
+  // states of several threads each
+  constexpr std::size_t worker_count = 20;
+  std::atomic<std::size_t> turn{2 * worker_count};
+  const auto wait_for_turn = [&turn](std::size_t i) {
+    while (turn.load() != i) std::this_thread::yield();
+  };
+
+  std::vector<unodb::qsbr_thread> workers;
+  workers.reserve(worker_count);
+  for (std::size_t i = 0; i < worker_count; ++i) {
+    workers.emplace_back([this, i, &turn, &wait_for_turn] {
+      // The first round: the epoch changes once the last thread passes
+      wait_for_turn(i);
+      quiescent();
+      if (i < worker_count - 1) {
+        check_epoch_same();
+      } else {
+        check_epoch_advanced();
+      }
+      ++turn;
+
+      // The second round: half of the threads quit without passing
+      wait_for_turn(worker_count + i);
+      if (i % 2 == 0) {
+        quiescent();
+        check_epoch_same();
+      }
+      ++turn;
+    });
+  }
+  UNODB_EXPECT_EQ(get_qsbr_thread_count(), worker_count + 1);
+
+  quiescent();
+  mark_epoch();
+  turn = 0;
+
+  wait_for_turn(2 * worker_count);
+  for (auto& worker : workers) join(worker);
+  UNODB_EXPECT_EQ(get_qsbr_thread_count(), 1);
+  check_epoch_same();
+  quiescent();
+  check_epoch_advanced();
+}
+
+UNODB_TEST_F(QSBR, ThreadJoiningFlushedQuiescenceShard) {
+  // One thread in each of the eight quiescence shards, the main one last
+  constexpr std::size_t worker_count = 7;
+  const auto done_turn = 3 * worker_count;
+  std::atomic<std::size_t> turn{done_turn + 1};
+  const auto wait_for_turn = [&turn](std::size_t i) {
+    while (turn.load() != i) std::this_thread::yield();
+  };
+
+  qsbr_pause();
+  std::vector<unodb::qsbr_thread> workers;
+  workers.reserve(worker_count);
+  for (std::size_t i = 0; i < worker_count; ++i) {
+    workers.emplace_back([i, &turn, &wait_for_turn, done_turn] {
+      wait_for_turn(i);
+      quiescent();
+      ++turn;
+
+      wait_for_turn(worker_count + 3 + i);
+      quiescent();
+      // The first shard is not flushed until the late thread passes too
+      UNODB_EXPECT_EQ(get_qsbr_threads_in_previous_epoch(),
+                      worker_count + 2 - i);
+      ++turn;
+
+      wait_for_turn(done_turn);
+    });
+  }
+  unodb::this_thread().qsbr_resume();
+  mark_epoch();
+  turn = 0;
+
+  wait_for_turn(worker_count);
+  UNODB_EXPECT_EQ(get_qsbr_threads_in_previous_epoch(), 1);
+
+  // The late thread joins the flushed first shard, and subtracts itself from
+  // the previous epoch directly
+  unodb::qsbr_thread late_thread{[this, &turn, &wait_for_turn, done_turn] {
+    wait_for_turn(worker_count + 1);
+    quiescent();
+    UNODB_EXPECT_EQ(get_qsbr_threads_in_previous_epoch(), 1);
+    check_epoch_same();
+    ++turn;
+
+    wait_for_turn(2 * worker_count + 3);
+    quiescent();
+    UNODB_EXPECT_EQ(get_qsbr_threads_in_previous_epoch(), 1);
+    ++turn;
+
+    wait_for_turn(done_turn);
+  }};
+  UNODB_EXPECT_EQ(get_qsbr_threads_in_previous_epoch(), 2);
+  ++turn;
+
+  wait_for_turn(worker_count + 2);
+  quiescent();
+  check_epoch_advanced();
+  UNODB_EXPECT_EQ(get_qsbr_threads_in_previous_epoch(), worker_count + 2);
+  ++turn;
+
+  wait_for_turn(2 * worker_count + 4);
+  quiescent();
+  check_epoch_advanced();
+
+  turn = done_turn;
+  for (auto& worker : workers) join(worker);
+  join(late_thread);
+}
+
 UNODB_TEST_F(QSBR, TwoThreadAllocationsQuitWithoutQuiescentState) {
   auto* ptr = static_cast<char*>(allocate());
 
@@ -0,0 +1,273 @@
+// Copyright 2025 UnoDB contributors
+
+// Should be the first include
+#include "global.hpp"  // IWYU pragma: keep
+
+// IWYU pragma: no_include <string>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <ios>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include <gtest/gtest.h>
+
+#include "art_common.hpp"
+#include "db_test_utils.hpp"
+#include "gtest_utils.hpp"
+#include "qsbr.hpp"
+#include "qsbr_test_utils.hpp"
+#include "redo_log.hpp"
+
+namespace {
+
+template <class Db>
+class RedoLogTest : public ::testing::Test {
+ public:
+  UNODB_DETAIL_DISABLE_MSVC_WARNING(26447)
+  ~RedoLogTest() noexcept override {
+    if constexpr (unodb::test::is_olc_db<Db>) {
+      unodb::this_thread().quiescent();
+      unodb::test::expect_idle_qsbr();
+    }
+    std::error_code ignored;
+    std::filesystem::remove_all(dir, ignored);
+  }
+  UNODB_DETAIL_RESTORE_MSVC_WARNINGS()
+
+ protected:
+  using durable_db = unodb::durable_db<Db>;
+
+  // NOLINTNEXTLINE(bugprone-exception-escape)
+  RedoLogTest() {
+    auto name =
+        std::string{"unodb_test_redo_log_"} +
+        ::testing::UnitTest::GetInstance()->current_test_suite()->name() + "_" +
+        ::testing::UnitTest::GetInstance()->current_test_info()->name();
+    // The test suite name contains a '/' for the typed tests, which must not
+    // become a path separator
+    for (auto& c : name)
+      if (c == '/' || c == '\\') c = '_';
+    dir = std::filesystem::temp_directory_path() / name;
+    std::filesystem::remove_all(dir);
+    if constexpr (unodb::test::is_olc_db<Db>) unodb::test::expect_idle_qsbr();
+  }
+
+  [[nodiscard]] std::filesystem::path log_path() const {
+    return dir / durable_db::log_name();
+  }
+
+  static void insert_range(durable_db& db, std::uint64_t begin,
+                           std::uint64_t end) {
+    for (auto i = begin; i < end; ++i) {
+      UNODB_ASSERT_TRUE(db.insert(
+          i, unodb::test::test_values[i % unodb::test::test_values.size()]));
+    }
+  }
+
+  static void check_present(const durable_db& db, std::uint64_t begin,
+                            std::uint64_t end) {
+    for (auto i = begin; i < end; ++i) {
+      unodb::test::detail::assert_result_eq<Db>(
+          db.get_db(), i,
+          unodb::test::test_values[i % unodb::test::test_values.size()],
+          __FILE__, __LINE__);
+    }
+  }
+
+  static void check_absent(const durable_db& db, std::uint64_t begin,
+                           std::uint64_t end) {
+    for (auto i = begin; i < end; ++i)
+      UNODB_EXPECT_FALSE(Db::key_found(db.get_db().get(i)));
+  }
+
+  std::filesystem::path dir;
+};
+
+using ARTTypes = ::testing::Types<unodb::test::u64_db, unodb::test::u64_mutex_db,
+                                  unodb::test::u64_olc_db>;
+
+UNODB_TYPED_TEST_SUITE(RedoLogTest, ARTTypes)
+
+UNODB_TYPED_TEST(RedoLogTest, EmptyRecovery) {
+  {
+    const typename TestFixture::durable_db db{this->dir};
+    UNODB_EXPECT_TRUE(db.empty());
+  }
+  const typename TestFixture::durable_db db{this->dir};
+  UNODB_EXPECT_TRUE(db.empty());
+  UNODB_EXPECT_EQ(std::filesystem::file_size(this->log_path()), 0);
+}
+
+UNODB_TYPED_TEST(RedoLogTest, RecoverInsertsAndRemoves) {
+  {
+    typename TestFixture::durable_db db{this->dir};
+    TestFixture::insert_range(db, 0, 100);
+    for (std::uint64_t i = 0; i < 50; ++i) UNODB_ASSERT_TRUE(db.remove(i));
+    // Failed operations are not logged
+    UNODB_ASSERT_FALSE(db.remove(0));
+    UNODB_ASSERT_FALSE(db.insert(99, unodb::test::test_values[0]));
+    UNODB_EXPECT_EQ(db.get_log().get_record_count(), 150);
+  }
+  const typename TestFixture::durable_db db{this->dir};
+  TestFixture::check_absent(db, 0, 50);
+  TestFixture::check_present(db, 50, 100);
+}
+
+UNODB_TYPED_TEST(RedoLogTest, AsyncCommits) {
+  {
+    typename TestFixture::durable_db db{this->dir, false};
+    TestFixture::insert_range(db, 0, 100);
+    UNODB_EXPECT_EQ(db.get_log().get_sync_count(), 0);
+    db.sync();
+    UNODB_EXPECT_EQ(db.get_log().get_sync_count(), 1);
+    TestFixture::insert_range(db, 100, 200);
+  }
+  const typename TestFixture::durable_db db{this->dir};
+  TestFixture::check_present(db, 0, 200);
+}
+
+UNODB_TYPED_TEST(RedoLogTest, Checkpoint) {
+  {
+    typename TestFixture::durable_db db{this->dir};
+    TestFixture::insert_range(db, 0, 100);
+    db.checkpoint();
+    UNODB_EXPECT_EQ(std::filesystem::file_size(this->log_path()), 0);
+    for (std::uint64_t i = 0; i < 10; ++i) UNODB_ASSERT_TRUE(db.remove(i));
+    TestFixture::insert_range(db, 100, 110);
+  }
+  {
+    typename TestFixture::durable_db db{this->dir};
+    TestFixture::check_absent(db, 0, 10);
+    TestFixture::check_present(db, 10, 110);
+    db.checkpoint();
+  }
+  // Replaying a stale log over the newer base image, as after a crash between
+  // the two steps of a checkpoint, recovers the same state.
+  const auto stale_log = this->dir / "stale.log";
+  std::filesystem::copy_file(this->log_path(), stale_log);
+  {
+    typename TestFixture::durable_db db{this->dir};
+    TestFixture::insert_range(db, 200, 210);
+    UNODB_ASSERT_TRUE(db.remove(200));
+    std::filesystem::copy_file(
+        this->log_path(), stale_log,
+        std::filesystem::copy_options::overwrite_existing);
+    db.checkpoint();
+  }
+  std::filesystem::copy_file(stale_log, this->log_path(),
+                             std::filesystem::copy_options::overwrite_existing);
+  const typename TestFixture::durable_db db{this->dir};
+  TestFixture::check_absent(db, 0, 10);
+  TestFixture::check_present(db, 10, 110);
+  TestFixture::check_absent(db, 200, 201);
+  TestFixture::check_present(db, 201, 210);
+}
+
+UNODB_TYPED_TEST(RedoLogTest, TornTail) {
+  {
+    typename TestFixture::durable_db db{this->dir};
+    TestFixture::insert_range(db, 0, 10);
+  }
+  const auto valid_size = std::filesystem::file_size(this->log_path());
+  {
+    std::ofstream log{this->log_path(), std::ios::binary | std::ios::app};
+    // A record header claiming more bytes than there are
+    const std::array<char, 12> torn{1, 8, 0, 0, 0, 100, 0, 0, 0, 1, 2, 3};
+    log.write(torn.data(), torn.size());
+  }
+  {
+    typename TestFixture::durable_db db{this->dir};
+    UNODB_EXPECT_EQ(std::filesystem::file_size(this->log_path()), valid_size);
+    TestFixture::check_present(db, 0, 10);
+    TestFixture::insert_range(db, 10, 20);
+  }
+  const typename TestFixture::durable_db db{this->dir};
+  TestFixture::check_present(db, 0, 20);
+}
+
+UNODB_TYPED_TEST(RedoLogTest, CorruptedRecord) {
+  {
+    typename TestFixture::durable_db db{this->dir};
+    TestFixture::insert_range(db, 0, 10);
+  }
+  const auto log_size = std::filesystem::file_size(this->log_path());
+  {
+    // Flip a byte in the value of the last record
+    std::fstream log{this->log_path(),
+                     std::ios::binary | std::ios::in | std::ios::out};
+    log.seekp(static_cast<std::streamoff>(log_size - 5));
+    log.put('\x7F');
+  }
+  const typename TestFixture::durable_db db{this->dir};
+  TestFixture::check_present(db, 0, 9);
+  TestFixture::check_absent(db, 9, 10);
+}
+
+UNODB_TYPED_TEST(RedoLogTest, GroupCommit) {
+  if constexpr (!std::is_same_v<TypeParam, unodb::test::u64_db>) {
+    constexpr std::size_t thread_count = 4;
+    constexpr std::uint64_t ops_per_thread = 100;
+    {
+      typename TestFixture::durable_db db{this->dir};
+      if constexpr (unodb::test::is_olc_db<TypeParam>)
+        unodb::this_thread().qsbr_pause();
+
+      std::array<unodb::test::thread<TypeParam>, thread_count> threads;
+      for (std::size_t i = 0; i < thread_count; ++i) {
+        threads[i] = unodb::test::thread<TypeParam>{[&db, i] {
+          TestFixture::insert_range(db, i * ops_per_thread,
+                                    (i + 1) * ops_per_thread);
+        }};
+      }
+      for (auto& t : threads) t.join();
+
+      if constexpr (unodb::test::is_olc_db<TypeParam>)
+        unodb::this_thread().qsbr_resume();
+
+      UNODB_EXPECT_EQ(db.get_log().get_record_count(),
+                      thread_count * ops_per_thread);
+      UNODB_EXPECT_LE(db.get_log().get_sync_count(),
+                      thread_count * ops_per_thread);
+    }
+    const typename TestFixture::durable_db db{this->dir};
+    TestFixture::check_present(db, 0, thread_count * ops_per_thread);
+  }
+}
+
+TEST(RedoLogKeyView, Recover) {
+  const auto dir =
+      std::filesystem::temp_directory_path() / "unodb_test_redo_log_key_view";
+  std::filesystem::remove_all(dir);
+  const std::array<std::string, 3> keys{"alpha", "beta", "gamma"};
+  unodb::key_encoder enc;
+  const auto encode = [&enc](const std::string& k) {
+    return enc.reset().encode_text(k).get_key_view();
+  };
+  {
+    unodb::durable_db<unodb::test::key_view_db> db{dir};
+    for (std::size_t i = 0; i < keys.size(); ++i)
+      UNODB_ASSERT_TRUE(db.insert(encode(keys[i]), unodb::test::test_values[i]));
+    UNODB_ASSERT_TRUE(db.remove(encode(keys[1])));
+    db.checkpoint();
+    UNODB_ASSERT_TRUE(db.insert(encode(keys[1]), unodb::test::test_values[4]));
+  }
+  {
+    const unodb::durable_db<unodb::test::key_view_db> db{dir};
+    const auto& tree = db.get_db();
+    for (const auto& [i, value_i] :
+         {std::pair{0U, 0U}, std::pair{1U, 4U}, std::pair{2U, 2U}}) {
+      unodb::test::detail::assert_result_eq<unodb::test::key_view_db>(
+          tree, encode(keys[i]), unodb::test::test_values[value_i], __FILE__,
+          __LINE__);
+    }
+  }
+  std::filesystem::remove_all(dir);
+}
+
+}  // namespace